@@ -422,7 +422,7 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
             goto Done;
         }
         ccnl_content_add2cache(ccnl, c);
-        c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+        ccnl_content_set_static(ccnl, c);
 Done:
         ccnl_pkt_free(pk);
         ccnl_free(buf);
@@ -505,7 +505,7 @@ int
 ccnl_android_http_io(int fd, int events, void *data)
 {
     struct ccnl_relay_s *relay = (struct ccnl_relay_s*) data;
-    struct ccnl_http_s *http = relay->http;
+    struct ccnl_http_conn_s *http = relay->http->conn; // only one client
 
     DEBUGMSG(TRACE, "-- http_io\n");
 
@@ -526,8 +526,11 @@ ccnl_android_http_io(int fd, int events, void *data)
             // we should check if there are pending clients ...
             return 0;
         } else if (len > 0) {
-            http->in[len] = 0;
-            ccnl_http_status(relay, http);
+            http->inlen += len;
+            http->in[http->inlen] = 0;
+            if (!http->out)
+                ccnl_http_status(relay, http);
+            ccnl_http_produce(relay, http);
         }
     }
     if (http->outlen > 0 && (events | ALOOPER_EVENT_OUTPUT)) {
@@ -536,10 +539,16 @@ ccnl_android_http_io(int fd, int events, void *data)
         if (len > 0) {
             http->outlen -= len;
             http->outoffs += len;
+            if (http->outlen <= 0 && http->busy)
+                ccnl_http_produce(relay, http);
             if (http->outlen <= 0) {
                 ALooper_removeFd(theLooper, http->client);
                 close(http->client);
                 http->client = 0;
+                if (http->metrics) {
+                    ccnl_free(http->metrics);
+                    http->metrics = NULL;
+                }
                 // we should check if there are pending clients ...
                 DEBUGMSG(TRACE, " http closed\n");
                 return 0;
@@ -556,7 +565,7 @@ int
 ccnl_android_http_accept(int fd, int events, void *data)
 {
     struct ccnl_relay_s *relay = (struct ccnl_relay_s*) data;
-    struct ccnl_http_s *http = relay->http;
+    struct ccnl_http_conn_s *http = relay->http->conn;
     struct sockaddr_in peer;
     socklen_t len = sizeof(peer);
 
@@ -568,13 +577,14 @@ ccnl_android_http_accept(int fd, int events, void *data)
     if (!(events | ALOOPER_EVENT_INPUT))
         return 1;
 
-    http->client = accept(http->server,
+    http->client = accept(relay->http->server,
                           (struct sockaddr*) &peer, &len);
     if (http->client < 0)
         http->client = 0;
     else {
         DEBUGMSG(DEBUG, "accepted web server client fd=%d\n", http->client);
-        http->inlen = http->outlen = http->inoffs = http->outoffs = 0;
+        http->inlen = http->outlen = http->outoffs = 0;
+        http->out = NULL;
 
         ALooper_addFd(theLooper, http->client,
                       ALOOPER_POLL_CALLBACK,
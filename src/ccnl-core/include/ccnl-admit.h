@@ -0,0 +1,111 @@
+/*
+ * @f ccnl-admit.h
+ * @b CCN lite, admission policies of the content store
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * An admission policy decides whether a Data packet that would evict an
+ * entry of a full content store is cached at all, so that a scan of names
+ * requested once does not flush the popular ones. While the store has
+ * room every packet is cached.
+ *
+ *   all        cache every packet (the default)
+ *   prob:P     cache a packet with probability P
+ *   second     cache a name the second time it arrives, a Bloom filter
+ *              (the doorkeeper) remembers the first time
+ *   tinylfu    cache a packet if its name was requested more often than
+ *              the name of the entry it evicts. The requests are counted
+ *              in a count-min sketch behind a doorkeeper, all counts are
+ *              halved every 10 requests per cache entry.
+ *
+ * A policy set with ccnl_set_cache_strategy_cache() takes precedence.
+ */
+
+#ifndef CCNL_ADMIT_H
+#define CCNL_ADMIT_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+struct ccnl_relay_s;
+struct ccnl_content_s;
+
+enum {
+    CCNL_ADMIT_ALL,
+    CCNL_ADMIT_PROB,
+    CCNL_ADMIT_SECOND,
+    CCNL_ADMIT_TINYLFU,
+};
+
+#define CCNL_ADMIT_ROWS         4       // of the count-min sketch
+#define CCNL_ADMIT_MAXCOUNT     15
+#define CCNL_ADMIT_WINDOW       10      // requests per cache entry to ageing
+#define CCNL_ADMIT_DOORBITS     16      // doorkeeper bits per cache entry
+#define CCNL_ADMIT_HASHES       3       // doorkeeper bits per name
+
+struct ccnl_admit_s {
+    int policy;
+    double prob;
+    uint8_t *sketch;            // CCNL_ADMIT_ROWS rows of width counters
+    uint32_t width;             // a power of two
+    uint64_t *door;             // the doorkeeper
+    uint32_t doorbits;          // a power of two
+    uint32_t window, seen;      // names between ageings, since the last
+    uint64_t admitted, rejected;
+};
+
+/**
+ * @brief Selects the admission policy of @p relay, sized for its
+ * max_cache_entries
+ *
+ * @param spec  all, prob:P, second or tinylfu
+ *
+ * @return 0 on success, -1 for an unknown policy or out of memory (the
+ *         policy is not changed then)
+ */
+int
+ccnl_admit_set(struct ccnl_relay_s *relay, const char *spec);
+
+/**
+ * @brief Writes the policy of @p relay in the form ccnl_admit_set() takes
+ */
+char*
+ccnl_admit_str(struct ccnl_relay_s *relay, char *buf, size_t buflen);
+
+void
+ccnl_admit_free(struct ccnl_relay_s *relay);
+
+/**
+ * @brief Counts a request for the name with ccnl_prefix_hash() @p namehash
+ */
+void
+ccnl_admit_seen(struct ccnl_relay_s *relay, uint64_t namehash);
+
+/**
+ * @brief Whether to cache @p c, see cache_strategy_cache()
+ *
+ * @return 1 to cache, 0 to drop
+ */
+int
+ccnl_admit(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+
+#endif // CCNL_ADMIT_H
@@ -24,12 +24,18 @@
 #include <string.h>
 #endif
 #include <stddef.h>
+#ifdef USE_HISTOGRAMS
+#include <stdint.h>
+#endif
 
 
 struct ccnl_relay_s;
 
 struct ccnl_buf_s {
     struct ccnl_buf_s *next;
+#ifdef USE_HISTOGRAMS
+    uint64_t queued;            // when it was put into a face's outq
+#endif
     size_t datalen;
     unsigned char data[1];
 };
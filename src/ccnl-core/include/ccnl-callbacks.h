@@ -31,6 +31,36 @@ typedef int (*ccnl_cb_on_data)(struct ccnl_relay_s *relay,
                                struct ccnl_face_s *face,
                                struct ccnl_pkt_s *pkt);
 
+/**
+ * @brief Returned by a Content Store miss callback that answers the
+ * Interest later, e.g. after a read from disk. It counts the CS hit or
+ * miss on the face itself once the outcome is known.
+ */
+#define CCNL_CS_MISS_DEFERRED   2
+
+/**
+ * @brief Function pointer callback type for Content Store miss events
+ */
+typedef int (*ccnl_cb_on_cs_miss)(struct ccnl_relay_s *relay,
+                                  struct ccnl_face_s *from,
+                                  struct ccnl_pkt_s **pkt);
+
+/**
+ * @brief Function pointer callback type for Content Store eviction events
+ */
+typedef void (*ccnl_cb_on_cs_evict)(struct ccnl_relay_s *relay,
+                                    struct ccnl_content_s *c);
+
+/**
+ * @brief Function pointer callback type for snapshot requests
+ */
+typedef int (*ccnl_cb_on_snapshot)(struct ccnl_relay_s *relay);
+
+/**
+ * @brief Function pointer callback type for end of receive burst events
+ */
+typedef void (*ccnl_cb_on_rx_burst_end)(struct ccnl_relay_s *relay);
+
 /**
  * @brief Set an inbound on-data event callback function
  *
@@ -51,6 +81,50 @@ void ccnl_set_cb_rx_on_data(ccnl_cb_on_data func);
  */
 void ccnl_set_cb_tx_on_data(ccnl_cb_on_data func);
 
+/**
+ * @brief Set a Content Store miss callback function
+ *
+ * Setting a Content Store miss callback allows to consult a secondary
+ * content store (e.g. a memory mapped segment file) before an Interest which
+ * could not be satisfied from the in-memory Content Store is added to the
+ * PIT and forwarded.
+ *
+ * @param[in] func  The callback function for Content Store miss events
+ */
+void ccnl_set_cb_cs_miss(ccnl_cb_on_cs_miss func);
+
+/**
+ * @brief Set a Content Store eviction callback function
+ *
+ * The callback is invoked for content which is dropped from the Content
+ * Store to make room for new content or because it aged out, right before
+ * it is freed. Explicit removals (e.g. via mgmt) are not reported.
+ *
+ * @param[in] func  The callback function for Content Store eviction events
+ */
+void ccnl_set_cb_cs_evict(ccnl_cb_on_cs_evict func);
+
+/**
+ * @brief Set a snapshot callback function
+ *
+ * The callback is invoked when a snapshot of the relay's state is requested
+ * via mgmt ("debug snapshot"). Writing the snapshot is up to the platform.
+ *
+ * @param[in] func  The callback function for snapshot requests
+ */
+void ccnl_set_cb_snapshot(ccnl_cb_on_snapshot func);
+
+/**
+ * @brief Set an end of receive burst callback function
+ *
+ * The callback is invoked by the platform's receive loop after it has
+ * handled all packets that were ready at once. Stages which hold packets
+ * back to process them in batches flush their batch here.
+ *
+ * @param[in] func  The callback function for end of receive burst events
+ */
+void ccnl_set_cb_rx_burst_end(ccnl_cb_on_rx_burst_end func);
+
 /**
  * @brief Callback for inbound on-data events
  *
@@ -85,4 +159,50 @@ int ccnl_callback_tx_on_data(struct ccnl_relay_s *relay,
                              struct ccnl_face_s *to,
                              struct ccnl_pkt_s *pkt);
 
+/**
+ * @brief Callback for Content Store miss events
+ *
+ * @param[in] relay The active ccn-lite relay
+ * @param[in] from  The face the Interest was received over
+ * @param[in] pkt   The received Interest
+ *
+ * @note if the callback function returns any other value than 0, the
+ *       Interest is considered handled and is neither added to the PIT nor
+ *       forwarded. The callback may take ownership of the Interest by
+ *       setting \p *pkt to NULL. Any value other than
+ *       \ref CCNL_CS_MISS_DEFERRED counts as a CS hit.
+ *
+ * @return return value of the callback function
+ * @return 0, if no function has been set
+ */
+int ccnl_callback_cs_miss(struct ccnl_relay_s *relay,
+                          struct ccnl_face_s *from,
+                          struct ccnl_pkt_s **pkt);
+
+/**
+ * @brief Callback for Content Store eviction events
+ *
+ * @param[in] relay The active ccn-lite relay
+ * @param[in] c     The content about to be evicted
+ */
+void ccnl_callback_cs_evict(struct ccnl_relay_s *relay,
+                            struct ccnl_content_s *c);
+
+/**
+ * @brief Callback for snapshot requests
+ *
+ * @param[in] relay The active ccn-lite relay
+ *
+ * @return return value of the callback function (0 on success)
+ * @return -1, if no function has been set
+ */
+int ccnl_callback_snapshot(struct ccnl_relay_s *relay);
+
+/**
+ * @brief Callback for end of receive burst events
+ *
+ * @param[in] relay The active ccn-lite relay
+ */
+void ccnl_callback_rx_burst_end(struct ccnl_relay_s *relay);
+
 #endif  /* CCNL_CALLBACKS_H */
@@ -66,6 +66,17 @@ typedef struct ccnl_content_s {
     evtimer_msg_event_t evtmsg_cstimeout; /**< event timer message which is triggered when a timeout in the content store occurs */
 #endif
     int served_cnt;                       /**< determines how often the content has been served */
+    uint64_t namehash;                    /**< ccnl_prefix_hash() of the name, set when cached */
+    struct ccnl_content_s *name_next;     /**< next entry in the relay's name index chain */
+    uint64_t staletime;                   /**< ms when the content goes stale, see ccnl_content_expire() */
+    int freshpos;                         /**< position in the relay's expiry queue + 1, 0: not queued */
+    struct ccnl_content_s *stale_next;    /**< next entry in the relay's list of stale content */
+    struct ccnl_content_s *stale_prev;    /**< previous entry in the relay's list of stale content */
+#ifdef USE_CCNxDIGEST
+    struct ccnl_content_s *digest_next;   /**< next entry in the relay's digest index chain */
+    unsigned char digest[32];             /**< implicit digest, valid if has_digest is set */
+    bool has_digest;                      /**< the implicit digest was computed */
+#endif
 } ccnl_content;
 
 /**
@@ -81,6 +92,20 @@ typedef struct ccnl_content_s {
 struct ccnl_content_s*
 ccnl_content_new(struct ccnl_pkt_s **packet);
 
+/**
+ * @brief Returns the implicit digest of a content object
+ *
+ * The SHA256 digest of the packet is computed on first use and kept with
+ * the content object.
+ *
+ * @param[in] content The content object
+ *
+ * @return Upon success, the CCNL_CCNX_DIGEST_LEN bytes of the digest
+ * @return NULL if the digest cannot be computed (e.g. no USE_CCNxDIGEST)
+ */
+unsigned char*
+ccnl_content_digest(struct ccnl_content_s *content);
+
 /**
  * @brief Frees a \p content object.
 
@@ -23,11 +23,13 @@
 #ifndef CCNL_CORE_H
 #define CCNL_CORE_H
 
+#include "ccnl-admit.h"
 #include "ccnl-array.h"
 #include "ccnl-content.h"
 #include "ccnl-defs.h"
 #include "ccnl-face.h"
 #include "ccnl-frag.h"
+#include "ccnl-histo.h"
 #include "ccnl-interest.h"
 #include "ccnl-malloc.h"
 #include "ccnl-os-time.h"
@@ -82,12 +82,21 @@
 #ifndef CCNL_MAX_INTEREST_RETRANSMIT
 # define CCNL_MAX_INTEREST_RETRANSMIT    7
 #endif
+#ifndef CCNL_PENDINT_INLINE
+// pending faces kept inside a PIT entry, more go to the heap
+# define CCNL_PENDINT_INLINE             4
+#endif
 
 #ifndef CCNL_FACE_TIMEOUT
 // # define CCNL_FACE_TIMEOUT    60 // sec
 # define CCNL_FACE_TIMEOUT       30 // sec
 #endif
 
+#ifndef CCNL_PMTU_PROBE_INTERVAL
+// a learned path MTU is given up after this time, as the kernel does
+# define CCNL_PMTU_PROBE_INTERVAL 600 // sec
+#endif
+
 #define CCNL_DEFAULT_MAX_CACHE_ENTRIES  0   // means: no content caching
 #ifdef CCNL_RIOT
 #define CCNL_MAX_NONCES                 -1 // -1 --> detect dups by PIT
@@ -113,6 +122,24 @@ enum {
 
 #define CCNL_SUITE_DEFAULT (CCNL_SUITE_LAST - 1)
 
+// A single-suite build (CMake option CCNL_SINGLE_SUITE) forwards exactly one
+// packet format. CCNL_SUITE_OF() then folds a packet's suite to a constant,
+// so that switches on it reduce to their only case.
+#ifdef CCNL_SINGLE_SUITE
+# if defined(USE_SUITE_CCNB) + defined(USE_SUITE_CCNTLV) + \
+     defined(USE_SUITE_LOCALRPC) + defined(USE_SUITE_NDNTLV) != 1
+#  error "CCNL_SINGLE_SUITE requires exactly one USE_SUITE_* flag"
+# endif
+# if defined(USE_SUITE_NDNTLV)
+#  define CCNL_ONLY_SUITE       CCNL_SUITE_NDNTLV
+# else
+#  error "CCNL_SINGLE_SUITE is only supported for USE_SUITE_NDNTLV"
+# endif
+# define CCNL_SUITE_OF(s)       CCNL_ONLY_SUITE
+#else
+# define CCNL_SUITE_OF(s)       (s)
+#endif
+
 // ----------------------------------------------------------------------
 // our own packet format extension for switching encodings:
 // 0x80 followed by:
@@ -240,8 +267,8 @@ typedef enum ccnl_enc_e {
 
 #define CCNL_FACE_FLAGS_STATIC  1
 #define CCNL_FACE_FLAGS_REFLECT 2
-#define CCNL_FACE_FLAGS_SERVED  4
 #define CCNL_FACE_FLAGS_FWDALLI 8 // forward all interests, also known ones
+#define CCNL_FACE_FLAGS_AUTOFRAG 16 // fragmenting because of the path MTU
 
 #define CCNL_FRAG_NONE          0
 #define CCNL_FRAG_SEQUENCED2012 1
@@ -259,10 +286,12 @@ typedef enum ccnl_enc_e {
 // ----------------------------------------------------------------------
 
 
+#define CCNL_CCNX_DIGEST_LEN    32      // SHA256 implicit digest
+
 #ifdef USE_CCNxDIGEST
-#  define compute_ccnx_digest(buf) SHA256(buf->data, buf->datalen, NULL)
+#  define compute_ccnx_digest(buf, md) SHA256(buf->data, buf->datalen, md)
 #else
-#  define compute_ccnx_digest(b) NULL
+#  define compute_ccnx_digest(b, md) NULL
 #endif
 
 #endif //CCNL_DEFS_H
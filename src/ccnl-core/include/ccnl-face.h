@@ -29,6 +29,35 @@
 #include "evtimer_msg.h"
 #endif
 
+#ifdef USE_STATS
+// why a face dropped a packet
+enum {
+    CCNL_DROP_DUPNONCE,         // interest seen before
+    CCNL_DROP_UNSOLICITED,      // data without a pending interest
+    CCNL_DROP_HOPLIMIT,
+    CCNL_DROP_MALFORMED,        // could not be parsed
+    CCNL_DROP_QUEUE,            // interface queue full
+    CCNL_DROP_SEND,             // the socket did not take it
+    CCNL_DROP_REASONS
+};
+
+// the counters of one face, plain fields: only the relay's thread changes
+// them, and the status server reads them on the same thread
+struct ccnl_face_stats_s {
+    uint64_t interests_in, interests_out;
+    uint64_t data_in, data_out;
+    uint64_t nacks_in;
+    uint64_t bytes_in, bytes_out;
+    uint64_t cs_hits, cs_misses;
+    uint64_t pit_aggregated;    // interests added to an existing PIT entry
+    uint64_t drops[CCNL_DROP_REASONS];
+};
+
+# define CCNL_FACE_COUNT(F, FIELD, N)   do { if (F) (F)->stats.FIELD += (N); } while (0)
+#else
+# define CCNL_FACE_COUNT(F, FIELD, N)   do {} while (0)
+#endif
+
 struct ccnl_face_s {
     struct ccnl_face_s *next, *prev;
     int faceid;
@@ -38,7 +67,13 @@ struct ccnl_face_s {
     uint32_t last_used; // updated when we receive a packet
     struct ccnl_buf_s *outq, *outqend; // queue of packets to send
     struct ccnl_frag_s *frag;  // which special datagram armoring
+    int mtu;                   // path MTU to the peer, 0 if not learned
+    uint32_t mtu_learned;      // when the path MTU was last lowered
     struct ccnl_sched_s *sched;
+    uint32_t served;           // servegen of the relay when data was last sent
+#ifdef USE_STATS
+    struct ccnl_face_stats_s stats;
+#endif
 #ifdef CCNL_RIOT
     evtimer_msg_event_t evtmsg_timeout;
 #endif
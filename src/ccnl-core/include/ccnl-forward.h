@@ -37,6 +37,9 @@ struct ccnl_forward_s {
     tapCallback tap;
     struct ccnl_face_s *face;
     char suite;
+#ifdef USE_STATS
+    uint64_t interests, bytes; // interests sent because of this entry
+#endif
 };
 
 #endif //CCNL_FORWARD_H
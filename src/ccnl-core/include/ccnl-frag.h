@@ -28,12 +28,28 @@
 #include "ccnl-relay.h"
 
 // returns >=0 if content consumed, buf and len pointers updated
-typedef int (RX_datagram)(struct ccnl_relay_s*, struct ccnl_face_s*,
-                          unsigned char**, int*);
+typedef int8_t (RX_datagram)(struct ccnl_relay_s*, struct ccnl_face_s*,
+                             uint8_t**, size_t*);
+
+#ifndef CCNL_FRAG_WINDOW
+# define CCNL_FRAG_WINDOW        8  // fragments held for reordering, power of two
+#endif
+#define CCNL_FRAG_SEQMASK        0x3fff // BeginEnd2015 sequence numbers
+#define CCNL_FRAG_MAXHDR         16 // longest BeginEnd2015 fragment header
+#define CCNL_FRAG_BATCH          16 // fragments handed to the driver at once
+
+// one outgoing fragment: its header and the slice of the packet it carries
+struct ccnl_frag_iov_s {
+    uint8_t hdr[CCNL_FRAG_MAXHDR];
+    size_t hdrlen;
+    uint8_t *data;             // points into the packet being fragmented
+    size_t datalen;
+};
 
  struct ccnl_frag_s {
     int protocol; // fragmentation protocol, 0=none
     int mtu;
+    int cfgmtu;   // the mtu it was set up with, before any path MTU was learned
     sockunion dest;
     struct ccnl_buf_s *bigpkt; // outgoing bytes
     unsigned int sendoffs;
@@ -42,7 +58,10 @@ typedef int (RX_datagram)(struct ccnl_relay_s*, struct ccnl_face_s*,
     int ifndx;
 
     // int insuite; // suite of incoming packet series
-    struct ccnl_buf_s *defrag; // incoming bytes
+    struct ccnl_buf_s *defrag, *defragend; // fragments of the series, in order
+    size_t defraglen;
+    struct ccnl_buf_s *rxwin[CCNL_FRAG_WINDOW]; // received ahead of recvseq
+    unsigned char rxwinbits[CCNL_FRAG_WINDOW];
 
     unsigned int sendseq;
     unsigned int losscount;
@@ -87,6 +106,22 @@ ccnl_frag_getnextBE2015(struct ccnl_frag_s *fr, int *ifndx, sockunion *su);
 struct ccnl_buf_s*
 ccnl_frag_getnext(struct ccnl_frag_s *fr, int *ifndx, sockunion *su);
 
+// BeginEnd2015 flags and sequence number of the next fragment, which
+// carries datalen bytes
+uint16_t
+ccnl_frag_fields(struct ccnl_frag_s *fr, size_t datalen);
+
+/**
+ * @brief Produces up to \p max fragments of the current packet as header
+ *        plus a pointer into the packet, for drivers that gather them
+ *
+ * The packet stays referenced by \p fr until the next ccnl_frag_reset().
+ *
+ * @return the number of fragments written to \p iov, 0 once all are sent
+ */
+int
+ccnl_frag_getiov(struct ccnl_frag_s *fr, struct ccnl_frag_iov_s *iov, int max);
+
 int
 ccnl_frag_nomorefragments(struct ccnl_frag_s *e);
 
@@ -136,11 +171,19 @@ ccnl_frag_RX_Sequenced2015(RX_datagram callback, struct ccnl_relay_s *relay,
 
 #endif // OBSOLTE_BY_2015_06
 
+/**
+ * @brief Processes a BeginEnd2015 fragment, calls \p callback once a packet
+ *        is complete
+ *
+ * Fragments are kept as a list and copied once, when the last one arrives.
+ * Up to CCNL_FRAG_WINDOW fragments ahead of the expected sequence number
+ * are held back, so that limited reordering does not lose the series.
+ */
 int
 ccnl_frag_RX_BeginEnd2015(RX_datagram callback, struct ccnl_relay_s *relay,
                           struct ccnl_face_s *from, int mtu,
                           unsigned int bits, unsigned int seqno,
-                          unsigned char **data, int *datalen);
+                          uint8_t **data, size_t *datalen);
 
 struct ccnl_buf_s*
 ccnl_frag_getnext(struct ccnl_frag_s *fr, int *ifndx, sockunion *su);
@@ -0,0 +1,129 @@
+/*
+ * @f ccnl-histo.h
+ * @b CCN lite, latency histograms of the forwarding stages
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * The time a packet spends in each stage of the relay, in nanoseconds, is
+ * counted in log-linear buckets: each power of two is split into
+ * 2^CCNL_HISTO_SUBBITS buckets, so a quantile is off by at most 1/8.
+ * Nothing is recorded until ccnl_histo_on is set.
+ *
+ * A stage does not include the time spent sending packets, which is
+ * counted in the two queue stages.
+ */
+
+#ifndef CCNL_HISTO_H
+#define CCNL_HISTO_H
+
+#ifdef USE_HISTOGRAMS
+
+#ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+struct ccnl_relay_s;
+struct ccnl_interest_s;
+
+#define CCNL_HISTO_SUBBITS      3
+#define CCNL_HISTO_MAXBITS      40      // about 18 minutes
+#define CCNL_HISTO_BUCKETS      ((CCNL_HISTO_MAXBITS - CCNL_HISTO_SUBBITS + 1) \
+                                 << CCNL_HISTO_SUBBITS)
+#define CCNL_HISTO_PREFIXES     64      // FIB prefixes with their own histogram
+
+enum {
+    CCNL_HISTO_PARSE,           // packet to ccnl_pkt_s, or the fast path scan
+    CCNL_HISTO_CS,              // content store lookup
+    CCNL_HISTO_PIT,             // PIT lookup and insert
+    CCNL_HISTO_FIB,             // FIB lookup in ccnl_interest_propagate()
+    CCNL_HISTO_SERVE,           // ccnl_content_serve_pending()
+    CCNL_HISTO_FACEQ,           // waiting in the outq of a face
+    CCNL_HISTO_IFQ,             // waiting in the queue of an interface
+    CCNL_HISTO_STAGES
+};
+
+struct ccnl_histo_s {
+    uint64_t count, sum, max;
+    uint32_t buckets[CCNL_HISTO_BUCKETS];
+};
+
+extern int ccnl_histo_on;
+extern struct ccnl_histo_s ccnl_histo_stage[CCNL_HISTO_STAGES];
+extern const char *ccnl_histo_stagename[CCNL_HISTO_STAGES];
+
+/**
+ * @brief The time in nanoseconds, from CLOCK_MONOTONIC
+ */
+uint64_t
+ccnl_histo_now(void);
+
+void
+ccnl_histo_add(struct ccnl_histo_s *h, uint64_t ns);
+
+/**
+ * @brief The value below which the fraction @p q of the recorded values is,
+ * rounded up to the end of its bucket
+ */
+uint64_t
+ccnl_histo_quantile(const struct ccnl_histo_s *h, double q);
+
+/**
+ * @brief Records the time from the creation of @p i until now in the
+ * histogram of the longest FIB prefix that matches the name of @p i
+ */
+void
+ccnl_histo_satisfied(struct ccnl_relay_s *relay, struct ccnl_interest_s *i);
+
+/**
+ * @brief The histogram of the n-th FIB prefix that was seen, NULL when there
+ * are no more
+ *
+ * @param name  set to the prefix, as a string
+ */
+struct ccnl_histo_s*
+ccnl_histo_prefix(int n, const char **name);
+
+/**
+ * @brief Writes all histograms to the log, with their quantiles
+ */
+void
+ccnl_histo_dump(void);
+
+// T is started only if the histograms are on
+# define CCNL_HISTO_START(T)     uint64_t T = ccnl_histo_on ? ccnl_histo_now() : 0
+# define CCNL_HISTO_STOP(S, T)   do { if (T) ccnl_histo_add(ccnl_histo_stage + (S), \
+                                         ccnl_histo_now() - (T)); } while (0)
+// the time spent in STMT is not counted in T
+# define CCNL_HISTO_SKIP(T, STMT) do {                                  \
+        uint64_t skip_ = (T) ? ccnl_histo_now() : 0;                    \
+        STMT;                                                           \
+        if (T) { (T) += ccnl_histo_now() - skip_; }                     \
+    } while (0)
+
+#else // !USE_HISTOGRAMS
+
+# define CCNL_HISTO_START(T)      do {} while (0)
+# define CCNL_HISTO_STOP(S, T)    do {} while (0)
+# define CCNL_HISTO_SKIP(T, STMT) do { STMT; } while (0)
+
+#endif // USE_HISTOGRAMS
+
+#endif // CCNL_HISTO_H
@@ -25,18 +25,50 @@
 #include "ccnl-sockunion.h"
 #include <time.h>
 
+#define CCNL_HTTP_CLIENTS       4       // connections served at the same time
+#define CCNL_HTTP_OUTSIZE       16384   // bytes written per loop iteration
+#define CCNL_HTTP_ROWS          64      // table rows written per loop iteration
+#define CCNL_HTTP_SKIPS         4096    // table rows skipped per loop iteration
+#define CCNL_HTTP_PAGE          100     // table rows per page, if not asked for
+#define CCNL_HTTP_MAXPAGE       10000
+#define CCNL_HTTP_IDLE          10      // seconds a connection may stall
+
+/**
+ * A response is written a few rows at a time, see ccnl_http_produce(): the
+ * parts of the page are worked off one after the other, and a table is
+ * walked with a pointer to its next row. When that row is removed from the
+ * relay, ccnl_http_unlinked() moves the pointer on.
+ */
+struct ccnl_http_conn_s {
+    int client;                         // socket, 0 if not used
+    unsigned char in[1024];             // the request
+    int inlen;
+    unsigned char *out;                 // what is left to send
+    int outoffs, outlen;
+    double last;                        // CCNL_NOW() when last active
+    int keepalive, chunked;
+    int busy;                           // a response is being written
+    int hdrsent;
+
+    int parts[8], npart, part;          // what the page is made of
+    int json;
+    int tablestate;                     // 0: table head, 1: rows
+    void *row;                          // the next row of the table
+    int rowno, skip, left;
+    int start, limit;
+    char *metrics;                      // the /metrics response
+    char obuf[CCNL_HTTP_OUTSIZE];
+};
+
 struct ccnl_http_s {
-    int server, client; // socket
-    unsigned char in[512], *out; // ring buffers
-    int inoffs, outoffs, inlen, outlen;
+    int server; // socket
+    struct ccnl_http_conn_s conn[CCNL_HTTP_CLIENTS];
 };
 
 
 struct ccnl_http_s*
 ccnl_http_new(struct ccnl_relay_s *ccnl, int serverport);
 
-int ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http);
-
 struct ccnl_http_s*
 ccnl_http_cleanup(struct ccnl_http_s *http);
 
@@ -48,14 +80,46 @@ int
 ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
                      fd_set *readfs, fd_set *writefs);
 
+/**
+ * @brief Starts the response to the request in c->in, if it is complete
+ *
+ * Pages:
+ *   /                          status page
+ *   /html/TABLE?start=N&limit=M one table (fib, faces, ifs, pit, cs)
+ *   /json/TABLE?start=N&limit=M the same as JSON
+ *   /metrics                   counters in the Prometheus text format
+ *
+ * @return 0 if a response was started, -1 if the request is not complete
+ */
 int
-ccnl_cmpfaceid(const void *a, const void *b);
+ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_conn_s *c);
 
-int
-ccnl_cmpfib(const void *a, const void *b);
+/**
+ * @brief Writes the next part of the response into c->out
+ *
+ * At most CCNL_HTTP_ROWS rows are written, so a large table does not hold
+ * up forwarding. c->busy is cleared when the response is complete.
+ */
+void
+ccnl_http_produce(struct ccnl_relay_s *ccnl, struct ccnl_http_conn_s *c);
 
-int
-ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http);
+/**
+ * @brief Called when a face, FIB, PIT or CS entry is removed from its list,
+ * with the entry that follows it
+ */
+void
+ccnl_http_unlinked(struct ccnl_relay_s *ccnl, void *entry, void *next);
+
+#ifdef USE_STATS
+/**
+ * @brief Writes the face, FIB and interface counters in the Prometheus
+ * text format to buf
+ *
+ * @return the number of bytes written
+ */
+size_t
+ccnl_http_metrics(struct ccnl_relay_s *ccnl, char *buf, size_t buflen);
+#endif
 
 #endif //USE_HTTP_STATUS
 
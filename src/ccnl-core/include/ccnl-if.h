@@ -32,11 +32,16 @@
 
 
 
+struct ccnl_ethring_s;
+
 struct ccnl_txrequest_s {
     struct ccnl_buf_s *buf;
     sockunion dst;
     void (*txdone)(void*, int, int);
     struct ccnl_face_s* txdone_face;
+#ifdef USE_HISTOGRAMS
+    uint64_t queued;
+#endif
 };
 
 struct ccnl_if_s { // interface for packet IO
@@ -56,8 +61,10 @@ struct ccnl_if_s { // interface for packet IO
     uint16_t addr_len;
 #else
     int sock;
+    struct ccnl_ethring_s *ring; // PACKET_MMAP rings, NULL: socket calls
 #endif
     int reflect; // whether to reflect I packets on this interface
+    int stream; // sock listens, each connection is one face (ccnl-stream.h)
     int fwdalli; // whether to forward all I packets rcvd on this interface
     uint32_t mtu;
 
@@ -33,12 +33,13 @@
 #endif
 
 /**
- * @brief A pending interest linked list element
+ * @brief A face waiting for the content of an interest
  */
 struct ccnl_pendint_s { 
-    struct ccnl_pendint_s *next; /**< pointer to the next list element */
     struct ccnl_face_s *face;    /**< pointer to incoming face  */
-    uint32_t last_used;          /** */
+    uint32_t last_used;          /**< when the face last sent the interest */
+    uint32_t expires;            /**< when the record times out */
+    int32_t nonce;               /**< nonce of the face's last interest, 0 if none */
 };
 
 /**
@@ -49,10 +50,18 @@ struct ccnl_interest_s {
     struct ccnl_interest_s *prev;       /**< pointer to the previous list element */
     struct ccnl_pkt_s *pkt;             /**< the packet the interests originates from (?) */
     struct ccnl_face_s *from;           /**< the face the interest was received from */
-    struct ccnl_pendint_s *pending;     /**< linked list of faces wanting that content */
+    struct ccnl_pendint_s *pending;     /**< faces wanting that content, pendinline or on the heap */
+    int pendcnt;                        /**< number of entries in pending */
+    int pendsize;                       /**< number of slots in pending, 0 before the first one */
     uint32_t lifetime;                  /**< interest lifetime */
     uint32_t last_used;                 /**< last time the entry was used */
     int retries;                        /**< current number of executed retransmits. */
+    uint64_t namehash;                  /**< ccnl_prefix_hash() of the name */
+    struct ccnl_interest_s *name_next;  /**< next entry in the relay's name index chain */
+#ifdef USE_HISTOGRAMS
+    uint64_t created;                   /**< ccnl_histo_now() at creation, 0 if not recording */
+#endif
+    struct ccnl_pendint_s pendinline[CCNL_PENDINT_INLINE]; /**< room for a small fan-in */
 #ifdef CCNL_RIOT
     evtimer_msg_event_t evtmsg_retrans; /**< retransmission timer */
     evtimer_msg_event_t evtmsg_timeout; /**< timeout timer for (?) */
@@ -88,18 +97,22 @@ int
 ccnl_interest_isSame(struct ccnl_interest_s *i, struct ccnl_pkt_s *pkt);
 
 /**
- * Adds a pending interest
+ * Adds a pending interest, or refreshes the record if the face is
+ * already listed. The record expires with the face's own interest,
+ * the entry is kept at least as long.
  * 
  * @param[in] i
  * @param[in] face
+ * @param[in] nonce  nonce of the face's interest, 0 if none
+ * @param[in] lifetime  lifetime of the face's interest, in seconds
  *
  * @return 0
- * @return 1
- * @return -1 if \ref i was NULL
+ * @return -1 if \ref i was NULL or out of memory
  * @return -2 if \ref face was NULL
  */
 int
-ccnl_interest_append_pending(struct ccnl_interest_s *i, struct ccnl_face_s *from);
+ccnl_interest_append_pending(struct ccnl_interest_s *i, struct ccnl_face_s *from,
+                             int32_t nonce, uint32_t lifetime);
 
 /**
  * Removes a pending interest 
@@ -115,4 +128,12 @@ ccnl_interest_append_pending(struct ccnl_interest_s *i, struct ccnl_face_s *from
 int
 ccnl_interest_remove_pending(struct ccnl_interest_s *i, struct ccnl_face_s *face);
 
+/**
+ * Drops the pending records that timed out before @p now
+ *
+ * @return number of records dropped
+ */
+int
+ccnl_interest_expire_pending(struct ccnl_interest_s *i, uint32_t now);
+
 #endif //CCNL_INTEREST_H
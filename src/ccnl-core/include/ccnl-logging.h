@@ -51,6 +51,29 @@ extern int debug_level;
 char
 ccnl_debugLevelToChar(int level);
 
+// messages above this level are not compiled in, e.g. -DCCNL_LOG_LEVEL_MIN=INFO
+#ifndef CCNL_LOG_LEVEL_MIN
+# define CCNL_LOG_LEVEL_MIN     TRACE
+#endif
+
+// the modules whose level can be set apart from debug_level
+enum {
+    CCNL_LOG_CORE,
+    CCNL_LOG_CFWD,
+    CCNL_LOG_CUTL,
+    CCNL_LOG_EFRA,
+    CCNL_LOG_PCNX,
+    CCNL_LOG_PIOT,
+    CCNL_LOG_PNDN,
+    CCNL_LOG_MODULES
+};
+
+// the level of each module, -1 if it follows debug_level
+extern int ccnl_log_modlevel[CCNL_LOG_MODULES];
+
+#define ccnl_log_level(M)       (ccnl_log_modlevel[M] >= 0 ? \
+                                 ccnl_log_modlevel[M] : debug_level)
+
 // ----------------------------------------------------------------------
 // _TRACE macro
 
@@ -85,7 +108,7 @@ ccnl_debugLevelToChar(int level);
 #else
 
 #define _TRACE(F,P) do {                                    \
-    if (debug_level >= TRACE) {                             \
+    if (TRACE <= CCNL_LOG_LEVEL_MIN && debug_level >= TRACE) { \
         fprintf(stderr, "[%c] %s: %s() in %s:%d\n",         \
                 (P), timestamp(), (F), __FILE__, __LINE__); \
     }} while (0)
@@ -95,6 +118,17 @@ ccnl_debugLevelToChar(int level);
 int
 ccnl_debug_str2level(char *s);
 
+/**
+ * @brief Sets the log levels from a list like "info,cfwd=debug,pndn=trace"
+ *
+ * A bare level sets debug_level, MODULE=LEVEL the level of one module (core,
+ * cfwd, cutl, efra, pcnx, piot, pndn).
+ *
+ * @return 0 on success, -1 if the list has an unknown module or level
+ */
+int
+ccnl_debug_setlevels(char *spec);
+
 #endif // CCNL_ARDUINO
 
 #define DEBUGSTMT(LVL, ...) do { \
@@ -143,12 +177,32 @@ ccnl_debug_str2level(char *s);
 
 #else
 #ifndef CCNL_RIOT
+#include <stdarg.h>
+
+/**
+ * @brief The function that writes the log messages instead of stderr
+ *
+ * It gets the level and the message before formatting, see ccnl-logring.h.
+ */
+typedef void (*ccnl_log_sink_func)(int level, const char *fmt, va_list ap);
+
+void
+ccnl_log_set_sink(ccnl_log_sink_func sink);
+
+void
+ccnl_log_printf(int level, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+// the arguments are only evaluated if the message is written
 #  define DEBUGMSG(LVL, ...) do {                   \
-        if ((LVL)>debug_level) break;               \
-        fprintf(stderr, "[%c] %s: ",                \
-            ccnl_debugLevelToChar(LVL),             \
-            timestamp());                           \
-        fprintf(stderr, __VA_ARGS__);               \
+        if ((LVL) > CCNL_LOG_LEVEL_MIN ||           \
+            (LVL) > debug_level) break;             \
+        ccnl_log_printf((LVL), __VA_ARGS__);        \
+    } while (0)
+#  define DEBUGMSG_MOD(M, LVL, ...) do {            \
+        if ((LVL) > CCNL_LOG_LEVEL_MIN ||           \
+            (LVL) > ccnl_log_level(M)) break;       \
+        ccnl_log_printf((LVL), __VA_ARGS__);        \
     } while (0)
 #endif
 #endif
@@ -189,7 +243,16 @@ debug_memdump(void);
 
 
 // only in the Arduino case we wish to control debugging on a module basis
-#ifndef CCNL_ARDUINO
+// at compile time, on Unix the modules have their own levels at runtime
+#ifdef DEBUGMSG_MOD
+# define DEBUGMSG_CORE(...) DEBUGMSG_MOD(CCNL_LOG_CORE, __VA_ARGS__)
+# define DEBUGMSG_CFWD(...) DEBUGMSG_MOD(CCNL_LOG_CFWD, __VA_ARGS__)
+# define DEBUGMSG_CUTL(...) DEBUGMSG_MOD(CCNL_LOG_CUTL, __VA_ARGS__)
+# define DEBUGMSG_EFRA(...) DEBUGMSG_MOD(CCNL_LOG_EFRA, __VA_ARGS__)
+# define DEBUGMSG_PCNX(...) DEBUGMSG_MOD(CCNL_LOG_PCNX, __VA_ARGS__)
+# define DEBUGMSG_PIOT(...) DEBUGMSG_MOD(CCNL_LOG_PIOT, __VA_ARGS__)
+# define DEBUGMSG_PNDN(...) DEBUGMSG_MOD(CCNL_LOG_PNDN, __VA_ARGS__)
+#elif !defined(CCNL_ARDUINO)
 // core source files
 # define DEBUGMSG_CORE(...) DEBUGMSG(__VA_ARGS__)
 # define DEBUGMSG_CFWD(...) DEBUGMSG(__VA_ARGS__)
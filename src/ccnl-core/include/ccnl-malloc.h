@@ -32,6 +32,7 @@
 #ifdef USE_DEBUG_MALLOC
 struct mhdr {
     struct mhdr *next;
+    struct mhdr **pprev; // the pointer to this block, for unlinking in O(1)
     char *fname;
     int lineno;
     size_t size;
@@ -0,0 +1,146 @@
+/*
+ * @f ccnl-mgmt-bin.h
+ * @b CCN lite, binary management protocol
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * A request is an NDN interest for /ccnx/<node>/bin/<ops>. Its last name
+ * component is a CCNL_MGMT_BIN_REQID TLV followed by any number of
+ * operation TLVs, all in the NDN-TLV encoding:
+ *
+ *   PREFIXREG, PREFIXUNREG   PREFIX (URI), FACEID, [SUITE]
+ *   ADDCACHE                 PACKET (a data packet of any suite)
+ *   DUMP                     TABLE, [START]
+ *   FIBSTAGE                 PREFIX (URI), FACEID, [SUITE]
+ *   FIBSTAGERM               PREFIX (URI), [SUITE]
+ *   FIBCOMMIT, FIBMERGE      (none)
+ *   FIBABORT                 (none)
+ *   ADMISSION                [POLICY]
+ *
+ * The reply is a data packet for /ccnx/bin whose content holds the REQID
+ * of the request, a STATUS blob with one byte per operation, and for a
+ * DUMP the rows of the table that fit into one packet. When more rows
+ * are left, NEXT gives the START of the next request. A FIBCOMMIT or
+ * FIBMERGE adds the COUNT of entries in the new FIB, an ADMISSION the
+ * POLICY of the content store after it, see ccnl_admit_set().
+ *
+ * FIBSTAGE entries build a new FIB over as many requests as needed, which
+ * FIBCOMMIT swaps in at once. FIBMERGE instead applies only the staged
+ * changes, with FIBSTAGERM staging a removal, see ccnl_fib_commit().
+ */
+
+#ifndef CCNL_MGMT_BIN_H
+#define CCNL_MGMT_BIN_H
+
+#if defined(USE_MGMT) && defined(USE_SUITE_NDNTLV)
+
+#ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#include "ccnl-defs.h"
+
+struct ccnl_relay_s;
+struct ccnl_buf_s;
+struct ccnl_prefix_s;
+struct ccnl_face_s;
+
+#define CCNL_MGMT_BIN_CMD       "bin"
+#define CCNL_MGMT_BIN_MAXREQ    (CCNL_MAX_PACKET_SIZE - 256)  // bytes of ops
+#define CCNL_MGMT_BIN_MAXREPLY  (CCNL_MAX_PACKET_SIZE - 256)
+
+// TLV types, from the application range of NDN-TLV
+enum {
+    CCNL_MGMT_BIN_REQID         = 0x80,
+    CCNL_MGMT_BIN_PREFIXREG     = 0x81,
+    CCNL_MGMT_BIN_PREFIXUNREG   = 0x82,
+    CCNL_MGMT_BIN_ADDCACHE      = 0x83,
+    CCNL_MGMT_BIN_DUMP          = 0x84,
+    CCNL_MGMT_BIN_FIBSTAGE      = 0x85,
+    CCNL_MGMT_BIN_FIBCOMMIT     = 0x86,
+    CCNL_MGMT_BIN_FIBABORT      = 0x87,
+    CCNL_MGMT_BIN_FIBSTAGERM    = 0x88,
+    CCNL_MGMT_BIN_FIBMERGE      = 0x89,
+    CCNL_MGMT_BIN_ADMISSION     = 0x8a,
+
+    CCNL_MGMT_BIN_PREFIX        = 0x90,
+    CCNL_MGMT_BIN_FACEID        = 0x91,
+    CCNL_MGMT_BIN_SUITE         = 0x92,
+    CCNL_MGMT_BIN_PACKET        = 0x93,
+    CCNL_MGMT_BIN_TABLE         = 0x94,
+    CCNL_MGMT_BIN_START         = 0x95,
+    CCNL_MGMT_BIN_IFNDX         = 0x96,
+    CCNL_MGMT_BIN_PEER          = 0x97,
+    CCNL_MGMT_BIN_FLAGS         = 0x98,
+    CCNL_MGMT_BIN_COUNT         = 0x99,
+    CCNL_MGMT_BIN_POLICY        = 0x9a,
+
+    CCNL_MGMT_BIN_STATUS        = 0xa0,
+    CCNL_MGMT_BIN_ROW           = 0xa1,
+    CCNL_MGMT_BIN_NEXT          = 0xa2,
+};
+
+// the tables of a DUMP
+enum {
+    CCNL_MGMT_BIN_FIB,          // PREFIX FACEID SUITE
+    CCNL_MGMT_BIN_FACES,        // FACEID IFNDX PEER FLAGS
+    CCNL_MGMT_BIN_IFS,          // IFNDX PEER COUNT (queue length)
+    CCNL_MGMT_BIN_PIT,          // PREFIX FACEID COUNT (pending faces)
+    CCNL_MGMT_BIN_CS,           // PREFIX COUNT (times served) FLAGS
+    CCNL_MGMT_BIN_TABLES
+};
+
+// the status of an operation
+enum {
+    CCNL_MGMT_BIN_OK,
+    CCNL_MGMT_BIN_EINVAL,       // malformed operation
+    CCNL_MGMT_BIN_ENOFACE,      // no face with this id
+    CCNL_MGMT_BIN_ENOENT,       // no such FIB entry
+    CCNL_MGMT_BIN_EFAIL,        // out of memory, or the cache refused it
+    CCNL_MGMT_BIN_EUNKNOWN,     // unknown operation
+};
+
+/**
+ * @brief Appends a type and length to the TLV at *buf
+ *
+ * @return 0 on success, -1 if it does not fit before end
+ */
+int
+ccnl_mgmt_bin_putTL(uint8_t **buf, uint8_t *end, uint64_t type, uint64_t len);
+
+int
+ccnl_mgmt_bin_putBlob(uint8_t **buf, uint8_t *end, uint64_t type,
+                      const void *blob, size_t len);
+
+int
+ccnl_mgmt_bin_putInt(uint8_t **buf, uint8_t *end, uint64_t type, uint64_t val);
+
+/**
+ * @brief Carries out the operations of a request and sends the reply
+ * to @p from
+ */
+int8_t
+ccnl_mgmt_bin(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
+              struct ccnl_prefix_s *prefix, struct ccnl_face_s *from);
+
+#endif // USE_MGMT && USE_SUITE_NDNTLV
+
+#endif // CCNL_MGMT_BIN_H
@@ -42,6 +42,22 @@ ccnl_str2suite(char *cp);
 int
 ccnl_pkt2suite(uint8_t *data, size_t len, size_t *skip);
 
+/**
+ * Tells where a packet ends that arrives on a stream
+ *
+ * Only the TLV suites can be framed: their headers carry the length.
+ *
+ * @param[in] data The bytes received so far, starting with the packet
+ * @param[in] datalen Their number
+ * @param[out] framelen The length of the packet, possibly more than
+ *             datalen; 0 if datalen is too short to tell
+ *
+ * @return 0 on success
+ * @return -1 if the data does not start with a TLV packet
+ */
+int
+ccnl_pkt_framelen(uint8_t *data, size_t datalen, size_t *framelen);
+
 /**
  * Returns the integer representation of a string
  *
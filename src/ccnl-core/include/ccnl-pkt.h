@@ -96,10 +96,17 @@ struct ccnl_pkt_s {
         uint64_t seqno;
     } val;
     union {
+#if !defined(CCNL_SINGLE_SUITE) || defined(USE_SUITE_CCNB)
         struct ccnl_pktdetail_ccnb_s   ccnb;
+#endif
+#if !defined(CCNL_SINGLE_SUITE) || defined(USE_SUITE_CCNTLV)
         struct ccnl_pktdetail_ccntlv_s ccntlv;
+#endif
+#if !defined(CCNL_SINGLE_SUITE) || defined(USE_SUITE_NDNTLV)
         struct ccnl_pktdetail_ndntlv_s ndntlv;
-    } s;                           /**< suite specific packet details */
+#endif
+    } s;                           /**< suite specific packet details (a
+                                        single-suite build keeps its own only) */
 #ifdef USE_HMAC256
     uint8_t *hmacStart;
     size_t hmacLen;
@@ -72,6 +72,39 @@ ccnl_prefix_free(struct ccnl_prefix_s *prefix);
 struct ccnl_prefix_s* 
 ccnl_prefix_dup(struct ccnl_prefix_s *prefix);
 
+/**
+ * @brief Computes a 64 bit hash over the name components of a Prefix
+ *
+ * The hash only depends on the components (including a chunk component, if
+ * present), i.e. an Interest and the Data it asks for yield the same value
+ * when parsed with the same suite. It is meant for name indexes, a hash hit
+ * still has to be confirmed with a name comparison.
+ *
+ * @param[in] prefix       Prefix to hash
+ *
+ * @return The hash value
+*/
+uint64_t
+ccnl_prefix_hash(struct ccnl_prefix_s *prefix);
+
+#define CCNL_PREFIX_HASH_INIT   14695981039346656037ULL // 64 bit FNV-1a
+
+/**
+ * @brief Add one component to a name hash
+ *
+ * Hashing all components of a name, starting from CCNL_PREFIX_HASH_INIT,
+ * gives ccnl_prefix_hash(). This allows to hash a name in place, e.g. while
+ * scanning it on the wire.
+ *
+ * @param[in] h            Hash of the preceding components
+ * @param[in] comp         The component, as stored in the prefix
+ * @param[in] complen      Length of the component
+ *
+ * @return The hash value
+*/
+uint64_t
+ccnl_prefix_hash_comp(uint64_t h, const uint8_t *comp, size_t complen);
+
 /**
  * @brief Add a component to a Prefix
  *
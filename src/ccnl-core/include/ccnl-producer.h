@@ -42,6 +42,31 @@ typedef int (*ccnl_producer_func)(struct ccnl_relay_s *relay,
  */
 void ccnl_set_local_producer(ccnl_producer_func func);
 
+/**
+ * @brief Tells whether a local producer function is set
+ *
+ * @return 1 if a function was set via \ref ccnl_set_local_producer, 0 otherwise
+ */
+int ccnl_local_producer_isset(void);
+
+#ifdef NEEDS_PACKET_CRAFTING
+/**
+ * @brief The largest content a Data packet for a name can carry unfragmented
+ *
+ * The smallest MTU on the way is taken: that of the faces with pending
+ * Interests under the prefix and of the faces it is forwarded to, or of all
+ * faces if there are none. The encoding of the name and of the Data packet,
+ * without a signature, is subtracted.
+ *
+ * @param[in] relay   The active ccn-lite relay
+ * @param[in] prefix  The prefix the content is published under
+ *
+ * @return the chunk size in bytes, < 0 if the prefix cannot be encoded
+ */
+int ccnl_producer_chunksize(struct ccnl_relay_s *relay,
+                            struct ccnl_prefix_s *prefix);
+#endif
+
 /**
  * @brief Allows to generates content on the fly/or react to any kind of interest
  *
@@ -29,6 +29,7 @@
 #include "ccnl-pkt.h"
 #include "ccnl-sched.h"
 
+struct ccnl_frag_iov_s;
 
 struct ccnl_relay_s {
     void (*ccnl_ll_TX_ptr)(struct ccnl_relay_s*, struct ccnl_if_s*,
@@ -39,13 +40,24 @@ struct ccnl_relay_s {
     int id;
     struct ccnl_face_s *faces;  /**< The existing forwarding faces */
     struct ccnl_forward_s *fib; /**< The Forwarding Information Base (FIB) */
+    struct ccnl_forward_s *fibstage; /**< A FIB being built, see ccnl_fib_commit() */
+    struct ccnl_forward_s *fibstagelast; /**< The last entry of fibstage */
+    int fibstagecnt;            /**< number of entries in fibstage */
 
     struct ccnl_interest_s *pit; /**< The Pending Interest Table (PIT) */
-    struct ccnl_content_s *contents; /**< contentsend; */
+    struct ccnl_content_s *contents; /**< The Content Store, newest entry first */
+    struct ccnl_content_s *contentsend; /**< The oldest entry of contents */
+    struct ccnl_content_s **fresh; /**< expiry queue, a heap of fresh content by staletime */
+    int freshcnt;               /**< number of entries in fresh */
+    int freshsize;              /**< number of slots in fresh */
+    struct ccnl_content_s *stale; /**< stale content, in the order it went stale */
+    struct ccnl_content_s *staleend; /**< the last entry of stale */
     struct ccnl_buf_s *nonces;  /**< The nonces that are currently in use */
     int contentcnt;             /**< number of cached items */
     int max_cache_entries;      /**< max number of cached items -1: unlimited */
+    struct ccnl_admit_s *admit; /**< admission policy of the CS, NULL: cache all */
     int pitcnt;                 /**< Number of entries in the PIT */
+    uint32_t servegen;          /**< counts calls of ccnl_content_serve_pending() */
     int max_pit_entries;        /**< max number of pit entries; -1: unlimited */ 
     struct ccnl_if_s ifs[CCNL_MAX_INTERFACES];
     int ifcount;               /**< number of active interfaces */
@@ -58,6 +70,24 @@ struct ccnl_relay_s {
     struct ccnl_http_s *http;  /**< http server for status information*/
 #endif
     void *aux;
+    struct ccnl_content_s **cs_names; /**< CS index by name hash */
+    unsigned int cs_namesize;   /**< number of buckets in the CS name index */
+    struct ccnl_interest_s **pit_names; /**< PIT index by name hash */
+    unsigned int pit_namesize;  /**< number of buckets in the PIT name index */
+#ifdef USE_CCNxDIGEST
+    struct ccnl_content_s **digests; /**< CS index by implicit digest, built on first lookup */
+    unsigned int digestsize;    /**< number of buckets in the digest index */
+#endif
+#ifdef USE_FRAG
+    int (*ccnl_ll_TXv_ptr)(struct ccnl_relay_s*, struct ccnl_if_s*,
+        sockunion*, struct ccnl_frag_iov_s*, int); /**< sends a batch of fragments, returns how many went out, optional */
+#endif
+#ifdef USE_STREAM
+    struct ccnl_face_s* (*ccnl_stream_connect_ptr)(struct ccnl_relay_s*,
+        sockunion*); /**< opens a face over a new stream connection, optional */
+    void (*ccnl_stream_close_ptr)(struct ccnl_relay_s*,
+        struct ccnl_face_s*); /**< closes the connection of a removed face */
+#endif
   /*
     struct ccnl_face_s *crypto_face;
     struct ccnl_pendcrypt_s *pendcrypt;
@@ -128,6 +158,37 @@ int
 ccnl_face_enqueue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
                  struct ccnl_buf_s *buf);
 
+/**
+ * @brief The largest packet that can be sent to a face without fragmenting
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+ * @param[in] f     the face
+ *
+ * @return   the learned path MTU, or else the MTU of the face's interface
+ * @return   0 if neither is known
+*/
+int
+ccnl_face_getmtu(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f);
+
+/**
+ * @brief Records the path MTU of a face, reported when a packet was refused
+ *
+ * Fragmentation (BeginEnd2015) is switched on for a face that had none; it
+ * is switched off again once the path MTU is probed after
+ * CCNL_PMTU_PROBE_INTERVAL.
+ *
+ * @param[in] ccnl     pointer to current ccnl relay
+ * @param[in] f        face whose path turned out narrower
+ * @param[in] mtu      the path MTU, without the headers of the transport
+ * @param[in] refused  the packet that was too large, may be NULL
+ *
+ * @return   0 if the refused packet was queued again, in fragments
+ * @return   < 0 if the caller has to deal with it
+*/
+int
+ccnl_face_setmtu(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f, int mtu,
+                 struct ccnl_buf_s *refused);
+
 
 struct ccnl_interest_s*
 ccnl_interest_remove(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i);
@@ -159,6 +220,133 @@ ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
 struct ccnl_content_s*
 ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
 
+/**
+ * @brief Looks up content by its implicit digest
+ *
+ * The content store is indexed by digest from the first lookup on, which
+ * computes the digests of all cached content once.
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+ * @param[in] md    the CCNL_CCNX_DIGEST_LEN bytes of the digest
+ *
+ * @return   the cached content with this digest
+ * @return   NULL, if there is none (or without USE_CCNxDIGEST)
+*/
+struct ccnl_content_s*
+ccnl_content_lookup_digest(struct ccnl_relay_s *ccnl, const unsigned char *md);
+
+/**
+ * @brief Looks up the content a name with implicit digest stands for
+ *
+ * The last component of \p pfx is taken as a digest if it has the form of
+ * one in the suite of \p pfx: 32 bytes, in CCNx behind the TL of a name
+ * segment.
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+ * @param[in] pfx   the name with the digest
+ *
+ * @return   the cached content with this digest and the name before it
+ * @return   NULL, if there is none (or without USE_CCNxDIGEST)
+*/
+struct ccnl_content_s*
+ccnl_content_lookup_fullname(struct ccnl_relay_s *ccnl, struct ccnl_prefix_s *pfx);
+
+/**
+ * @brief The entry ccnl_content_add2cache() evicts from a full CS: the
+ * first to go stale, or else the oldest one that is not static
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+ *
+ * @return   NULL, if all entries are static
+*/
+struct ccnl_content_s*
+ccnl_content_victim(struct ccnl_relay_s *ccnl);
+
+/**
+ * @brief Marks the cached content whose freshness period is over as stale
+ *
+ * Fresh NDN content waits in an expiry queue ordered by staletime, this
+ * takes the expired entries from its front. Stale content is evicted
+ * first and does not match MustBeFresh Interests.
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+*/
+void
+ccnl_content_expire(struct ccnl_relay_s *ccnl);
+
+/**
+ * @brief Makes NDN content @p c go stale at @p staletime, e.g. a copy kept
+ * elsewhere that already used part of its freshness period
+ *
+ * Call again after ccnl_content_add2cache(), which starts a full period.
+ *
+ * @param[in] ccnl       pointer to current ccnl relay
+ * @param[in] c          the content, cached or not
+ * @param[in] staletime  in ms as c->staletime, stale at once if not later than now
+*/
+void
+ccnl_content_set_staletime(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c,
+                           uint64_t staletime);
+
+/**
+ * @brief Marks content @p c as static: it never goes stale and is not evicted
+ *
+ * Takes @p c off the expiry queue and the stale list; static content
+ * satisfies MustBeFresh Interests.
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+ * @param[in] c     the content, cached or about to be cached
+*/
+void
+ccnl_content_set_static(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
+
+/**
+ * @brief Marks cached content @p c as just used: it moves to the front of
+ * the CS and is evicted last. Eviction is FIFO unless entries are touched.
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+ * @param[in] c     pointer to content in the CS
+*/
+void
+ccnl_content_touch(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
+
+/**
+ * @brief Looks up cached content by the hash of its name
+ *
+ * Returns the head of the index chain the hash falls into. The caller walks
+ * the chain via name_next and compares namehash and the name itself, as
+ * different names may share a hash.
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+ * @param[in] hash  ccnl_prefix_hash() of the wanted name
+ *
+ * @return   the first content of the chain, NULL if the chain is empty
+*/
+struct ccnl_content_s*
+ccnl_content_lookup_name(struct ccnl_relay_s *ccnl, uint64_t hash);
+
+/**
+ * @brief Looks up PIT entries by the hash of their name
+ *
+ * Same contract as ccnl_content_lookup_name(), chained via name_next.
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+ * @param[in] hash  ccnl_prefix_hash() of the wanted name
+ *
+ * @return   the first PIT entry of the chain, NULL if the chain is empty
+*/
+struct ccnl_interest_s*
+ccnl_interest_lookup_name(struct ccnl_relay_s *ccnl, uint64_t hash);
+
+/**
+ * @brief Adds a new PIT entry to the name index, see ccnl_interest_new()
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+ * @param[in] i     the PIT entry, already in ccnl->pit
+*/
+void
+ccnl_interest_index(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i);
+
 /**
  * @brief deliver new content @p c to all clients with (loosely) matching interest 
  *
@@ -176,6 +364,20 @@ ccnl_do_ageing(void *ptr, void *dummy);
 int
 ccnl_nonce_find_or_append(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *nonce);
 
+/**
+ * @brief Checks a nonce against the recently seen ones, without a packet
+ *
+ * @param[in] ccnl      pointer to current ccnl relay
+ * @param[in] nonce     the nonce bytes
+ * @param[in] len       number of nonce bytes
+ * @param[in] append    remember the nonce if it was not seen yet
+ *
+ * @return   1 if the nonce was seen before, 0 otherwise
+*/
+int
+ccnl_nonce_seen(struct ccnl_relay_s *ccnl, const uint8_t *nonce, size_t len,
+                int append);
+
 int
 ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt);
 
@@ -210,6 +412,45 @@ ccnl_fib_add_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
 int
 ccnl_fib_rem_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
                    struct ccnl_face_s *face);
+
+/**
+ * @brief Appends an entry to the staged FIB, which ccnl_fib_commit()
+ * applies. Unlike ccnl_fib_add_entry(), this does not search for an
+ * existing entry.
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] pfx     Prefix of the FIB entry, owned by the FIB on success
+ * @par[in] face    Face for the FIB entry, NULL to remove the prefix
+ *
+ * @return 0    on success
+ * @return -1   on error
+ */
+int
+ccnl_fib_stage_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
+                     struct ccnl_face_s *face);
+
+/**
+ * @brief Replaces the FIB with the staged one, or merges the staged
+ * entries into it, in one step. Of several staged entries for a prefix
+ * the last one wins. Entries that stay keep their tap and counters.
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] merge   0 to replace the FIB, 1 to add, change and remove
+ *                  only the staged prefixes
+ *
+ * @return the number of entries in the new FIB, -1 on error (the staged
+ *         FIB is kept then)
+ */
+int
+ccnl_fib_commit(struct ccnl_relay_s *relay, int merge);
+
+/**
+ * @brief Drops the staged FIB
+ *
+ * @par[in] relay   Local relay struct
+ */
+void
+ccnl_fib_abort(struct ccnl_relay_s *relay);
 #endif //NEEDS_PREFIX_MATCHING
 
 /**
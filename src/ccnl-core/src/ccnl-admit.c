@@ -0,0 +1,257 @@
+/*
+ * @f ccnl-admit.c
+ * @b CCN lite, admission policies of the content store
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#include "ccnl-admit.h"
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "ccnl-core.h"
+
+#define CCNL_ADMIT_MAXSIZE      (1U << 26)  // cache entries the tables grow to
+
+// the high bits of ccnl_prefix_hash() are weak, spread them
+static uint64_t
+ccnl_admit_mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// whether all bits of h are set in the doorkeeper, sets them if add
+static int
+ccnl_admit_door(struct ccnl_admit_s *a, uint64_t h, int add)
+{
+    uint32_t h1 = (uint32_t) h, h2 = (uint32_t) (h >> 32) | 1, bit, k;
+    int found = 1;
+
+    for (k = 0; k < CCNL_ADMIT_HASHES; k++) {
+        bit = (h1 + k * h2) & (a->doorbits - 1);
+        if (!(a->door[bit / 64] & (1ULL << (bit % 64)))) {
+            found = 0;
+            if (add) {
+                a->door[bit / 64] |= 1ULL << (bit % 64);
+            }
+        }
+    }
+    return found;
+}
+
+// the requests for h in the current window, as far as the sketch knows
+static int
+ccnl_admit_count(struct ccnl_admit_s *a, uint64_t h)
+{
+    uint32_t h1 = (uint32_t) h, h2 = (uint32_t) (h >> 32) | 1, k;
+    int min = CCNL_ADMIT_MAXCOUNT;
+
+    for (k = 0; k < CCNL_ADMIT_ROWS; k++) {
+        uint8_t v = a->sketch[k * a->width + ((h1 + k * h2) & (a->width - 1))];
+        if (v < min) {
+            min = v;
+        }
+    }
+    return min + ccnl_admit_door(a, h, 0);
+}
+
+static void
+ccnl_admit_age(struct ccnl_admit_s *a)
+{
+    uint32_t k;
+
+    if (a->sketch) {
+        for (k = 0; k < CCNL_ADMIT_ROWS * a->width; k++) {
+            a->sketch[k] >>= 1;
+        }
+    }
+    memset(a->door, 0, a->doorbits / 8);
+    a->seen = 0;
+}
+
+int
+ccnl_admit_set(struct ccnl_relay_s *relay, const char *spec)
+{
+    struct ccnl_admit_s *a;
+    uint32_t size;
+    char *end;
+    double prob = 1.0;
+    int policy;
+
+    if (!strcmp(spec, "all")) {
+        ccnl_admit_free(relay);
+        return 0;
+    }
+    if (!strncmp(spec, "prob:", 5)) {
+        prob = strtod(spec + 5, &end);
+        if (end == spec + 5 || *end || !(prob >= 0.0 && prob <= 1.0)) {
+            return -1;
+        }
+        policy = CCNL_ADMIT_PROB;
+    } else if (!strcmp(spec, "second")) {
+        policy = CCNL_ADMIT_SECOND;
+    } else if (!strcmp(spec, "tinylfu")) {
+        policy = CCNL_ADMIT_TINYLFU;
+    } else {
+        return -1;
+    }
+
+    a = (struct ccnl_admit_s *) ccnl_calloc(1, sizeof(*a));
+    if (!a) {
+        return -1;
+    }
+    a->policy = policy;
+    a->prob = prob;
+    // an unlimited cache is never full, the tables are not used then
+    size = relay->max_cache_entries > 0 ? (uint32_t) relay->max_cache_entries : 1024;
+    if (size > CCNL_ADMIT_MAXSIZE) {
+        size = CCNL_ADMIT_MAXSIZE;
+    }
+    if (policy != CCNL_ADMIT_PROB) {
+        for (a->doorbits = 64; a->doorbits < CCNL_ADMIT_DOORBITS * size;
+             a->doorbits *= 2);
+        a->door = (uint64_t *) ccnl_calloc(a->doorbits / 64, sizeof(uint64_t));
+        // a full doorkeeper of "second" forgets, at about 3% false positives
+        a->window = a->doorbits / 8;
+    }
+    if (policy == CCNL_ADMIT_TINYLFU) {
+        for (a->width = 64; a->width < size; a->width *= 2);
+        a->sketch = (uint8_t *) ccnl_calloc(CCNL_ADMIT_ROWS, a->width);
+        a->window = CCNL_ADMIT_WINDOW * size;
+    }
+    if ((policy != CCNL_ADMIT_PROB && !a->door) ||
+        (policy == CCNL_ADMIT_TINYLFU && !a->sketch)) {
+        ccnl_free(a->door);
+        ccnl_free(a->sketch);
+        ccnl_free(a);
+        return -1;
+    }
+
+    ccnl_admit_free(relay);
+    relay->admit = a;
+    DEBUGMSG_CORE(INFO, "CS admission policy %s\n", spec);
+    return 0;
+}
+
+char*
+ccnl_admit_str(struct ccnl_relay_s *relay, char *buf, size_t buflen)
+{
+    struct ccnl_admit_s *a = relay->admit;
+
+    switch (a ? a->policy : CCNL_ADMIT_ALL) {
+    case CCNL_ADMIT_PROB:
+        snprintf(buf, buflen, "prob:%g", a->prob);
+        break;
+    case CCNL_ADMIT_SECOND:
+        snprintf(buf, buflen, "second");
+        break;
+    case CCNL_ADMIT_TINYLFU:
+        snprintf(buf, buflen, "tinylfu");
+        break;
+    default:
+        snprintf(buf, buflen, "all");
+        break;
+    }
+    return buf;
+}
+
+void
+ccnl_admit_free(struct ccnl_relay_s *relay)
+{
+    if (relay->admit) {
+        ccnl_free(relay->admit->door);
+        ccnl_free(relay->admit->sketch);
+        ccnl_free(relay->admit);
+        relay->admit = NULL;
+    }
+}
+
+void
+ccnl_admit_seen(struct ccnl_relay_s *relay, uint64_t namehash)
+{
+    struct ccnl_admit_s *a = relay->admit;
+    uint32_t h1, h2, k;
+    uint64_t h;
+
+    if (!a || a->policy != CCNL_ADMIT_TINYLFU) {
+        return;
+    }
+    // the first request of a window only goes to the doorkeeper
+    h = ccnl_admit_mix(namehash);
+    if (ccnl_admit_door(a, h, 1)) {
+        h1 = (uint32_t) h;
+        h2 = (uint32_t) (h >> 32) | 1;
+        for (k = 0; k < CCNL_ADMIT_ROWS; k++) {
+            uint8_t *v = a->sketch + k * a->width + ((h1 + k * h2) & (a->width - 1));
+            if (*v < CCNL_ADMIT_MAXCOUNT) {
+                (*v)++;
+            }
+        }
+    }
+    if (++a->seen >= a->window) {
+        ccnl_admit_age(a);
+    }
+}
+
+int
+ccnl_admit(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    struct ccnl_admit_s *a = relay->admit;
+    struct ccnl_content_s *victim;
+    int ok = 1;
+
+    if (!a || relay->max_cache_entries <= 0 ||
+        relay->contentcnt < relay->max_cache_entries) {
+        return 1;
+    }
+    switch (a->policy) {
+    case CCNL_ADMIT_PROB:
+        ok = (double) rand() / ((double) RAND_MAX + 1.0) < a->prob;
+        break;
+    case CCNL_ADMIT_SECOND:
+        ok = ccnl_admit_door(a, ccnl_admit_mix(ccnl_prefix_hash(c->pkt->pfx)), 1);
+        if (!ok && ++a->seen >= a->window) {
+            ccnl_admit_age(a);
+        }
+        break;
+    case CCNL_ADMIT_TINYLFU:
+        victim = ccnl_content_victim(relay);
+        ok = !victim ||
+             ccnl_admit_count(a, ccnl_admit_mix(ccnl_prefix_hash(c->pkt->pfx))) >
+             ccnl_admit_count(a, ccnl_admit_mix(victim->namehash));
+        break;
+    default:
+        break;
+    }
+    if (ok) {
+        a->admitted++;
+    } else {
+        a->rejected++;
+        DEBUGMSG_CORE(DEBUG, "  content not admitted to the cache\n");
+    }
+    return ok;
+}
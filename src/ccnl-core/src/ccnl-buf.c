@@ -29,6 +29,7 @@
 #include "ccnl-forward.h"
 #include "ccnl-prefix.h"
 #include "ccnl-malloc.h"
+#include "ccnl-admit.h"
 #else
 #include <ccnl-os-time.h>
 #include <ccnl-buf.h>
@@ -37,6 +38,7 @@
 #include <ccnl-forward.h>
 #include <ccnl-prefix.h>
 #include <ccnl-malloc.h>
+#include <ccnl-admit.h>
 #endif
 
 struct ccnl_buf_s*
@@ -72,8 +74,23 @@ ccnl_core_cleanup(struct ccnl_relay_s *ccnl)
         ccnl_free(ccnl->fib);
         ccnl->fib = fwd;
     }
+#ifdef NEEDS_PREFIX_MATCHING
+    ccnl_fib_abort(ccnl);
+#endif
     while (ccnl->contents)
         ccnl_content_remove(ccnl, ccnl->contents);
+    ccnl_admit_free(ccnl);
+    ccnl_free(ccnl->cs_names);
+    ccnl->cs_names = NULL;
+    ccnl_free(ccnl->pit_names);
+    ccnl->pit_names = NULL;
+    ccnl_free(ccnl->fresh);
+    ccnl->fresh = NULL;
+    ccnl->freshsize = 0;
+#ifdef USE_CCNxDIGEST
+    ccnl_free(ccnl->digests);
+    ccnl->digests = NULL;
+#endif
     while (ccnl->nonces) {
         struct ccnl_buf_s *tmp = ccnl->nonces->next;
         ccnl_free(ccnl->nonces);
@@ -32,6 +32,26 @@ static ccnl_cb_on_data _cb_rx_on_data = NULL;
  */
 static ccnl_cb_on_data _cb_tx_on_data = NULL;
 
+/**
+ * callback function for content store miss events
+ */
+static ccnl_cb_on_cs_miss _cb_cs_miss = NULL;
+
+/**
+ * callback function for content store eviction events
+ */
+static ccnl_cb_on_cs_evict _cb_cs_evict = NULL;
+
+/**
+ * callback function for snapshot requests
+ */
+static ccnl_cb_on_snapshot _cb_snapshot = NULL;
+
+/**
+ * callback function for end of receive burst events
+ */
+static ccnl_cb_on_rx_burst_end _cb_rx_burst_end = NULL;
+
 void
 ccnl_set_cb_rx_on_data(ccnl_cb_on_data func)
 {
@@ -44,6 +64,30 @@ ccnl_set_cb_tx_on_data(ccnl_cb_on_data func)
     _cb_tx_on_data = func;
 }
 
+void
+ccnl_set_cb_cs_miss(ccnl_cb_on_cs_miss func)
+{
+    _cb_cs_miss = func;
+}
+
+void
+ccnl_set_cb_cs_evict(ccnl_cb_on_cs_evict func)
+{
+    _cb_cs_evict = func;
+}
+
+void
+ccnl_set_cb_snapshot(ccnl_cb_on_snapshot func)
+{
+    _cb_snapshot = func;
+}
+
+void
+ccnl_set_cb_rx_burst_end(ccnl_cb_on_rx_burst_end func)
+{
+    _cb_rx_burst_end = func;
+}
+
 int
 ccnl_callback_rx_on_data(struct ccnl_relay_s *relay,
                          struct ccnl_face_s *from,
@@ -67,3 +111,42 @@ ccnl_callback_tx_on_data(struct ccnl_relay_s *relay,
 
     return 0;
 }
+
+int
+ccnl_callback_cs_miss(struct ccnl_relay_s *relay,
+                      struct ccnl_face_s *from,
+                      struct ccnl_pkt_s **pkt)
+{
+    if (_cb_cs_miss) {
+        return _cb_cs_miss(relay, from, pkt);
+    }
+
+    return 0;
+}
+
+void
+ccnl_callback_cs_evict(struct ccnl_relay_s *relay,
+                       struct ccnl_content_s *c)
+{
+    if (_cb_cs_evict) {
+        _cb_cs_evict(relay, c);
+    }
+}
+
+int
+ccnl_callback_snapshot(struct ccnl_relay_s *relay)
+{
+    if (_cb_snapshot) {
+        return _cb_snapshot(relay);
+    }
+
+    return -1;
+}
+
+void
+ccnl_callback_rx_burst_end(struct ccnl_relay_s *relay)
+{
+    if (_cb_rx_burst_end) {
+        _cb_rx_burst_end(relay);
+    }
+}
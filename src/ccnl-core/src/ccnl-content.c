@@ -28,6 +28,9 @@
 #include "ccnl-os-time.h"
 #include "ccnl-logging.h"
 #include "ccnl-defs.h"
+#ifdef USE_CCNxDIGEST
+#include <openssl/sha.h>
+#endif
 #else
 #include <ccnl-content.h>
 #include <ccnl-malloc.h>
@@ -65,6 +68,24 @@ ccnl_content_new(struct ccnl_pkt_s **pkt)
     return c;
 }
 
+unsigned char*
+ccnl_content_digest(struct ccnl_content_s *c)
+{
+#ifdef USE_CCNxDIGEST
+    if (!c->has_digest) {
+        if (!c->pkt || !c->pkt->buf ||
+            !compute_ccnx_digest(c->pkt->buf, c->digest)) {
+            return NULL;
+        }
+        c->has_digest = true;
+    }
+    return c->digest;
+#else
+    (void) c;
+    return NULL;
+#endif
+}
+
 int 
 ccnl_content_free(struct ccnl_content_s *content) 
 {
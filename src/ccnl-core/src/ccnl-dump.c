@@ -39,6 +39,9 @@
 #include "ccnl-interest.h"
 #include "ccnl-pkt.h"
 #include "ccnl-content.h"
+#ifdef USE_FRAG
+#include "ccnl-frag.h"
+#endif
 
 
 static void
@@ -51,6 +54,21 @@ blob(struct ccnl_buf_s *buf)
         CONSOLE("%02x", *cp);
 }
 
+#ifdef USE_FRAG
+char*
+frag_protocol(int e)
+{
+    switch (e) {
+    case CCNL_FRAG_NONE:            return "none";
+    case CCNL_FRAG_SEQUENCED2012:   return "seqd2012";
+    case CCNL_FRAG_CCNx2013:        return "ccnx2013";
+    case CCNL_FRAG_SEQUENCED2015:   return "seqd2015";
+    case CCNL_FRAG_BEGINEND2015:    return "be2015";
+    default:                        return "?";
+    }
+}
+#endif
+
 
 void
 ccnl_dump(int lev, int typ, void *p)
@@ -195,23 +213,22 @@ ccnl_dump(int lev, int typ, void *p)
                         (void *) itr, (void *) itr->next, (void *) itr->prev,
                         itr->last_used, itr->retries);
                 ccnl_dump(lev + 1, CCNL_PACKET, itr->pkt);
-                if (itr->pending) {
+                if (itr->pendcnt) {
                     INDENT(lev + 1);
                     CONSOLE("pending:\n");
-                    ccnl_dump(lev + 2, CCNL_PENDINT, itr->pending);
+                    for (k = 0; k < itr->pendcnt; k++) {
+                        ccnl_dump(lev + 2, CCNL_PENDINT, itr->pending + k);
+                    }
                 }
                 itr = itr->next;
 
             }
             break;
         case CCNL_PENDINT:
-            while (pir) {
-                INDENT(lev);
-                CONSOLE("%p PENDINT next=%p face=%p last=%" PRIu32 "\n",
-                        (void *) pir, (void *) pir->next,
-                        (void *) pir->face, pir->last_used);
-                pir = pir->next;
-            }
+            INDENT(lev);
+            CONSOLE("%p PENDINT face=%p last=%" PRIu32 " expires=%" PRIu32
+                    " nonce=%" PRIi32 "\n", (void *) pir, (void *) pir->face,
+                    pir->last_used, pir->expires, pir->nonce);
             break;
         case CCNL_PACKET:
             INDENT(lev);
@@ -497,23 +514,22 @@ get_pendint_dump(int lev, void *p, char **out) {
 
     struct ccnl_relay_s *top = (struct ccnl_relay_s *) p;
     struct ccnl_interest_s *itr = (struct ccnl_interest_s *) top->pit;
-    struct ccnl_pendint_s *pir = (struct ccnl_pendint_s *) itr->pending;
+    struct ccnl_pendint_s *pir;
 
     int line = 0;
     int result = 0;
 
-    while (pir) {
+    while (line < itr->pendcnt) {
         /* indent entry by 'lev' spaces */
         //INDENT(lev);
+        pir = itr->pending + line;
 
         /* check if the sprintf call fails */
-        if ((result = sprintf(out[line], "%p PENDINT next=%p face=%p last=%d",
-                       (void *) pir, (void *) pir->next,
+        if ((result = sprintf(out[line], "%p PENDINT face=%p last=%d",
+                       (void *) pir,
                        (void *) pir->face, pir->last_used)) < 0) { 
             DEBUGMSG(ERROR, "get_pendint_dump: could not write PIT entry\n");
         }
-        /* set pointer to next entry */
-        pir = pir->next;
         /* new entry in pit */
         ++line;
     }
@@ -23,6 +23,9 @@
 #include "ccnl-frag.h"
 #include "ccnl-malloc.h"
 #include "ccnl-pkt.h"
+#include "ccnl-pkt-util.h"
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-pkt-ndntlv.h"
 #include "ccnl-logging.h"
 
 #ifdef USE_FRAG
@@ -72,6 +75,7 @@ ccnl_frag_new(int protocol, int mtu)
         if (e) {
             e->protocol = protocol;
             e->mtu = mtu;
+            e->cfgmtu = mtu;
             e->flagwidth = 1;
             e->sendseqwidth =   4;
             e->losscountwidth = 2;
@@ -84,6 +88,7 @@ ccnl_frag_new(int protocol, int mtu)
         if (e) {
             e->protocol = protocol;
             e->mtu = mtu;
+            e->cfgmtu = mtu;
         }
         break;
     case CCNL_FRAG_NONE:
@@ -97,8 +102,8 @@ void
 ccnl_frag_reset(struct ccnl_frag_s *e, struct ccnl_buf_s *buf,
                   int ifndx, sockunion *dst)
 {
-    DEBUGMSG_EFRA(VERBOSE, "ccnl_frag_reset if=%d (%zd bytes) dst=%s\n", ifndx,
-             buf ? buf->datalen : -1, ccnl_addr2ascii(dst));
+    DEBUGMSG_EFRA(VERBOSE, "ccnl_frag_reset if=%d (%d bytes) dst=%s\n", ifndx,
+             buf ? (int) buf->datalen : -1, ccnl_addr2ascii(dst));
     if (!e)
         return;
     e->ifndx = ifndx;
@@ -371,50 +376,94 @@ ccnl_frag_getnextSEQD2015(struct ccnl_frag_s *fr, int *ifndx, sockunion *su)
 }
 #endif // OBSOLETE
 
-struct ccnl_buf_s*
-ccnl_frag_getnextBE2015(struct ccnl_frag_s *fr, int *ifndx, sockunion *su)
+uint16_t
+ccnl_frag_fields(struct ccnl_frag_s *fr, size_t datalen)
 {
-    struct ccnl_buf_s *buf = 0;
-    unsigned int datalen = 0;
+    uint16_t fields = fr->sendseq & CCNL_FRAG_SEQMASK;
+
+    if (datalen >= fr->bigpkt->datalen) {                   // single
+        fields |= CCNL_BEFRAG_FLAG_SINGLE << 14;
+    } else if (fr->sendoffs == 0) {                         // start
+        fields |= CCNL_BEFRAG_FLAG_FIRST << 14;
+    } else if (datalen >= fr->bigpkt->datalen - fr->sendoffs) { // end
+        fields |= CCNL_BEFRAG_FLAG_LAST << 14;
+    } else {                                                // middle
+        fields |= CCNL_BEFRAG_FLAG_MID << 14;
+    }
+    return fields;
+}
 
-    DEBUGMSG_EFRA(VERBOSE, "ccnl_frag_getnextBE2015: remaining=%zd\n",
-                  fr->bigpkt->datalen - fr->sendoffs);
+int
+ccnl_frag_getiov(struct ccnl_frag_s *fr, struct ccnl_frag_iov_s *iov, int max)
+{
+    int cnt = 0, rc;
 
-    switch(fr->outsuite) {
+    if (!fr || fr->protocol != CCNL_FRAG_BEGINEND2015) {
+        return 0;
+    }
+    while (cnt < max && !ccnl_frag_nomorefragments(fr)) {
+        switch(fr->outsuite) {
 #ifdef USE_SUITE_CCNTLV
-    case CCNL_SUITE_CCNTLV:
-        buf = ccnl_ccntlv_mkFrag(fr, &datalen);
-        break;
+        case CCNL_SUITE_CCNTLV:
+            rc = ccnl_ccntlv_mkFragHdr(fr, iov[cnt].hdr, &iov[cnt].hdrlen,
+                                       &iov[cnt].datalen);
+            break;
 #endif
 #ifdef USE_SUITE_NDNTLV
-    case CCNL_SUITE_NDNTLV:
-        buf = ccnl_ndntlv_mkFrag(fr, &datalen);
-        break;
+        case CCNL_SUITE_NDNTLV:
+            rc = ccnl_ndntlv_mkFragHdr(fr, iov[cnt].hdr, &iov[cnt].hdrlen,
+                                       &iov[cnt].datalen);
+            break;
 #endif
-    default:
-        break;
+        default:
+            rc = -1;
+            break;
+        }
+        if (rc) {
+            DEBUGMSG_EFRA(VERBOSE, "  produced NO fragment, seqnr remains at =%u-1\n",
+                          fr->sendseq);
+            break;
+        }
+        iov[cnt].data = fr->bigpkt->data + fr->sendoffs;
+        fr->sendseq++;
+        fr->sendoffs += iov[cnt].datalen;
+        cnt++;
     }
+    return cnt;
+}
 
-    if (buf) {
-        fr->sendseq++;
+struct ccnl_buf_s*
+ccnl_frag_getnextBE2015(struct ccnl_frag_s *fr, int *ifndx, sockunion *su)
+{
+    struct ccnl_frag_iov_s iov;
+    struct ccnl_buf_s *buf;
 
-        fr->sendoffs += datalen;
-        if (fr->sendoffs >= (unsigned) fr->bigpkt->datalen) {
-            ccnl_free(fr->bigpkt);
-            fr->bigpkt = NULL;
-        }
+    DEBUGMSG_EFRA(VERBOSE, "ccnl_frag_getnextBE2015: remaining=%zu\n",
+                  fr->bigpkt->datalen - fr->sendoffs);
 
-        if (ifndx)
-            *ifndx = fr->ifndx;
-        if (su)
-            memcpy(su, &fr->dest, sizeof(*su));
+    if (ccnl_frag_getiov(fr, &iov, 1) != 1) {
+        return NULL;
+    }
+    buf = ccnl_buf_new(NULL, iov.hdrlen + iov.datalen);
+    if (buf) {
+        memcpy(buf->data, iov.hdr, iov.hdrlen);
+        memcpy(buf->data + iov.hdrlen, iov.data, iov.datalen);
+    }
+    if (fr->sendoffs >= fr->bigpkt->datalen) {
+        ccnl_free(fr->bigpkt);
+        fr->bigpkt = NULL;
+    }
+    if (!buf) {
+        return NULL;
+    }
 
-        DEBUGMSG_EFRA(VERBOSE, "  produced %zd bytes fragment, seqnr=%d-1\n",
-                 buf->datalen, fr->sendseq);
-    } else
-        DEBUGMSG_EFRA(VERBOSE, "  produced NO fragment, seqnr remains at =%d-1\n",
-                 fr->sendseq);
+    if (ifndx)
+        *ifndx = fr->ifndx;
+    if (su)
+        memcpy(su, &fr->dest, sizeof(*su));
 
+    DEBUGMSG_EFRA(VERBOSE, "  produced %zu bytes fragment, seqnr=%u-1\n",
+                  buf->datalen, fr->sendseq);
     return buf;
 }
 
@@ -423,7 +472,7 @@ ccnl_frag_getnext(struct ccnl_frag_s *fr, int *ifndx, sockunion *su)
 {
     if (!fr->bigpkt) return NULL;
 
-    DEBUGMSG_EFRA(VERBOSE, "fragmenting %zd bytes (@ %d)\n",
+    DEBUGMSG_EFRA(VERBOSE, "fragmenting %zu bytes (@ %u)\n",
                                 fr->bigpkt->datalen, fr->sendoffs);
 
     switch (fr->protocol) {
@@ -450,15 +499,22 @@ ccnl_frag_nomorefragments(struct ccnl_frag_s *e)
 {
     if (!e || !e->bigpkt)
         return 1;
-    return (unsigned) e->bigpkt->datalen <= e->sendoffs;
+    return e->bigpkt->datalen <= e->sendoffs;
 }
 
+static void ccnl_frag_freeseries(struct ccnl_frag_s *e);
+
 void
 ccnl_frag_destroy(struct ccnl_frag_s *e)
 {
+    int i;
+
     if (e) {
         ccnl_free(e->bigpkt);
-        ccnl_free(e->defrag);
+        ccnl_frag_freeseries(e);
+        for (i = 0; i < CCNL_FRAG_WINDOW; i++) {
+            ccnl_free(e->rxwin[i]);
+        }
         ccnl_free(e);
     }
 }
@@ -753,16 +809,144 @@ ccnl_frag_RX_Sequenced2015(RX_datagram callback, struct ccnl_relay_s *relay,
 }
 #endif // OBSOLETE
 
+#define CCNL_FRAG_SLOT(seqno)   ((seqno) % CCNL_FRAG_WINDOW)
+#define CCNL_FRAG_NEXT(seqno)   (((seqno) + 1) & CCNL_FRAG_SEQMASK)
+
+static void
+ccnl_frag_freeseries(struct ccnl_frag_s *e)
+{
+    struct ccnl_buf_s *buf;
+
+    while (e->defrag) {
+        buf = e->defrag;
+        e->defrag = buf->next;
+        ccnl_free(buf);
+    }
+    e->defragend = NULL;
+    e->defraglen = 0;
+}
+
+static void
+ccnl_frag_dropseries(struct ccnl_frag_s *e)
+{
+    if (e->defrag) {
+        DEBUGMSG_EFRA(WARNING, "  >> had to drop defrag buf\n");
+        e->losscount++;
+        ccnl_frag_freeseries(e);
+    }
+}
+
+// takes over frag, the fragment which was expected next (NULL if it is lost)
+static void
+ccnl_frag_inorder(RX_datagram callback, struct ccnl_relay_s *relay,
+                  struct ccnl_face_s *from, struct ccnl_buf_s *frag,
+                  unsigned int bits)
+{
+    struct ccnl_frag_s *e = from->frag;
+    struct ccnl_buf_s *buf = NULL;
+    uint8_t *data;
+    size_t datalen, offs;
+
+    if (!frag) {
+        ccnl_frag_dropseries(e);
+        return;
+    }
+    frag->next = NULL;
+
+    switch(bits) {
+    case CCNL_BEFRAG_FLAG_SINGLE: // single packet
+        DEBUGMSG_EFRA(VERBOSE, "  >> single fragment (%zu bytes)\n",
+                      frag->datalen);
+        ccnl_frag_dropseries(e);
+        buf = frag;
+        break;
+    case CCNL_BEFRAG_FLAG_FIRST: // start of fragment sequence
+        DEBUGMSG_EFRA(VERBOSE, "  >> start of fragment series\n");
+        ccnl_frag_dropseries(e);
+        e->defrag = e->defragend = frag;
+        e->defraglen = frag->datalen;
+        return;
+    case CCNL_BEFRAG_FLAG_LAST: // end of fragment sequence
+    case CCNL_BEFRAG_FLAG_MID:  // fragment in the middle of a squence
+    default:
+        DEBUGMSG_EFRA(VERBOSE, "  >> %s fragment of a series\n",
+                      bits == CCNL_BEFRAG_FLAG_LAST ? "last" : "middle");
+        if (!e->defrag) {
+            DEBUGMSG_EFRA(WARNING, "  >> no e->defrag?\n");
+            e->losscount++;
+            ccnl_free(frag);
+            return;
+        }
+        if (e->defraglen + frag->datalen > CCNL_MAX_PACKET_SIZE) {
+            DEBUGMSG_EFRA(WARNING, "  >> series exceeds %d bytes\n",
+                          CCNL_MAX_PACKET_SIZE);
+            ccnl_frag_dropseries(e);
+            ccnl_free(frag);
+            return;
+        }
+        e->defragend->next = frag;
+        e->defragend = frag;
+        e->defraglen += frag->datalen;
+        if (bits != CCNL_BEFRAG_FLAG_LAST) {
+            return;
+        }
+        // the only copy of the reassembled packet
+        buf = ccnl_buf_new(NULL, e->defraglen);
+        if (buf) {
+            for (frag = e->defrag, offs = 0; frag; frag = frag->next) {
+                memcpy(buf->data + offs, frag->data, frag->datalen);
+                offs += frag->datalen;
+            }
+        }
+        ccnl_frag_freeseries(e);
+        break;
+    }
+
+    if (buf) {
+        data = buf->data;
+        datalen = buf->datalen;
+        DEBUGMSG_EFRA(DEBUG, "  >> reassembled fragment is %zu bytes\n",
+                      buf->datalen);
+        // FIXME: loop over multiple packets in this reassembled frame?
+        callback(relay, from, &data, &datalen);
+        ccnl_free(buf);
+    }
+}
+
+// moves the window forward until seqno fits in, fragments falling out of it
+// are lost, as is the series in progress
+static void
+ccnl_frag_resync(struct ccnl_frag_s *e, unsigned int seqno)
+{
+    unsigned int base = (seqno + 1 - CCNL_FRAG_WINDOW) & CCNL_FRAG_SEQMASK;
+    unsigned int steps = (base - e->recvseq) & CCNL_FRAG_SEQMASK, k;
+
+    DEBUGMSG_EFRA(WARNING, "  >> seqnum jump: rcvd %u, expected %u\n",
+                  seqno, e->recvseq);
+    e->losscount++;
+    ccnl_frag_freeseries(e);
+    for (k = 0; k < steps && k < CCNL_FRAG_WINDOW; k++) {
+        ccnl_free(e->rxwin[CCNL_FRAG_SLOT(e->recvseq + k)]);
+        e->rxwin[CCNL_FRAG_SLOT(e->recvseq + k)] = NULL;
+    }
+    // skip over what did not arrive in time
+    e->recvseq = base;
+    while (e->recvseq != seqno && !e->rxwin[CCNL_FRAG_SLOT(e->recvseq)]) {
+        e->recvseq = CCNL_FRAG_NEXT(e->recvseq);
+    }
+}
+
 int
 ccnl_frag_RX_BeginEnd2015(RX_datagram callback, struct ccnl_relay_s *relay,
                           struct ccnl_face_s *from, int mtu,
                           unsigned int bits, unsigned int seqno,
-                          unsigned char **data, int *datalen)
+                          uint8_t **data, size_t *datalen)
 {
-    struct ccnl_buf_s *buf = NULL;
+    struct ccnl_buf_s *buf;
     struct ccnl_frag_s *e;
+    unsigned int ahead, slot;
 
-    DEBUGMSG_EFRA(DEBUG, "ccnl_frag_RX_BeginEnd2015 (%d bytes), seqno=%d\n",
+    DEBUGMSG_EFRA(DEBUG, "ccnl_frag_RX_BeginEnd2015 (%zu bytes), seqno=%u\n",
                   *datalen, seqno);
 
     if (!from) {
@@ -781,83 +965,51 @@ ccnl_frag_RX_BeginEnd2015(RX_datagram callback, struct ccnl_relay_s *relay,
     }
 
     e = from->frag;
-    if (e->recvseq != seqno) {
-        // should increase error counter here
-        DEBUGMSG_EFRA(WARNING, "  >> seqnum mismatch: rcvd %d, expected %d\n",
-                      seqno, e->recvseq);
-        if (e->defrag) {
-            DEBUGMSG_EFRA(WARNING, "  >> had to drop defrag buf\n");
-            ccnl_free(e->defrag);
-            e->defrag = NULL;
+    bits &= CCNL_BEFRAG_FLAG_MASK;
+    seqno &= CCNL_FRAG_SEQMASK;
+    ahead = (seqno - e->recvseq) & CCNL_FRAG_SEQMASK;
+
+    if (ahead >= CCNL_FRAG_WINDOW) {
+        if (ahead > CCNL_FRAG_SEQMASK - CCNL_FRAG_WINDOW) {
+            DEBUGMSG_EFRA(DEBUG, "  >> late fragment, seqno=%u, dropped\n",
+                          seqno);
+            *data += *datalen;
+            *datalen = 0;
+            return 1;
         }
-        e->recvseq = seqno;
+        ccnl_frag_resync(e, seqno);
+        ahead = (seqno - e->recvseq) & CCNL_FRAG_SEQMASK;
     }
 
-    switch(bits & (CCNL_BEFRAG_FLAG_MASK)) {
-    case CCNL_BEFRAG_FLAG_SINGLE: // single packet
-        DEBUGMSG_EFRA(VERBOSE, "  >> single fragment seqno=%d (%d bytes)\n",
+    if (ahead == 0 && bits == CCNL_BEFRAG_FLAG_SINGLE) {
+        DEBUGMSG_EFRA(VERBOSE, "  >> single fragment seqno=%u (%zu bytes)\n",
                       seqno, *datalen);
-        if (e->defrag) {
-            DEBUGMSG_EFRA(WARNING, "    had to drop defrag buf\n");
-            ccnl_free(e->defrag);
-            e->defrag = NULL;
-        }
-        e->recvseq++;
+        ccnl_frag_dropseries(e);
+        e->recvseq = CCNL_FRAG_NEXT(e->recvseq);
         // no need to copy the buffer:
         callback(relay, from, data, datalen);
-        return 1;
-    case CCNL_BEFRAG_FLAG_FIRST: // start of fragment sequence
-        DEBUGMSG_EFRA(VERBOSE, "  >> start of fragment series\n");
-        if (e->defrag) {
-            DEBUGMSG_EFRA(WARNING, "    had to drop defrag buf\n");
-            ccnl_free(e->defrag);
-        }
-        e->defrag = ccnl_buf_new(*data, *datalen);
-        break;
-    case CCNL_BEFRAG_FLAG_LAST: // end of fragment sequence
-        DEBUGMSG_EFRA(VERBOSE, "  >> last fragment of a series\n");
-        if (!e->defrag) {
-            DEBUGMSG_EFRA(WARNING, "  >> no e->defrag?\n");
-            break;
-        }
-        buf = ccnl_buf_new(NULL, e->defrag->datalen + *datalen);
-        if (buf) {
-            memcpy(buf->data, e->defrag->data, e->defrag->datalen);
-            memcpy(buf->data + e->defrag->datalen, *data, *datalen);
-        }
-        ccnl_free(e->defrag);
-        e->defrag = NULL;
-        break;
-    case CCNL_BEFRAG_FLAG_MID:  // fragment in the middle of a squence
-    default:
-        DEBUGMSG_EFRA(VERBOSE, "  >> fragment in the middle of a series\n");
-        if (!e->defrag)
-            break;
-        buf = ccnl_buf_new(NULL, e->defrag->datalen + *datalen);
-        if (buf) {
-            memcpy(buf->data, e->defrag->data, e->defrag->datalen);
-            memcpy(buf->data + e->defrag->datalen, *data, *datalen);
-            ccnl_free(e->defrag);
-            e->defrag = buf;
-            buf = NULL;
+    } else {
+        buf = ccnl_buf_new(*data, *datalen);
+        *data += *datalen;
+        *datalen = 0;
+        if (ahead == 0) {
+            e->recvseq = CCNL_FRAG_NEXT(e->recvseq);
+            ccnl_frag_inorder(callback, relay, from, buf, bits);
         } else {
-            ccnl_free(e->defrag);
-            e->defrag = NULL;
+            DEBUGMSG_EFRA(VERBOSE, "  >> holding back seqno=%u, expected %u\n",
+                          seqno, e->recvseq);
+            slot = CCNL_FRAG_SLOT(seqno);
+            ccnl_free(e->rxwin[slot]); // a duplicate
+            e->rxwin[slot] = buf;
+            e->rxwinbits[slot] = bits;
         }
-        break;
     }
-    *data += *datalen;
-    *datalen = 0;
-    e->recvseq++;
 
-    if (buf) {
-        unsigned char *frag = buf->data;
-        int fraglen = buf->datalen;
-        DEBUGMSG_EFRA(DEBUG, "  >> reassembled fragment is %zd bytes\n",
-                      buf->datalen);
-        // FIXME: loop over multiple packets in this reassembled frame?
-        callback(relay, from, &frag, &fraglen);
-        ccnl_free(buf);
+    // fragments held back which are in order now
+    while ((buf = e->rxwin[slot = CCNL_FRAG_SLOT(e->recvseq)])) {
+        e->rxwin[slot] = NULL;
+        e->recvseq = CCNL_FRAG_NEXT(e->recvseq);
+        ccnl_frag_inorder(callback, relay, from, buf, e->rxwinbits[slot]);
     }
 
     return 1;
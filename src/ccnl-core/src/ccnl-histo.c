@@ -0,0 +1,215 @@
+/*
+ * @f ccnl-histo.c
+ * @b CCN lite, latency histograms of the forwarding stages
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "ccnl-histo.h"
+
+void null_func(void);
+
+#ifdef USE_HISTOGRAMS
+
+#include <time.h>
+#include <string.h>
+
+#include "ccnl-core.h"
+
+struct ccnl_histo_pfx_s {
+    uint64_t hash;              // ccnl_prefix_hash() of the FIB prefix
+    int suite;
+    char name[64];
+    struct ccnl_histo_s h;
+};
+
+int ccnl_histo_on;
+struct ccnl_histo_s ccnl_histo_stage[CCNL_HISTO_STAGES];
+const char *ccnl_histo_stagename[CCNL_HISTO_STAGES] = {
+    "parse", "cs", "pit", "fib", "serve", "faceq", "ifq"
+};
+
+static struct ccnl_histo_pfx_s ccnl_histo_pfx[CCNL_HISTO_PREFIXES];
+static int ccnl_histo_pfxcnt;
+
+uint64_t
+ccnl_histo_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static int
+ccnl_histo_bucket(uint64_t ns)
+{
+    int m;
+
+    if (ns < (1U << CCNL_HISTO_SUBBITS)) {
+        return (int) ns;
+    }
+    m = 63 - __builtin_clzll(ns);
+    if (m >= CCNL_HISTO_MAXBITS) {
+        return CCNL_HISTO_BUCKETS - 1;
+    }
+    return ((m - CCNL_HISTO_SUBBITS + 1) << CCNL_HISTO_SUBBITS) +
+           (int) ((ns >> (m - CCNL_HISTO_SUBBITS)) &
+                  ((1U << CCNL_HISTO_SUBBITS) - 1));
+}
+
+// the first value after bucket b
+static uint64_t
+ccnl_histo_bucketend(int b)
+{
+    int m, sub = 1 << CCNL_HISTO_SUBBITS;
+
+    if (b < sub) {
+        return (uint64_t) b + 1;
+    }
+    m = b / sub + CCNL_HISTO_SUBBITS - 1;
+    return ((uint64_t) (sub + b % sub) + 1) << (m - CCNL_HISTO_SUBBITS);
+}
+
+void
+ccnl_histo_add(struct ccnl_histo_s *h, uint64_t ns)
+{
+    h->count++;
+    h->sum += ns;
+    if (ns > h->max) {
+        h->max = ns;
+    }
+    h->buckets[ccnl_histo_bucket(ns)]++;
+}
+
+uint64_t
+ccnl_histo_quantile(const struct ccnl_histo_s *h, double q)
+{
+    uint64_t want, seen = 0, end;
+    int b;
+
+    if (!h->count) {
+        return 0;
+    }
+    want = (uint64_t) (q * (double) h->count);
+    if (want >= h->count) {
+        return h->max;
+    }
+    for (b = 0; b < CCNL_HISTO_BUCKETS; b++) {
+        seen += h->buckets[b];
+        if (seen > want) {
+            break;
+        }
+    }
+    if (b >= CCNL_HISTO_BUCKETS - 1) {
+        return h->max; // the last bucket has no end
+    }
+    end = ccnl_histo_bucketend(b) - 1;
+    return end < h->max ? end : h->max;
+}
+
+void
+ccnl_histo_satisfied(struct ccnl_relay_s *relay, struct ccnl_interest_s *i)
+{
+    struct ccnl_forward_s *fwd, *best = NULL;
+    struct ccnl_histo_pfx_s *p;
+    uint64_t hash;
+    int k;
+
+    if (!i->created || !i->pkt->pfx) {
+        return;
+    }
+    for (fwd = relay->fib; fwd; fwd = fwd->next) {
+        if (!fwd->prefix || fwd->suite != i->pkt->pfx->suite ||
+            (best && fwd->prefix->compcnt <= best->prefix->compcnt)) {
+            continue;
+        }
+        if (ccnl_prefix_cmp(fwd->prefix, NULL, i->pkt->pfx, CMP_LONGEST) >=
+                                            (int32_t) fwd->prefix->compcnt) {
+            best = fwd;
+        }
+    }
+    if (!best) {
+        return;
+    }
+
+    hash = ccnl_prefix_hash(best->prefix);
+    for (k = 0; k < ccnl_histo_pfxcnt; k++) {
+        if (ccnl_histo_pfx[k].hash == hash &&
+                                ccnl_histo_pfx[k].suite == best->suite) {
+            break;
+        }
+    }
+    if (k == ccnl_histo_pfxcnt) {
+        if (k == CCNL_HISTO_PREFIXES) {
+            return;
+        }
+        p = ccnl_histo_pfx + ccnl_histo_pfxcnt++;
+        p->hash = hash;
+        p->suite = best->suite;
+        ccnl_prefix_to_str(best->prefix, p->name, sizeof(p->name));
+    }
+    ccnl_histo_add(&ccnl_histo_pfx[k].h, ccnl_histo_now() - i->created);
+}
+
+struct ccnl_histo_s*
+ccnl_histo_prefix(int n, const char **name)
+{
+    if (n < 0 || n >= ccnl_histo_pfxcnt) {
+        return NULL;
+    }
+    *name = ccnl_histo_pfx[n].name;
+    return &ccnl_histo_pfx[n].h;
+}
+
+static void
+ccnl_histo_dumpone(const char *what, const char *name,
+                   const struct ccnl_histo_s *h)
+{
+    CONSOLE("  %-5s %-24s %10llu %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n",
+            what, name, (unsigned long long) h->count,
+            h->count ? (double) h->sum / (double) h->count / 1000.0 : 0.0,
+            (double) ccnl_histo_quantile(h, 0.5) / 1000.0,
+            (double) ccnl_histo_quantile(h, 0.9) / 1000.0,
+            (double) ccnl_histo_quantile(h, 0.99) / 1000.0,
+            (double) ccnl_histo_quantile(h, 0.999) / 1000.0,
+            (double) h->max / 1000.0);
+}
+
+void
+ccnl_histo_dump(void)
+{
+    int k;
+
+    CONSOLE("latency histograms (usec)%s\n",
+            ccnl_histo_on ? "" : ", not recording");
+    CONSOLE("  %-5s %-24s %10s %9s %9s %9s %9s %9s %9s\n", "", "",
+            "count", "mean", "p50", "p90", "p99", "p99.9", "max");
+    for (k = 0; k < CCNL_HISTO_STAGES; k++) {
+        ccnl_histo_dumpone("stage", ccnl_histo_stagename[k],
+                           ccnl_histo_stage + k);
+    }
+    for (k = 0; k < ccnl_histo_pfxcnt; k++) {
+        ccnl_histo_dumpone("I->D", ccnl_histo_pfx[k].name,
+                           &ccnl_histo_pfx[k].h);
+    }
+}
+
+#endif // USE_HISTOGRAMS
@@ -20,6 +20,7 @@
  * 2013-04-11 created
  */
 
+
 void null_func(void);
 
 #ifdef USE_HTTP_STATUS
@@ -28,6 +29,984 @@ void null_func(void);
 #include "ccnl-http-status.h"
 #include "ccnl-os-time.h"
 
+#include <stdarg.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#ifndef MSG_NOSIGNAL
+# define MSG_NOSIGNAL 0
+#endif
+
+#define CCNL_HTTP_FRAME         16      // room for the chunk size line
+#define CCNL_HTTP_METRICS       (256 * 1024)
+
+// the parts of a page, a table part is CCNL_HTTP_P_TABLE + CCNL_HTTP_T_*
+enum {
+    CCNL_HTTP_P_HEAD,
+    CCNL_HTTP_P_MISC,
+    CCNL_HTTP_P_TAIL,
+    CCNL_HTTP_P_TABLE
+};
+
+enum {
+    CCNL_HTTP_T_FIB,
+    CCNL_HTTP_T_FACES,
+    CCNL_HTTP_T_IFS,
+    CCNL_HTTP_T_PIT,
+    CCNL_HTTP_T_CS,
+    CCNL_HTTP_TABLES
+};
+
+struct ccnl_http_buf_s {
+    char *buf;
+    size_t len, size;
+    int full;                   // something did not fit
+};
+
+// ----------------------------------------------------------------------
+
+// once something does not fit, nothing more is written
+static void
+ccnl_http_printf(struct ccnl_http_buf_s *b, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void
+ccnl_http_printf(struct ccnl_http_buf_s *b, const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    if (b->full) {
+        return;
+    }
+    va_start(ap, fmt);
+    n = vsnprintf(b->buf + b->len, b->size - b->len, fmt, ap);
+    va_end(ap);
+    if (n >= 0 && (size_t) n < b->size - b->len) {
+        b->len += (size_t) n;
+    } else {
+        b->buf[b->len] = '\0';
+        b->full = 1;
+    }
+}
+
+// a string as JSON (quoted) or as HTML text
+static void
+ccnl_http_str(struct ccnl_http_buf_s *b, const char *s, int json)
+{
+    if (json) {
+        ccnl_http_printf(b, "\"");
+    }
+    for (; *s && !b->full; s++) {
+        unsigned char ch = (unsigned char) *s;
+
+        if (json && (ch == '"' || ch == '\\')) {
+            ccnl_http_printf(b, "\\%c", ch);
+        } else if (json && (ch < 0x20 || ch > 0x7e)) {
+            ccnl_http_printf(b, "\\u%04x", ch);
+        } else if (!json && ch == '<') {
+            ccnl_http_printf(b, "&lt;");
+        } else if (!json && ch == '>') {
+            ccnl_http_printf(b, "&gt;");
+        } else if (!json && ch == '&') {
+            ccnl_http_printf(b, "&amp;");
+        } else if (!json && ch == '"') {
+            ccnl_http_printf(b, "&quot;");
+        } else {
+            ccnl_http_printf(b, "%c", ch);
+        }
+    }
+    if (json) {
+        ccnl_http_printf(b, "\"");
+    }
+}
+
+static char*
+ccnl_http_prefix(struct ccnl_prefix_s *pfx, char *s)
+{
+    if (!pfx) {
+        s[0] = '\0';
+        return s;
+    }
+    return ccnl_prefix_to_str(pfx, s, CCNL_MAX_PREFIX_SIZE);
+}
+
+// ----------------------------------------------------------------------
+// the tables, walked one row at a time
+
+#ifdef USE_STATS
+
+#define CCNL_FACE_STAT(F)  { #F, offsetof(struct ccnl_face_stats_s, F) }
+
+static const struct {
+    const char *name;
+    size_t offs;
+} ccnl_face_metrics[] = {
+    CCNL_FACE_STAT(interests_in),
+    CCNL_FACE_STAT(interests_out),
+    CCNL_FACE_STAT(data_in),
+    CCNL_FACE_STAT(data_out),
+    CCNL_FACE_STAT(nacks_in),
+    CCNL_FACE_STAT(bytes_in),
+    CCNL_FACE_STAT(bytes_out),
+    CCNL_FACE_STAT(cs_hits),
+    CCNL_FACE_STAT(cs_misses),
+    CCNL_FACE_STAT(pit_aggregated),
+};
+
+#define ccnl_face_stat(F, K)    (*(uint64_t *) ((char *) &(F)->stats + \
+                                                ccnl_face_metrics[K].offs))
+
+#endif // USE_STATS
+
+static void*
+ccnl_http_fib_first(struct ccnl_relay_s *ccnl)
+{
+    return ccnl->fib;
+}
+
+static void*
+ccnl_http_fib_next(struct ccnl_relay_s *ccnl, void *row)
+{
+    (void) ccnl;
+    return ((struct ccnl_forward_s *) row)->next;
+}
+
+static void
+ccnl_http_fib_row(struct ccnl_relay_s *ccnl, void *row, int json,
+                  struct ccnl_http_buf_s *b)
+{
+    struct ccnl_forward_s *fwd = (struct ccnl_forward_s *) row;
+    char s[CCNL_MAX_PREFIX_SIZE], fname[16];
+    (void) ccnl;
+
+    if (json) {
+        ccnl_http_printf(b, "{\"prefix\":");
+        ccnl_http_str(b, ccnl_http_prefix(fwd->prefix, s), 1);
+        ccnl_http_printf(b, ",\"face\":%d,\"tap\":%s,\"suite\":\"%s\"",
+                         fwd->face ? fwd->face->faceid : -1,
+                         fwd->tap ? "true" : "false",
+                         ccnl_suite2str(fwd->suite));
+#ifdef USE_STATS
+        ccnl_http_printf(b, ",\"interests\":%llu,\"bytes\":%llu",
+                         (unsigned long long) fwd->interests,
+                         (unsigned long long) fwd->bytes);
+#endif
+        ccnl_http_printf(b, "}");
+        return;
+    }
+
+#ifdef USE_ECHO
+    if (fwd->tap)
+        strcpy(fname, "'echoserver'");
+    else
+#endif
+    if (fwd->face)
+        snprintf(fname, sizeof(fname), "f%d", fwd->face->faceid);
+    else
+        strcpy(fname, "?");
+    ccnl_http_printf(b, "<li>via %4s: <font face=courier>", fname);
+    ccnl_http_str(b, ccnl_http_prefix(fwd->prefix, s), 0);
+    ccnl_http_printf(b, "</font> (%s)", ccnl_suite2str(fwd->suite));
+#ifdef USE_STATS
+    ccnl_http_printf(b, " &nbsp;interests=%llu &nbsp;bytes=%llu",
+                     (unsigned long long) fwd->interests,
+                     (unsigned long long) fwd->bytes);
+#endif
+    ccnl_http_printf(b, "\n");
+}
+
+static void*
+ccnl_http_faces_first(struct ccnl_relay_s *ccnl)
+{
+    return ccnl->faces;
+}
+
+static void*
+ccnl_http_faces_next(struct ccnl_relay_s *ccnl, void *row)
+{
+    (void) ccnl;
+    return ((struct ccnl_face_s *) row)->next;
+}
+
+static void
+ccnl_http_faces_row(struct ccnl_relay_s *ccnl, void *row, int json,
+                    struct ccnl_http_buf_s *b)
+{
+    struct ccnl_face_s *f = (struct ccnl_face_s *) row;
+    struct ccnl_buf_s *bpt;
+    int qlen, fixed = f->flags & CCNL_FACE_FLAGS_STATIC;
+    double ttl = f->last_used + CCNL_FACE_TIMEOUT - CCNL_NOW();
+    (void) ccnl;
+
+    for (qlen = 0, bpt = f->outq; bpt; bpt = bpt->next, qlen++);
+
+    if (json) {
+        ccnl_http_printf(b, "{\"id\":%d,\"if\":%d,\"peer\":", f->faceid, f->ifndx);
+        ccnl_http_str(b, ccnl_addr2ascii(&f->peer), 1);
+        if (fixed)
+            ccnl_http_printf(b, ",\"static\":true,\"ttl\":null");
+        else
+            ccnl_http_printf(b, ",\"static\":false,\"ttl\":%.1f", ttl);
+        ccnl_http_printf(b, ",\"qlen\":%d,\"mtu\":%d", qlen, f->mtu);
+#ifdef USE_STATS
+        {
+            size_t k;
+            for (k = 0; k < sizeof(ccnl_face_metrics) / sizeof(ccnl_face_metrics[0]); k++) {
+                ccnl_http_printf(b, ",\"%s\":%llu", ccnl_face_metrics[k].name,
+                                 (unsigned long long) ccnl_face_stat(f, k));
+            }
+        }
+#endif
+        ccnl_http_printf(b, "}");
+        return;
+    }
+
+    ccnl_http_printf(b, "<li><strong>f%d</strong> (via i%d) &nbsp;"
+                     "peer=<font face=courier>", f->faceid, f->ifndx);
+    ccnl_http_str(b, ccnl_addr2ascii(&f->peer), 0);
+    ccnl_http_printf(b, "</font> &nbsp;ttl=");
+    if (fixed)
+        ccnl_http_printf(b, "static");
+    else
+        ccnl_http_printf(b, "%.1fsec", ttl);
+    ccnl_http_printf(b, " &nbsp;qlen=%d", qlen);
+    if (f->mtu)
+        ccnl_http_printf(b, " &nbsp;mtu=%d", f->mtu);
+#ifdef USE_STATS
+    ccnl_http_printf(b, " &nbsp;in=%llu/%llu &nbsp;out=%llu/%llu",
+                     (unsigned long long) f->stats.interests_in,
+                     (unsigned long long) f->stats.data_in,
+                     (unsigned long long) f->stats.interests_out,
+                     (unsigned long long) f->stats.data_out);
+#endif
+    ccnl_http_printf(b, "\n");
+}
+
+static void*
+ccnl_http_ifs_first(struct ccnl_relay_s *ccnl)
+{
+    return ccnl->ifcount > 0 ? ccnl->ifs : NULL;
+}
+
+static void*
+ccnl_http_ifs_next(struct ccnl_relay_s *ccnl, void *row)
+{
+    struct ccnl_if_s *ifc = (struct ccnl_if_s *) row + 1;
+
+    return ifc < ccnl->ifs + ccnl->ifcount ? ifc : NULL;
+}
+
+static void
+ccnl_http_ifs_row(struct ccnl_relay_s *ccnl, void *row, int json,
+                  struct ccnl_http_buf_s *b)
+{
+    struct ccnl_if_s *ifc = (struct ccnl_if_s *) row;
+    int i = (int) (ifc - ccnl->ifs);
+
+    if (json) {
+        ccnl_http_printf(b, "{\"if\":%d,\"addr\":", i);
+        ccnl_http_str(b, ccnl_addr2ascii(&ifc->addr), 1);
+        ccnl_http_printf(b, ",\"qlen\":%zu,\"mtu\":%u", ifc->qlen, ifc->mtu);
+#ifdef USE_STATS
+        ccnl_http_printf(b, ",\"rx\":%u,\"tx\":%u", ifc->rx_cnt, ifc->tx_cnt);
+#endif
+        ccnl_http_printf(b, "}");
+        return;
+    }
+
+    ccnl_http_printf(b, "<li><strong>i%d</strong>&nbsp;&nbsp;"
+                     "addr=<font face=courier>", i);
+    ccnl_http_str(b, ccnl_addr2ascii(&ifc->addr), 0);
+    ccnl_http_printf(b, "</font>&nbsp;&nbsp;qlen=%zu/%d",
+                     ifc->qlen, CCNL_MAX_IF_QLEN);
+#ifdef USE_STATS
+    ccnl_http_printf(b, "&nbsp;&nbsp;rx=%u&nbsp;&nbsp;tx=%u",
+                     ifc->rx_cnt, ifc->tx_cnt);
+#endif
+    ccnl_http_printf(b, "\n");
+}
+
+static void*
+ccnl_http_pit_first(struct ccnl_relay_s *ccnl)
+{
+    return ccnl->pit;
+}
+
+static void*
+ccnl_http_pit_next(struct ccnl_relay_s *ccnl, void *row)
+{
+    (void) ccnl;
+    return ((struct ccnl_interest_s *) row)->next;
+}
+
+static void
+ccnl_http_pit_row(struct ccnl_relay_s *ccnl, void *row, int json,
+                  struct ccnl_http_buf_s *b)
+{
+    struct ccnl_interest_s *i = (struct ccnl_interest_s *) row;
+    char s[CCNL_MAX_PREFIX_SIZE];
+    int cnt = i->pendcnt;
+    (void) ccnl;
+
+    ccnl_http_prefix(i->pkt ? i->pkt->pfx : NULL, s);
+
+    if (json) {
+        ccnl_http_printf(b, "{\"name\":");
+        ccnl_http_str(b, s, 1);
+        ccnl_http_printf(b, ",\"from\":%d,\"pending\":%d,\"retries\":%d,"
+                         "\"lifetime\":%u}", i->from ? i->from->faceid : -1,
+                         cnt, i->retries, i->lifetime);
+        return;
+    }
+
+    ccnl_http_printf(b, "<li><font face=courier>");
+    ccnl_http_str(b, s, 0);
+    ccnl_http_printf(b, "</font> &nbsp;from=f%d &nbsp;pending=%d"
+                     " &nbsp;retries=%d &nbsp;lifetime=%u\n",
+                     i->from ? i->from->faceid : -1, cnt, i->retries,
+                     i->lifetime);
+}
+
+static void*
+ccnl_http_cs_first(struct ccnl_relay_s *ccnl)
+{
+    return ccnl->contents;
+}
+
+static void*
+ccnl_http_cs_next(struct ccnl_relay_s *ccnl, void *row)
+{
+    (void) ccnl;
+    return ((struct ccnl_content_s *) row)->next;
+}
+
+static void
+ccnl_http_cs_row(struct ccnl_relay_s *ccnl, void *row, int json,
+                 struct ccnl_http_buf_s *b)
+{
+    struct ccnl_content_s *c = (struct ccnl_content_s *) row;
+    char s[CCNL_MAX_PREFIX_SIZE];
+    int fixed = c->flags & CCNL_CONTENT_FLAGS_STATIC;
+    (void) ccnl;
+
+    ccnl_http_prefix(c->pkt ? c->pkt->pfx : NULL, s);
+
+    if (json) {
+        ccnl_http_printf(b, "{\"name\":");
+        ccnl_http_str(b, s, 1);
+        ccnl_http_printf(b, ",\"served\":%d,\"idle\":%.1f,\"static\":%s}",
+                         c->served_cnt, CCNL_NOW() - c->last_used,
+                         fixed ? "true" : "false");
+        return;
+    }
+
+    ccnl_http_printf(b, "<li><font face=courier>");
+    ccnl_http_str(b, s, 0);
+    ccnl_http_printf(b, "</font> &nbsp;served=%d &nbsp;idle=%.1fsec%s\n",
+                     c->served_cnt, CCNL_NOW() - c->last_used,
+                     fixed ? " &nbsp;static" : "");
+}
+
+static const struct {
+    const char *name, *title;
+    void* (*first)(struct ccnl_relay_s *ccnl);
+    void* (*next)(struct ccnl_relay_s *ccnl, void *row);
+    void (*row)(struct ccnl_relay_s *ccnl, void *row, int json,
+                struct ccnl_http_buf_s *b);
+} ccnl_http_tables[CCNL_HTTP_TABLES] = {
+    { "fib", "Forwarding table",
+      ccnl_http_fib_first, ccnl_http_fib_next, ccnl_http_fib_row },
+    { "faces", "Faces",
+      ccnl_http_faces_first, ccnl_http_faces_next, ccnl_http_faces_row },
+    { "ifs", "Interfaces",
+      ccnl_http_ifs_first, ccnl_http_ifs_next, ccnl_http_ifs_row },
+    { "pit", "Pending interests",
+      ccnl_http_pit_first, ccnl_http_pit_next, ccnl_http_pit_row },
+    { "cs", "Content store",
+      ccnl_http_cs_first, ccnl_http_cs_next, ccnl_http_cs_row },
+};
+
+void
+ccnl_http_unlinked(struct ccnl_relay_s *ccnl, void *entry, void *next)
+{
+    int i;
+
+    if (!ccnl->http)
+        return;
+    for (i = 0; i < CCNL_HTTP_CLIENTS; i++) {
+        struct ccnl_http_conn_s *c = ccnl->http->conn + i;
+        if (c->busy && c->row == entry)
+            c->row = next;
+    }
+}
+
+// ----------------------------------------------------------------------
+// the parts of a page
+
+static void
+ccnl_http_head(struct ccnl_relay_s *ccnl, struct ccnl_http_buf_s *b)
+{
+    time_t t;
+    char *cp;
+
+    ccnl_http_printf(b, "<html><head><title>ccn-lite-relay status</title>\n"
+                     "<style type=\"text/css\">\n"
+                     "body {font-family: sans-serif;}\n"
+                     "</style>\n"
+                     "</head><body>\n");
+    ccnl_http_printf(b, "\n<table borders=0>\n<tr><td>"
+                     "<a href=\"/\">[refresh]</a>&nbsp;&nbsp;<td>"
+                     "ccn-lite-relay Status Page &nbsp;&nbsp;");
+    t = time(NULL);
+    cp = ctime(&t);
+    cp[strlen(cp)-1] = 0;
+    ccnl_http_printf(b, "<tr><td><td><font size=-1>%s &nbsp;&nbsp;", cp);
+    cp = ctime(&ccnl->startup_time);
+    cp[strlen(cp)-1] = 0;
+    ccnl_http_printf(b, " (started %s)</font>\n</table>\n", cp);
+}
+
+static void
+ccnl_http_misc(struct ccnl_relay_s *ccnl, struct ccnl_http_buf_s *b)
+{
+    struct ccnl_buf_s *bpt;
+    char policy[32];
+    int cnt;
+
+    ccnl_http_printf(b, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
+                     "<tr><td><em>Misc stats</em></table><ul>\n");
+    for (cnt = 0, bpt = ccnl->nonces; bpt; bpt = bpt->next, cnt++);
+    ccnl_http_printf(b, "<li>Nonces: %d\n", cnt);
+    ccnl_http_printf(b, "<li>Pending interests: %d\n", ccnl->pitcnt);
+    ccnl_http_printf(b, "<li>Content chunks: %d (max=%d)\n",
+                     ccnl->contentcnt, ccnl->max_cache_entries);
+    ccnl_http_printf(b, "<li>Admission policy: %s\n",
+                     ccnl_admit_str(ccnl, policy, sizeof(policy)));
+    ccnl_http_printf(b, "</ul>\n");
+
+    ccnl_http_printf(b, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
+                     "<tr><td><em>Config</em></table><table borders=0>\n");
+    ccnl_http_printf(b, "<tr><td>content.timeout:"
+                     "<td align=right> %d<td>\n", CCNL_CONTENT_TIMEOUT);
+    ccnl_http_printf(b, "<tr><td>face.timeout:"
+                     "<td align=right> %d<td>\n", CCNL_FACE_TIMEOUT);
+    ccnl_http_printf(b, "<tr><td>interest.maxretransmit:"
+                     "<td align=right> %d<td>\n", CCNL_MAX_INTEREST_RETRANSMIT);
+    ccnl_http_printf(b, "<tr><td>interest.timeout:"
+                     "<td align=right> %d<td>\n", CCNL_INTEREST_TIMEOUT);
+    ccnl_http_printf(b, "<tr><td>nonces.max:"
+                     "<td align=right> %d<td>\n", CCNL_MAX_NONCES);
+    ccnl_http_printf(b, "<tr><td>compile.time:"
+                     "<td><td>%s %s\n", __DATE__, __TIME__);
+    ccnl_http_printf(b, "<tr><td>compile.ccnl_core_version:"
+                     "<td><td>%s\n", CCNL_VERSION);
+    ccnl_http_printf(b, "</table>\n");
+}
+
+// writes rows of table t until the buffer or the row budget is used up,
+// returns 1 when the table is complete
+static int
+ccnl_http_table(struct ccnl_relay_s *ccnl, struct ccnl_http_conn_s *c, int t,
+                struct ccnl_http_buf_s *b, int *rows, int *skips)
+{
+    size_t mark = b->len;
+
+    if (!c->tablestate) {
+        if (c->json)
+            ccnl_http_printf(b, "{\"table\":\"%s\",\"start\":%d,\"rows\":[",
+                             ccnl_http_tables[t].name, c->start);
+        else
+            ccnl_http_printf(b, "\n<p><table borders=0 width=100%% "
+                             "bgcolor=#e0e0ff><tr><td><em>%s</em></table><ul>\n",
+                             ccnl_http_tables[t].title);
+        if (b->full) {
+            b->len = mark;
+            return 0;
+        }
+        c->row = ccnl_http_tables[t].first(ccnl);
+        c->rowno = 0;
+        c->skip = c->start;
+        c->left = c->limit;
+        c->tablestate = 1;
+    }
+
+    while (c->row && c->skip > 0) {
+        if ((*skips)++ >= CCNL_HTTP_SKIPS)
+            return 0;
+        c->row = ccnl_http_tables[t].next(ccnl, c->row);
+        c->rowno++;
+        c->skip--;
+    }
+    while (c->row && c->left > 0) {
+        if (*rows >= CCNL_HTTP_ROWS)
+            return 0;
+        mark = b->len;
+        if (c->json && c->left < c->limit)
+            ccnl_http_printf(b, ",");
+        ccnl_http_tables[t].row(ccnl, c->row, c->json, b);
+        if (b->full) {
+            b->len = mark;
+            if (mark)
+                return 0;
+            // does not even fit alone
+            b->full = 0;
+            if (c->json)
+                ccnl_http_printf(b, "%snull", c->left < c->limit ? "," : "");
+        }
+        (*rows)++;
+        c->row = ccnl_http_tables[t].next(ccnl, c->row);
+        c->rowno++;
+        c->left--;
+    }
+
+    mark = b->len;
+    if (c->json) {
+        if (c->row)
+            ccnl_http_printf(b, "],\"next\":%d}\n", c->rowno);
+        else
+            ccnl_http_printf(b, "],\"next\":null}\n");
+    } else {
+        if (c->row)
+            ccnl_http_printf(b, "<li><a href=\"/html/%s?start=%d&amp;limit=%d\">"
+                             "more</a>\n", ccnl_http_tables[t].name,
+                             c->rowno, c->limit);
+        ccnl_http_printf(b, "</ul>\n");
+    }
+    if (b->full) {
+        b->len = mark;
+        return 0;
+    }
+    c->tablestate = 0;
+    return 1;
+}
+
+void
+ccnl_http_produce(struct ccnl_relay_s *ccnl, struct ccnl_http_conn_s *c)
+{
+    struct ccnl_http_buf_s b;
+    int rows = 0, skips = 0;
+    char frame[CCNL_HTTP_FRAME];
+    int n;
+
+    if (!c->busy || c->outlen > 0)
+        return;
+
+    if (!c->hdrsent) {
+        n = snprintf(c->obuf, sizeof(c->obuf),
+                     "HTTP/1.1 200 OK\r\n"
+                     "Content-Type: %s\r\n"
+                     "%s"
+                     "Connection: %s\r\n\r\n",
+                     c->json ? "application/json" : "text/html; charset=utf-8",
+                     c->chunked ? "Transfer-Encoding: chunked\r\n" : "",
+                     c->keepalive ? "keep-alive" : "close");
+        c->out = (unsigned char*) c->obuf;
+        c->outoffs = 0;
+        c->outlen = n;
+        c->hdrsent = 1;
+        return;
+    }
+
+    // room for the chunk size before and "\r\n0\r\n\r\n" after the body
+    b.buf = c->obuf + CCNL_HTTP_FRAME;
+    b.size = sizeof(c->obuf) - CCNL_HTTP_FRAME - 8;
+    b.len = 0;
+    b.full = 0;
+    b.buf[0] = '\0';
+
+    while (c->part < c->npart && !b.full && rows < CCNL_HTTP_ROWS) {
+        int p = c->parts[c->part];
+        size_t mark = b.len;
+
+        if (p >= CCNL_HTTP_P_TABLE) {
+            if (!ccnl_http_table(ccnl, c, p - CCNL_HTTP_P_TABLE, &b,
+                                 &rows, &skips))
+                break;
+        } else {
+            if (p == CCNL_HTTP_P_HEAD)
+                ccnl_http_head(ccnl, &b);
+            else if (p == CCNL_HTTP_P_MISC)
+                ccnl_http_misc(ccnl, &b);
+            else
+                ccnl_http_printf(&b, "\n<p><hr></body></html>\n");
+            if (b.full && mark) {
+                b.len = mark;
+                break;
+            }
+        }
+        c->part++;
+    }
+    if (c->part >= c->npart)
+        c->busy = 0;
+
+    c->out = (unsigned char*) b.buf;
+    if (c->chunked) {
+        if (b.len > 0) {
+            n = snprintf(frame, sizeof(frame), "%zx\r\n", b.len);
+            c->out -= n;
+            memcpy(c->out, frame, n);
+            memcpy(b.buf + b.len, "\r\n", 2);
+            b.len += n + 2;
+        }
+        if (!c->busy) {
+            memcpy(c->out + b.len, "0\r\n\r\n", 5);
+            b.len += 5;
+        }
+    }
+    c->outoffs = 0;
+    c->outlen = (int) b.len;
+}
+
+// a response with a short text body, sent at once
+static void
+ccnl_http_error(struct ccnl_http_conn_s *c, int code, const char *reason)
+{
+    char body[64];
+    int n;
+
+    n = snprintf(body, sizeof(body), "%d %s\n", code, reason);
+    n = snprintf(c->obuf, sizeof(c->obuf),
+                 "HTTP/1.1 %d %s\r\n"
+                 "%s"
+                 "Content-Type: text/plain\r\n"
+                 "Content-Length: %d\r\n"
+                 "Connection: %s\r\n\r\n%s",
+                 code, reason, code == 405 ? "Allow: GET\r\n" : "", n,
+                 c->keepalive ? "keep-alive" : "close", body);
+    c->out = (unsigned char*) c->obuf;
+    c->outoffs = 0;
+    c->outlen = n;
+    c->hdrsent = 1;
+    c->busy = 0;
+}
+
+#ifdef USE_STATS
+
+// ----------------------------------------------------------------------
+// Prometheus text format
+
+// a label value: quote, backslash and newline are escaped, other bytes
+// that are not printable ASCII are written as %XX
+static char*
+ccnl_metrics_label(const char *in, char *out, size_t outlen)
+{
+    size_t len = 0;
+
+    for (; *in && len + 4 < outlen; in++) {
+        unsigned char ch = (unsigned char) *in;
+
+        if (ch == '"' || ch == '\\') {
+            out[len++] = '\\';
+            out[len++] = (char) ch;
+        } else if (ch == '\n') {
+            out[len++] = '\\';
+            out[len++] = 'n';
+        } else if (ch < 0x20 || ch > 0x7e) {
+            len += (size_t) snprintf(out + len, outlen - len, "%%%02X", ch);
+        } else {
+            out[len++] = (char) ch;
+        }
+    }
+    out[len] = '\0';
+    return out;
+}
+
+static const char *ccnl_drop_reasons[CCNL_DROP_REASONS] = {
+    "dupnonce", "unsolicited", "hoplimit", "malformed", "queue", "send"
+};
+
+#ifdef USE_HISTOGRAMS
+static void
+ccnl_metrics_summary(struct ccnl_http_buf_s *b, const char *metric,
+                     const char *label, const char *value,
+                     const struct ccnl_histo_s *h)
+{
+    static const double q[] = { 0.5, 0.9, 0.99, 0.999 };
+    size_t k;
+
+    for (k = 0; k < sizeof(q) / sizeof(q[0]); k++) {
+        ccnl_http_printf(b, "%s{%s=\"%s\",quantile=\"%g\"} %g\n",
+                         metric, label, value, q[k],
+                         (double) ccnl_histo_quantile(h, q[k]) / 1e9);
+    }
+    ccnl_http_printf(b, "%s_sum{%s=\"%s\"} %g\n", metric, label, value,
+                     (double) h->sum / 1e9);
+    ccnl_http_printf(b, "%s_count{%s=\"%s\"} %llu\n", metric, label, value,
+                     (unsigned long long) h->count);
+}
+#endif
+
+size_t
+ccnl_http_metrics(struct ccnl_relay_s *ccnl, char *buf, size_t buflen)
+{
+    struct ccnl_http_buf_s mb = { buf, 0, buflen, 0 }, *b = &mb;
+    struct ccnl_face_s *f;
+    struct ccnl_forward_s *fwd;
+    struct ccnl_buf_s *bpt;
+    char s[CCNL_MAX_PREFIX_SIZE], label[2 * CCNL_MAX_PREFIX_SIZE];
+    size_t k;
+    int i, j;
+
+    buf[0] = '\0';
+    ccnl_http_printf(b, "# TYPE ccnl_face_info gauge\n");
+    for (f = ccnl->faces; f; f = f->next) {
+        ccnl_http_printf(b, "ccnl_face_info{face=\"%d\",if=\"%d\",peer=\"%s\"} 1\n",
+                         f->faceid, f->ifndx,
+                         ccnl_metrics_label(ccnl_addr2ascii(&f->peer),
+                                            label, sizeof(label)));
+    }
+    for (k = 0; k < sizeof(ccnl_face_metrics) / sizeof(ccnl_face_metrics[0]); k++) {
+        ccnl_http_printf(b, "# TYPE ccnl_face_%s_total counter\n",
+                         ccnl_face_metrics[k].name);
+        for (f = ccnl->faces; f; f = f->next) {
+            ccnl_http_printf(b, "ccnl_face_%s_total{face=\"%d\"} %llu\n",
+                             ccnl_face_metrics[k].name, f->faceid,
+                             (unsigned long long) ccnl_face_stat(f, k));
+        }
+    }
+    ccnl_http_printf(b, "# TYPE ccnl_face_drops_total counter\n");
+    for (f = ccnl->faces; f; f = f->next) {
+        for (j = 0; j < CCNL_DROP_REASONS; j++) {
+            ccnl_http_printf(b, "ccnl_face_drops_total{face=\"%d\",reason=\"%s\"} %llu\n",
+                             f->faceid, ccnl_drop_reasons[j],
+                             (unsigned long long) f->stats.drops[j]);
+        }
+    }
+    ccnl_http_printf(b, "# TYPE ccnl_face_queue_length gauge\n");
+    for (f = ccnl->faces; f; f = f->next) {
+        for (j = 0, bpt = f->outq; bpt; bpt = bpt->next, j++);
+        ccnl_http_printf(b, "ccnl_face_queue_length{face=\"%d\"} %d\n",
+                         f->faceid, j);
+    }
+
+    ccnl_http_printf(b, "# TYPE ccnl_fib_interests_total counter\n");
+    for (fwd = ccnl->fib; fwd; fwd = fwd->next) {
+        ccnl_http_printf(b, "ccnl_fib_interests_total{prefix=\"%s\",face=\"%d\"} %llu\n",
+                         ccnl_metrics_label(ccnl_http_prefix(fwd->prefix, s),
+                                            label, sizeof(label)),
+                         fwd->face ? fwd->face->faceid : -1,
+                         (unsigned long long) fwd->interests);
+    }
+    ccnl_http_printf(b, "# TYPE ccnl_fib_bytes_total counter\n");
+    for (fwd = ccnl->fib; fwd; fwd = fwd->next) {
+        ccnl_http_printf(b, "ccnl_fib_bytes_total{prefix=\"%s\",face=\"%d\"} %llu\n",
+                         ccnl_metrics_label(ccnl_http_prefix(fwd->prefix, s),
+                                            label, sizeof(label)),
+                         fwd->face ? fwd->face->faceid : -1,
+                         (unsigned long long) fwd->bytes);
+    }
+
+    ccnl_http_printf(b, "# TYPE ccnl_if_rx_packets_total counter\n");
+    for (i = 0; i < ccnl->ifcount; i++) {
+        ccnl_http_printf(b, "ccnl_if_rx_packets_total{if=\"%d\"} %u\n",
+                         i, ccnl->ifs[i].rx_cnt);
+    }
+    ccnl_http_printf(b, "# TYPE ccnl_if_tx_packets_total counter\n");
+    for (i = 0; i < ccnl->ifcount; i++) {
+        ccnl_http_printf(b, "ccnl_if_tx_packets_total{if=\"%d\"} %u\n",
+                         i, ccnl->ifs[i].tx_cnt);
+    }
+    ccnl_http_printf(b, "# TYPE ccnl_if_queue_length gauge\n");
+    for (i = 0; i < ccnl->ifcount; i++) {
+        ccnl_http_printf(b, "ccnl_if_queue_length{if=\"%d\"} %zu\n",
+                         i, ccnl->ifs[i].qlen);
+    }
+
+    ccnl_http_printf(b, "# TYPE ccnl_pit_entries gauge\n"
+                     "ccnl_pit_entries %d\n", ccnl->pitcnt);
+    ccnl_http_printf(b, "# TYPE ccnl_cs_entries gauge\n"
+                     "ccnl_cs_entries %d\n", ccnl->contentcnt);
+    if (ccnl->admit) {
+        ccnl_admit_str(ccnl, s, sizeof(s));
+        ccnl_http_printf(b, "# TYPE ccnl_cs_admission_total counter\n"
+                         "ccnl_cs_admission_total{policy=\"%s\",decision=\"admit\"} %llu\n"
+                         "ccnl_cs_admission_total{policy=\"%s\",decision=\"reject\"} %llu\n",
+                         s, (unsigned long long) ccnl->admit->admitted,
+                         s, (unsigned long long) ccnl->admit->rejected);
+    }
+
+#ifdef USE_HISTOGRAMS
+    {
+        struct ccnl_histo_s *h;
+        const char *name;
+
+        ccnl_http_printf(b, "# TYPE ccnl_stage_seconds summary\n");
+        for (i = 0; i < CCNL_HISTO_STAGES; i++) {
+            ccnl_metrics_summary(b, "ccnl_stage_seconds", "stage",
+                                 ccnl_histo_stagename[i], ccnl_histo_stage + i);
+        }
+        ccnl_http_printf(b, "# TYPE ccnl_satisfaction_seconds summary\n");
+        for (i = 0; (h = ccnl_histo_prefix(i, &name)); i++) {
+            ccnl_metrics_summary(b, "ccnl_satisfaction_seconds", "prefix",
+                                 ccnl_metrics_label(name, label, sizeof(label)), h);
+        }
+    }
+#endif
+
+    return mb.len;
+}
+
+// the counters are written at once, behind room for the headers
+static void
+ccnl_http_sendmetrics(struct ccnl_relay_s *ccnl, struct ccnl_http_conn_s *c)
+{
+    char hdr[256];
+    size_t len;
+    int n;
+
+    c->metrics = ccnl_malloc(CCNL_HTTP_METRICS);
+    if (!c->metrics) {
+        ccnl_http_error(c, 503, "Service Unavailable");
+        return;
+    }
+    len = ccnl_http_metrics(ccnl, c->metrics + sizeof(hdr),
+                            CCNL_HTTP_METRICS - sizeof(hdr));
+    n = snprintf(hdr, sizeof(hdr),
+                 "HTTP/1.1 200 OK\r\n"
+                 "Content-Type: text/plain; version=0.0.4\r\n"
+                 "Content-Length: %zu\r\n"
+                 "Connection: %s\r\n\r\n",
+                 len, c->keepalive ? "keep-alive" : "close");
+    c->out = (unsigned char*) c->metrics + sizeof(hdr) - n;
+    memcpy(c->out, hdr, n);
+    c->outoffs = 0;
+    c->outlen = (int) len + n;
+    c->hdrsent = 1;
+    c->busy = 0;
+}
+
+#endif // USE_STATS
+
+// ----------------------------------------------------------------------
+
+static int
+ccnl_http_hasprefix(const char *s, const char *prefix)
+{
+    for (; *prefix; s++, prefix++) {
+        if (tolower((unsigned char) *s) != *prefix)
+            return 0;
+    }
+    return 1;
+}
+
+// the length of the request head in c->in, 0 if it is not complete
+static int
+ccnl_http_reqlen(struct ccnl_http_conn_s *c)
+{
+    int i;
+
+    for (i = 0; i + 3 < c->inlen; i++) {
+        if (!memcmp(c->in + i, "\r\n\r\n", 4))
+            return i + 4;
+    }
+    return 0;
+}
+
+int
+ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_conn_s *c)
+{
+    char *req = (char*) c->in, *path, *query, *cp;
+    int reqlen = ccnl_http_reqlen(c), t;
+    (void) ccnl;
+
+    if (!reqlen) {
+        if ((size_t) c->inlen >= sizeof(c->in) - 1) {
+            c->keepalive = 0;
+            c->inlen = 0;
+            ccnl_http_error(c, 431, "Request Header Fields Too Large");
+            return 0;
+        }
+        return -1;
+    }
+    req[reqlen - 1] = '\0';
+
+    // HTTP/1.1 keeps the connection and sends the body in chunks
+    path = strchr(req, ' ');
+    cp = path ? strchr(path + 1, ' ') : NULL;
+    c->keepalive = cp && !strncmp(cp + 1, "HTTP/1.1", 8);
+    c->chunked = c->keepalive;
+    for (cp = strchr(req, '\n'); cp; cp = strchr(cp, '\n')) {
+        cp++;
+        if (ccnl_http_hasprefix(cp, "connection:") &&
+            ccnl_http_hasprefix(cp + 11 + strspn(cp + 11, " \t"), "close"))
+            c->keepalive = 0;
+    }
+
+    c->busy = 1;
+    c->hdrsent = 0;
+    c->part = c->npart = 0;
+    c->json = 0;
+    c->tablestate = 0;
+    c->row = NULL;
+    c->start = 0;
+    c->limit = CCNL_HTTP_PAGE;
+    c->out = (unsigned char*) c->obuf;
+    c->outoffs = c->outlen = 0;
+
+    if (!path || strncmp(req, "GET ", 4)) {
+        ccnl_http_error(c, 405, "Method Not Allowed");
+        goto done;
+    }
+    path++;
+    path[strcspn(path, " \r\n")] = '\0';
+    query = strchr(path, '?');
+    if (query) {
+        *query++ = '\0';
+        for (cp = strtok(query, "&"); cp; cp = strtok(NULL, "&")) {
+            if (!strncmp(cp, "start=", 6))
+                c->start = atoi(cp + 6);
+            else if (!strncmp(cp, "limit=", 6))
+                c->limit = atoi(cp + 6);
+        }
+        if (c->start < 0)
+            c->start = 0;
+        if (c->limit < 1 || c->limit > CCNL_HTTP_MAXPAGE)
+            c->limit = c->limit < 1 ? 1 : CCNL_HTTP_MAXPAGE;
+    }
+
+    if (!strcmp(path, "/")) {
+        c->parts[c->npart++] = CCNL_HTTP_P_HEAD;
+        c->parts[c->npart++] = CCNL_HTTP_P_TABLE + CCNL_HTTP_T_FIB;
+        c->parts[c->npart++] = CCNL_HTTP_P_TABLE + CCNL_HTTP_T_FACES;
+        c->parts[c->npart++] = CCNL_HTTP_P_TABLE + CCNL_HTTP_T_IFS;
+        c->parts[c->npart++] = CCNL_HTTP_P_MISC;
+        c->parts[c->npart++] = CCNL_HTTP_P_TAIL;
+        goto done;
+    }
+#ifdef USE_STATS
+    if (!strcmp(path, "/metrics")) {
+        ccnl_http_sendmetrics(ccnl, c);
+        goto done;
+    }
+#endif
+    if (!strncmp(path, "/html/", 6) || !strncmp(path, "/json/", 6)) {
+        c->json = path[1] == 'j';
+        for (t = 0; t < CCNL_HTTP_TABLES; t++) {
+            if (!strcmp(path + 6, ccnl_http_tables[t].name))
+                break;
+        }
+        if (t < CCNL_HTTP_TABLES) {
+            if (!c->json)
+                c->parts[c->npart++] = CCNL_HTTP_P_HEAD;
+            c->parts[c->npart++] = CCNL_HTTP_P_TABLE + t;
+            if (!c->json)
+                c->parts[c->npart++] = CCNL_HTTP_P_TAIL;
+            goto done;
+        }
+    }
+    ccnl_http_error(c, 404, "Not Found");
+
+done:
+    // keep what the client sent after this request
+    c->inlen -= reqlen;
+    memmove(c->in, c->in + reqlen, c->inlen);
+    c->in[c->inlen] = 0;
+    return 0;
+}
+
 // ----------------------------------------------------------------------
 
 struct ccnl_http_s*
@@ -53,7 +1032,7 @@ ccnl_http_new(struct ccnl_relay_s *ccnl, int serverport)
         DEBUGMSG(INFO, "could not bind socket for http server\n");
         return NULL;
     }
-    listen(s, 2);
+    listen(s, CCNL_HTTP_CLIENTS);
 
     http = (struct ccnl_http_s*) ccnl_calloc(1, sizeof(*http));
     if (!http) {
@@ -67,16 +1046,34 @@ ccnl_http_new(struct ccnl_relay_s *ccnl, int serverport)
     return http;
 }
 
+static void
+ccnl_http_close(struct ccnl_http_conn_s *c)
+{
+    close(c->client);
+    c->client = 0;
+    c->busy = 0;
+    c->row = NULL;
+    c->out = NULL;
+    c->outlen = 0;
+    if (c->metrics) {
+        ccnl_free(c->metrics);
+        c->metrics = NULL;
+    }
+}
 
 struct ccnl_http_s*
 ccnl_http_cleanup(struct ccnl_http_s *http)
 {
+    int i;
+
     if (!http)
         return NULL;
     if (http->server)
         close(http->server);
-    if (http->client)
-        close(http->client);
+    for (i = 0; i < CCNL_HTTP_CLIENTS; i++) {
+        if (http->conn[i].client)
+            ccnl_http_close(http->conn + i);
+    }
     ccnl_free(http);
     return NULL;
 }
@@ -86,20 +1083,28 @@ int
 ccnl_http_anteselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
                      fd_set *readfs, fd_set *writefs, int *maxfd)
 {
+    int i, listening = 0;
     (void) ccnl;
+
     if (!http)
         return -1;
-    if (!http->client) {
+    for (i = 0; i < CCNL_HTTP_CLIENTS; i++) {
+        struct ccnl_http_conn_s *c = http->conn + i;
+        if (!c->client) {
+            listening = 1;
+            continue;
+        }
+        if ((unsigned long)c->inlen < sizeof(c->in) - 1)
+            FD_SET(c->client, readfs);
+        if (c->busy || c->outlen > 0)
+            FD_SET(c->client, writefs);
+        if (*maxfd <= c->client)
+            *maxfd = c->client + 1;
+    }
+    if (listening) {
         FD_SET(http->server, readfs);
         if (*maxfd <= http->server)
             *maxfd = http->server + 1;
-    } else {
-        if ((unsigned long)http->inlen < sizeof(http->in))
-            FD_SET(http->client, readfs);
-        if (http->outlen > 0)
-            FD_SET(http->client, writefs);
-        if (*maxfd <= http->client)
-            *maxfd = http->client + 1;
     }
     return 0;
 }
@@ -109,243 +1114,92 @@ int
 ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
                      fd_set *readfs, fd_set *writefs)
 {
+    int i, len;
+    double now = CCNL_NOW();
+    (void) writefs;
+
     if (!http)
         return -1;
-    // accept only one client at the time:
-    if (!http->client && FD_ISSET(http->server, readfs)) {
+    if (FD_ISSET(http->server, readfs)) {
         struct sockaddr_in peer;
-        socklen_t len = sizeof(peer);
-        http->client = accept(http->server, (struct sockaddr*) &peer, &len);
-        if (http->client < 0)
-            http->client = 0;
-        else {
-            DEBUGMSG(INFO, "accepted web server client %s\n",
-                     ccnl_addr2ascii((sockunion*)&peer));
-            http->inlen = http->outlen = http->inoffs = http->outoffs = 0;
-        }
-    }
-    if (http->client && FD_ISSET(http->client, readfs)) {
-        int len = sizeof(http->in) - http->inlen - 1;
-        len = recv(http->client, http->in + http->inlen, len, 0);
-        if (len == 0) {
-            DEBUGMSG(INFO, "web client went away\n");
-            close(http->client);
-            http->client = 0;
-        } else if (len > 0) {
-            http->in[len] = 0;
-            ccnl_http_status(ccnl, http);
-        }
-    }
-    if (http->client && FD_ISSET(http->client, writefs) && http->out) {
-        int len = send(http->client, http->out + http->outoffs,
-                       http->outlen, 0);
-        if (len > 0) {
-            http->outlen -= len;
-            http->outoffs += len;
-            if (http->outlen == 0) {
-                close(http->client);
-                http->client = 0;
+        socklen_t plen = sizeof(peer);
+
+        for (i = 0; i < CCNL_HTTP_CLIENTS && http->conn[i].client; i++);
+        if (i < CCNL_HTTP_CLIENTS) {
+            struct ccnl_http_conn_s *c = http->conn + i;
+            int s = accept(http->server, (struct sockaddr*) &peer, &plen);
+            if (s > 0) {
+                DEBUGMSG(INFO, "accepted web server client %s\n",
+                         ccnl_addr2ascii((sockunion*)&peer));
+                fcntl(s, F_SETFL, fcntl(s, F_GETFL) | O_NONBLOCK);
+                c->client = s;
+                c->inlen = c->outlen = c->outoffs = 0;
+                c->out = NULL;
+                c->busy = 0;
+                c->last = now;
             }
         }
     }
-    return 0;
-}
 
-int
-ccnl_cmpfaceid(const void *a, const void *b)
-{
-    int aa = (*(struct ccnl_face_s**)a)->faceid;
-    int bb = (*(struct ccnl_face_s**)b)->faceid;
-    return  aa - bb;
-}
+    for (i = 0; i < CCNL_HTTP_CLIENTS; i++) {
+        struct ccnl_http_conn_s *c = http->conn + i;
+        if (!c->client)
+            continue;
 
-int
-ccnl_cmpfib(const void *a, const void *b)
-{
-    struct ccnl_prefix_s *p1 = (*(struct ccnl_forward_s**)a)->prefix;
-    struct ccnl_prefix_s *p2 = (*(struct ccnl_forward_s**)b)->prefix;
-    int r;
-    size_t len;
-    uint32_t i; //TODO: Is uint32_t correct here?
-    for (i = 0; ; i++) {
-        if (p1->compcnt <= i) {
-            return p2->compcnt <= i ? 0 : -1;
-        }
-        if (p2->compcnt <= i) {
-            return 1;
-        }
-        len = p1->complen[i];
-        if (len > p2->complen[i]) {
-            len = p2->complen[i];
-        }
-        r = memcmp(p1->comp[i], p2->comp[i], len);
-        if (r) {
-            return r;
-        }
-        if (p1->complen[i] > len) {
-            return 1;
-        }
-        if (p2->complen[i] > len) {
-            return -1;
+        if (FD_ISSET(c->client, readfs)) {
+            len = recv(c->client, c->in + c->inlen,
+                       sizeof(c->in) - c->inlen - 1, MSG_DONTWAIT);
+            if (len == 0 || (len < 0 && errno != EAGAIN &&
+                             errno != EWOULDBLOCK && errno != EINTR)) {
+                DEBUGMSG(INFO, "web client went away\n");
+                ccnl_http_close(c);
+                continue;
+            }
+            if (len > 0) {
+                c->inlen += len;
+                c->in[c->inlen] = 0;
+                c->last = now;
+            }
         }
-    }
-    return 0;
-}
 
-int
-ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
-{
-    static char txt[64000];
-    char *hdr =
-        "HTTP/1.1 200 OK\n\r"
-        "Content-Type: text/html; charset=utf-8\n\r"
-        "Connection: close\n\r\n\r", *cp;
-    size_t len = strlen(hdr);
-    int i, j, cnt;
-    time_t t;
-    //struct utsname uts;
-    struct ccnl_face_s *f;
-    struct ccnl_forward_s *fwd;
-    struct ccnl_interest_s *ipt;
-    struct ccnl_buf_s *bpt;
-    char s[CCNL_MAX_PREFIX_SIZE];
-
-    strcpy(txt, hdr);
-    len += snprintf(txt+len, sizeof(txt) - len,
-                   "<html><head><title>ccn-lite-relay status</title>\n"
-                   "<style type=\"text/css\">\n"
-                   "body {font-family: sans-serif;}\n"
-                   "</style>\n"
-                   "</head><body>\n");
-    len += snprintf(txt+len, sizeof(txt) - len, "\n<table borders=0>\n<tr><td>"
-                   "<a href=\"\">[refresh]</a>&nbsp;&nbsp;<td>"
-                   "ccn-lite-relay Status Page &nbsp;&nbsp;");
-    //uname(&uts);
-    //len += sprintf(txt+len, "node <strong>%s (%d)</strong>\n",
-    //               uts.nodename, getpid());
-    t = time(NULL);
-    cp = ctime(&t);
-    cp[strlen(cp)-1] = 0;
-    len += snprintf(txt+len, sizeof(txt) - len, "<tr><td><td><font size=-1>%s &nbsp;&nbsp;", cp);
-    cp = ctime(&ccnl->startup_time);
-    cp[strlen(cp)-1] = 0;
-    len += snprintf(txt+len, sizeof(txt) - len, " (started %s)</font>\n</table>\n", cp);
-
-    len += snprintf(txt+len, sizeof(txt) - len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
-                   "<tr><td><em>Forwarding table</em></table><ul>\n");
-    for (fwd = ccnl->fib, cnt = 0; fwd; fwd = fwd->next, cnt++);
-    if (cnt > 0) {
-        struct ccnl_forward_s **fwda;
-        fwda = (struct ccnl_forward_s**) ccnl_malloc(cnt * sizeof(fwd));
-        for (fwd = ccnl->fib, i = 0; fwd; fwd = fwd->next, i++)
-            fwda[i] = fwd;
-        qsort(fwda, cnt, sizeof(fwd), ccnl_cmpfib);
-        for (i = 0; i < cnt; i++) {
-            char fname[16];
-#ifdef USE_ECHO
-            if (fwda[i]->tap)
-                strcpy(fname, "'echoserver'");
-            else
-#endif
-            if(fwda[i]->face)
-                snprintf(fname, sizeof(fname), "f%d", fwda[i]->face->faceid);
-            else
-                sprintf(fname, "?");
-            len += snprintf(txt+len, sizeof(txt) - len,
-                           "<li>via %4s: <font face=courier>%s</font>\n",
-                           fname, ccnl_prefix_to_str(fwda[i]->prefix,s,CCNL_MAX_PREFIX_SIZE));
-        }
-        ccnl_free(fwda);
-    }
-    len += snprintf(txt+len, sizeof(txt) - len, "</ul>\n");
-
-    len += snprintf(txt+len, sizeof(txt) - len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
-                   "<tr><td><em>Faces</em></table><ul>\n");
-    for (f = ccnl->faces, cnt = 0; f; f = f->next, cnt++);
-    if (cnt > 0) {
-        struct ccnl_face_s **fa;
-        fa = (struct ccnl_face_s**) ccnl_malloc(cnt * sizeof(f));
-        for (f = ccnl->faces, i = 0; f; f = f->next, i++)
-            fa[i] = f;
-        qsort(fa, cnt, sizeof(f), ccnl_cmpfaceid);
-        for (i = 0; i < cnt; i++) {
-            len += snprintf(txt+len, sizeof(txt) - len,
-                           "<li><strong>f%d</strong> (via i%d) &nbsp;"
-                           "peer=<font face=courier>%s</font> &nbsp;ttl=",
-                           fa[i]->faceid, fa[i]->ifndx,
-                           ccnl_addr2ascii(&(fa[i]->peer)));
-            if (fa[i]->flags & CCNL_FACE_FLAGS_STATIC)
-                len += snprintf(txt+len, sizeof(txt) - len, "static");
-            else
-                len += snprintf(txt+len, sizeof(txt) - len, "%.1fsec",
-                        fa[i]->last_used + CCNL_FACE_TIMEOUT - CCNL_NOW());
-            for (j = 0, bpt = fa[i]->outq; bpt; bpt = bpt->next, j++);
-            len += snprintf(txt+len, sizeof(txt) - len, " &nbsp;qlen=%d\n", j);
+        if (!c->out)
+            ccnl_http_status(ccnl, c);
+        if (c->busy && c->outlen == 0)
+            ccnl_http_produce(ccnl, c);
+        if (c->outlen > 0) {
+            len = send(c->client, c->out + c->outoffs, c->outlen,
+                       MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+                errno != EINTR) {
+                ccnl_http_close(c);
+                continue;
+            }
+            if (len > 0) {
+                c->outlen -= len;
+                c->outoffs += len;
+                c->last = now;
+            }
         }
-        ccnl_free(fa);
-    }
-    len += snprintf(txt+len, sizeof(txt) - len, "</ul>\n");
 
-    len += snprintf(txt+len, sizeof(txt) - len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
-                   "<tr><td><em>Interfaces</em></table><ul>\n");
-    for (i = 0; i < ccnl->ifcount; i++) {
-#ifdef USE_STATS
-        len += snprintf(txt+len, sizeof(txt) - len, "<li><strong>i%d</strong>&nbsp;&nbsp;"
-                       "addr=<font face=courier>%s</font>&nbsp;&nbsp;"
-                       "qlen=%zu/%d"
-                       "&nbsp;&nbsp;rx=%u&nbsp;&nbsp;tx=%u"
-                       "\n",
-                       i, ccnl_addr2ascii(&ccnl->ifs[i].addr),
-                       ccnl->ifs[i].qlen, CCNL_MAX_IF_QLEN,
-                       ccnl->ifs[i].rx_cnt, ccnl->ifs[i].tx_cnt);
-#else
-        len += snprintf(txt+len, sizeof(txt) - len, "<li><strong>i%d</strong>&nbsp;&nbsp;"
-                       "addr=<font face=courier>%s</font>&nbsp;&nbsp;"
-                       "qlen=%d/%d"
-                       "\n",
-                       i, ccnl_addr2ascii(&ccnl->ifs[i].addr),
-                       ccnl->ifs[i].qlen, CCNL_MAX_IF_QLEN);
-#endif
+        if (c->out && !c->busy && c->outlen == 0) {
+            // the response is out
+            c->out = NULL;
+            if (c->metrics) {
+                ccnl_free(c->metrics);
+                c->metrics = NULL;
+            }
+            if (!c->keepalive) {
+                ccnl_http_close(c);
+                continue;
+            }
+            // a request that came along with the last one
+            ccnl_http_status(ccnl, c);
+        } else if (now - c->last > CCNL_HTTP_IDLE) {
+            // nothing came in, or a response did not move on
+            DEBUGMSG(DEBUG, "closing idle web client\n");
+            ccnl_http_close(c);
+        }
     }
-    len += snprintf(txt+len, sizeof(txt) - len, "</ul>\n");
-
-    len += snprintf(txt+len, sizeof(txt) - len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
-                   "<tr><td><em>Misc stats</em></table><ul>\n");
-    for (cnt = 0, bpt = ccnl->nonces; bpt; bpt = bpt->next, cnt++);
-    len += snprintf(txt+len, sizeof(txt) - len, "<li>Nonces: %d\n", cnt);
-    for (cnt = 0, ipt = ccnl->pit; ipt; ipt = ipt->next, cnt++);
-    len += snprintf(txt+len, sizeof(txt) - len, "<li>Pending interests: %d\n", cnt);
-    len += snprintf(txt+len, sizeof(txt) - len, "<li>Content chunks: %d (max=%d)\n",
-                   ccnl->contentcnt, ccnl->max_cache_entries);
-    len += snprintf(txt+len, sizeof(txt) - len, "</ul>\n");
-
-    len += snprintf(txt+len, sizeof(txt) - len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
-                   "<tr><td><em>Config</em></table><table borders=0>\n");
-    len += snprintf(txt+len, sizeof(txt) - len, "<tr><td>content.timeout:"
-                   "<td align=right> %d<td>\n", CCNL_CONTENT_TIMEOUT);
-    len += snprintf(txt+len, sizeof(txt) - len, "<tr><td>face.timeout:"
-                   "<td align=right> %d<td>\n", CCNL_FACE_TIMEOUT);
-    len += snprintf(txt+len, sizeof(txt) - len, "<tr><td>interest.maxretransmit:"
-                   "<td align=right> %d<td>\n", CCNL_MAX_INTEREST_RETRANSMIT);
-    len += snprintf(txt+len, sizeof(txt) - len, "<tr><td>interest.timeout:"
-                   "<td align=right> %d<td>\n", CCNL_INTEREST_TIMEOUT);
-    len += snprintf(txt+len, sizeof(txt) - len, "<tr><td>nonces.max:"
-                   "<td align=right> %d<td>\n", CCNL_MAX_NONCES);
-
-    //len += sprintf(txt+len, "<tr><td>compile.featureset:<td><td> %s\n",
-    //               compile_string);
-    len += snprintf(txt+len, sizeof(txt) - len, "<tr><td>compile.time:"
-                   "<td><td>%s %s\n", __DATE__, __TIME__);
-    len += snprintf(txt+len, sizeof(txt) - len, "<tr><td>compile.ccnl_core_version:"
-                   "<td><td>%s\n", CCNL_VERSION);
-    len += snprintf(txt+len, sizeof(txt) - len, "</table>\n");
-
-    len += snprintf(txt+len, sizeof(txt) - len, "\n<p><hr></body></html>\n");
-
-    http->out = (unsigned char*) txt;
-    http->outoffs = 0;
-    http->outlen = len;
-
     return 0;
 }
 
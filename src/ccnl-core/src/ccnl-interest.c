@@ -29,6 +29,7 @@
 #include "ccnl-prefix.h"
 #include "ccnl-logging.h"
 #include "ccnl-pkt-util.h"
+#include "ccnl-histo.h"
 #else
 #include <ccnl-relay.h>
 #include <ccnl-interest.h>
@@ -66,8 +67,13 @@ ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
     *pkt = NULL;
     i->from = from;
     i->last_used = CCNL_NOW();
+#ifdef USE_HISTOGRAMS
+    if (ccnl_histo_on) {
+        i->created = ccnl_histo_now();
+    }
+#endif
 
-    if (ccnl->pitcnt >= ccnl->max_pit_entries) {
+    if (ccnl->max_pit_entries >= 0 && ccnl->pitcnt >= ccnl->max_pit_entries) {
         ccnl_pkt_free(i->pkt);
         ccnl_free(i);
         return NULL;
@@ -76,6 +82,8 @@ ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
     DBL_LINKED_LIST_ADD(ccnl->pit, i);
 
     ccnl->pitcnt++;
+    i->namehash = ccnl_prefix_hash(i->pkt->pfx);
+    ccnl_interest_index(ccnl, i);
 
 #ifdef CCNL_RIOT
     ccnl_evtimer_reset_interest_retrans(i);
@@ -90,11 +98,12 @@ ccnl_interest_isSame(struct ccnl_interest_s *i, struct ccnl_pkt_s *pkt)
 {
     if (i) {
         if (pkt) {
-            if (i->pkt->pfx->suite != pkt->suite || ccnl_prefix_cmp(i->pkt->pfx, NULL, pkt->pfx, CMP_EXACT)) { 
+            if (CCNL_SUITE_OF(i->pkt->pfx->suite) != CCNL_SUITE_OF(pkt->suite) ||
+                ccnl_prefix_cmp(i->pkt->pfx, NULL, pkt->pfx, CMP_EXACT)) { 
                 return 0;
             }
             
-            switch (i->pkt->pfx->suite) {
+            switch (CCNL_SUITE_OF(i->pkt->pfx->suite)) {
 #ifdef USE_SUITE_CCNB
                 case CCNL_SUITE_CCNB: 
                     return i->pkt->s.ccnb.minsuffix == pkt->s.ccnb.minsuffix && i->pkt->s.ccnb.maxsuffix == pkt->s.ccnb.maxsuffix &&
@@ -125,37 +134,53 @@ ccnl_interest_isSame(struct ccnl_interest_s *i, struct ccnl_pkt_s *pkt)
 
 
 int
-ccnl_interest_append_pending(struct ccnl_interest_s *i,  struct ccnl_face_s *from)
+ccnl_interest_append_pending(struct ccnl_interest_s *i,  struct ccnl_face_s *from,
+                             int32_t nonce, uint32_t lifetime)
 {
     if (i) {
         DEBUGMSG_CORE(TRACE, "ccnl_append_pending\n");
         if (from) {
-            struct ccnl_pendint_s *pi, *last = NULL;
-            char s[CCNL_MAX_PREFIX_SIZE];
+            struct ccnl_pendint_s *pi;
+            uint32_t now = CCNL_NOW();
+            int k;
 
-            for (pi = i->pending; pi; pi = pi->next) { // check whether already listed
-                    if (pi->face == from) {
-                            DEBUGMSG_CORE(DEBUG, "  we found a matching interest, updating time\n");
-                            pi->last_used = CCNL_NOW();
-                            return 0;
-                    }
-                    last = pi;
+            for (k = 0; k < i->pendcnt; k++) { // check whether already listed
+                if (i->pending[k].face->faceid == from->faceid) {
+                    DEBUGMSG_CORE(DEBUG, "  we found a matching interest, updating time\n");
+                    break;
+                }
             }
-            pi = (struct ccnl_pendint_s *) ccnl_calloc(1,sizeof(struct ccnl_pendint_s));
-            if (!pi) {
-                    DEBUGMSG_CORE(DEBUG, "  no mem\n");
-                    return -1;
+            if (k == i->pendcnt) {
+                if (!i->pendsize) {
+                    i->pending = i->pendinline;
+                    i->pendsize = CCNL_PENDINT_INLINE;
+                }
+                if (i->pendcnt == i->pendsize) { // spill to the heap
+                    pi = (struct ccnl_pendint_s *) ccnl_malloc(2 * i->pendsize *
+                                                       sizeof(struct ccnl_pendint_s));
+                    if (!pi) {
+                        DEBUGMSG_CORE(DEBUG, "  no mem\n");
+                        return -1;
+                    }
+                    memcpy(pi, i->pending, i->pendcnt * sizeof(struct ccnl_pendint_s));
+                    if (i->pending != i->pendinline) {
+                        ccnl_free(i->pending);
+                    }
+                    i->pending = pi;
+                    i->pendsize *= 2;
+                }
+                DEBUGMSG_CORE(DEBUG, "  appending a new pendint entry %d for face %d\n",
+                              i->pendcnt, from->faceid);
+                i->pendcnt++;
             }
-
-            DEBUGMSG_CORE(DEBUG, "  appending a new pendint entry %p <%s>(%p)\n",
-                            (void *) pi, ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
-                            (void *) i->pkt->pfx);
+            pi = i->pending + k;
             pi->face = from;
-            pi->last_used = CCNL_NOW();
-            if (last)
-                    last->next = pi;
-            else
-                    i->pending = pi;
+            pi->last_used = now;
+            pi->expires = now + lifetime;
+            pi->nonce = nonce;
+            if (pi->expires > i->last_used + i->lifetime) {
+                i->lifetime = pi->expires - i->last_used;
+            }
             return 0;
         }
 
@@ -176,34 +201,23 @@ ccnl_interest_remove_pending(struct ccnl_interest_s *interest, struct ccnl_face_
         /** face is valid? */
         if (face) {
             char s[CCNL_MAX_PREFIX_SIZE];
+            int k, n;
             result = 0;
 
-            struct ccnl_pendint_s *prev = NULL;
-            struct ccnl_pendint_s *pend = interest->pending; 
-            
             DEBUGMSG_CORE(TRACE, "ccnl_interest_remove_pending\n"); 
-            
-            while (pend) {  // TODO: is this really the most elegant solution?
-                if (face->faceid == pend->face->faceid) { 
+
+            // records are unique per face, but keep the order of the others
+            for (k = n = 0; k < interest->pendcnt; k++) {
+                if (face->faceid == interest->pending[k].face->faceid) { 
                     DEBUGMSG_CFWD(INFO, "  removed face (%s) for interest %s\n",
-                        ccnl_addr2ascii(&pend->face->peer), 
+                        ccnl_addr2ascii(&interest->pending[k].face->peer), 
                         ccnl_prefix_to_str(interest->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE)); 
-                    
                     result++; 
-                    if (prev) { 
-                        prev->next = pend->next;
-                        ccnl_free(pend);
-                        pend = prev->next;
-                    } else {
-                        interest->pending = pend->next;
-                        ccnl_free(pend);
-                        pend = interest->pending;
-                    }
                 } else {
-                    prev = pend;
-                    pend = pend->next; 
+                    interest->pending[n++] = interest->pending[k];
                 }
             }
+            interest->pendcnt = n;
             return result;
         }
 
@@ -214,3 +228,19 @@ ccnl_interest_remove_pending(struct ccnl_interest_s *interest, struct ccnl_face_
     /** interest was NULL */
     return result;
 }
+
+int
+ccnl_interest_expire_pending(struct ccnl_interest_s *i, uint32_t now)
+{
+    int k, n;
+
+    for (k = n = 0; k < i->pendcnt; k++) {
+        if (i->pending[k].expires > now) {
+            i->pending[n++] = i->pending[k];
+        }
+    }
+    k -= n;
+    i->pendcnt = n;
+
+    return k;
+}
@@ -29,6 +29,9 @@
 #endif
 
 int debug_level;
+#ifdef USE_LOGGING
+int ccnl_log_modlevel[CCNL_LOG_MODULES] = { -1, -1, -1, -1, -1, -1, -1 };
+#endif
 
 char
 ccnl_debugLevelToChar(int level)
@@ -77,6 +80,85 @@ ccnl_debug_str2level(char *s)
     return 1;
 }
 
+#if defined(USE_LOGGING) && !defined(CCNL_ARDUINO) && !defined(CCNL_LINUXKERNEL)
+static int
+ccnl_debug_name2level(char *s)
+{
+    static const char *names[] = { "fatal", "error", "warning", "info",
+                                   "debug", "verbose", "trace" };
+    int i;
+
+    for (i = 0; i < (int) (sizeof(names) / sizeof(names[0])); i++) {
+        if (!strcmp(s, names[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int
+ccnl_debug_setlevels(char *spec)
+{
+    static const char *modules[CCNL_LOG_MODULES] = { "core", "cfwd", "cutl",
+                                        "efra", "pcnx", "piot", "pndn" };
+    char buf[128], *tok, *next, *eq;
+    int m, lvl;
+
+    if (strlen(spec) >= sizeof(buf)) {
+        return -1;
+    }
+    strcpy(buf, spec);
+    for (tok = buf; tok; tok = next) {
+        next = strchr(tok, ',');
+        if (next) {
+            *next++ = '\0';
+        }
+        eq = strchr(tok, '=');
+        lvl = ccnl_debug_name2level(eq ? eq + 1 : tok);
+        if (lvl < 0) {
+            return -1;
+        }
+        if (!eq) {
+            debug_level = lvl;
+            continue;
+        }
+        *eq = '\0';
+        for (m = 0; m < CCNL_LOG_MODULES && strcmp(tok, modules[m]); m++);
+        if (m == CCNL_LOG_MODULES) {
+            return -1;
+        }
+        ccnl_log_modlevel[m] = lvl;
+    }
+    return 0;
+}
+#endif
+
+#if defined(USE_LOGGING) && !defined(CCNL_ARDUINO) && \
+    !defined(CCNL_LINUXKERNEL) && !defined(CCNL_ANDROID) && !defined(CCNL_RIOT)
+static ccnl_log_sink_func ccnl_log_sink;
+
+void
+ccnl_log_set_sink(ccnl_log_sink_func sink)
+{
+    ccnl_log_sink = sink;
+}
+
+void
+ccnl_log_printf(int level, const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    if (ccnl_log_sink) {
+        ccnl_log_sink(level, fmt, ap);
+    } else {
+        fprintf(stderr, "[%c] %s: ", ccnl_debugLevelToChar(level), timestamp());
+        vfprintf(stderr, fmt, ap);
+    }
+    va_end(ap);
+}
+#endif
+
 #ifdef USE_DEBUG
 #ifdef USE_DEBUG_MALLOC
 
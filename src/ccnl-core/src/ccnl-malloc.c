@@ -26,6 +26,17 @@
 
 #ifdef USE_DEBUG_MALLOC
 
+static void
+debug_link(struct mhdr *hdr)
+{
+    hdr->next = mem;
+    hdr->pprev = &mem;
+    if (mem) {
+        mem->pprev = &hdr->next;
+    }
+    mem = hdr;
+}
+
 #ifdef CCNL_ARDUINO
 void* debug_malloc(size_t s, const char *fn, int lno, double tstamp)
 #else
@@ -45,8 +56,7 @@ void* debug_malloc(size_t s, const char *fn, int lno, char *tstamp)
             return NULL;
         }
 
-        h->next = mem;
-        mem = h;
+        debug_link(h);
         h->fname = (char *) fn;
         h->lineno = lno;
         h->size = s;
@@ -120,17 +130,15 @@ void* debug_calloc(size_t n, size_t s, const char *fn, int lno, char *tstamp)
 int
 debug_unlink(struct mhdr *hdr)
 {
-    struct mhdr **pp = &mem;
-
-    for (pp = &mem; pp; pp = &((*pp)->next)) {
-        if (*pp == hdr) {
-            *pp = hdr->next;
-            return 0;
-        }
-    if (!(*pp)->next)
-            break;
+    if (!hdr->pprev || *hdr->pprev != hdr) {
+        return 1;
+    }
+    *hdr->pprev = hdr->next;
+    if (hdr->next) {
+        hdr->next->pprev = hdr->pprev;
     }
-    return 1;
+    hdr->pprev = NULL;
+    return 0;
 }
 
 void*
@@ -173,8 +181,7 @@ debug_realloc(void *p, size_t s, const char *fn, int lno)
     h->fname = (char *) fn;
     h->lineno = lno;
     h->size = s;
-    h->next = mem;
-    mem = h;
+    debug_link(h);
     return ((unsigned char *)h) + sizeof(struct mhdr);
 }
 
@@ -0,0 +1,517 @@
+/*
+ * @f ccnl-mgmt-bin.c
+ * @b CCN lite, binary management protocol
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#include "ccnl-mgmt-bin.h"
+
+void null_func(void);
+
+#if defined(USE_MGMT) && defined(USE_SUITE_NDNTLV)
+
+#include <string.h>
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-segment.h"
+
+// ----------------------------------------------------------------------
+// encoding, in the order of the bytes
+
+static int
+ccnl_mgmt_bin_putNum(uint8_t **buf, uint8_t *end, uint64_t val)
+{
+    int n, i;
+
+    if (val < 253) {
+        n = 0;
+    } else if (val <= 0xffff) {
+        n = 2;
+    } else if (val <= 0xffffffffULL) {
+        n = 4;
+    } else {
+        n = 8;
+    }
+    if (end - *buf < n + 1) {
+        return -1;
+    }
+    *(*buf)++ = n == 0 ? (uint8_t) val : n == 2 ? 253 : n == 4 ? 254 : 255;
+    for (i = n - 1; i >= 0; i--) {
+        *(*buf)++ = (uint8_t) (val >> (8 * i));
+    }
+    return 0;
+}
+
+int
+ccnl_mgmt_bin_putTL(uint8_t **buf, uint8_t *end, uint64_t type, uint64_t len)
+{
+    uint8_t *start = *buf;
+
+    if (ccnl_mgmt_bin_putNum(buf, end, type) ||
+        ccnl_mgmt_bin_putNum(buf, end, len) ||
+        (uint64_t) (end - *buf) < len) {
+        *buf = start;
+        return -1;
+    }
+    return 0;
+}
+
+int
+ccnl_mgmt_bin_putBlob(uint8_t **buf, uint8_t *end, uint64_t type,
+                      const void *blob, size_t len)
+{
+    if (ccnl_mgmt_bin_putTL(buf, end, type, len)) {
+        return -1;
+    }
+    if (len) {
+        memcpy(*buf, blob, len);
+    }
+    *buf += len;
+    return 0;
+}
+
+int
+ccnl_mgmt_bin_putInt(uint8_t **buf, uint8_t *end, uint64_t type, uint64_t val)
+{
+    uint8_t b[8];
+    size_t len = val <= 0xff ? 1 : val <= 0xffff ? 2 :
+                 val <= 0xffffffffULL ? 4 : 8;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        b[i] = (uint8_t) (val >> (8 * (len - 1 - i)));
+    }
+    return ccnl_mgmt_bin_putBlob(buf, end, type, b, len);
+}
+
+// ----------------------------------------------------------------------
+// the operations
+
+struct ccnl_mgmt_bin_args_s {
+    char uri[CCNL_MAX_PREFIX_SIZE];
+    int faceid, suite, table;
+    uint64_t start;
+    uint8_t *packet;
+    size_t packetlen;
+    char policy[32];
+};
+
+static int
+ccnl_mgmt_bin_args(uint8_t *data, size_t len, struct ccnl_mgmt_bin_args_s *a)
+{
+    uint64_t typ;
+    size_t vallen;
+
+    a->uri[0] = '\0';
+    a->faceid = a->table = -1;
+    a->suite = CCNL_SUITE_NDNTLV;
+    a->start = 0;
+    a->packet = NULL;
+    a->packetlen = 0;
+    a->policy[0] = '\0';
+
+    while (len > 0) {
+        if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen) || vallen > len) {
+            return -1;
+        }
+        switch (typ) {
+        case CCNL_MGMT_BIN_PREFIX:
+            if (vallen >= sizeof(a->uri)) {
+                return -1;
+            }
+            memcpy(a->uri, data, vallen);
+            a->uri[vallen] = '\0';
+            break;
+        case CCNL_MGMT_BIN_FACEID:
+            a->faceid = (int) ccnl_ndntlv_nonNegInt(data, vallen);
+            break;
+        case CCNL_MGMT_BIN_SUITE:
+            a->suite = (int) ccnl_ndntlv_nonNegInt(data, vallen);
+            break;
+        case CCNL_MGMT_BIN_TABLE:
+            a->table = (int) ccnl_ndntlv_nonNegInt(data, vallen);
+            break;
+        case CCNL_MGMT_BIN_START:
+            a->start = ccnl_ndntlv_nonNegInt(data, vallen);
+            break;
+        case CCNL_MGMT_BIN_PACKET:
+            a->packet = data;
+            a->packetlen = vallen;
+            break;
+        case CCNL_MGMT_BIN_POLICY:
+            if (vallen >= sizeof(a->policy)) {
+                return -1;
+            }
+            memcpy(a->policy, data, vallen);
+            a->policy[vallen] = '\0';
+            break;
+        default:
+            break;
+        }
+        data += vallen;
+        len -= vallen;
+    }
+    return 0;
+}
+
+static int
+ccnl_mgmt_bin_fib(struct ccnl_relay_s *ccnl, uint64_t op,
+                  struct ccnl_mgmt_bin_args_s *a, struct ccnl_face_s **lastface)
+{
+    struct ccnl_prefix_s *pfx;
+    struct ccnl_face_s *f = *lastface;
+    int rc = CCNL_MGMT_BIN_OK;
+
+    if (!a->uri[0] || !ccnl_isSuite(a->suite) ||
+        (a->faceid < 0 && op != CCNL_MGMT_BIN_FIBSTAGERM)) {
+        return CCNL_MGMT_BIN_EINVAL;
+    }
+    if (op == CCNL_MGMT_BIN_FIBSTAGERM) {
+        f = NULL;
+    } else if (!f || f->faceid != a->faceid) {
+        // a batch mostly goes to one face
+        for (f = ccnl->faces; f && f->faceid != a->faceid; f = f->next);
+        if (!f) {
+            return CCNL_MGMT_BIN_ENOFACE;
+        }
+        *lastface = f;
+    }
+    pfx = ccnl_URItoPrefix(a->uri, a->suite, NULL);
+    if (!pfx) {
+        return CCNL_MGMT_BIN_EINVAL;
+    }
+
+    if (op != CCNL_MGMT_BIN_PREFIXUNREG) {
+        if (op == CCNL_MGMT_BIN_PREFIXREG ? ccnl_fib_add_entry(ccnl, pfx, f) :
+                                        ccnl_fib_stage_entry(ccnl, pfx, f)) {
+            rc = CCNL_MGMT_BIN_EFAIL;
+        } else {
+            pfx = NULL; // now in the FIB
+        }
+    } else if (ccnl_fib_rem_entry(ccnl, pfx, f)) {
+        rc = CCNL_MGMT_BIN_ENOENT;
+    }
+    if (pfx) {
+        ccnl_prefix_free(pfx);
+    }
+    return rc;
+}
+
+static int
+ccnl_mgmt_bin_addcache(struct ccnl_relay_s *ccnl,
+                       struct ccnl_mgmt_bin_args_s *a)
+{
+    struct ccnl_pkt_s *pkt;
+    struct ccnl_content_s *c;
+
+    if (!a->packet) {
+        return CCNL_MGMT_BIN_EINVAL;
+    }
+    pkt = ccnl_bytes2content(a->packet, a->packetlen);
+    if (!pkt) {
+        return CCNL_MGMT_BIN_EINVAL;
+    }
+    c = ccnl_content_new(&pkt);
+    ccnl_pkt_free(pkt);
+    if (!c) {
+        return CCNL_MGMT_BIN_EFAIL;
+    }
+    if (!ccnl_content_add2cache(ccnl, c)) {
+        ccnl_content_free(c);
+        return CCNL_MGMT_BIN_EFAIL;
+    }
+    ccnl_content_serve_pending(ccnl, c);
+    return CCNL_MGMT_BIN_OK;
+}
+
+// one row of a table, NULL when there are no more
+static void*
+ccnl_mgmt_bin_row(struct ccnl_relay_s *ccnl, int table, void *row)
+{
+    switch (table) {
+    case CCNL_MGMT_BIN_FIB:
+        return row ? ((struct ccnl_forward_s*) row)->next : ccnl->fib;
+    case CCNL_MGMT_BIN_FACES:
+        return row ? ((struct ccnl_face_s*) row)->next : ccnl->faces;
+    case CCNL_MGMT_BIN_IFS:
+        row = row ? (struct ccnl_if_s*) row + 1 : ccnl->ifs;
+        return (struct ccnl_if_s*) row < ccnl->ifs + ccnl->ifcount ? row : NULL;
+    case CCNL_MGMT_BIN_PIT:
+        return row ? ((struct ccnl_interest_s*) row)->next : ccnl->pit;
+    case CCNL_MGMT_BIN_CS:
+        return row ? ((struct ccnl_content_s*) row)->next : ccnl->contents;
+    }
+    return NULL;
+}
+
+static int
+ccnl_mgmt_bin_putrow(struct ccnl_relay_s *ccnl, int table, void *row,
+                     uint8_t **buf, uint8_t *end)
+{
+    uint8_t fields[CCNL_MAX_PREFIX_SIZE + 128], *cp = fields;
+    uint8_t *fend = fields + sizeof(fields);
+    char s[CCNL_MAX_PREFIX_SIZE], *addr;
+    struct ccnl_prefix_s *pfx = NULL;
+    int rc = 0;
+
+    switch (table) {
+    case CCNL_MGMT_BIN_FIB: {
+        struct ccnl_forward_s *fwd = (struct ccnl_forward_s*) row;
+        pfx = fwd->prefix;
+        rc = ccnl_mgmt_bin_putInt(&cp, fend, CCNL_MGMT_BIN_FACEID,
+                                  fwd->face ? (uint64_t) fwd->face->faceid : 0) ||
+             ccnl_mgmt_bin_putInt(&cp, fend, CCNL_MGMT_BIN_SUITE,
+                                  (uint64_t) fwd->suite);
+        break;
+    }
+    case CCNL_MGMT_BIN_FACES: {
+        struct ccnl_face_s *f = (struct ccnl_face_s*) row;
+        addr = ccnl_addr2ascii(&f->peer);
+        rc = ccnl_mgmt_bin_putInt(&cp, fend, CCNL_MGMT_BIN_FACEID,
+                                  (uint64_t) f->faceid) ||
+             ccnl_mgmt_bin_putInt(&cp, fend, CCNL_MGMT_BIN_IFNDX,
+                                  (uint64_t) (f->ifndx + 1)) ||
+             ccnl_mgmt_bin_putBlob(&cp, fend, CCNL_MGMT_BIN_PEER,
+                                   addr, addr ? strlen(addr) : 0) ||
+             ccnl_mgmt_bin_putInt(&cp, fend, CCNL_MGMT_BIN_FLAGS,
+                                  (uint64_t) f->flags);
+        break;
+    }
+    case CCNL_MGMT_BIN_IFS: {
+        struct ccnl_if_s *ifc = (struct ccnl_if_s*) row;
+        addr = ccnl_addr2ascii(&ifc->addr);
+        rc = ccnl_mgmt_bin_putInt(&cp, fend, CCNL_MGMT_BIN_IFNDX,
+                                  (uint64_t) (ifc - ccnl->ifs + 1)) ||
+             ccnl_mgmt_bin_putBlob(&cp, fend, CCNL_MGMT_BIN_PEER,
+                                   addr, addr ? strlen(addr) : 0) ||
+             ccnl_mgmt_bin_putInt(&cp, fend, CCNL_MGMT_BIN_COUNT, ifc->qlen);
+        break;
+    }
+    case CCNL_MGMT_BIN_PIT: {
+        struct ccnl_interest_s *i = (struct ccnl_interest_s*) row;
+        uint64_t cnt = i->pendcnt;
+        pfx = i->pkt ? i->pkt->pfx : NULL;
+        rc = ccnl_mgmt_bin_putInt(&cp, fend, CCNL_MGMT_BIN_FACEID,
+                                  i->from ? (uint64_t) i->from->faceid : 0) ||
+             ccnl_mgmt_bin_putInt(&cp, fend, CCNL_MGMT_BIN_COUNT, cnt);
+        break;
+    }
+    case CCNL_MGMT_BIN_CS: {
+        struct ccnl_content_s *c = (struct ccnl_content_s*) row;
+        pfx = c->pkt ? c->pkt->pfx : NULL;
+        rc = ccnl_mgmt_bin_putInt(&cp, fend, CCNL_MGMT_BIN_COUNT,
+                                  (uint64_t) c->served_cnt) ||
+             ccnl_mgmt_bin_putInt(&cp, fend, CCNL_MGMT_BIN_FLAGS,
+                                  (uint64_t) c->flags);
+        break;
+    }
+    }
+    if (!rc && pfx) {
+        ccnl_prefix_to_str(pfx, s, sizeof(s));
+        rc = ccnl_mgmt_bin_putBlob(&cp, fend, CCNL_MGMT_BIN_PREFIX,
+                                   s, strlen(s));
+    }
+    if (rc) {
+        return -1;
+    }
+    return ccnl_mgmt_bin_putBlob(buf, end, CCNL_MGMT_BIN_ROW,
+                                 fields, (size_t) (cp - fields));
+}
+
+// the rows from a->start on, as many as fit
+static int
+ccnl_mgmt_bin_dump(struct ccnl_relay_s *ccnl, struct ccnl_mgmt_bin_args_s *a,
+                   uint8_t **buf, uint8_t *end)
+{
+    uint8_t *first = *buf;
+    void *row;
+    uint64_t n;
+
+    if (a->table < 0 || a->table >= CCNL_MGMT_BIN_TABLES) {
+        return CCNL_MGMT_BIN_EINVAL;
+    }
+    // leave room for NEXT
+    end -= 12;
+    row = ccnl_mgmt_bin_row(ccnl, a->table, NULL);
+    for (n = 0; row && n < a->start; n++) {
+        row = ccnl_mgmt_bin_row(ccnl, a->table, row);
+    }
+    for (; row; n++, row = ccnl_mgmt_bin_row(ccnl, a->table, row)) {
+        if (ccnl_mgmt_bin_putrow(ccnl, a->table, row, buf, end)) {
+            if (*buf == first) {
+                continue; // never fits, skip it
+            }
+            break;
+        }
+    }
+    if (row) {
+        ccnl_mgmt_bin_putInt(buf, end + 12, CCNL_MGMT_BIN_NEXT, n);
+    }
+    return CCNL_MGMT_BIN_OK;
+}
+
+// ----------------------------------------------------------------------
+
+static void
+ccnl_mgmt_bin_reply(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
+                    uint8_t *payload, size_t len)
+{
+    struct ccnl_prefix_s *name;
+    struct ccnl_buf_s *buf;
+    size_t contentpos;
+    char uri[] = "/ccnx/bin";
+
+    name = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+    if (!name) {
+        return;
+    }
+    buf = ccnl_mkSimpleContent(name, payload, len, &contentpos, NULL);
+    ccnl_prefix_free(name);
+    if (buf) {
+        ccnl_face_enqueue(ccnl, from, buf);
+    }
+}
+
+int8_t
+ccnl_mgmt_bin(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
+              struct ccnl_prefix_s *prefix, struct ccnl_face_s *from)
+{
+    static uint8_t status[CCNL_MGMT_BIN_MAXREQ / 2];
+    static uint8_t rows[CCNL_MGMT_BIN_MAXREPLY], reply[CCNL_MGMT_BIN_MAXREPLY];
+    uint8_t *data, *reqid = NULL, *rp = rows, *cp = reply, *rowsend;
+    uint8_t *end = reply + sizeof(reply);
+    size_t len, vallen, reqidlen = 0, nops = 0, k;
+    uint64_t typ;
+    struct ccnl_mgmt_bin_args_s a;
+    struct ccnl_face_s *lastface = NULL;
+    int dumped = 0;
+    (void) orig;
+
+    if (prefix->compcnt < 4) {
+        return -1;
+    }
+
+    // the rows go after the status of each operation
+    data = prefix->comp[3];
+    len = prefix->complen[3];
+    while (len > 0) {
+        if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen) || vallen > len) {
+            return -1;
+        }
+        if (typ == CCNL_MGMT_BIN_REQID) {
+            reqidlen = vallen;
+        } else {
+            nops++;
+        }
+        data += vallen;
+        len -= vallen;
+    }
+    if (nops > sizeof(status) || nops + reqidlen + 16 > sizeof(rows)) {
+        return -1;
+    }
+    rowsend = rows + sizeof(rows) - nops - reqidlen - 16;
+
+    DEBUGMSG(DEBUG, "ccnl_mgmt_bin: %zu operation(s)\n", nops);
+
+    data = prefix->comp[3];
+    len = prefix->complen[3];
+    for (k = 0; len > 0; ) {
+        uint8_t *val;
+
+        ccnl_ndntlv_dehead(&data, &len, &typ, &vallen);
+        val = data;
+        data += vallen;
+        len -= vallen;
+        if (typ == CCNL_MGMT_BIN_REQID) {
+            reqid = val;
+            reqidlen = vallen;
+            continue;
+        }
+        if (ccnl_mgmt_bin_args(val, vallen, &a)) {
+            status[k++] = CCNL_MGMT_BIN_EINVAL;
+            continue;
+        }
+        switch (typ) {
+        case CCNL_MGMT_BIN_PREFIXREG:
+        case CCNL_MGMT_BIN_PREFIXUNREG:
+        case CCNL_MGMT_BIN_FIBSTAGE:
+        case CCNL_MGMT_BIN_FIBSTAGERM:
+            status[k++] = (uint8_t) ccnl_mgmt_bin_fib(ccnl, typ, &a, &lastface);
+            break;
+        case CCNL_MGMT_BIN_FIBCOMMIT:
+        case CCNL_MGMT_BIN_FIBMERGE: {
+            int cnt = ccnl_fib_commit(ccnl, typ == CCNL_MGMT_BIN_FIBMERGE);
+            if (cnt < 0) {
+                status[k++] = CCNL_MGMT_BIN_EFAIL;
+                break;
+            }
+            ccnl_mgmt_bin_putInt(&rp, rowsend, CCNL_MGMT_BIN_COUNT,
+                                 (uint64_t) cnt);
+            status[k++] = CCNL_MGMT_BIN_OK;
+            break;
+        }
+        case CCNL_MGMT_BIN_FIBABORT:
+            ccnl_fib_abort(ccnl);
+            status[k++] = CCNL_MGMT_BIN_OK;
+            break;
+        case CCNL_MGMT_BIN_ADDCACHE:
+            status[k++] = (uint8_t) ccnl_mgmt_bin_addcache(ccnl, &a);
+            break;
+        case CCNL_MGMT_BIN_ADMISSION: {
+            char policy[32];
+            if (a.policy[0] && ccnl_admit_set(ccnl, a.policy)) {
+                status[k++] = CCNL_MGMT_BIN_EINVAL;
+                break;
+            }
+            ccnl_admit_str(ccnl, policy, sizeof(policy));
+            ccnl_mgmt_bin_putBlob(&rp, rowsend, CCNL_MGMT_BIN_POLICY,
+                                  policy, strlen(policy));
+            status[k++] = CCNL_MGMT_BIN_OK;
+            break;
+        }
+        case CCNL_MGMT_BIN_DUMP:
+            // one table per reply
+            if (dumped++) {
+                status[k++] = CCNL_MGMT_BIN_EINVAL;
+                break;
+            }
+            status[k++] = (uint8_t) ccnl_mgmt_bin_dump(ccnl, &a, &rp, rowsend);
+            break;
+        default:
+            status[k++] = CCNL_MGMT_BIN_EUNKNOWN;
+            break;
+        }
+    }
+
+    if ((reqid && ccnl_mgmt_bin_putBlob(&cp, end, CCNL_MGMT_BIN_REQID,
+                                        reqid, reqidlen)) ||
+        ccnl_mgmt_bin_putBlob(&cp, end, CCNL_MGMT_BIN_STATUS, status, nops) ||
+        end - cp < rp - rows) {
+        return -1;
+    }
+    memcpy(cp, rows, (size_t) (rp - rows));
+    cp += rp - rows;
+
+    ccnl_mgmt_bin_reply(ccnl, from, reply, (size_t) (cp - reply));
+    return 0;
+}
+
+#endif // USE_MGMT && USE_SUITE_NDNTLV
@@ -27,6 +27,7 @@
 #include "ccnl-crypto.h"
 #include "ccnl-forward.h"
 #include "ccnl-pkt-switch.h"
+#include "ccnl-callbacks.h"
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -41,6 +42,7 @@
 #include <ccnl-crypto.h>
 #include <ccnl-forward.h>
 #include <ccnl-pkt-switch.h>
+#include <ccnl-callbacks.h>
 #endif
 
 
@@ -49,6 +51,7 @@
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-unix.h"
 #endif
+#include "ccnl-mgmt-bin.h"
 
 #define CONTENTOBJ_BUF_SIZE 2000
 #define FACEINST_BUF_SIZE 2000
@@ -1036,6 +1039,14 @@ ccnl_mgmt_debug(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
                     contentlast_use, contentserved_cnt, cprefixlen, cprefix);
         } else if (!strcmp((char*) debugaction, "halt")){
             ccnl->halt_flag = 1;
+        } else if (!strcmp((char*) debugaction, "snapshot")) {
+            if (ccnl_callback_snapshot(ccnl)) {
+                cp = "snapshot failed";
+            }
+#ifdef USE_HISTOGRAMS
+        } else if (!strcmp((char*) debugaction, "histo")) {
+            ccnl_histo_dump();
+#endif
         } else if (!strcmp((char*) debugaction, "dump+halt")) {
             ccnl_dump(0, CCNL_RELAY, ccnl);
 
@@ -1353,6 +1364,40 @@ ccnl_mgmt_newface(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         f = ccnl_get_face_or_create(ccnl, -1, &su.sa, sizeof(su.linklayer));
     } else
 #endif
+#endif
+#ifdef USE_STREAM
+    if (proto && host && port && !strcmp("6", (const char*) proto)) {
+        sockunion su;
+        unsigned long lport;
+        int ok = 0;
+        DEBUGMSG(TRACE, "  adding TCP face host=%s, port=%s\n", host, port);
+        errno = 0;
+        lport = strtoul((const char*) port, NULL, 0);
+        if (errno != 0 || lport > UINT16_MAX) {
+            goto SoftBail;
+        }
+        memset(&su, 0, sizeof(su));
+#ifdef USE_IPV6
+        if (ip6src) {
+            su.ip6.sin6_family = AF_INET6;
+            su.ip6.sin6_port = htons((uint16_t) lport);
+            ok = inet_pton(AF_INET6, (const char*) host, &su.ip6.sin6_addr) == 1;
+        }
+#endif
+#ifdef USE_IPV4
+        if (!ip6src) {
+            su.ip4.sin_family = AF_INET;
+            su.ip4.sin_port = htons((uint16_t) lport);
+            ok = inet_pton(AF_INET, (const char*) host, &su.ip4.sin_addr) == 1;
+        }
+#endif
+        if (!ok) {
+            goto SoftBail;
+        }
+        if (ccnl->ccnl_stream_connect_ptr) {
+            f = ccnl->ccnl_stream_connect_ptr(ccnl, &su);
+        }
+    } else
 #endif
     if ( (proto && host && port && !strcmp("17", (const char*) proto)) ||
                     (wpanaddr && wpanpanid) ) {
@@ -1507,7 +1552,7 @@ SoftBail:
         if (ccnl_ccnb_mkStrBlob(faceinst_buf+len3, faceinst_buf + FACEINST_BUF_SIZE, CCNL_DTAG_IP4SRC, CCN_TT_DTAG, (char*) ip4src, &len3)) {
             goto Bail;
         }
-        if (ccnl_ccnb_mkStrBlob(faceinst_buf+len3, faceinst_buf + FACEINST_BUF_SIZE, CCN_DTAG_IPPROTO, CCN_TT_DTAG, "17", &len3)) {
+        if (ccnl_ccnb_mkStrBlob(faceinst_buf+len3, faceinst_buf + FACEINST_BUF_SIZE, CCN_DTAG_IPPROTO, CCN_TT_DTAG, proto ? (char*) proto : "17", &len3)) {
             goto Bail;
         }
     }
@@ -1515,7 +1560,7 @@ SoftBail:
         if (ccnl_ccnb_mkStrBlob(faceinst_buf+len3, faceinst_buf + FACEINST_BUF_SIZE, CCNL_DTAG_IP6SRC, CCN_TT_DTAG, (char*) ip6src, &len3)) {
             goto Bail;
         }
-        if (ccnl_ccnb_mkStrBlob(faceinst_buf+len3, faceinst_buf + FACEINST_BUF_SIZE, CCN_DTAG_IPPROTO, CCN_TT_DTAG, "17", &len3)) {
+        if (ccnl_ccnb_mkStrBlob(faceinst_buf+len3, faceinst_buf + FACEINST_BUF_SIZE, CCN_DTAG_IPPROTO, CCN_TT_DTAG, proto ? (char*) proto : "17", &len3)) {
             goto Bail;
         }
     }
@@ -1660,6 +1705,7 @@ ccnl_mgmt_setfrag(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
             ccnl_frag_destroy(f->frag);
             f->frag = 0;
         }
+        f->flags &= ~CCNL_FACE_FLAGS_AUTOFRAG; // no longer ours to undo
         if (!strcmp((const char*)frag, "none")) {
             e = CCNL_FRAG_NONE;
         } else if (!strcmp((const char*)frag, "seqd2012")) {
@@ -1668,6 +1714,8 @@ ccnl_mgmt_setfrag(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
             e = CCNL_FRAG_CCNx2013;
         } else if (!strcmp((const char*)frag, "seqd2015")) {
             e = CCNL_FRAG_SEQUENCED2015;
+        } else if (!strcmp((const char*)frag, "be2015")) {
+            e = CCNL_FRAG_BEGINEND2015;
         }
         if (e < 0) {
             goto Error;
@@ -3055,6 +3103,10 @@ ccnl_mgmt_handle(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         return ccnl_mgmt_destroyface(ccnl, orig, prefix, from);
     } else if (!strcmp(cmd, "prefixreg")) {
         return ccnl_mgmt_prefixreg(ccnl, orig, prefix, from);
+#ifdef USE_SUITE_NDNTLV
+    } else if (!strcmp(cmd, CCNL_MGMT_BIN_CMD)) {
+        return ccnl_mgmt_bin(ccnl, orig, prefix, from);
+#endif
 //  TODO: Add ccnl_mgmt_prefixunreg(ccnl, orig, prefix, from)
 //  } else if (!strcmp(cmd, "prefixunreg")) {
 //      return ccnl_mgmt_prefixunreg(ccnl, orig, prefix, from);
@@ -183,6 +183,58 @@ ccnl_pkt2suite(uint8_t *data, size_t len, size_t *skip)
     return -1;
 }
 
+int
+ccnl_pkt_framelen(uint8_t *data, size_t datalen, size_t *framelen)
+{
+    size_t skip;
+
+    *framelen = 0;
+    switch (ccnl_pkt2suite(data, datalen, &skip)) {
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV:
+        // the fixed header carries the length of the whole packet
+        if (datalen - skip >= sizeof(struct ccnx_tlvhdr_ccnx2015_s)) {
+            *framelen = skip + (size_t) ((data[skip + 2] << 8) | data[skip + 3]);
+            if (*framelen < skip + sizeof(struct ccnx_tlvhdr_ccnx2015_s)) {
+                return -1;
+            }
+        }
+        return 0;
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV: {
+        uint8_t *cp = data + skip;
+        size_t len = datalen - skip, hdrlen = 0;
+        uint64_t typ, vallen;
+        int k;
+
+        // the type and the length, as far as they are there
+        for (k = 0; k < 2; k++) {
+            if (hdrlen >= len) {
+                return 0;
+            }
+            if (cp[hdrlen] == 255) {
+                return -1;
+            }
+            hdrlen += cp[hdrlen] < 253 ? 1 : cp[hdrlen] == 253 ? 3 : 5;
+        }
+        if (hdrlen > len) {
+            return 0;
+        }
+        if (ccnl_ndntlv_varlenint(&cp, &len, &typ) ||
+                            ccnl_ndntlv_varlenint(&cp, &len, &vallen)) {
+            return -1;
+        }
+        *framelen = skip + hdrlen + (size_t) vallen;
+        return 0;
+    }
+#endif
+    default:
+        // a switch header or the first bytes only
+        return datalen < sizeof(uint64_t) ? 0 : -1;
+    }
+}
+
 int
 ccnl_cmp2int(unsigned char *cmp, size_t cmplen)
 {
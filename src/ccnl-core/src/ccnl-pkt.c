@@ -36,7 +36,7 @@ ccnl_pkt_free(struct ccnl_pkt_s *pkt)
 {
     if (pkt) {
         if (pkt->pfx) {
-            switch (pkt->pfx->suite) {
+            switch (CCNL_SUITE_OF(pkt->pfx->suite)) {
 #ifdef USE_SUITE_CCNB
             case CCNL_SUITE_CCNB:
                 ccnl_free(pkt->s.ccnb.nonce);
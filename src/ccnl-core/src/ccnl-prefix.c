@@ -109,6 +109,37 @@ ccnl_prefix_dup(struct ccnl_prefix_s *prefix)
     return p;
 }
 
+uint64_t
+ccnl_prefix_hash(struct ccnl_prefix_s *prefix)
+{
+    uint64_t h = CCNL_PREFIX_HASH_INIT;
+    uint32_t i;
+
+    for (i = 0; i < prefix->compcnt; i++) {
+        h = ccnl_prefix_hash_comp(h, prefix->comp[i], prefix->complen[i]);
+    }
+
+    return h;
+}
+
+uint64_t
+ccnl_prefix_hash_comp(uint64_t h, const uint8_t *comp, size_t complen)
+{
+    size_t j;
+
+    // mix in the length, so /ab/c and /a/bc differ
+    for (j = 0; j < sizeof(uint32_t); j++) {
+        h ^= (complen >> (8 * j)) & 0xffU;
+        h *= 1099511628211ULL;
+    }
+    for (j = 0; j < complen; j++) {
+        h ^= comp[j];
+        h *= 1099511628211ULL;
+    }
+
+    return h;
+}
+
 int8_t
 ccnl_prefix_appendCmp(struct ccnl_prefix_s *prefix, uint8_t *cmp,
                       size_t cmplen)
@@ -462,7 +493,17 @@ ccnl_i_prefixof_c(struct ccnl_prefix_s *prefix,
     unsigned char *md = NULL;
 
     if ((prefix->compcnt - p->compcnt) == 1) {
-        md = compute_ccnx_digest(c->pkt->buf);
+        uint32_t i;
+
+        // compare the name first, the digest is only needed on a match
+        for (i = 0; i < p->compcnt; i++) {
+            if (p->complen[i] != prefix->complen[i] ||
+                memcmp(p->comp[i], prefix->comp[i], p->complen[i])) {
+                DEBUGMSG(TRACE, "  name mismatch\n");
+                return -1;
+            }
+        }
+        md = ccnl_content_digest(c);
 
         /* computing the ccnx digest failed */
         if (!md) {
@@ -23,6 +23,9 @@
  */
 
 #include "ccnl-producer.h"
+#ifdef NEEDS_PACKET_CRAFTING
+#include "ccnl-pkt-builder.h"
+#endif
 
 /**
  * local producer function defined by the application
@@ -35,6 +38,12 @@ ccnl_set_local_producer(ccnl_producer_func func)
     _prod_func = func;
 }
 
+int
+ccnl_local_producer_isset(void)
+{
+    return _prod_func != NULL;
+}
+
 int
 local_producer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                    struct ccnl_pkt_s *pkt)
@@ -45,3 +54,77 @@ local_producer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 
     return 0;
 }
+
+#ifdef NEEDS_PACKET_CRAFTING
+
+// the length fields of content and packet may grow with the content
+#define CCNL_CHUNK_LENGTH_SLACK 4
+
+static int
+ccnl_producer_minmtu(struct ccnl_relay_s *relay, struct ccnl_face_s *f, int mtu)
+{
+    int m = f ? ccnl_face_getmtu(relay, f) : 0;
+
+    return m > 0 && (!mtu || m < mtu) ? m : mtu;
+}
+
+int
+ccnl_producer_chunksize(struct ccnl_relay_s *relay,
+                        struct ccnl_prefix_s *prefix)
+{
+    struct ccnl_interest_s *i;
+    struct ccnl_forward_s *fwd;
+    struct ccnl_face_s *f;
+    struct ccnl_buf_s *buf;
+    ccnl_data_opts_u opts;
+    uint8_t dummy = 0;
+    int mtu = 0, k;
+    size_t overhead;
+
+    for (i = relay->pit; i; i = i->next) {
+        if (i->pkt->pfx->suite != prefix->suite ||
+            ccnl_prefix_cmp(prefix, NULL, i->pkt->pfx, CMP_LONGEST) <
+                                                    (int32_t) prefix->compcnt) {
+            continue;
+        }
+        for (k = 0; k < i->pendcnt; k++) {
+            mtu = ccnl_producer_minmtu(relay, i->pending[k].face, mtu);
+        }
+    }
+    for (fwd = relay->fib; fwd; fwd = fwd->next) {
+        if (fwd->prefix && fwd->suite == prefix->suite &&
+            ccnl_prefix_cmp(fwd->prefix, NULL, prefix, CMP_LONGEST) >=
+                                                (int32_t) fwd->prefix->compcnt) {
+            mtu = ccnl_producer_minmtu(relay, fwd->face, mtu);
+        }
+    }
+    if (!mtu) {
+        for (f = relay->faces; f; f = f->next) {
+            mtu = ccnl_producer_minmtu(relay, f, mtu);
+        }
+    }
+    if (!mtu) { // no faces yet
+        for (k = 0; k < relay->ifcount; k++) {
+            if (relay->ifs[k].mtu > 0 &&
+                (!mtu || relay->ifs[k].mtu < (uint32_t) mtu)) {
+                mtu = (int) relay->ifs[k].mtu;
+            }
+        }
+    }
+    if (!mtu) {
+        mtu = CCNL_MAX_PACKET_SIZE;
+    }
+
+    memset(&opts, 0, sizeof(opts));
+    buf = ccnl_mkSimpleContent(prefix, &dummy, 0, NULL, &opts);
+    if (!buf) {
+        return -1;
+    }
+    overhead = buf->datalen + CCNL_CHUNK_LENGTH_SLACK;
+    ccnl_free(buf);
+    DEBUGMSG_CORE(DEBUG, "chunk size: mtu=%d overhead=%zu\n", mtu, overhead);
+
+    return (size_t) mtu > overhead ? mtu - (int) overhead : 0;
+}
+
+#endif // NEEDS_PACKET_CRAFTING
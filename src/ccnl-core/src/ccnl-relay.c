@@ -22,16 +22,23 @@
 
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-core.h"
+#include "ccnl-callbacks.h"
+#include "ccnl-pkt-ccntlv.h"
 #include <stdio.h>
 #include <inttypes.h>
 #include <assert.h>
 #else //CCNL_LINUXKERNEL
 #include <ccnl-core.h>
+#include <ccnl-callbacks.h>
+#include <ccnl-pkt-ccntlv.h>
 #endif //CCNL_LINUXKERNEL
 
 #ifdef CCNL_RIOT
 #include "ccn-lite-riot.h"
 #endif
+#ifdef USE_HTTP_STATUS
+#include "ccnl-http-status.h"
+#endif
 
 
 
@@ -77,7 +84,8 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
 
     if (sa && ifndx == -1) {
         for (i = 0; i < ccnl->ifcount; i++) {
-            if (sa->sa_family != ccnl->ifs[i].addr.sa.sa_family) {
+            if (sa->sa_family != ccnl->ifs[i].addr.sa.sa_family ||
+                                                    ccnl->ifs[i].stream) {
                 continue;
             }
             ifndx = i;
@@ -141,23 +149,19 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
     ccnl_sched_destroy(f->sched);
 #ifdef USE_FRAG
     ccnl_frag_destroy(f->frag);
+#endif
+#ifdef USE_STREAM
+    if (f->ifndx >= 0 && ccnl->ifs[f->ifndx].stream && ccnl->ccnl_stream_close_ptr) {
+        ccnl->ccnl_stream_close_ptr(ccnl, f);
+    }
 #endif
     DEBUGMSG_CORE(TRACE, "face_remove: cleaning PIT\n");
     for (pit = ccnl->pit; pit; ) {
-        struct ccnl_pendint_s **ppend, *pend;
         if (pit->from == f) {
             pit->from = NULL;
         }
-        for (ppend = &pit->pending; *ppend;) {
-            if ((*ppend)->face == f) {
-                pend = *ppend;
-                *ppend = pend->next;
-                ccnl_free(pend);
-            } else {
-                ppend = &(*ppend)->next;
-            }
-        }
-        if (pit->pending) {
+        ccnl_interest_remove_pending(pit, f);
+        if (pit->pendcnt) {
             pit = pit->next;
         } else {
             DEBUGMSG_CORE(TRACE, "before interest_remove 0x%p\n",
@@ -171,8 +175,23 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
             struct ccnl_forward_s *pfwd = *ppfwd;
             ccnl_prefix_free(pfwd->prefix);
             *ppfwd = pfwd->next;
+#ifdef USE_HTTP_STATUS
+            ccnl_http_unlinked(ccnl, pfwd, pfwd->next);
+#endif
+            ccnl_free(pfwd);
+        } else {
+            ppfwd = &(*ppfwd)->next;
+        }
+    }
+    for (ppfwd = &ccnl->fibstage, ccnl->fibstagelast = NULL; *ppfwd;) {
+        if ((*ppfwd)->face == f) {
+            struct ccnl_forward_s *pfwd = *ppfwd;
+            ccnl_prefix_free(pfwd->prefix);
+            *ppfwd = pfwd->next;
             ccnl_free(pfwd);
+            ccnl->fibstagecnt--;
         } else {
+            ccnl->fibstagelast = *ppfwd;
             ppfwd = &(*ppfwd)->next;
         }
     }
@@ -187,6 +206,9 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
     f2 = f->next;
     DEBUGMSG_CORE(TRACE, "face_remove: unlinking2\n");
     DBL_LINKED_LIST_REMOVE(ccnl->faces, f);
+#ifdef USE_HTTP_STATUS
+    ccnl_http_unlinked(ccnl, f, f2);
+#endif
     DEBUGMSG_CORE(TRACE, "face_remove: unlinking3\n");
     ccnl_free(f);
 
@@ -211,6 +233,7 @@ ccnl_interface_enqueue(void (tx_done)(void*, int, int), struct ccnl_face_s *f,
         if (ifc->qlen >= CCNL_MAX_IF_QLEN) {
             if (buf) {
                 DEBUGMSG_CORE(WARNING, "  DROPPING buf=%p\n", (void*)buf); 
+                CCNL_FACE_COUNT(f, drops[CCNL_DROP_QUEUE], 1);
                 ccnl_free(buf); 
                 return;
             }
@@ -221,6 +244,9 @@ ccnl_interface_enqueue(void (tx_done)(void*, int, int), struct ccnl_face_s *f,
         memcpy(&r->dst, dest, sizeof(sockunion));
         r->txdone = tx_done;
         r->txdone_face = f;
+#ifdef USE_HISTOGRAMS
+        r->queued = ccnl_histo_on ? ccnl_histo_now() : 0;
+#endif
         ifc->qlen++;
 
 #ifdef USE_SCHEDULER
@@ -247,6 +273,7 @@ ccnl_face_dequeue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
         f->outqend = NULL;
     }
     pkt->next = NULL;
+    CCNL_HISTO_STOP(CCNL_HISTO_FACEQ, pkt->queued);
     return pkt;
 }
 
@@ -275,6 +302,30 @@ ccnl_face_CTS(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
         }
     }
 #ifdef USE_FRAG
+#ifndef USE_SCHEDULER
+    else if (ccnl->ccnl_ll_TXv_ptr && f->ifndx >= 0 &&
+             !ccnl->ifs[f->ifndx].qlen) {
+        // the driver gathers header and payload of each fragment, so the
+        // packet is not copied into one buffer per fragment
+        struct ccnl_frag_iov_s iov[CCNL_FRAG_BATCH];
+        int cnt, sent;
+
+        do {
+            while ((cnt = ccnl_frag_getiov(f->frag, iov, CCNL_FRAG_BATCH)) > 0) {
+                sent = ccnl->ccnl_ll_TXv_ptr(ccnl, ccnl->ifs + f->frag->ifndx,
+                                             &f->frag->dest, iov, cnt);
+#ifdef USE_STATS
+                ccnl->ifs[f->frag->ifndx].tx_cnt += sent;
+                CCNL_FACE_COUNT(f, drops[CCNL_DROP_SEND], cnt - sent);
+#else
+                (void) sent;
+#endif
+            }
+            buf = ccnl_face_dequeue(ccnl, f);
+            ccnl_frag_reset(f->frag, buf, f->ifndx, &f->peer);
+        } while (buf);
+    }
+#endif
     else {
         sockunion dst;
         int ifndx = f->ifndx;
@@ -328,6 +379,10 @@ ccnl_face_enqueue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
         to->outq = buf;
     }
     to->outqend = buf;
+    CCNL_FACE_COUNT(to, bytes_out, buf->datalen);
+#ifdef USE_HISTOGRAMS
+    buf->queued = ccnl_histo_on ? ccnl_histo_now() : 0;
+#endif
 #ifdef USE_SCHEDULER
     if (to->sched) {
 #ifdef USE_FRAG
@@ -345,6 +400,224 @@ ccnl_face_enqueue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
     return 0;
 }
 
+int
+ccnl_face_getmtu(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
+{
+    if (f->mtu > 0) {
+        return f->mtu;
+    }
+    if (f->ifndx >= 0 && ccnl->ifs[f->ifndx].mtu > 0) {
+        return (int) ccnl->ifs[f->ifndx].mtu;
+    }
+    return 0;
+}
+
+int
+ccnl_face_setmtu(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f, int mtu,
+                 struct ccnl_buf_s *refused)
+{
+    if (mtu <= 0) {
+        return -1;
+    }
+    DEBUGMSG_CORE(INFO, "path MTU to %s is %d\n",
+                  ccnl_addr2ascii(&f->peer), mtu);
+    f->mtu = mtu;
+    f->mtu_learned = CCNL_NOW();
+#ifdef USE_FRAG
+    if (f->frag && f->frag->protocol != CCNL_FRAG_NONE) {
+        // the refused buffer was a fragment already, it cannot be split again
+        f->frag->mtu = mtu;
+        return -1;
+    }
+    if (f->frag) {
+        ccnl_frag_destroy(f->frag);
+    }
+    f->frag = ccnl_frag_new(CCNL_FRAG_BEGINEND2015, mtu);
+    if (!f->frag) {
+        return -1;
+    }
+    f->flags |= CCNL_FACE_FLAGS_AUTOFRAG;
+    if (refused) {
+        // the suites BeginEnd2015 has a fragment format for
+        switch (ccnl_pkt2suite(refused->data, refused->datalen, NULL)) {
+#ifdef USE_SUITE_CCNTLV
+        case CCNL_SUITE_CCNTLV:
+#endif
+#ifdef USE_SUITE_NDNTLV
+        case CCNL_SUITE_NDNTLV:
+#endif
+            return ccnl_face_enqueue(ccnl, f, buf_dup(refused));
+        default:
+            break;
+        }
+    }
+#else
+    (void) ccnl;
+    (void) refused;
+#endif
+    return -1;
+}
+
+// forget the learned path MTU so that whole packets are tried again: if the
+// path is still narrow, the first one refused lowers it anew
+static void
+ccnl_face_probemtu(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
+{
+    DEBUGMSG_CORE(DEBUG, "probing the path MTU to %s\n",
+                  ccnl_addr2ascii(&f->peer));
+    (void) ccnl;
+    f->mtu = 0;
+#ifdef USE_FRAG
+    if (f->flags & CCNL_FACE_FLAGS_AUTOFRAG) {
+        ccnl_frag_destroy(f->frag);
+        f->frag = NULL;
+        f->flags &= ~CCNL_FACE_FLAGS_AUTOFRAG;
+    } else if (f->frag) {
+        // fragmentation set up by hand: back to the configured MTU
+        f->frag->mtu = f->frag->cfgmtu;
+    }
+#endif
+}
+
+
+#define CCNL_NAMEIDX_MINSIZE    64      // buckets of the CS and PIT name indexes
+
+static unsigned int
+ccnl_nameidx_bucket(uint64_t hash, unsigned int size)
+{
+    return (unsigned int) (hash ^ (hash >> 32)) & (size - 1);
+}
+
+// power of two, at least one bucket per entry
+static unsigned int
+ccnl_nameidx_size(int cnt)
+{
+    unsigned int size = CCNL_NAMEIDX_MINSIZE;
+
+    while (size < (unsigned int) cnt) {
+        size <<= 1;
+    }
+    return size;
+}
+
+static void
+ccnl_cs_link(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    unsigned int b = ccnl_nameidx_bucket(c->namehash, ccnl->cs_namesize);
+
+    c->name_next = ccnl->cs_names[b];
+    ccnl->cs_names[b] = c;
+}
+
+static void
+ccnl_cs_unlink(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    struct ccnl_content_s **pp;
+
+    if (!ccnl->cs_names) {
+        return;
+    }
+    for (pp = ccnl->cs_names + ccnl_nameidx_bucket(c->namehash, ccnl->cs_namesize);
+                                               *pp; pp = &(*pp)->name_next) {
+        if (*pp == c) {
+            *pp = c->name_next;
+            break;
+        }
+    }
+}
+
+// links the new entry c, growing the index with the content store
+static void
+ccnl_cs_index(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    if (!ccnl->cs_names || (unsigned int) ccnl->contentcnt > ccnl->cs_namesize) {
+        unsigned int size = ccnl_nameidx_size(ccnl->contentcnt);
+        struct ccnl_content_s **tab, *c2;
+
+        tab = (struct ccnl_content_s **) ccnl_calloc(size, sizeof(*tab));
+        if (tab) {
+            ccnl_free(ccnl->cs_names);
+            ccnl->cs_names = tab;
+            ccnl->cs_namesize = size;
+            for (c2 = ccnl->contents; c2; c2 = c2->next) {
+                ccnl_cs_link(ccnl, c2);
+            }
+            return;
+        }
+        if (!ccnl->cs_names) {
+            return;
+        }
+    }
+    ccnl_cs_link(ccnl, c);
+}
+
+static void
+ccnl_pit_link(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
+{
+    unsigned int b = ccnl_nameidx_bucket(i->namehash, ccnl->pit_namesize);
+
+    i->name_next = ccnl->pit_names[b];
+    ccnl->pit_names[b] = i;
+}
+
+static void
+ccnl_pit_unlink(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
+{
+    struct ccnl_interest_s **pp;
+
+    if (!ccnl->pit_names) {
+        return;
+    }
+    for (pp = ccnl->pit_names + ccnl_nameidx_bucket(i->namehash, ccnl->pit_namesize);
+                                               *pp; pp = &(*pp)->name_next) {
+        if (*pp == i) {
+            *pp = i->name_next;
+            break;
+        }
+    }
+}
+
+void
+ccnl_interest_index(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
+{
+    if (!ccnl->pit_names || (unsigned int) ccnl->pitcnt > ccnl->pit_namesize) {
+        unsigned int size = ccnl_nameidx_size(ccnl->pitcnt);
+        struct ccnl_interest_s **tab, *i2;
+
+        tab = (struct ccnl_interest_s **) ccnl_calloc(size, sizeof(*tab));
+        if (tab) {
+            ccnl_free(ccnl->pit_names);
+            ccnl->pit_names = tab;
+            ccnl->pit_namesize = size;
+            for (i2 = ccnl->pit; i2; i2 = i2->next) {
+                ccnl_pit_link(ccnl, i2);
+            }
+            return;
+        }
+        if (!ccnl->pit_names) {
+            return;
+        }
+    }
+    ccnl_pit_link(ccnl, i);
+}
+
+struct ccnl_content_s*
+ccnl_content_lookup_name(struct ccnl_relay_s *ccnl, uint64_t hash)
+{
+    if (!ccnl->cs_names) {
+        return NULL;
+    }
+    return ccnl->cs_names[ccnl_nameidx_bucket(hash, ccnl->cs_namesize)];
+}
+
+struct ccnl_interest_s*
+ccnl_interest_lookup_name(struct ccnl_relay_s *ccnl, uint64_t hash)
+{
+    if (!ccnl->pit_names) {
+        return NULL;
+    }
+    return ccnl->pit_names[ccnl_nameidx_bucket(hash, ccnl->pit_namesize)];
+}
 
 struct ccnl_interest_s*
 ccnl_interest_remove(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
@@ -361,16 +634,18 @@ ccnl_interest_remove(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
     ccnl_riot_interest_remove((evtimer_t *)(&ccnl_evtimer), i);
 #endif
 
-    while (i->pending) {
-        struct ccnl_pendint_s *tmp = i->pending->next;          \
+    if (i->pending != i->pendinline) {
         ccnl_free(i->pending);
-        i->pending = tmp;
     }
     i2 = i->next;
 
     ccnl->pitcnt--;
 
     DBL_LINKED_LIST_REMOVE(ccnl->pit, i);
+    ccnl_pit_unlink(ccnl, i);
+#ifdef USE_HTTP_STATUS
+    ccnl_http_unlinked(ccnl, i, i2);
+#endif
 
     if (i->pkt) {
         ccnl_pkt_free(i->pkt);
@@ -397,6 +672,7 @@ ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
         return;
     }
     DEBUGMSG_CORE(DEBUG, "ccnl_interest_propagate\n");
+    CCNL_HISTO_START(t);
 
     // CONFORM: "A node MUST implement some strategy rule, even if it is only to
     // transmit an Interest Message on all listed dest faces in sequence."
@@ -440,10 +716,15 @@ ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
 
             // DEBUGMSG(DEBUG, "%p %p %p\n", (void*)i, (void*)i->pkt, (void*)i->pkt->buf);
             if (fwd->tap) {
-                (fwd->tap)(ccnl, i->from, i->pkt->pfx, i->pkt->buf);
+                CCNL_HISTO_SKIP(t, (fwd->tap)(ccnl, i->from, i->pkt->pfx, i->pkt->buf));
             }
             if (fwd->face) {
-                ccnl_send_pkt(ccnl, fwd->face, i->pkt);
+                CCNL_FACE_COUNT(fwd->face, interests_out, 1);
+#ifdef USE_STATS
+                fwd->interests++;
+                fwd->bytes += i->pkt->buf->datalen;
+#endif
+                CCNL_HISTO_SKIP(t, ccnl_send_pkt(ccnl, fwd->face, i->pkt));
             }
 #if defined(USE_RONR)
             matching_face = 1;
@@ -452,6 +733,7 @@ ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
             DEBUGMSG_CORE(DEBUG, "  no matching fib entry found\n");
         }
     }
+    CCNL_HISTO_STOP(CCNL_HISTO_FIB, t);
 
 #ifdef USE_RONR
     if (!matching_face) {
@@ -470,6 +752,9 @@ ccnl_interest_broadcast(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *inter
     extern int ccnl_suite2defaultPort(int suite);
     unsigned i = 0;
     for (i = 0; i < CCNL_MAX_INTERFACES; i++) {
+        if (ccnl->ifs[i].stream) {
+            continue;   // no broadcast over connections
+        }
         switch (ccnl->ifs[i].addr.sa.sa_family) {
 #ifdef USE_LINKLAYER 
 #if !(defined(__FreeBSD__) || defined(__APPLE__))
@@ -518,12 +803,359 @@ ccnl_interest_broadcast(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *inter
 #endif
         }
         if (fibface) {
+            CCNL_FACE_COUNT(fibface, interests_out, 1);
             ccnl_send_pkt(ccnl, fibface, interest->pkt);
             DEBUGMSG_CORE(DEBUG, "  broadcasting interest (%s)\n", ccnl_addr2ascii(&sun));
         }
     }
 }
 
+#ifdef USE_CCNxDIGEST
+#define CCNL_DIGEST_MINSIZE     256     // buckets of the digest index
+
+static unsigned int
+ccnl_digest_bucket(struct ccnl_relay_s *ccnl, const unsigned char *md)
+{
+    uint32_t h;
+
+    // the digest is uniformly distributed, any four bytes will do
+    memcpy(&h, md, sizeof(h));
+    return h & (ccnl->digestsize - 1);
+}
+
+static void
+ccnl_digest_link(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    unsigned int b;
+
+    if (!ccnl_content_digest(c)) {
+        return;
+    }
+    b = ccnl_digest_bucket(ccnl, c->digest);
+    c->digest_next = ccnl->digests[b];
+    ccnl->digests[b] = c;
+}
+
+static void
+ccnl_digest_unlink(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    struct ccnl_content_s **pp;
+
+    if (!ccnl->digests || !c->has_digest) {
+        return;
+    }
+    for (pp = ccnl->digests + ccnl_digest_bucket(ccnl, c->digest); *pp;
+                                                 pp = &(*pp)->digest_next) {
+        if (*pp == c) {
+            *pp = c->digest_next;
+            break;
+        }
+    }
+}
+
+static int
+ccnl_digest_rebuild(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_content_s **tab, *c;
+    unsigned int size = CCNL_DIGEST_MINSIZE;
+
+    while (size < (unsigned int) ccnl->contentcnt) {
+        size <<= 1;
+    }
+    tab = (struct ccnl_content_s **) ccnl_calloc(size, sizeof(*tab));
+    if (!tab) {
+        return -1;
+    }
+    ccnl_free(ccnl->digests);
+    ccnl->digests = tab;
+    ccnl->digestsize = size;
+    for (c = ccnl->contents; c; c = c->next) {
+        ccnl_digest_link(ccnl, c);
+    }
+    return 0;
+}
+#endif // USE_CCNxDIGEST
+
+struct ccnl_content_s*
+ccnl_content_lookup_digest(struct ccnl_relay_s *ccnl, const unsigned char *md)
+{
+#ifdef USE_CCNxDIGEST
+    struct ccnl_content_s *c;
+
+    if (!ccnl->digests && ccnl_digest_rebuild(ccnl)) {
+        return NULL;
+    }
+    for (c = ccnl->digests[ccnl_digest_bucket(ccnl, md)]; c; c = c->digest_next) {
+        if (!memcmp(c->digest, md, CCNL_CCNX_DIGEST_LEN)) {
+            return c;
+        }
+    }
+#else
+    (void) ccnl;
+    (void) md;
+#endif
+    return NULL;
+}
+
+#ifdef USE_CCNxDIGEST
+// the digest in the last component of pfx, if that has the form of an
+// implicit digest in the suite of pfx: CCNx components keep their TL
+static const unsigned char*
+ccnl_prefix_digest(struct ccnl_prefix_s *pfx)
+{
+    const unsigned char *comp;
+    size_t len;
+
+    if (pfx->compcnt == 0) {
+        return NULL;
+    }
+    comp = pfx->comp[pfx->compcnt - 1];
+    len = pfx->complen[pfx->compcnt - 1];
+#ifdef USE_SUITE_CCNTLV
+    if (CCNL_SUITE_OF(pfx->suite) == CCNL_SUITE_CCNTLV) {
+        if (len != 4 + CCNL_CCNX_DIGEST_LEN ||
+            ((comp[0] << 8) | comp[1]) != CCNX_TLV_N_NameSegment ||
+            ((comp[2] << 8) | comp[3]) != CCNL_CCNX_DIGEST_LEN) {
+            return NULL;
+        }
+        return comp + 4;
+    }
+#endif
+    return len == CCNL_CCNX_DIGEST_LEN ? comp : NULL;
+}
+#endif // USE_CCNxDIGEST
+
+struct ccnl_content_s*
+ccnl_content_lookup_fullname(struct ccnl_relay_s *ccnl, struct ccnl_prefix_s *pfx)
+{
+#ifdef USE_CCNxDIGEST
+    const unsigned char *md = ccnl_prefix_digest(pfx);
+    struct ccnl_content_s *c;
+    uint32_t k;
+
+    if (!md || !(c = ccnl_content_lookup_digest(ccnl, md))) {
+        return NULL;
+    }
+    if (CCNL_SUITE_OF(c->pkt->pfx->suite) != CCNL_SUITE_OF(pfx->suite) ||
+        c->pkt->pfx->compcnt + 1 != pfx->compcnt) {
+        return NULL;
+    }
+    for (k = 0; k < c->pkt->pfx->compcnt; k++) {
+        if (c->pkt->pfx->complen[k] != pfx->complen[k] ||
+            memcmp(c->pkt->pfx->comp[k], pfx->comp[k], pfx->complen[k])) {
+            return NULL;
+        }
+    }
+    return c;
+#else
+    (void) ccnl;
+    (void) pfx;
+    return NULL;
+#endif
+}
+
+// the expiry queue is a binary heap of the fresh content by staletime,
+// stale content is kept in a list in the order it went stale
+
+static uint64_t
+ccnl_now_ms(void)
+{
+    return (uint64_t) (CCNL_NOW() * 1000);
+}
+
+static void
+ccnl_fresh_set(struct ccnl_relay_s *ccnl, int pos, struct ccnl_content_s *c)
+{
+    ccnl->fresh[pos] = c;
+    c->freshpos = pos + 1;
+}
+
+static void
+ccnl_fresh_up(struct ccnl_relay_s *ccnl, int pos)
+{
+    struct ccnl_content_s *c = ccnl->fresh[pos];
+    int parent;
+
+    while (pos > 0) {
+        parent = (pos - 1) / 2;
+        if (ccnl->fresh[parent]->staletime <= c->staletime) {
+            break;
+        }
+        ccnl_fresh_set(ccnl, pos, ccnl->fresh[parent]);
+        pos = parent;
+    }
+    ccnl_fresh_set(ccnl, pos, c);
+}
+
+static void
+ccnl_fresh_down(struct ccnl_relay_s *ccnl, int pos)
+{
+    struct ccnl_content_s *c = ccnl->fresh[pos];
+    int child;
+
+    while ((child = 2 * pos + 1) < ccnl->freshcnt) {
+        if (child + 1 < ccnl->freshcnt &&
+            ccnl->fresh[child + 1]->staletime < ccnl->fresh[child]->staletime) {
+            child++;
+        }
+        if (c->staletime <= ccnl->fresh[child]->staletime) {
+            break;
+        }
+        ccnl_fresh_set(ccnl, pos, ccnl->fresh[child]);
+        pos = child;
+    }
+    ccnl_fresh_set(ccnl, pos, c);
+}
+
+static int
+ccnl_fresh_add(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    if (ccnl->freshcnt >= ccnl->freshsize) {
+        int size = ccnl->freshsize ? 2 * ccnl->freshsize : 64;
+        struct ccnl_content_s **tab;
+
+        tab = (struct ccnl_content_s **) ccnl_realloc(ccnl->fresh,
+                                                      (size_t) size * sizeof(*tab));
+        if (!tab) {
+            return -1;
+        }
+        ccnl->fresh = tab;
+        ccnl->freshsize = size;
+    }
+    ccnl->fresh[ccnl->freshcnt] = c;
+    ccnl_fresh_up(ccnl, ccnl->freshcnt++);
+    return 0;
+}
+
+static void
+ccnl_fresh_del(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    int pos = c->freshpos - 1;
+    struct ccnl_content_s *last = ccnl->fresh[--ccnl->freshcnt];
+
+    c->freshpos = 0;
+    if (last != c) {
+        ccnl_fresh_set(ccnl, pos, last);
+        ccnl_fresh_up(ccnl, pos);
+        ccnl_fresh_down(ccnl, last->freshpos - 1);
+    }
+}
+
+static void
+ccnl_stale_link(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    c->flags |= CCNL_CONTENT_FLAGS_STALE;
+    c->stale_next = NULL;
+    c->stale_prev = ccnl->staleend;
+    if (ccnl->staleend) {
+        ccnl->staleend->stale_next = c;
+    } else {
+        ccnl->stale = c;
+    }
+    ccnl->staleend = c;
+}
+
+static void
+ccnl_stale_unlink(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    if (!(c->flags & CCNL_CONTENT_FLAGS_STALE)) {
+        return;
+    }
+    c->flags &= ~CCNL_CONTENT_FLAGS_STALE;
+    if (c->stale_prev) {
+        c->stale_prev->stale_next = c->stale_next;
+    } else {
+        ccnl->stale = c->stale_next;
+    }
+    if (c->stale_next) {
+        c->stale_next->stale_prev = c->stale_prev;
+    } else {
+        ccnl->staleend = c->stale_prev;
+    }
+    c->stale_next = c->stale_prev = NULL;
+}
+
+#ifdef USE_SUITE_NDNTLV
+// (re)starts the freshness period of cached content, in ms
+static void
+ccnl_content_freshen(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c,
+                     uint64_t period)
+{
+    uint64_t now = ccnl_now_ms();
+
+    if (c->freshpos) {
+        ccnl_fresh_del(ccnl, c);
+    }
+    ccnl_stale_unlink(ccnl, c);
+    if (c->flags & CCNL_CONTENT_FLAGS_STATIC) {
+        return;
+    }
+    c->staletime = period > UINT64_MAX - now ? UINT64_MAX : now + period;
+    // content without a freshness period is stale right away
+    if (!period || ccnl_fresh_add(ccnl, c)) {
+        ccnl_stale_link(ccnl, c);
+    }
+}
+#endif
+
+void
+ccnl_content_set_staletime(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c,
+                           uint64_t staletime)
+{
+#ifdef USE_SUITE_NDNTLV
+    uint64_t now = ccnl_now_ms();
+
+    if (CCNL_SUITE_OF(c->pkt->suite) != CCNL_SUITE_NDNTLV) {
+        return;
+    }
+    if (c->prev || ccnl->contents == c) {
+        ccnl_content_freshen(ccnl, c, staletime > now ? staletime - now : 0);
+    } else {
+        // not cached: the flag only tells cMatch, add2cache clears it
+        c->staletime = staletime;
+        if (staletime <= now) {
+            c->flags |= CCNL_CONTENT_FLAGS_STALE;
+        }
+    }
+#else
+    (void) ccnl;
+    (void) c;
+    (void) staletime;
+#endif
+}
+
+void
+ccnl_content_expire(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_content_s *c;
+    uint64_t now;
+
+    if (!ccnl->freshcnt) {
+        return;
+    }
+    now = ccnl_now_ms();
+    while (ccnl->freshcnt && ccnl->fresh[0]->staletime <= now) {
+        c = ccnl->fresh[0];
+        ccnl_fresh_del(ccnl, c);
+        if (!(c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
+            ccnl_stale_link(ccnl, c);
+        }
+    }
+}
+
+void
+ccnl_content_set_static(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    if (c->flags & CCNL_CONTENT_FLAGS_STATIC) {
+        return;
+    }
+    c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+    if (c->freshpos) {
+        ccnl_fresh_del(ccnl, c);
+    }
+    ccnl_stale_unlink(ccnl, c);
+}
+
 struct ccnl_content_s*
 ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 {
@@ -531,7 +1163,21 @@ ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
     DEBUGMSG_CORE(TRACE, "ccnl_content_remove\n");
 
     c2 = c->next;
+    if (ccnl->contentsend == c) {
+        ccnl->contentsend = c->prev;
+    }
     DBL_LINKED_LIST_REMOVE(ccnl->contents, c);
+    ccnl_cs_unlink(ccnl, c);
+    if (c->freshpos) {
+        ccnl_fresh_del(ccnl, c);
+    }
+    ccnl_stale_unlink(ccnl, c);
+#ifdef USE_HTTP_STATUS
+    ccnl_http_unlinked(ccnl, c, c2);
+#endif
+#ifdef USE_CCNxDIGEST
+    ccnl_digest_unlink(ccnl, c);
+#endif
 
 //    free_content(c);
     if (c->pkt) {
@@ -549,6 +1195,51 @@ ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
     return c2;
 }
 
+struct ccnl_content_s*
+ccnl_content_victim(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_content_s *c2;
+
+    ccnl_content_expire(ccnl);
+    for (c2 = ccnl->stale; c2; c2 = c2->stale_next) {
+        if (!(c2->flags & CCNL_CONTENT_FLAGS_STATIC)) {
+            return c2;
+        }
+    }
+    // entries are kept in the order they were cached or touched, so the
+    // oldest is found from the end instead of by comparing last_used
+    for (c2 = ccnl->contentsend; c2; c2 = c2->prev) {
+        if (!(c2->flags & CCNL_CONTENT_FLAGS_STATIC)) {
+            return c2;
+        }
+    }
+    return NULL;
+}
+
+void
+ccnl_content_touch(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    c->last_used = CCNL_NOW();
+    if (c->flags & CCNL_CONTENT_FLAGS_STALE) {
+        // of the stale entries, too, it goes last
+        ccnl_stale_unlink(ccnl, c);
+        ccnl_stale_link(ccnl, c);
+    }
+    if (ccnl->contents == c) {
+        return;
+    }
+    if (ccnl->contentsend == c) {
+        ccnl->contentsend = c->prev;
+    }
+#ifdef USE_HTTP_STATUS
+    // a CS page stopped at c goes on where c was
+    ccnl_http_unlinked(ccnl, c, c->next);
+#endif
+    DBL_LINKED_LIST_REMOVE(ccnl->contents, c);
+    c->prev = NULL;
+    DBL_LINKED_LIST_ADD(ccnl->contents, c);
+}
+
 struct ccnl_content_s*
 ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 {
@@ -560,9 +1251,18 @@ ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
                   ccnl->contentcnt, ccnl->max_cache_entries,
                   (void*)c, ccnl_prefix_to_str(c->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE), (c->pkt->pfx->chunknum)? (signed) *(c->pkt->pfx->chunknum) : -1);
 
-    for (cit = ccnl->contents; cit; cit = cit->next) {
-        if (ccnl_prefix_cmp(c->pkt->pfx, NULL, cit->pkt->pfx, CMP_EXACT) == 0) {
+    c->namehash = ccnl_prefix_hash(c->pkt->pfx);
+    for (cit = ccnl_content_lookup_name(ccnl, c->namehash); cit; cit = cit->name_next) {
+        if (cit->namehash == c->namehash &&
+            ccnl_prefix_cmp(c->pkt->pfx, NULL, cit->pkt->pfx, CMP_EXACT) == 0) {
             DEBUGMSG_CORE(DEBUG, "--- Already in cache ---\n");
+#ifdef USE_SUITE_NDNTLV
+            // a new copy is fresh again
+            if (CCNL_SUITE_OF(c->pkt->suite) == CCNL_SUITE_NDNTLV &&
+                CCNL_SUITE_OF(cit->pkt->suite) == CCNL_SUITE_NDNTLV) {
+                ccnl_content_freshen(ccnl, cit, c->pkt->s.ndntlv.freshnessperiod);
+            }
+#endif
             return NULL;
         }
     }
@@ -570,25 +1270,37 @@ ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
     if (ccnl->max_cache_entries > 0 &&
         ccnl->contentcnt >= ccnl->max_cache_entries && !cache_strategy_remove(ccnl, c)) {
         // remove oldest content
-        struct ccnl_content_s *c2, *oldest = NULL;
-        uint32_t age = 0;
-        for (c2 = ccnl->contents; c2; c2 = c2->next) {
-             if (!(c2->flags & CCNL_CONTENT_FLAGS_STATIC)) {
-                 if ((age == 0) || c2->last_used < age) {
-                     age = c2->last_used;
-                     oldest = c2;
-                 }
-             }
-         }
+        struct ccnl_content_s *oldest = ccnl_content_victim(ccnl);
          if (oldest) {
              DEBUGMSG_CORE(DEBUG, " remove old entry from cache\n");
+             ccnl_callback_cs_evict(ccnl, oldest);
              ccnl_content_remove(ccnl, oldest);
          }
     }
     if ((ccnl->max_cache_entries <= 0) ||
          (ccnl->contentcnt <= ccnl->max_cache_entries)) {
+            // the STALE flag tells whether c is on the stale list, not yet
+            c->flags &= ~CCNL_CONTENT_FLAGS_STALE;
             DBL_LINKED_LIST_ADD(ccnl->contents, c);
+            if (!ccnl->contentsend) {
+                ccnl->contentsend = c;
+            }
             ccnl->contentcnt++;
+            ccnl_cs_index(ccnl, c);
+#ifdef USE_SUITE_NDNTLV
+            if (CCNL_SUITE_OF(c->pkt->suite) == CCNL_SUITE_NDNTLV) {
+                ccnl_content_freshen(ccnl, c, c->pkt->s.ndntlv.freshnessperiod);
+            }
+#endif
+#ifdef USE_CCNxDIGEST
+            if (ccnl->digests) {
+                if ((unsigned int) ccnl->contentcnt > ccnl->digestsize) {
+                    ccnl_digest_rebuild(ccnl);
+                } else {
+                    ccnl_digest_link(ccnl, c);
+                }
+            }
+#endif
 #ifdef CCNL_RIOT
             /* set cache timeout timer if content is not static */
             if (!(c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
@@ -605,20 +1317,28 @@ ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 {
     struct ccnl_interest_s *i;
     struct ccnl_face_s *f;
+    uint32_t gen;
     int cnt = 0;
     DEBUGMSG_CORE(TRACE, "ccnl_content_serve_pending\n");
     char s[CCNL_MAX_PREFIX_SIZE];
+    CCNL_HISTO_START(t);
 
-    for (f = ccnl->faces; f; f = f->next){
-                f->flags &= ~CCNL_FACE_FLAGS_SERVED; // reply on a face only once
+    // reply on a face only once: faces served by this call carry its gen
+    gen = ++ccnl->servegen;
+    if (!gen) {
+        for (f = ccnl->faces; f; f = f->next) {
+            f->served = 0;
+        }
+        gen = ccnl->servegen = 1;
     }
     for (i = ccnl->pit; i;) {
         struct ccnl_pendint_s *pi;
+        int k;
         if (!i->pkt->pfx) {
             continue;
         }
 
-        switch (i->pkt->pfx->suite) {
+        switch (CCNL_SUITE_OF(i->pkt->pfx->suite)) {
 #ifdef USE_SUITE_CCNB
         case CCNL_SUITE_CCNB:
             if (ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ccnb.minsuffix,
@@ -641,7 +1361,8 @@ ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 #ifdef USE_SUITE_NDNTLV
         case CCNL_SUITE_NDNTLV:
             if (ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ndntlv.minsuffix,
-                    i->pkt->s.ndntlv.maxsuffix, c) < 0) {
+                    i->pkt->s.ndntlv.maxsuffix, c) < 0 ||
+                (i->pkt->s.ndntlv.mbf && (c->flags & CCNL_CONTENT_FLAGS_STALE))) {
                 // XX must also check i->ppkl,
                 i = i->next;
                 continue;
@@ -654,9 +1375,12 @@ ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
         }
 
         //Hook for add content to cache by callback:
-        if(i && ! i->pending){
+        if(i && ! i->pendcnt){
             DEBUGMSG_CORE(WARNING, "releasing interest 0x%p OK?\n", (void*)i);
-            c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+            ccnl_content_set_static(ccnl, c);
+#ifdef USE_HISTOGRAMS
+            CCNL_HISTO_SKIP(t, ccnl_histo_satisfied(ccnl, i));
+#endif
             i = ccnl_interest_remove(ccnl, i);
 
             c->served_cnt++;
@@ -668,18 +1392,14 @@ ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 
         // CONFORM: "Data MUST only be transmitted in response to
         // an Interest that matches the Data."
-        for (pi = i->pending; pi; pi = pi->next) {
-            if (pi->face->flags & CCNL_FACE_FLAGS_SERVED) {
+        for (k = 0; k < i->pendcnt; k++) {
+            pi = i->pending + k;
+            if (pi->face->served == gen) {
                 continue;
             }
-            pi->face->flags |= CCNL_FACE_FLAGS_SERVED;
+            pi->face->served = gen;
             if (pi->face->ifndx >= 0) {
-                int32_t nonce = 0;
-                if (i->pkt != NULL && i->pkt->s.ndntlv.nonce != NULL) {
-                    if (i->pkt->s.ndntlv.nonce->datalen == 4) {
-                        memcpy(&nonce, i->pkt->s.ndntlv.nonce->data, 4);
-                    }
-                }
+                int32_t nonce = pi->nonce;
 
 #ifndef CCNL_LINUXKERNEL
                 DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%"PRIi32" to=%s\n",
@@ -695,7 +1415,8 @@ ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
                 DEBUGMSG_CORE(VERBOSE, "    Serve to face: %d (pkt=%p)\n",
                          pi->face->faceid, (void*) c->pkt);
 
-                ccnl_send_pkt(ccnl, pi->face, c->pkt);
+                CCNL_FACE_COUNT(pi->face, data_out, 1);
+                CCNL_HISTO_SKIP(t, ccnl_send_pkt(ccnl, pi->face, c->pkt));
 
 
             } else {// upcall to deliver content to local client
@@ -706,8 +1427,12 @@ ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
             c->served_cnt++;
             cnt++;
         }
+#ifdef USE_HISTOGRAMS
+        CCNL_HISTO_SKIP(t, ccnl_histo_satisfied(ccnl, i));
+#endif
         i = ccnl_interest_remove(ccnl, i);
     }
+    CCNL_HISTO_STOP(CCNL_HISTO_SERVE, t);
 
     return cnt;
 }
@@ -732,28 +1457,24 @@ ccnl_do_ageing(void *ptr, void *dummy)
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
+    ccnl_content_expire(relay);
     while (c) {
         if ((c->last_used + CCNL_CONTENT_TIMEOUT) <= (uint32_t) t &&
                                 !(c->flags & CCNL_CONTENT_FLAGS_STATIC)){
             DEBUGMSG_CORE(TRACE, "AGING: CONTENT REMOVE %p\n", (void*) c);
+            ccnl_callback_cs_evict(relay, c);
             c = ccnl_content_remove(relay, c);
         }
         else {
-#ifdef USE_SUITE_NDNTLV
-            if (c->pkt->suite == CCNL_SUITE_NDNTLV) {
-                // Mark content as stale if its freshness period expired and it is not static
-                if ((c->last_used + (c->pkt->s.ndntlv.freshnessperiod / 1000)) <= (uint32_t) t &&
-                        !(c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
-                    c->flags |= CCNL_CONTENT_FLAGS_STALE;
-                }
-            }
-#endif
             c = c->next;
         }
     }
     while (i) { // CONFORM: "Entries in the PIT MUST timeout rather
                 // than being held indefinitely."
-        if ((i->last_used + i->lifetime) <= (uint32_t) t ||
+        // an entry whose faces all timed out has no one left to serve
+        int gone = i->pendcnt && ccnl_interest_expire_pending(i, t) &&
+                   !i->pendcnt;
+        if (gone || (i->last_used + i->lifetime) <= (uint32_t) t ||
                                 i->retries >= CCNL_MAX_INTEREST_RETRANSMIT) {
                 DEBUGMSG_AGEING("AGING: REMOVE INTEREST", "timeout: remove interest", s, CCNL_MAX_PREFIX_SIZE);
                 i = ccnl_interest_remove(relay, i);
@@ -775,6 +1496,13 @@ ccnl_do_ageing(void *ptr, void *dummy)
             DEBUGMSG_CORE(TRACE, "AGING: FACE REMOVE %p\n", (void*) f);
             f = ccnl_face_remove(relay, f);
         } else {
+            if (f->mtu && (f->mtu_learned + CCNL_PMTU_PROBE_INTERVAL) <= (uint32_t) t
+#ifdef USE_FRAG
+                && ccnl_frag_nomorefragments(f->frag)
+#endif
+                ) {
+                ccnl_face_probemtu(relay, f);
+            }
             f = f->next;
         }
     }
@@ -782,20 +1510,31 @@ ccnl_do_ageing(void *ptr, void *dummy)
 
 int
 ccnl_nonce_find_or_append(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *nonce)
+{
+    DEBUGMSG_CORE(TRACE, "ccnl_nonce_find_or_append\n");
+
+    return ccnl_nonce_seen(ccnl, nonce->data, nonce->datalen, 1) ? -1 : 0;
+}
+
+int
+ccnl_nonce_seen(struct ccnl_relay_s *ccnl, const uint8_t *nonce, size_t len,
+                int append)
 {
     struct ccnl_buf_s *n, *n2 = 0;
     int i;
-    DEBUGMSG_CORE(TRACE, "ccnl_nonce_find_or_append\n");
 
     for (n = ccnl->nonces, i = 0; n; n = n->next, i++) {
-        if (buf_equal(n, nonce)) {
-            return -1;
+        if (n->datalen == len && !memcmp(n->data, nonce, len)) {
+            return 1;
         }
         if (n->next) {
             n2 = n;
         }
     }
-    n = ccnl_buf_new(nonce->data, nonce->datalen);
+    if (!append) {
+        return 0;
+    }
+    n = ccnl_buf_new((void *) nonce, len);
     if (n) {
         n->next = ccnl->nonces;
         ccnl->nonces = n;
@@ -810,6 +1549,7 @@ ccnl_nonce_find_or_append(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *nonce)
 int
 ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt)
 {
+#ifdef USE_SUITE_NDNTLV
     if(CCNL_MAX_NONCES < 0){
         struct ccnl_interest_s *i = NULL;
         for (i = relay->pit; i; i = i->next) {
@@ -819,7 +1559,8 @@ ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt)
         }
         return 0;
     }
-    switch (pkt->suite) {
+#endif
+    switch (CCNL_SUITE_OF(pkt->suite)) {
 #ifdef USE_SUITE_CCNB
     case CCNL_SUITE_CCNB:
         return pkt->s.ccnb.nonce &&
@@ -905,6 +1646,9 @@ ccnl_fib_rem_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
             else {
                 last->next = fwd->next;
             }
+#ifdef USE_HTTP_STATUS
+            ccnl_http_unlinked(relay, fwd, fwd->next);
+#endif
             ccnl_prefix_free(fwd->prefix);
             ccnl_free(fwd);
             break;
@@ -919,6 +1663,172 @@ ccnl_fib_rem_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
 
     return res;
 }
+
+int
+ccnl_fib_stage_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
+                     struct ccnl_face_s *face)
+{
+    struct ccnl_forward_s *fwd;
+
+    fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
+    if (!fwd) {
+        return -1;
+    }
+    fwd->prefix = pfx;
+    fwd->face = face;
+    fwd->suite = pfx->suite;
+    if (relay->fibstagelast) {
+        relay->fibstagelast->next = fwd;
+    } else {
+        relay->fibstage = fwd;
+    }
+    relay->fibstagelast = fwd;
+    relay->fibstagecnt++;
+    return 0;
+}
+
+// the slot of fwd's prefix in an open addressed table of size mask+1
+static struct ccnl_forward_s**
+ccnl_fib_slot(struct ccnl_forward_s **tab, size_t mask,
+              struct ccnl_forward_s *fwd)
+{
+    size_t k = (size_t) (ccnl_prefix_hash(fwd->prefix) ^
+                         (uint64_t) fwd->suite) & mask;
+
+    while (tab[k] && (tab[k]->suite != fwd->suite ||
+                      ccnl_prefix_cmp(tab[k]->prefix, NULL, fwd->prefix,
+                                      CMP_EXACT))) {
+        k = (k + 1) & mask;
+    }
+    return tab + k;
+}
+
+int
+ccnl_fib_commit(struct ccnl_relay_s *relay, int merge)
+{
+    struct ccnl_forward_s **tab, **slot, *fwd, **pp, *stage, *old = NULL;
+    struct ccnl_forward_s *gone = NULL;
+    char *dead;
+    size_t size = 16, n = (size_t) relay->fibstagecnt;
+    int cnt = 0;
+
+    if (merge) {
+        for (fwd = relay->fib; fwd; fwd = fwd->next) {
+            n++;
+        }
+    }
+    while (size < 2 * n) {
+        size *= 2;
+    }
+    tab = (struct ccnl_forward_s **) ccnl_calloc(size, sizeof(*tab));
+    dead = (char *) ccnl_calloc(size, 1);
+    if (!tab || !dead) {
+        ccnl_free(tab);
+        ccnl_free(dead);
+        return -1;
+    }
+
+    // a merge changes the FIB in place, a replace starts from an empty one
+    if (merge) {
+        for (pp = &relay->fib; *pp; pp = &(*pp)->next) {
+            slot = ccnl_fib_slot(tab, size - 1, *pp);
+            if (!*slot) {
+                *slot = *pp;
+            }
+        }
+    } else {
+        old = relay->fib;
+        relay->fib = NULL;
+        pp = &relay->fib;
+    }
+
+    // one entry per prefix: the position of the first, the face of the last
+    stage = relay->fibstage;
+    relay->fibstage = relay->fibstagelast = NULL;
+    relay->fibstagecnt = 0;
+    while (stage) {
+        fwd = stage;
+        stage = stage->next;
+        fwd->next = NULL;
+        slot = ccnl_fib_slot(tab, size - 1, fwd);
+        if (!*slot && fwd->face) {
+            *slot = *pp = fwd;
+            pp = &fwd->next;
+            continue;
+        }
+        if (*slot) {
+            dead[slot - tab] = !fwd->face;
+            if (fwd->face) {
+                (*slot)->face = fwd->face;
+            }
+        }
+        ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
+    }
+
+    // hand over what the replaced entries had collected
+    while (old) {
+        fwd = old;
+        old = old->next;
+        slot = ccnl_fib_slot(tab, size - 1, fwd);
+        if (*slot && (*slot)->face == fwd->face) {
+            (*slot)->tap = fwd->tap;
+#ifdef USE_STATS
+            (*slot)->interests = fwd->interests;
+            (*slot)->bytes = fwd->bytes;
+#endif
+        }
+#ifdef USE_HTTP_STATUS
+        ccnl_http_unlinked(relay, fwd, NULL);
+#endif
+        ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
+    }
+
+    // unlink the removed entries, the table still points to them
+    for (pp = &relay->fib; *pp;) {
+        fwd = *pp;
+        slot = ccnl_fib_slot(tab, size - 1, fwd);
+        if (*slot == fwd && dead[slot - tab]) {
+            *pp = fwd->next;
+#ifdef USE_HTTP_STATUS
+            ccnl_http_unlinked(relay, fwd, fwd->next);
+#endif
+            fwd->next = gone;
+            gone = fwd;
+        } else {
+            cnt++;
+            pp = &fwd->next;
+        }
+    }
+    while (gone) {
+        fwd = gone;
+        gone = gone->next;
+        ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
+    }
+    ccnl_free(dead);
+    ccnl_free(tab);
+
+    DEBUGMSG_CUTL(INFO, "%s a FIB of %d entries\n",
+                  merge ? "merged into" : "committed", cnt);
+    return cnt;
+}
+
+void
+ccnl_fib_abort(struct ccnl_relay_s *relay)
+{
+    struct ccnl_forward_s *fwd;
+
+    while (relay->fibstage) {
+        fwd = relay->fibstage;
+        relay->fibstage = fwd->next;
+        ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
+    }
+    relay->fibstagelast = NULL;
+    relay->fibstagecnt = 0;
+}
 #endif
 
 /* prints the current FIB */
@@ -992,6 +1902,7 @@ ccnl_interface_CTS(void *aux1, void *aux2)
 
     r = ifc->queue + ifc->qfront;
     memcpy(&req, r, sizeof(req));
+    CCNL_HISTO_STOP(CCNL_HISTO_IFQ, req.queued);
     ifc->qfront = (ifc->qfront + 1) % CCNL_MAX_IF_QLEN;
     ifc->qlen--;
 #ifndef CCNL_LINUXKERNEL
@@ -1094,6 +2005,6 @@ cache_strategy_cache(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
     if (_cs_decision_func) {
         return _cs_decision_func(relay, c);
     }
-    // If no caching decision strategy is defined, cache everything
-    return 1;
+    // If no caching decision strategy is defined, the admission policy decides
+    return ccnl_admit(relay, c);
 }
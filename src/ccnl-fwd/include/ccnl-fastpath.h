@@ -0,0 +1,95 @@
+/*
+ * @f ccnl-fastpath.h
+ * @b CCN lite, classification of incoming Interests before parsing
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * The fast path looks at an Interest's wire encoding only: it scans the name
+ * in place, hashes it like ccnl_prefix_hash() and consults the name indexes
+ * of the Content Store and the PIT. Without allocating a packet it decides
+ *
+ *  - drop:       the nonce was seen before (USE_DUP_CHECK)
+ *  - CS hit:     cached content with exactly this name is sent back
+ *  - aggregate:  a PIT entry for this name takes the face as pending
+ *  - parse:      anything else goes through the full parse and
+ *                ccnl_fwd_handleInterest()
+ *
+ * Only plain Interests are classified: a name of ordinary components, no
+ * selectors or restrictions, received on a network face and with no local
+ * producer set. Everything the fast path handles is handled the way
+ * ccnl_fwd_handleInterest() would, except that a CS hit requires an exact
+ * name match where the full path may also answer with a longer name.
+ */
+
+#ifndef CCNL_FASTPATH_H
+#define CCNL_FASTPATH_H
+
+#include "ccnl-core.h"
+
+#define CCNL_FAST_PARSE         0   /**< needs the full parse */
+#define CCNL_FAST_DROP          1   /**< duplicate, dropped */
+#define CCNL_FAST_CS_HIT        2   /**< answered from the Content Store */
+#define CCNL_FAST_AGGREGATE     3   /**< added to an existing PIT entry */
+
+/**
+ * @brief Scans a name in place
+ */
+struct ccnl_fastname_s {
+    uint64_t hash;                          /**< ccnl_prefix_hash() of the name */
+    uint32_t compcnt;                       /**< number of components */
+    uint8_t *comp[CCNL_MAX_NAME_COMP];      /**< components, as in ccnl_prefix_s */
+    size_t complen[CCNL_MAX_NAME_COMP];     /**< component lengths */
+};
+
+#ifdef USE_SUITE_CCNTLV
+/**
+ * @brief Classifies a CCNx Interest
+ *
+ * @param[in] relay     pointer to current ccnl relay
+ * @param[in] from      face on which the Interest was received
+ * @param[in] data      the message, following the fixed and optional headers
+ * @param[in] len       length of the message and its validation TLVs
+ *
+ * @return   CCNL_FAST_PARSE if the packet was not touched, otherwise it was
+ *           consumed and the return value tells how
+ */
+int
+ccnl_fast_ccntlv_interest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                          uint8_t *data, size_t len);
+#endif
+
+#ifdef USE_SUITE_NDNTLV
+/**
+ * @brief Classifies an NDN Interest
+ *
+ * @param[in] relay     pointer to current ccnl relay
+ * @param[in] from      face on which the Interest was received
+ * @param[in] data      value of the Interest TLV
+ * @param[in] len       length of the value
+ *
+ * @return   CCNL_FAST_PARSE if the packet was not touched, otherwise it was
+ *           consumed and the return value tells how
+ */
+int
+ccnl_fast_ndntlv_interest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                          uint8_t *data, size_t len);
+#endif
+
+#endif // CCNL_FASTPATH_H
@@ -109,13 +109,21 @@ ccnl_ndntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                       uint8_t **data, size_t *datalen);
 #endif // USE_SUITE_NDNTLV
 
+#ifdef CCNL_SINGLE_SUITE
+// the forwarder and CS-matching function of the only suite, called directly
+// instead of through ccnl_core_suites[] and a cMatchFct
+# define CCNL_ONLY_SUITE_RX         ccnl_ndntlv_forwarder
+# define CCNL_ONLY_SUITE_CMATCH     ccnl_ndntlv_cMatch
+#endif // CCNL_SINGLE_SUITE
+
 /**
  * @brief Handle and incomming Interest Message
  *
  * @param[in] relay   pointer to current ccnl relay
  * @param[in] from    face on which the interest was received
  * @param[in] pkt     packet which was received   
- * @param[in] cMatch  matching strategy for the Content Store 
+ * @param[in] cMatch  matching strategy for the Content Store, ignored in a
+ *                    single-suite build
  *
  * @return   0 on success
  * @return   < 0 on failure
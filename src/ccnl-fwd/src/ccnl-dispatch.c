@@ -71,6 +71,7 @@ ccnl_core_RX(struct ccnl_relay_s *relay, int ifndx, uint8_t *data,
         DEBUGMSG_CORE(DEBUG, "  face %d, peer=%s\n", from->faceid,
                     ccnl_addr2ascii(&from->peer));
     }
+    CCNL_FACE_COUNT(from, bytes_in, datalen);
 
     // loop through all packets in the received frame (UDP, Ethernet etc)
     while (datalen > 0) {
@@ -86,6 +87,17 @@ ccnl_core_RX(struct ccnl_relay_s *relay, int ifndx, uint8_t *data,
             return;
         }
 
+#ifdef CCNL_SINGLE_SUITE
+        (void) dispatch;
+        if (suite != CCNL_ONLY_SUITE) {
+            DEBUGMSG_CORE(WARNING, "suite %s is not forwarded by this build\n",
+                          ccnl_suite2str(suite));
+            return;
+        }
+        if (CCNL_ONLY_SUITE_RX(relay, from, &data, &datalen) < 0) {
+            break;
+        }
+#else
         dispatch = ccnl_core_suites[suite].RX;
         if (!dispatch) {
             DEBUGMSG_CORE(ERROR, "Forwarder not initialized or dispatcher "
@@ -95,6 +107,7 @@ ccnl_core_RX(struct ccnl_relay_s *relay, int ifndx, uint8_t *data,
         if (dispatch(relay, from, &data, &datalen) < 0) {
             break;
         }
+#endif
         if (datalen > 0) {
             DEBUGMSG_CORE(WARNING, "ccnl_core_RX: %zu bytes left\n", datalen);
         }
@@ -0,0 +1,301 @@
+/*
+ * @f ccnl-fastpath.c
+ * @b CCN lite, classification of incoming Interests before parsing
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#include "ccnl-fastpath.h"
+
+#include "ccnl-core.h"
+#include "ccnl-producer.h"
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-pkt-ndntlv.h"
+#else
+#include <ccnl-pkt-ccntlv.h>
+#include <ccnl-pkt-ndntlv.h>
+#endif
+
+static void
+ccnl_fast_addcomp(struct ccnl_fastname_s *name, uint8_t *comp, size_t len)
+{
+    name->comp[name->compcnt] = comp;
+    name->complen[name->compcnt] = len;
+    name->compcnt++;
+    name->hash = ccnl_prefix_hash_comp(name->hash, comp, len);
+}
+
+static int
+ccnl_fast_name_eq(struct ccnl_prefix_s *pfx, struct ccnl_fastname_s *name)
+{
+    uint32_t k;
+
+    if (pfx->compcnt != name->compcnt) {
+        return 0;
+    }
+    for (k = 0; k < name->compcnt; k++) {
+        if (pfx->complen[k] != name->complen[k] ||
+            memcmp(pfx->comp[k], name->comp[k], name->complen[k])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// the PIT entry would be ccnl_interest_isSame() with an Interest without
+// selectors
+static int
+ccnl_fast_plain_entry(struct ccnl_interest_s *i)
+{
+    switch (CCNL_SUITE_OF(i->pkt->pfx->suite)) {
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+        return i->pkt->s.ndntlv.minsuffix == 0 &&
+               i->pkt->s.ndntlv.maxsuffix == CCNL_MAX_NAME_COMP &&
+               !i->pkt->s.ndntlv.ppkl;
+#endif
+    default:
+        break;
+    }
+    return 1;
+}
+
+// the steps of ccnl_fwd_handleInterest(), on the scanned name
+static int
+ccnl_fast_classify(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                   int suite, struct ccnl_fastname_s *name,
+                   uint8_t *nonce, size_t noncelen, uint32_t lifetime)
+{
+    struct ccnl_content_s *c;
+    struct ccnl_interest_s *i = NULL;
+    int32_t nonce32 = 0;
+
+    if (nonce && CCNL_MAX_NONCES < 0) {
+        return CCNL_FAST_PARSE; // duplicates are found through the PIT
+    }
+#ifdef USE_DUP_CHECK
+    if (nonce && ccnl_nonce_seen(relay, nonce, noncelen, 0)) {
+        DEBUGMSG_CFWD(DEBUG, "  fast path: dropped because of duplicate nonce\n");
+        CCNL_FACE_COUNT(from, interests_in, 1);
+        CCNL_FACE_COUNT(from, drops[CCNL_DROP_DUPNONCE], 1);
+        return CCNL_FAST_DROP;
+    }
+#endif
+    if (!from || from->ifndx < 0 || ccnl_local_producer_isset()) {
+        return CCNL_FAST_PARSE;
+    }
+#ifdef USE_SUITE_NDNTLV
+    // possibly a mgmt message
+    if (suite == CCNL_SUITE_NDNTLV && name->compcnt == 4 &&
+        (name->complen[0] < 4 || !memcmp(name->comp[0], "ccnx", 4))) {
+        return CCNL_FAST_PARSE;
+    }
+#endif
+
+    CCNL_HISTO_START(t);
+    for (c = ccnl_content_lookup_name(relay, name->hash); c; c = c->name_next) {
+        if (c->namehash == name->hash && CCNL_SUITE_OF(c->pkt->pfx->suite) == suite &&
+            ccnl_fast_name_eq(c->pkt->pfx, name)) {
+            break;
+        }
+    }
+    CCNL_HISTO_STOP(CCNL_HISTO_CS, t);
+    if (!c) {
+        CCNL_HISTO_START(t2);
+        for (i = ccnl_interest_lookup_name(relay, name->hash); i; i = i->name_next) {
+            if (i->namehash == name->hash && CCNL_SUITE_OF(i->pkt->pfx->suite) == suite &&
+                ccnl_fast_plain_entry(i) && ccnl_fast_name_eq(i->pkt->pfx, name)) {
+                break;
+            }
+        }
+        if (!i) {
+            return CCNL_FAST_PARSE;
+        }
+        CCNL_HISTO_STOP(CCNL_HISTO_PIT, t2);
+    }
+
+#ifdef USE_DUP_CHECK
+    if (nonce) {
+        ccnl_nonce_seen(relay, nonce, noncelen, 1);
+    }
+#else
+    (void) noncelen;
+#endif
+    CCNL_FACE_COUNT(from, interests_in, 1);
+    ccnl_admit_seen(relay, name->hash);
+    if (c) {
+        DEBUGMSG_CFWD(DEBUG, "  fast path: found matching content %p\n", (void *) c);
+        CCNL_FACE_COUNT(from, cs_hits, 1);
+        CCNL_FACE_COUNT(from, data_out, 1);
+        ccnl_send_pkt(relay, from, c->pkt);
+        return CCNL_FAST_CS_HIT;
+    }
+    DEBUGMSG_CFWD(DEBUG, "  fast path: appending interest entry %p\n", (void *) i);
+    if (nonce && noncelen == 4) {
+        memcpy(&nonce32, nonce, 4);
+    }
+    CCNL_FACE_COUNT(from, cs_misses, 1);
+    CCNL_FACE_COUNT(from, pit_aggregated, 1);
+    ccnl_interest_append_pending(i, from, nonce32, lifetime);
+    return CCNL_FAST_AGGREGATE;
+}
+
+// ----------------------------------------------------------------------
+
+#ifdef USE_SUITE_CCNTLV
+
+int
+ccnl_fast_ccntlv_interest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                          uint8_t *data, size_t len)
+{
+    struct ccnl_fastname_s name;
+    uint16_t typ;
+    size_t vallen;
+    int gotname = 0;
+
+    CCNL_HISTO_START(t);
+    name.hash = CCNL_PREFIX_HASH_INIT;
+    name.compcnt = 0;
+
+    if (ccnl_ccntlv_dehead(&data, &len, &typ, &vallen) ||
+                                            typ != CCNX_TLV_TL_Interest) {
+        return CCNL_FAST_PARSE;
+    }
+    len = vallen; // validation TLVs are not looked at
+    while (len > 0) {
+        if (ccnl_ccntlv_dehead(&data, &len, &typ, &vallen)) {
+            return CCNL_FAST_PARSE;
+        }
+        switch (typ) {
+        case CCNX_TLV_M_Name: {
+            uint8_t *cp = data, *cp2;
+            size_t len2 = vallen, len3;
+
+            if (gotname) {
+                return CCNL_FAST_PARSE;
+            }
+            gotname = 1;
+            while (len2 > 0) {
+                cp2 = cp;
+                if (ccnl_ccntlv_dehead(&cp, &len2, &typ, &len3) ||
+                                    name.compcnt >= CCNL_MAX_NAME_COMP) {
+                    return CCNL_FAST_PARSE;
+                }
+                // components keep their TL header, as in the parser
+                if (typ == CCNX_TLV_N_NameSegment ||
+                    (typ == CCNX_TLV_N_Chunk && len3 <= sizeof(uint32_t))) {
+                    ccnl_fast_addcomp(&name, cp2, cp - cp2 + len3);
+                } else {
+                    return CCNL_FAST_PARSE;
+                }
+                cp += len3;
+                len2 -= len3;
+            }
+            break;
+        }
+        case CCNX_TLV_M_Payload:
+            break;
+        default: // restrictions and unknown TLVs
+            return CCNL_FAST_PARSE;
+        }
+        data += vallen;
+        len -= vallen;
+    }
+    if (!gotname) {
+        return CCNL_FAST_PARSE;
+    }
+
+    CCNL_HISTO_STOP(CCNL_HISTO_PARSE, t);
+    return ccnl_fast_classify(relay, from, CCNL_SUITE_CCNTLV, &name, NULL, 0,
+                              CCNL_INTEREST_TIMEOUT);
+}
+
+#endif // USE_SUITE_CCNTLV
+
+// ----------------------------------------------------------------------
+
+#ifdef USE_SUITE_NDNTLV
+
+int
+ccnl_fast_ndntlv_interest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                          uint8_t *data, size_t len)
+{
+    struct ccnl_fastname_s name;
+    uint8_t *nonce = NULL;
+    size_t noncelen = 0, vallen;
+    uint64_t typ, lifetime = CCNL_INTEREST_TIMEOUT; // in ms, as in the parser
+    int gotname = 0;
+
+    CCNL_HISTO_START(t);
+    name.hash = CCNL_PREFIX_HASH_INIT;
+    name.compcnt = 0;
+
+    while (len > 0) {
+        if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen)) {
+            return CCNL_FAST_PARSE;
+        }
+        switch (typ) {
+        case NDN_TLV_Name: {
+            uint8_t *cp = data;
+            size_t len2 = vallen, len3;
+
+            if (gotname) {
+                return CCNL_FAST_PARSE;
+            }
+            gotname = 1;
+            while (len2 > 0) {
+                if (ccnl_ndntlv_dehead(&cp, &len2, &typ, &len3) ||
+                    typ != NDN_TLV_NameComponent || len3 == 0 ||
+                    name.compcnt >= CCNL_MAX_NAME_COMP) {
+                    return CCNL_FAST_PARSE;
+                }
+                // the parser rejects segment numbers beyond 32 bits
+                if (cp[0] == NDN_Marker_SegmentNumber && len3 > 1 + sizeof(uint32_t)) {
+                    return CCNL_FAST_PARSE;
+                }
+                ccnl_fast_addcomp(&name, cp, len3);
+                cp += len3;
+                len2 -= len3;
+            }
+            break;
+        }
+        case NDN_TLV_Nonce:
+            nonce = data;
+            noncelen = vallen;
+            break;
+        case NDN_TLV_InterestLifetime:
+            lifetime = ccnl_ndntlv_nonNegInt(data, vallen);
+            break;
+        default: // selectors, scope and unknown TLVs
+            return CCNL_FAST_PARSE;
+        }
+        data += vallen;
+        len -= vallen;
+    }
+    if (!gotname) {
+        return CCNL_FAST_PARSE;
+    }
+
+    CCNL_HISTO_STOP(CCNL_HISTO_PARSE, t);
+    return ccnl_fast_classify(relay, from, CCNL_SUITE_NDNTLV, &name,
+                              nonce, noncelen, (uint32_t) (lifetime / 1000));
+}
+
+#endif // USE_SUITE_NDNTLV
@@ -22,6 +22,7 @@
 
 
 #include "ccnl-fwd.h"
+#include "ccnl-fastpath.h"
 
 #include "ccnl-core.h"
 #include "ccnl-producer.h"
@@ -52,6 +53,21 @@ int ccnl_fib_add_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
                        struct ccnl_face_s *face);
 #endif
 
+#ifdef CCNL_SINGLE_SUITE
+#define ccnl_fwd_cMatch(fct, p, c)  ((void) (fct), CCNL_ONLY_SUITE_CMATCH(p, c))
+#else
+#define ccnl_fwd_cMatch(fct, p, c)  (fct)(p, c)
+#endif
+
+// the peer of a face for log messages, "" if it has none that can be printed
+static inline const char*
+ccnl_fwd_peer2ascii(struct ccnl_face_s *from)
+{
+    char *s = from ? ccnl_addr2ascii(&from->peer) : NULL;
+
+    return s ? s : "";
+}
+
 // returning 0 if packet was
 int
 ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
@@ -61,19 +77,11 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
-    if (from) {
-        char *from_as_str = ccnl_addr2ascii(&(from->peer));
-
-        if (from_as_str) {
-             DEBUGMSG_CFWD(INFO, "  incoming data=<%s>%s from=%s\n",
-                ccnl_prefix_to_str((*pkt)->pfx,s,CCNL_MAX_PREFIX_SIZE), ccnl_suite2str((*pkt)->suite),
-                  from_as_str ? from_as_str : "");
-        }
-    } else {
-        DEBUGMSG_CFWD(INFO, "  incoming data=<%s>%s from=%s\n",
-            ccnl_prefix_to_str((*pkt)->pfx,s,CCNL_MAX_PREFIX_SIZE), ccnl_suite2str((*pkt)->suite), "");
-
-    }
+    // the peer is only formatted if the message is written
+    DEBUGMSG_CFWD(INFO, "  incoming data=<%s>%s from=%s\n",
+        ccnl_prefix_to_str((*pkt)->pfx,s,CCNL_MAX_PREFIX_SIZE), ccnl_suite2str((*pkt)->suite),
+        ccnl_fwd_peer2ascii(from));
+    CCNL_FACE_COUNT(from, data_in, 1);
 
 #if defined(USE_SUITE_CCNB) && defined(USE_SIGNATURES)
 //  FIXME: mgmt messages for NDN and other suites?
@@ -105,6 +113,7 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     if (!ccnl_content_serve_pending(relay, c)) { // unsolicited content
         // CONFORM: "A node MUST NOT forward unsolicited data [...]"
         DEBUGMSG_CFWD(DEBUG, "  removed because no matching interest\n");
+        CCNL_FACE_COUNT(from, drops[CCNL_DROP_UNSOLICITED], 1);
         ccnl_content_free(c);
         return 0;
     }
@@ -139,15 +148,11 @@ int
 ccnl_fwd_handleFragment(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                         struct ccnl_pkt_s **pkt, dispatchFct callback)
 {
-    unsigned char *data = (*pkt)->content;
-    int datalen = (*pkt)->contlen;
-
-    if (from) {
-        char *from_as_str = ccnl_addr2ascii(&(from->peer));
+    uint8_t *data = (*pkt)->content;
+    size_t datalen = (*pkt)->contlen;
 
-        DEBUGMSG_CFWD(INFO, "  incoming fragment (%zd bytes) from=%s\n", 
-            (*pkt)->buf->datalen, from_as_str ? from_as_str : "");
-    }
+    DEBUGMSG_CFWD(INFO, "  incoming fragment (%zd bytes) from=%s\n",
+        (*pkt)->buf->datalen, ccnl_fwd_peer2ascii(from));
 
     ccnl_frag_RX_BeginEnd2015(callback, relay, from,
                               relay->ifs[from->ifndx].mtu,
@@ -165,7 +170,7 @@ ccnl_fwd_handleFragment(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 int
 ccnl_pkt_fwdOK(struct ccnl_pkt_s *pkt)
 {
-    switch (pkt->suite) {
+    switch (CCNL_SUITE_OF(pkt->suite)) {
 #ifdef USE_SUITE_NDNTLV
     case CCNL_SUITE_NDNTLV:
         return pkt->s.ndntlv.scope > 2;
@@ -177,6 +182,30 @@ ccnl_pkt_fwdOK(struct ccnl_pkt_s *pkt)
     return -1;
 }
 
+// content named by hash h in the name index which satisfies pkt; for
+// MustBeFresh only content on the expiry queue or static content is tried
+static struct ccnl_content_s*
+ccnl_fwd_lookup_name(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
+                     uint64_t h, int mbf, cMatchFct cMatch)
+{
+    struct ccnl_content_s *c;
+
+    for (c = ccnl_content_lookup_name(relay, h); c; c = c->name_next) {
+        if (c->namehash != h ||
+            CCNL_SUITE_OF(c->pkt->pfx->suite) != CCNL_SUITE_OF(pkt->pfx->suite)) {
+            continue;
+        }
+        if (mbf && ((c->flags & CCNL_CONTENT_FLAGS_STALE) ||
+                    !(c->freshpos || (c->flags & CCNL_CONTENT_FLAGS_STATIC)))) {
+            continue;
+        }
+        if (!ccnl_fwd_cMatch(cMatch, pkt, c)) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
 int
 ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                         struct ccnl_pkt_s **pkt, cMatchFct cMatch)
@@ -184,29 +213,34 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     struct ccnl_interest_s *i;
     struct ccnl_content_s *c;
     int propagate= 0;
+    int mbf = 0;
+    uint32_t lifetime;
+    uint64_t h;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
     int32_t nonce = 0;
+#ifdef USE_SUITE_NDNTLV
     if (pkt != NULL && (*pkt) != NULL && (*pkt)->s.ndntlv.nonce != NULL) {
         if ((*pkt)->s.ndntlv.nonce->datalen == 4) {
             memcpy(&nonce, (*pkt)->s.ndntlv.nonce->data, 4);
         }
     }
+#endif
 
     if (from) {
-        char *from_as_str = ccnl_addr2ascii(&(from->peer));
 #ifndef CCNL_LINUXKERNEL
         DEBUGMSG_CFWD(INFO, "  incoming interest=<%s>%s nonce=%"PRIi32" from=%s\n",
              ccnl_prefix_to_str((*pkt)->pfx,s,CCNL_MAX_PREFIX_SIZE),
              ccnl_suite2str((*pkt)->suite), nonce,
-             from_as_str ? from_as_str : "");
+             ccnl_fwd_peer2ascii(from));
 #else
         DEBUGMSG_CFWD(INFO, "  incoming interest=<%s>%s nonce=%d from=%s\n",
             ccnl_prefix_to_str((*pkt)->pfx,s,CCNL_MAX_PREFIX_SIZE),
             ccnl_suite2str((*pkt)->suite), nonce,
-            from_as_str ? from_as_str : "");
+            ccnl_fwd_peer2ascii(from));
 #endif
     }
+    CCNL_FACE_COUNT(from, interests_in, 1);
 
 #ifdef USE_DUP_CHECK
 
@@ -216,6 +250,7 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     #else
         DEBUGMSG_CFWD(DEBUG, "  dropped because of duplicate nonce %d\n", nonce);
     #endif
+        CCNL_FACE_COUNT(from, drops[CCNL_DROP_DUPNONCE], 1);
         return 0;
     }
 #endif
@@ -232,7 +267,7 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 #endif
 
 #ifdef USE_SUITE_NDNTLV
-    if ((*pkt)->suite == CCNL_SUITE_NDNTLV && (*pkt)->pfx->compcnt == 4 &&
+    if (CCNL_SUITE_OF((*pkt)->suite) == CCNL_SUITE_NDNTLV && (*pkt)->pfx->compcnt == 4 &&
         !memcmp((*pkt)->pfx->comp[0], "ccnx", 4)) {
         DEBUGMSG_CFWD(INFO, "  found a mgmt message\n");
 #ifdef USE_MGMT
@@ -244,17 +279,62 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 
             // Step 1: search in content store
     DEBUGMSG_CFWD(DEBUG, "  searching in CS\n");
+    CCNL_HISTO_START(t);
+    h = ccnl_prefix_hash((*pkt)->pfx);
+    ccnl_admit_seen(relay, h);
 
-    for (c = relay->contents; c; c = c->next) {
-        if (c->pkt->pfx->suite != (*pkt)->pfx->suite)
-            continue;
-        if (cMatch(*pkt, c))
-            continue;
+    c = NULL;
+#ifdef USE_SUITE_NDNTLV
+    // stale content never satisfies MustBeFresh, cMatch rejects it
+    mbf = CCNL_SUITE_OF((*pkt)->suite) == CCNL_SUITE_NDNTLV && (*pkt)->s.ndntlv.mbf;
+    if (mbf) {
+        ccnl_content_expire(relay);
+    }
+#endif
+#ifdef USE_CCNxDIGEST
+    // a full name with implicit digest is a hash lookup
+    c = ccnl_content_lookup_fullname(relay, (*pkt)->pfx);
+    if (c
+#ifdef USE_SUITE_CCNTLV
+        // the CCNx cMatch compares names, the lookup has compared the digest
+        && CCNL_SUITE_OF((*pkt)->pfx->suite) != CCNL_SUITE_CCNTLV
+#endif
+        && ccnl_fwd_cMatch(cMatch, *pkt, c)) {
+        c = NULL;
+    }
+#endif
+    if (!c) {
+        // content with exactly the Interest's name is in the name index
+        c = ccnl_fwd_lookup_name(relay, *pkt, h, mbf, cMatch);
+    }
+#ifdef USE_SUITE_NDNTLV
+    if (!c && mbf && (*pkt)->pfx->compcnt > 0) {
+        // a name with its implicit digest: the content is indexed without it
+        uint64_t hp = CCNL_PREFIX_HASH_INIT;
+        uint32_t k;
 
+        for (k = 0; k + 1 < (*pkt)->pfx->compcnt; k++) {
+            hp = ccnl_prefix_hash_comp(hp, (*pkt)->pfx->comp[k], (*pkt)->pfx->complen[k]);
+        }
+        c = ccnl_fwd_lookup_name(relay, *pkt, hp, mbf, cMatch);
+    }
+#endif
+    if (!c && !mbf) {
+        for (c = relay->contents; c; c = c->next) {
+            if (CCNL_SUITE_OF(c->pkt->pfx->suite) != CCNL_SUITE_OF((*pkt)->pfx->suite))
+                continue;
+            if (!ccnl_fwd_cMatch(cMatch, *pkt, c))
+                break;
+        }
+    }
+    CCNL_HISTO_STOP(CCNL_HISTO_CS, t);
+    if (c) {
         DEBUGMSG_CFWD(DEBUG, "  found matching content %p\n", (void *) c);
+        CCNL_FACE_COUNT(from, cs_hits, 1);
 
         if (from) {
             if (from->ifndx >= 0) {
+                CCNL_FACE_COUNT(from, data_out, 1);
                 ccnl_send_pkt(relay, from, c->pkt);
             } else {
 #ifdef CCNL_APP_RX 
@@ -266,9 +346,22 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         return 0; // we are done
     }
 
+    // a secondary content store may still have a copy
+    switch (ccnl_callback_cs_miss(relay, from, pkt)) {
+    case 0:
+        break;
+    case CCNL_CS_MISS_DEFERRED: // counted once it is answered
+        return 0;
+    default:
+        CCNL_FACE_COUNT(from, cs_hits, 1);
+        return 0;
+    }
+    CCNL_FACE_COUNT(from, cs_misses, 1);
+
     // CONFORM: Step 2: check whether interest is already known
-    for (i = relay->pit; i; i = i->next)
-        if (ccnl_interest_isSame(i, *pkt))
+    CCNL_HISTO_START(t2);
+    for (i = ccnl_interest_lookup_name(relay, h); i; i = i->name_next)
+        if (i->namehash == h && ccnl_interest_isSame(i, *pkt))
             break;
 
     if (!i) { // this is a new/unknown I request: create and propagate
@@ -276,6 +369,7 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     }
     if (!ccnl_pkt_fwdOK(*pkt))
         return -1;
+    lifetime = (uint32_t) ccnl_pkt_interest_lifetime(*pkt);
     if (!i) {
         i = ccnl_interest_new(relay, from, pkt);
 
@@ -285,7 +379,11 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     }
     if (i) { // store the I request, for the incoming face (Step 3)
         DEBUGMSG_CFWD(DEBUG, "  appending interest entry %p\n", (void *) i);
-        ccnl_interest_append_pending(i, from);
+        if (!propagate) {
+            CCNL_FACE_COUNT(from, pit_aggregated, 1);
+        }
+        ccnl_interest_append_pending(i, from, nonce, lifetime);
+        CCNL_HISTO_STOP(CCNL_HISTO_PIT, t2);
         if(propagate) {
             ccnl_interest_propagate(relay, i);
         }
@@ -307,9 +405,12 @@ ccnl_ccnb_fwd(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 
     DEBUGMSG_CFWD(DEBUG, "ccnb fwd (%zu bytes left)\n", *datalen);
 
+    CCNL_HISTO_START(t);
     pkt = ccnl_ccnb_bytes2pkt(*data - 2, data, datalen);
+    CCNL_HISTO_STOP(CCNL_HISTO_PARSE, t);
     if (!pkt) {
         DEBUGMSG_CFWD(WARNING, "  parsing error or no prefix\n");
+        CCNL_FACE_COUNT(from, drops[CCNL_DROP_MALFORMED], 1);
         goto Done;
     }
     pkt->type = typ;
@@ -436,6 +537,10 @@ ccnl_ccntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     *data += hdrlen;
     *datalen -= hdrlen;
 
+    if (hp->pkttype == CCNX_PT_NACK) {
+        CCNL_FACE_COUNT(from, nacks_in, 1);
+    }
+
     if (hp->pkttype == CCNX_PT_Interest ||
 #ifdef USE_FRAG
         hp->pkttype == CCNX_PT_Fragment ||
@@ -444,19 +549,28 @@ ccnl_ccntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         hp->hoplimit--;
         if (hp->hoplimit <= 0) { // drop it
             DEBUGMSG_CFWD(DEBUG, "  pkt dropped because of hop limit\n");
+            CCNL_FACE_COUNT(from, drops[CCNL_DROP_HOPLIMIT], 1);
             *data += payloadlen;
             *datalen -= payloadlen;
             return 0;
         }
     }
 
+    // duplicates, cached and pending names are handled without parsing
+    if (hp->pkttype == CCNX_PT_Interest &&
+        ccnl_fast_ccntlv_interest(relay, from, *data, payloadlen) != CCNL_FAST_PARSE) {
+        *data += payloadlen;
+        *datalen -= payloadlen;
+        return 0;
+    }
+
     DEBUGMSG_CFWD(DEBUG, "ccnl_ccntlv_forwarder (%zu bytes left, hdrlen=%zu)\n",
                   *datalen, hdrlen);
 
 #ifdef USE_FRAG
     if (hp->pkttype == CCNX_PT_Fragment) {
         uint16_t *sp = (uint16_t*) *data;
-        int fraglen = ntohs(*(sp+1));
+        size_t fraglen = ntohs(*(sp+1));
 
         if (ntohs(*sp) == CCNX_TLV_TL_Fragment && fraglen == (payloadlen-4)) {
             uint16_t fragfields; // = *(uint16_t *) &hp->fill;
@@ -471,15 +585,15 @@ ccnl_ccntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                             relay->ifs[from->ifndx].mtu, fragfields >> 14,
                             fragfields & 0x3fff, data, datalen);
 
-            DEBUGMSG_CFWD(TRACE, "  done (fraglen=%d, payloadlen=%d, *datalen=%d)\n",
+            DEBUGMSG_CFWD(TRACE, "  done (fraglen=%zu, payloadlen=%zu, *datalen=%zu)\n",
                      fraglen, payloadlen, *datalen);
         } else {
-            DEBUGMSG_CFWD(DEBUG, "  problem with frag type or length (%d, %d, %d)\n",
+            DEBUGMSG_CFWD(DEBUG, "  problem with frag type or length (%d, %zu, %zu)\n",
                      ntohs(*sp), fraglen, payloadlen);
             *data += payloadlen;
             *datalen -= payloadlen;
         }
-        DEBUGMSG_CFWD(TRACE, "  returning after fragment: %d bytes\n", *datalen);
+        DEBUGMSG_CFWD(TRACE, "  returning after fragment: %zu bytes\n", *datalen);
         return 0;
     } else {
         DEBUGMSG_CFWD(TRACE, "  not a fragment, continueing\n");
@@ -490,9 +604,12 @@ ccnl_ccntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         DEBUGMSG_CFWD(TRACE, "  local data, datalen=%zu\n", *datalen);
     }
 
+    CCNL_HISTO_START(t);
     pkt = ccnl_ccntlv_bytes2pkt(start, data, datalen);
+    CCNL_HISTO_STOP(CCNL_HISTO_PARSE, t);
     if (!pkt) {
         DEBUGMSG_CFWD(WARNING, "  parsing error or no prefix\n");
+        CCNL_FACE_COUNT(from, drops[CCNL_DROP_MALFORMED], 1);
         goto Done;
     }
     if (!from) {
@@ -551,9 +668,18 @@ ccnl_ndntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         DEBUGMSG_CFWD(TRACE, "  invalid packet format\n");
         return -1;
     }
+    if (typ == NDN_TLV_Interest &&
+        ccnl_fast_ndntlv_interest(relay, from, *data, len) != CCNL_FAST_PARSE) {
+        *data += len;
+        *datalen -= len;
+        return 0;
+    }
+    CCNL_HISTO_START(t);
     pkt = ccnl_ndntlv_bytes2pkt(typ, start, data, datalen);
+    CCNL_HISTO_STOP(CCNL_HISTO_PARSE, t);
     if (!pkt) {
         DEBUGMSG_CFWD(INFO, "  ndntlv packet coding problem\n");
+        CCNL_FACE_COUNT(from, drops[CCNL_DROP_MALFORMED], 1);
         goto Done;
     }
     pkt->type = typ;
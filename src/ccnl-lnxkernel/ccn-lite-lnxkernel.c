@@ -111,6 +111,7 @@
 #include "../../ccnl-core/src/ccnl-pkt-util.c"
 #include "../../ccnl-core/src/ccnl-sockunion.c"
 #include "../../ccnl-fwd/src/ccnl-fwd.c"
+#include "../../ccnl-fwd/src/ccnl-fastpath.c"
 #include "../../ccnl-fwd/src/ccnl-dispatch.c"
 #include "../../ccnl-core/src/ccnl-mgmt.c"
 
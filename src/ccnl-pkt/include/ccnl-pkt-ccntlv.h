@@ -216,4 +216,14 @@ ccnl_ccntlv_prependFixedHdr(uint8_t ver,
                             uint8_t hoplimit,
                             size_t *offset, uint8_t *buf);
 
+#ifdef USE_FRAG
+/**
+ * @brief Builds the fixed header and Fragment TL of the next fragment of
+ *        \p fr, see ccnl_ndntlv_mkFragHdr()
+ */
+int8_t
+ccnl_ccntlv_mkFragHdr(struct ccnl_frag_s *fr, uint8_t *hdr, size_t *hdrlen,
+                      size_t *datalen);
+#endif
+
 #endif // eof
@@ -198,4 +198,18 @@ int8_t
 ccnl_ndntlv_prependName(struct ccnl_prefix_s *name,
                         size_t *offset, uint8_t *buf);
 
+#ifdef USE_FRAG
+struct ccnl_frag_s;
+
+/**
+ * @brief Builds the header of the next fragment of \p fr, in front of at
+ *        most \p datalen bytes of the packet so that it fits the MTU
+ *
+ * @return 0 on success, -1 if no fragment fits
+ */
+int8_t
+ccnl_ndntlv_mkFragHdr(struct ccnl_frag_s *fr, uint8_t *hdr, size_t *hdrlen,
+                      size_t *datalen);
+#endif
+
 #endif // EOF
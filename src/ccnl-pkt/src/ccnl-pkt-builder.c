@@ -318,7 +318,11 @@ ccnl_mkContent(struct ccnl_prefix_s *name, uint8_t *payload, size_t paylen, uint
     switch (name->suite) {
 #ifdef USE_SUITE_CCNB
         case CCNL_SUITE_CCNB:
-            ccnl_ccnb_fillContent(name, payload, paylen, contentpos, tmp, tmp + *len, len);
+            // *offs is still the buffer size here
+            if (ccnl_ccnb_fillContent(name, payload, paylen, contentpos, tmp,
+                                      tmp + *offs, len)) {
+                return -1;
+            }
             *offs = 0;
             break;
 #endif
@@ -94,8 +94,6 @@ int8_t
 ccnl_ccntlv_dehead(uint8_t **buf, size_t *len,
                    uint16_t *typ, size_t *vallen)
 {
-    size_t maxlen = *len;
-
     if (*len < 4) { //ensure that len is not negative!
         return -1;
     }
@@ -103,7 +101,7 @@ ccnl_ccntlv_dehead(uint8_t **buf, size_t *len,
     *vallen = ((*buf)[2] << 8U) | (*buf)[3];
     *len -= 4;
     *buf += 4;
-    if (*vallen > maxlen) {
+    if (*vallen > *len) {
         return -1; //Return failure (-1) if length value in the tlv is longer than the buffer
     }
     return 0;
@@ -233,8 +231,19 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
                 goto Bail;
             }
             if (typ == CCNX_VALIDALGO_HMAC_SHA256) {
-                // ignore keyId and other algo dependent data ... && len3 == 0)
                 validAlgoIsHmac256 = 1;
+                // algo dependent data: we only pick up the keyId
+                len2 = len3;
+                while (len2 > 0) {
+                    if (ccnl_ccntlv_dehead(&cp, &len2, &typ, &len3)) {
+                        goto Bail;
+                    }
+                    if (typ == CCNX_VALIDALGO_KEYID && !pkt->s.ccntlv.keyid) {
+                        pkt->s.ccntlv.keyid = ccnl_buf_new(cp, len3);
+                    }
+                    cp += len3;
+                    len2 -= len3;
+                }
             }
             break;
         case CCNX_TLV_TL_ValidationPayload:
@@ -272,7 +281,9 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
     }
 #ifdef USE_HMAC256
     pkt->hmacStart = pkt->buf->data + (pkt->hmacStart - start);
-    pkt->hmacSignature = pkt->buf->data + (pkt->hmacSignature - start);
+    if (pkt->hmacSignature) {
+        pkt->hmacSignature = pkt->buf->data + (pkt->hmacSignature - start);
+    }
 #endif
 
     return pkt;
@@ -575,57 +586,43 @@ ccnl_ccntlv_prependContentWithHdr(struct ccnl_prefix_s *name,
 
 #ifdef USE_FRAG
 
-// produces a full FRAG packet. It does not write, just read the fields in *fr
-struct ccnl_buf_s*
-ccnl_ccntlv_mkFrag(struct ccnl_frag_s *fr, unsigned int *consumed)
+// It does not write, just read the fields in *fr
+int8_t
+ccnl_ccntlv_mkFragHdr(struct ccnl_frag_s *fr, uint8_t *hdr, size_t *hdrlen,
+                      size_t *datalen)
 {
-    size_t datalen;
-    struct ccnl_buf_s *buf;
-    struct ccnx_tlvhdr_ccnx2015_s *fp;
+    struct ccnx_tlvhdr_ccnx2015_s *fp = (struct ccnx_tlvhdr_ccnx2015_s*) hdr;
     uint16_t tmp;
 
-    DEBUGMSG_PCNX(TRACE, "ccnl_ccntlv_mkFrag seqno=%u\n", fr->sendseq);
+    DEBUGMSG_PCNX(TRACE, "ccnl_ccntlv_mkFragHdr seqno=%u\n", fr->sendseq);
 
-    datalen = fr->mtu - sizeof(*fp) - 4;
-    if (datalen > (fr->bigpkt->datalen - fr->sendoffs)) {
-        datalen = fr->bigpkt->datalen - fr->sendoffs;
+    *hdrlen = sizeof(*fp) + 4;
+    if (fr->mtu <= 0 || (size_t) fr->mtu <= *hdrlen) {
+        return -1;
     }
-    if (datalen > UINT16_MAX) {
-        return NULL;
+    *datalen = fr->mtu - *hdrlen;
+    if (*datalen > (fr->bigpkt->datalen - fr->sendoffs)) {
+        *datalen = fr->bigpkt->datalen - fr->sendoffs;
     }
-
-    buf = ccnl_buf_new(NULL, sizeof(*fp) + 4 + datalen);
-    if (!buf) {
-        return NULL;
+    if (*hdrlen + *datalen > UINT16_MAX) {
+        return -1;
     }
-    fp = (struct ccnx_tlvhdr_ccnx2015_s*) buf->data;
+
     memset(fp, 0, sizeof(*fp));
     fp->version = CCNX_TLV_V1;
     fp->pkttype = CCNX_PT_Fragment;
     fp->hdrlen = sizeof(*fp);
-    fp->pktlen = htons(sizeof(*fp) + 4 + datalen);
+    fp->pktlen = htons((uint16_t) (*hdrlen + *datalen));
 
     tmp = htons(CCNX_TLV_TL_Fragment);
     memcpy(fp+1, &tmp, 2);
-    tmp = htons((uint16_t) datalen);
+    tmp = htons((uint16_t) *datalen);
     memcpy((char*)(fp+1) + 2, &tmp, 2);
-    memcpy((char*)(fp+1) + 4, fr->bigpkt->data + fr->sendoffs, datalen);
-
-    tmp = fr->sendseq & 0x03fff;
-    if (datalen >= fr->bigpkt->datalen) {   // single
-        tmp |= CCNL_BEFRAG_FLAG_SINGLE << 14;
-    } else if (fr->sendoffs == 0) {          // start
-        tmp |= CCNL_BEFRAG_FLAG_FIRST  << 14;
-    } else if(datalen >= (fr->bigpkt->datalen - fr->sendoffs)) { // end
-        tmp |= CCNL_BEFRAG_FLAG_LAST   << 14;
-    } else {                                  // middle
-        tmp |= CCNL_BEFRAG_FLAG_MID    << 14;
-    }
-    tmp = htons(tmp);
+
+    tmp = htons(ccnl_frag_fields(fr, *datalen));
     memcpy(fp->fill, &tmp, 2);
 
-    *consumed = datalen;
-    return buf;
+    return 0;
 }
 #endif
 
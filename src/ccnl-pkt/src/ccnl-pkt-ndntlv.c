@@ -45,7 +45,10 @@
 int8_t
 ccnl_ndntlv_varlenint(uint8_t **buf, size_t *len, uint64_t *val)
 {
-    if (**buf < 253 && *len >= 1) {
+    if (*len < 1) {
+        return -1;
+    }
+    if (**buf < 253) {
         *val = **buf;
         *buf += 1;
         *len -= 1;
@@ -83,7 +86,6 @@ int8_t
 ccnl_ndntlv_dehead(uint8_t **buf, size_t *len,
                    uint64_t *typ, size_t *vallen)
 {
-    size_t maxlen = *len;
     uint64_t vallen_int = 0;
     if (ccnl_ndntlv_varlenint(buf, len, typ)) {
         return -1;
@@ -95,7 +97,7 @@ ccnl_ndntlv_dehead(uint8_t **buf, size_t *len,
         return -1; // Return failure (-1) if length value in the tlv exceeds size_t bounds
     }
     *vallen = (size_t) vallen_int;
-    if (*vallen > maxlen) {
+    if (*vallen > *len) {
         return -1; // Return failure (-1) if length value in the tlv is longer than the buffer
     }
     return 0;
@@ -286,7 +288,17 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
                 if (typ == NDN_TLV_SignatureType && i == 1 &&
                                           *cp == NDN_VAL_SIGTYPE_HMAC256) {
                     validAlgoIsHmac256 = 1;
-                    break;
+                }
+                if (typ == NDN_TLV_KeyLocator && !pkt->s.ndntlv.ppkl) {
+                    uint8_t *cp2 = cp;
+                    size_t len3 = i, i2;
+
+                    if (ccnl_ndntlv_dehead(&cp2, &len3, &typ, &i2)) {
+                        goto Bail;
+                    }
+                    if (typ == NDN_TLV_KeyLocatorDigest) {
+                        pkt->s.ndntlv.ppkl = ccnl_buf_new(cp2, i2);
+                    }
                 }
                 cp += i;
                 len2 -= i;
@@ -327,6 +339,12 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
             prefix->nameptr = pkt->buf->data + (prefix->nameptr - start);
         }
     }
+#ifdef USE_HMAC256
+    pkt->hmacStart = pkt->buf->data;
+    if (pkt->hmacSignature) {
+        pkt->hmacSignature = pkt->buf->data + (pkt->hmacSignature - start);
+    }
+#endif
 
     return pkt;
 Bail:
@@ -677,70 +695,63 @@ ccnl_ndntlv_prependContent(struct ccnl_prefix_s *name,
 
 #ifdef USE_FRAG
 
-// produces a full FRAG packet. It does not write, just read the fields in *fr
-struct ccnl_buf_s*
-ccnl_ndntlv_mkFrag(struct ccnl_frag_s *fr, unsigned int *consumed)
+static int8_t
+ccnl_ndntlv_prependFragHdr(uint16_t fields, size_t datalen,
+                           size_t *offset, uint8_t *buf)
 {
-    unsigned char test[20];
-    size_t offset, hdrlen;
-    long datalen;
-    struct ccnl_buf_s *buf;
-    uint16_t tmp = 0;
+    size_t oldoffset = *offset;
 
-    DEBUGMSG(TRACE, "ccnl_ndntlv_mkFrag seqno=%d\n", fr->sendseq);
+    if (ccnl_ndntlv_prependTL(NDN_TLV_NdnlpFragment, datalen, offset, buf) ||
+        *offset < 2) {
+        return -1;
+    }
+    *offset -= 2;
+    buf[*offset] = (uint8_t) (fields >> 8);
+    buf[*offset + 1] = (uint8_t) fields;
+    if (ccnl_ndntlv_prependTL(NDN_TLV_Frag_BeginEndFields, 2, offset, buf) ||
+        ccnl_ndntlv_prependTL(NDN_TLV_Fragment, oldoffset - *offset + datalen,
+                              offset, buf)) {
+        return -1;
+    }
+    return 0;
+}
+
+// It does not write, just read the fields in *fr
+int8_t
+ccnl_ndntlv_mkFragHdr(struct ccnl_frag_s *fr, uint8_t *hdr, size_t *hdrlen,
+                      size_t *datalen)
+{
+    uint8_t tmp[CCNL_FRAG_MAXHDR];
+    size_t offset = sizeof(tmp), maxlen;
+
+    DEBUGMSG(TRACE, "ccnl_ndntlv_mkFragHdr seqno=%u\n", fr->sendseq);
 
+    if (fr->mtu <= 0) {
+        return -1;
+    }
     // pre-compute overhead, first
-    datalen = fr->bigpkt->datalen - fr->sendoffs;
-    if (datalen > fr->mtu) {
-        datalen = fr->mtu;
-    }
-    offset = sizeof(test);
-    hdrlen = ccnl_ndntlv_prependTL(NDN_TLV_NdnlpFragment, datalen,
-                                   &offset, test);
-    hdrlen += ccnl_ndntlv_prependTL(NDN_TLV_Frag_BeginEndFields, 2,
-                                    &offset, test) + 2;
-    hdrlen += ccnl_ndntlv_prependTL(NDN_TLV_Fragment, hdrlen + datalen,
-                                    &offset, test);
+    *datalen = fr->bigpkt->datalen - fr->sendoffs;
+    if (*datalen > (size_t) fr->mtu) {
+        *datalen = fr->mtu;
+    }
+    if (ccnl_ndntlv_prependFragHdr(0, *datalen, &offset, tmp) ||
+                                    (size_t) fr->mtu <= sizeof(tmp) - offset) {
+        return -1;
+    }
 
     // with real values:
-    datalen = fr->bigpkt->datalen - fr->sendoffs;
-    if (datalen > (fr->mtu - hdrlen)) {
-        datalen = fr->mtu - hdrlen;
-    }
-
-    buf = ccnl_buf_new(NULL, datalen + hdrlen);
-    if (!buf) {
-        return 0;
-    }
-    offset = buf->datalen - datalen;
-    memcpy(buf->data + offset,
-           fr->bigpkt->data + fr->sendoffs, datalen);
-    ccnl_ndntlv_prependTL(NDN_TLV_NdnlpFragment, datalen,
-                          &offset, buf->data);
-
-    tmp = fr->sendseq & 0x03fff;
-    if (datalen >= fr->bigpkt->datalen) {            // single
-        tmp |= CCNL_DTAG_FRAG_FLAG_SINGLE << 14;
-    } else if (fr->sendoffs == 0) {                  // start
-        tmp |= CCNL_DTAG_FRAG_FLAG_FIRST << 14;
-    } else if((unsigned) datalen >= (fr->bigpkt->datalen - fr->sendoffs)) { // end
-        tmp |= CCNL_DTAG_FRAG_FLAG_LAST << 14;
-    } else
-        tmp |= CCNL_DTAG_FRAG_FLAG_MID << 14;        // middle
-    offset -= 2;
-    *(uint16_t*) (buf->data + offset) = htons(tmp);
-    tmp = ccnl_ndntlv_prependTL(NDN_TLV_Frag_BeginEndFields, 2,
-                          &offset, buf->data);
-    tmp = ccnl_ndntlv_prependTL(NDN_TLV_Fragment, buf->datalen - offset,
-                          &offset, buf->data);
-
-    if (offset > 0) {
-        buf->datalen -= offset;
-        memmove(buf->data, buf->data + offset, buf->datalen);
-    }
-
-    *consumed = datalen;
-    return buf;
+    maxlen = fr->mtu - (sizeof(tmp) - offset);
+    if (*datalen > maxlen) {
+        *datalen = maxlen;
+    }
+    offset = sizeof(tmp);
+    if (ccnl_ndntlv_prependFragHdr(ccnl_frag_fields(fr, *datalen), *datalen,
+                                   &offset, tmp)) {
+        return -1;
+    }
+    *hdrlen = sizeof(tmp) - offset;
+    memcpy(hdr, tmp + offset, *hdrlen);
+    return 0;
 }
 #endif // USE_FRAG
 
@@ -28,6 +28,7 @@
 #include <sys/types.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <signal.h>
 
 #ifdef USE_HTTP_STATUS
 #include "ccnl-http-status.h"
@@ -68,6 +69,15 @@
 
 #include "ccn-lite-relay.h"
 #include "ccnl-unix.h"
+#include "ccnl-segment.h"
+#include "ccnl-diskstore.h"
+#include "ccnl-ethring.h"
+#include "ccnl-uring.h"
+#include "ccnl-stream.h"
+#include "ccnl-logring.h"
+#include "ccnl-snapshot.h"
+#include "ccnl-verify.h"
+#include "ccnl-callbacks.h"
 
 static int lasthour = -1;
 static int inter_ccn_interval = 0; // in usec
@@ -140,6 +150,22 @@ const char *compile_string = ""
 
 // ----------------------------------------------------------------------
 
+static struct ccnl_relay_s *running_relay;
+static char *snapshot_path;
+
+static void
+relay_sigterm(int sig)
+{
+    (void) sig;
+    running_relay->halt_flag = 1;
+}
+
+static int
+relay_snapshot(struct ccnl_relay_s *relay)
+{
+    return ccnl_snapshot_save(relay, snapshot_path);
+}
+
 // ----------------------------------------------------------------------
 
 int
@@ -149,7 +175,8 @@ main(int argc, char **argv)
     int udpport1 = -1, udpport2 = -1;
     int udp6port1 = -1, udp6port2 = -1;
     char *datadir = NULL, *ethdev = NULL, *crypto_sock_path = NULL;
-    char *wpandev = NULL;
+    char *wpandev = NULL, *diskdir = NULL, *keyfile = NULL;
+    uint64_t disklimit = 0;
     int suite = CCNL_SUITE_DEFAULT;
     struct ccnl_relay_s *theRelay = ccnl_calloc(1, sizeof(struct ccnl_relay_s));
 #ifdef USE_UNIXSOCKET
@@ -160,6 +187,15 @@ main(int argc, char **argv)
 #ifdef USE_ECHO
     char *echopfx = NULL;
 #endif
+    char *backend = "select";
+    char *admission = NULL;
+#ifdef USE_LOGGING
+    int logring = 0;
+#endif
+#ifdef USE_STREAM
+    int tcpport = -1;
+    char *uxstreampath = NULL;
+#endif
 
     time(&theRelay->startup_time);
     unsigned int seed = time(NULL) * getpid();
@@ -169,8 +205,21 @@ main(int argc, char **argv)
     srandom(seed);
 #endif
 
-    while ((opt = getopt(argc, argv, "hc:d:e:g:i:o:p:s:t:u:6:v:w:x:")) != -1) {
+    while ((opt = getopt(argc, argv, "a:Ab:hHc:d:D:e:g:K:L:S:i:o:p:s:t:T:u:6:v:w:x:X:")) != -1) {
         switch (opt) {
+        case 'a':
+            admission = optarg;
+            break;
+        case 'b':
+            backend = optarg;
+            if (strcmp(backend, "select")
+#ifdef USE_IO_URING
+                && strcmp(backend, "uring")
+#endif
+                ) {
+                goto usage;
+            }
+            break;
         case 'c': {
             long max_cache_entries_l;
             errno = 0;
@@ -184,6 +233,9 @@ main(int argc, char **argv)
         case 'd':
             datadir = optarg;
             break;
+        case 'D':
+            diskdir = optarg;
+            break;
         case 'e':
             ethdev = optarg;
             break;
@@ -230,6 +282,21 @@ main(int argc, char **argv)
             httpport = (int) httpport_l;
             break;
         }
+#ifdef USE_STREAM
+        case 'T': {
+            long tcpport_l;
+            errno = 0;
+            tcpport_l = strtol(optarg, (char **) NULL, 10);
+            if (errno || tcpport_l <= 0 || tcpport_l > UINT16_MAX) {
+                goto usage;
+            }
+            tcpport = (int) tcpport_l;
+            break;
+        }
+        case 'X':
+            uxstreampath = optarg;
+            break;
+#endif
         case 'u':
             if (udpport1 == -1) {
                 long udpport1_l;
@@ -278,16 +345,42 @@ main(int argc, char **argv)
                     goto usage;
                 }
                 debug_level = (int) debuglevel_l;
-            } else {
-                debug_level = ccnl_debug_str2level(optarg);
+            } else if (ccnl_debug_setlevels(optarg)) {
+                goto usage;
             }
 #endif
             break;
+#ifdef USE_LOGGING
+        case 'A':
+            logring = 1;
+            break;
+#endif
 #ifdef USE_WPAN
         case 'w':
             wpandev = optarg;
             break;
 #endif
+#ifdef USE_HISTOGRAMS
+        case 'H':
+            ccnl_histo_on = 1;
+            break;
+#endif
+        case 'K':
+            keyfile = optarg;
+            break;
+        case 'L': {
+            unsigned long long disklimit_l;
+            errno = 0;
+            disklimit_l = strtoull(optarg, (char **) NULL, 10);
+            if (errno || disklimit_l == 0 || disklimit_l > UINT64_MAX / (1024 * 1024)) {
+                goto usage;
+            }
+            disklimit = (uint64_t) disklimit_l * 1024 * 1024;
+            break;
+        }
+        case 'S':
+            snapshot_path = optarg;
+            break;
         case 'x':
             uxpath = optarg;
             break;
@@ -296,29 +389,52 @@ main(int argc, char **argv)
 usage:
             fprintf(stderr,
                     "usage: %s [options]\n"
+                    "  -a POLICY (CS admission: all, prob:P, second, tinylfu)\n"
+#ifdef USE_LOGGING
+                    "  -A (log from a background thread)\n"
+#endif
+#ifdef USE_IO_URING
+                    "  -b BACKEND (select, uring)\n"
+#endif
                     "  -c MAX_CONTENT_ENTRIES\n"
-                    "  -d databasedir\n"
+                    "  -d databasedir or content segment file\n"
+                    "  -D diskstoredir (second tier content store)\n"
                     "  -e ethdev\n"
                     "  -g MIN_INTER_PACKET_INTERVAL\n"
                     "  -h\n"
+#ifdef USE_HISTOGRAMS
+                    "  -H (record latency histograms)\n"
+#endif
                     "  -i MIN_INTER_CCNMSG_INTERVAL\n"
+#ifdef USE_HMAC256
+                    "  -K keyfile (HMAC256 keys, base64 encoded: only verified data is accepted)\n"
+#endif
+                    "  -L DISKSTORE_LIMIT_MB\n"
 #ifdef USE_ECHO
                     "  -o echo_prefix\n"
 #endif
                     "  -p crypto_face_ux_socket\n"
                     "  -s SUITE (ccnb, ccnx2015, ndn2013)\n"
+                    "  -S snapshotfile (loaded at start, saved on SIGTERM)\n"
                     "  -t tcpport (for HTML status page)\n"
+#ifdef USE_STREAM
+                    "  -T tcpport (for TCP faces)\n"
+#endif
                     "  -u udpport (can be specified twice)\n"
                     "  -6 udp6port (can be specified twice)\n"
 
 #ifdef USE_LOGGING
-                    "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
+                    "  -v DEBUG_LEVEL[,MODULE=LEVEL...] (fatal, error, warning, info, debug, verbose, trace;\n"
+                    "     modules core, cfwd, cutl, efra, pcnx, piot, pndn)\n"
 #endif
 #ifdef USE_WPAN
                     "  -w wpandev\n"
 #endif
 #ifdef USE_UNIXSOCKET
                     "  -x unixpath\n"
+#endif
+#ifdef USE_STREAM
+                    "  -X unixpath (for Unix stream faces)\n"
 #endif
                     , argv[0]);
             exit(EXIT_FAILURE);
@@ -333,6 +449,11 @@ usage:
         httpport = opt;
     }
 
+#ifdef USE_LOGGING
+    if (logring && ccnl_logring_open()) {
+        DEBUGMSG(WARNING, "could not start the log writer, logging directly\n");
+    }
+#endif
     ccnl_core_init();
 
     DEBUGMSG(INFO, "This is ccn-lite-relay, starting at %s",
@@ -346,9 +467,56 @@ usage:
     ccnl_relay_config(theRelay, ethdev, wpandev, udpport1, udpport2,
                       udp6port1, udp6port2, httpport,
                       uxpath, suite, max_cache_entries, crypto_sock_path);
+    if (admission && ccnl_admit_set(theRelay, admission)) {
+        DEBUGMSG(ERROR, "unknown CS admission policy %s\n", admission);
+        exit(EXIT_FAILURE);
+    }
+#ifdef USE_STREAM
+    if (tcpport > 0) {
+        sockunion su;
+
+        memset(&su, 0, sizeof(su));
+        su.ip4.sin_family = AF_INET;
+        su.ip4.sin_addr.s_addr = htonl(INADDR_ANY);
+        su.ip4.sin_port = htons((uint16_t) tcpport);
+        if (ccnl_stream_listen(theRelay, &su)) {
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (uxstreampath) {
+        sockunion su;
+
+        memset(&su, 0, sizeof(su));
+        su.ux.sun_family = AF_UNIX;
+        strncpy(su.ux.sun_path, uxstreampath, sizeof(su.ux.sun_path) - 1);
+        if (ccnl_stream_listen(theRelay, &su)) {
+            exit(EXIT_FAILURE);
+        }
+    }
+#endif
     if (datadir) {
         ccnl_populate_cache(theRelay, datadir);
     }
+    if (diskdir && ccnl_diskstore_open(theRelay, diskdir, disklimit)) {
+        DEBUGMSG(ERROR, "could not open disk store %s\n", diskdir);
+        exit(EXIT_FAILURE);
+    }
+#ifdef USE_HMAC256
+    if (keyfile && ccnl_verify_open(theRelay, keyfile, 0)) {
+        DEBUGMSG(ERROR, "could not load keys from %s\n", keyfile);
+        exit(EXIT_FAILURE);
+    }
+#else
+    (void) keyfile;
+#endif
+    if (snapshot_path) {
+        if (!access(snapshot_path, F_OK)) {
+            ccnl_snapshot_load(theRelay, snapshot_path);
+        }
+        ccnl_set_cb_snapshot(relay_snapshot);
+        running_relay = theRelay;
+        signal(SIGTERM, relay_sigterm);
+    }
 
 #ifdef USE_ECHO
     if (echopfx) {
@@ -362,16 +530,42 @@ usage:
     }
 #endif
 
-    ccnl_io_loop(theRelay);
+#ifdef USE_IO_URING
+    if (!strcmp(backend, "uring") && ccnl_uring_loop(theRelay) < 0) {
+        DEBUGMSG(WARNING, "no io_uring, falling back to select()\n");
+        backend = "select";
+    }
+#endif
+    if (!strcmp(backend, "select")) {
+        ccnl_io_loop(theRelay);
+    }
 
     while (eventqueue) {
         ccnl_rem_timer(eventqueue);
     }
 
+    if (snapshot_path) {
+        ccnl_snapshot_save(theRelay, snapshot_path);
+    }
+
+#ifdef USE_HMAC256
+    ccnl_verify_close();
+#endif
+    ccnl_diskstore_close();
+    ccnl_segment_detach_all();
+#ifdef USE_PACKET_MMAP
+    ccnl_ethring_close_all(theRelay);
+#endif
+#ifdef USE_STREAM
+    ccnl_stream_close_all(theRelay);
+#endif
     ccnl_core_cleanup(theRelay);
 #ifdef USE_HTTP_STATUS
     theRelay->http = ccnl_http_cleanup(theRelay->http);
 #endif
+#ifdef USE_LOGGING
+    ccnl_logring_close();
+#endif
 #ifdef USE_DEBUG_MALLOC
     debug_memdump();
 #endif
@@ -0,0 +1,94 @@
+/*
+ * @f ccnl-diskstore.h
+ * @b CCN lite, disk backed second tier of the Content Store
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * The disk store keeps content evicted from the in-memory Content Store in
+ * append-only log files (DIR/XXXXXXXX.log). Each record is a
+ * struct ccnl_disk_rechdr_s followed by the wire encoded Data packet. An
+ * in-memory hash table maps name hashes to records; it is rebuilt by
+ * scanning the logs at startup.
+ *
+ * All file I/O is done by a worker thread which processes jobs in FIFO
+ * order. Completed jobs go on a list, and a pipe that is part of the relay's
+ * select loop wakes up the main thread to take them. An Interest which misses the memory CS but hits the index is
+ * put into the PIT without being forwarded; it is satisfied when the read
+ * completes, or forwarded if the read fails or its data does not satisfy it.
+ *
+ * Log files whose live data dropped below half are compacted in the
+ * background: live records are copied to the active log and the old file
+ * is removed. When the store exceeds its size limit, the oldest log is
+ * dropped. Logs are at most a quarter of the size limit.
+ */
+
+#ifndef CCNL_DISKSTORE_H
+#define CCNL_DISKSTORE_H
+
+#include <stdint.h>
+
+#include "ccnl-relay.h"
+
+#define CCNL_DISK_LOG_SIZE      (64 * 1024 * 1024)     // max. size of a log file
+#define CCNL_DISK_REC_MAGIC     0x43434454U     // "CCDT"
+
+struct ccnl_disk_rechdr_s {
+    uint32_t magic;         /**< CCNL_DISK_REC_MAGIC */
+    uint32_t len;           /**< length of the packet following the header */
+    uint64_t hash;          /**< ccnl_prefix_hash() of the packet's name */
+    uint64_t sum;           /**< FNV-1a hash of the packet's bytes */
+    uint64_t staletime;     /**< ms when NDN content goes stale, 0: stale */
+};
+
+/**
+ * @brief Opens (and recovers) a disk store and attaches it to a relay
+ *
+ * @param[in] relay     The relay
+ * @param[in] dir       Directory for the log files, created if missing
+ * @param[in] maxbytes  Size limit of the store (0: CCNL_DISK_LOG_SIZE * 16)
+ *
+ * @return 0 on success, -1 on error
+ */
+int
+ccnl_diskstore_open(struct ccnl_relay_s *relay, char *dir, uint64_t maxbytes);
+
+/**
+ * @brief Completes all queued I/O and closes the disk store
+ */
+void
+ccnl_diskstore_close(void);
+
+/**
+ * @brief The file descriptor signalling I/O completions
+ *
+ * @return The descriptor to select() on, -1 if no disk store is open
+ */
+int
+ccnl_diskstore_fd(void);
+
+/**
+ * @brief Processes I/O completions, call when ccnl_diskstore_fd() is readable
+ *
+ * @param[in] relay     The relay
+ */
+void
+ccnl_diskstore_complete(struct ccnl_relay_s *relay);
+
+#endif // CCNL_DISKSTORE_H
@@ -0,0 +1,131 @@
+/*
+ * @f ccnl-ethring.h
+ * @b CCN lite, PACKET_MMAP rings for Ethernet interfaces
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * An Ethernet interface with rings shares its frames with the kernel
+ * instead of copying each of them in a recvfrom() or sendto() call.
+ *
+ * Received frames are collected in TPACKET_V3 blocks. A block is handed
+ * over when it is full or after CCNL_ETHRING_TIMEOUT ms; its frames are
+ * passed to ccnl_core_RX() where they lie in the ring, and the block is
+ * returned to the kernel afterwards.
+ *
+ * Frames to send are written into the slots of the TX ring, the header in
+ * front of the packet. The kernel is kicked once for all slots filled
+ * since the last kick. Kernels without a TPACKET_V3 TX ring (before 4.11)
+ * get the RX ring only and send with sendto().
+ */
+
+#ifndef CCNL_ETHRING_H
+#define CCNL_ETHRING_H
+
+#if defined(USE_LINKLAYER) && defined(USE_PACKET_MMAP)
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include "ccnl-relay.h"
+
+#ifndef CCNL_ETHRING_BLOCKSIZE
+# define CCNL_ETHRING_BLOCKSIZE (1 << 16)  // a multiple of the page size
+#endif
+#ifndef CCNL_ETHRING_RXBLOCKS
+# define CCNL_ETHRING_RXBLOCKS  64
+#endif
+#ifndef CCNL_ETHRING_TXFRAMES
+# define CCNL_ETHRING_TXFRAMES  256
+#endif
+#define CCNL_ETHRING_FRAMESIZE  2048       // a TX slot, header included
+#ifndef CCNL_ETHRING_TIMEOUT
+# define CCNL_ETHRING_TIMEOUT   1          // ms a partly filled block waits
+#endif
+
+struct ccnl_ethring_s {
+    int sock;
+    uint8_t *map;                // RX blocks, followed by the TX slots
+    size_t maplen;
+    unsigned int rxblock;        // next block to look at
+    uint8_t *tx;                 // NULL if there is no TX ring
+    unsigned int txslot;         // next slot to fill
+    unsigned int txpending;      // slots filled since the last kick
+};
+
+/**
+ * @brief Sets up the rings of a bound AF_PACKET socket
+ *
+ * @param[in] sock  The socket of the interface
+ *
+ * @return The rings, NULL if the kernel does not provide them
+ */
+struct ccnl_ethring_s*
+ccnl_ethring_open(int sock);
+
+/**
+ * @brief Unmaps the rings, the socket is left open
+ */
+void
+ccnl_ethring_close(struct ccnl_ethring_s *r);
+
+/**
+ * @brief Closes the rings of all interfaces of a relay
+ */
+void
+ccnl_ethring_close_all(struct ccnl_relay_s *relay);
+
+/**
+ * @brief Hands the frames of all blocks handed over to ccnl_core_RX()
+ *
+ * @param[in] relay  The relay
+ * @param[in] ifndx  The interface the rings belong to
+ *
+ * @return The number of frames received
+ */
+int
+ccnl_ethring_RX(struct ccnl_relay_s *relay, int ifndx);
+
+/**
+ * @brief Writes a frame into the next slot of the TX ring
+ *
+ * The frame is sent at the next ccnl_ethring_flush(). When the ring is
+ * full, the slots filled so far are sent first.
+ *
+ * @param[in] r       The rings
+ * @param[in] dst     Destination MAC address
+ * @param[in] src     Source MAC address
+ * @param[in] iov     The pieces of the packet
+ * @param[in] iovcnt  Their number
+ *
+ * @return 0 on success, -1 if the frame did not fit or the ring stays full
+ */
+int
+ccnl_ethring_put(struct ccnl_ethring_s *r, uint8_t *dst, uint8_t *src,
+                 struct iovec *iov, int iovcnt);
+
+/**
+ * @brief Has the kernel send the frames put into the TX ring
+ */
+void
+ccnl_ethring_flush(struct ccnl_ethring_s *r);
+
+#endif // USE_LINKLAYER && USE_PACKET_MMAP
+
+#endif // CCNL_ETHRING_H
@@ -0,0 +1,65 @@
+/*
+ * @f ccnl-logring.h
+ * @b CCN lite, log messages written by a background thread
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * Once opened, DEBUGMSG() no longer writes to stderr. It puts the level,
+ * the time and the formatted message into a slot of a ring, without a lock
+ * or a system call, and a writer thread takes the messages out and writes
+ * them to stderr every CCNL_LOGRING_PERIOD microseconds, many in one
+ * write(). The time is formatted by the writer.
+ *
+ * The ring has one producer: only the relay's thread may log while it is
+ * open. When the ring is full, messages are dropped and counted rather
+ * than making the relay wait.
+ */
+
+#ifndef CCNL_LOGRING_H
+#define CCNL_LOGRING_H
+
+#ifdef USE_LOGGING
+
+#ifndef CCNL_LOGRING_SLOTS
+# define CCNL_LOGRING_SLOTS     4096    // messages, a power of two
+#endif
+#define CCNL_LOGRING_MSGLEN     240     // longer messages are cut
+#define CCNL_LOGRING_PERIOD     10000   // usec between two writes
+
+/**
+ * @brief Starts the writer thread and sends DEBUGMSG() through the ring
+ *
+ * The ring is closed at exit.
+ *
+ * @return 0 on success, -1 if the thread could not be started
+ */
+int
+ccnl_logring_open(void);
+
+/**
+ * @brief Writes what is left in the ring, stops the writer thread and sends
+ * DEBUGMSG() to stderr again
+ */
+void
+ccnl_logring_close(void);
+
+#endif // USE_LOGGING
+
+#endif // CCNL_LOGRING_H
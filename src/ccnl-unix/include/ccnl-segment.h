@@ -0,0 +1,192 @@
+/*
+ * @f ccnl-segment.h
+ * @b CCN lite, packed and memory mapped content segments
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * A content segment is a single file holding many wire encoded Data
+ * packets, followed by an index sorted by name hash:
+ *
+ *   +---------------------------+ 0
+ *   | struct ccnl_segment_hdr_s |
+ *   +---------------------------+
+ *   | Data packets, back to     |
+ *   | back, any suite           |
+ *   +---------------------------+ hdr.indexoffs (8 byte aligned)
+ *   | struct ccnl_segment_idx_s |
+ *   | [hdr.count], sorted by    |
+ *   | (hash, offset)            |
+ *   +---------------------------+
+ *
+ * The relay maps a segment read-only and binary searches the index in the
+ * mapping on a Content Store miss, so attaching a segment costs neither
+ * memory nor parsing time up front. Integers are stored in host byte order.
+ */
+
+#ifndef CCNL_SEGMENT_H
+#define CCNL_SEGMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ccnl-relay.h"
+
+#define CCNL_SEGMENT_MAGIC      "CCNLSEG"
+#define CCNL_SEGMENT_VERSION    1
+
+struct ccnl_segment_hdr_s {
+    char magic[8];          /**< CCNL_SEGMENT_MAGIC, '\0' terminated */
+    uint32_t version;       /**< CCNL_SEGMENT_VERSION */
+    uint32_t count;         /**< number of packets/index entries */
+    uint64_t indexoffs;     /**< file offset of the index */
+};
+
+struct ccnl_segment_idx_s {
+    uint64_t hash;          /**< ccnl_prefix_hash() of the packet's name */
+    uint64_t offset;        /**< file offset of the packet */
+    uint32_t len;           /**< length of the packet */
+    uint32_t flags;         /**< reserved, 0 */
+};
+
+struct ccnl_segment_s {
+    struct ccnl_segment_s *next;
+    uint8_t *base;          /**< start of the mapping */
+    size_t size;            /**< size of the mapping */
+    uint32_t count;
+    uint64_t indexoffs;
+    struct ccnl_segment_idx_s *idx;
+};
+
+struct ccnl_segment_writer_s {
+    int fd;
+    uint64_t offset;        /**< where the next packet goes */
+    uint32_t count;
+    uint32_t size;          /**< allocated index entries */
+    struct ccnl_segment_idx_s *idx;
+};
+
+/**
+ * @brief Parses a wire encoded Data packet of any enabled suite
+ *
+ * @param[in] data      The encoded packet
+ * @param[in] datalen   Length of \p data
+ *
+ * @return The parsed packet (a copy of \p data), NULL if \p data is not a
+ *         Data packet
+ */
+struct ccnl_pkt_s*
+ccnl_bytes2content(uint8_t *data, size_t datalen);
+
+/**
+ * @brief Maps a segment file and validates its header and index
+ *
+ * @param[in] path  The segment file
+ *
+ * @return The segment, NULL on error
+ */
+struct ccnl_segment_s*
+ccnl_segment_open(char *path);
+
+/**
+ * @brief Unmaps a segment
+ */
+void
+ccnl_segment_close(struct ccnl_segment_s *seg);
+
+/**
+ * @brief Looks up a Data packet satisfying an Interest in a segment
+ *
+ * Only exact name matches are found (the index is keyed by the full name),
+ * Interests for a name prefix miss and are forwarded as usual.
+ *
+ * @param[in] seg       The segment
+ * @param[in] interest  The Interest
+ *
+ * @return A new content object (not in the Content Store), NULL on a miss
+ */
+struct ccnl_content_s*
+ccnl_segment_lookup(struct ccnl_segment_s *seg, struct ccnl_pkt_s *interest);
+
+/**
+ * @brief Content Store miss handler for the attached segments
+ *
+ * Installed by ccnl_segment_attach() via ccnl_set_cb_cs_miss(). Other miss
+ * handlers (e.g. the disk store) call it first to keep segments consulted.
+ *
+ * @return 1 if the Interest was satisfied from a segment, 0 otherwise
+ */
+int
+ccnl_segment_cs_miss(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                     struct ccnl_pkt_s **pkt);
+
+/**
+ * @brief Attaches a segment file to a relay
+ *
+ * Attached segments are consulted on Content Store misses, matching
+ * content is sent to the requesting face and added to the Content Store.
+ *
+ * @param[in] relay The relay
+ * @param[in] path  The segment file
+ *
+ * @return 0 on success, -1 on error
+ */
+int
+ccnl_segment_attach(struct ccnl_relay_s *relay, char *path);
+
+/**
+ * @brief Detaches and unmaps all segments
+ */
+void
+ccnl_segment_detach_all(void);
+
+/**
+ * @brief Creates a segment file
+ *
+ * @param[in] path  The file to create (truncated if it exists)
+ *
+ * @return A segment writer, NULL on error
+ */
+struct ccnl_segment_writer_s*
+ccnl_segment_writer_open(char *path);
+
+/**
+ * @brief Appends a wire encoded Data packet to a segment
+ *
+ * @param[in] w         The segment writer
+ * @param[in] data      The packet
+ * @param[in] datalen   Length of \p data
+ *
+ * @return 0 on success, -1 if \p data is not a Data packet or on I/O errors
+ */
+int
+ccnl_segment_writer_add(struct ccnl_segment_writer_s *w,
+                        uint8_t *data, size_t datalen);
+
+/**
+ * @brief Writes the index and header and closes the segment file
+ *
+ * @param[in] w     The segment writer, freed by this function
+ *
+ * @return 0 on success, -1 on error
+ */
+int
+ccnl_segment_writer_close(struct ccnl_segment_writer_s *w);
+
+#endif // CCNL_SEGMENT_H
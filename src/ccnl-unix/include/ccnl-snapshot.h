@@ -0,0 +1,98 @@
+/*
+ * @f ccnl-snapshot.h
+ * @b CCN lite, snapshots of the Content Store and the FIB
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * A snapshot preserves the relay's Content Store and FIB across a restart.
+ * The file starts with a struct ccnl_snapshot_hdr_s, followed by records:
+ *
+ *   struct ccnl_snapshot_rec_s, then len bytes of payload
+ *
+ * CCNL_SNAPSHOT_CONTENT: the wire encoded Data packet. Contents are written
+ * oldest first, so that reloading them restores the LRU order.
+ *
+ * CCNL_SNAPSHOT_FIB: the face (sockunion address of its interface, int32
+ * flags, sockunion peer), then uint32 compcnt and per component uint32 len
+ * plus the bytes. Only entries pointing to network faces are saved. On
+ * load the face is bound to the interface with that address, entries whose
+ * interface is gone are skipped.
+ *
+ * Integers are in host byte order: a snapshot is meant to be reloaded by
+ * the same relay binary on the same host, with the same interface setup.
+ */
+
+#ifndef CCNL_SNAPSHOT_H
+#define CCNL_SNAPSHOT_H
+
+#include <stdint.h>
+
+#include "ccnl-relay.h"
+
+#define CCNL_SNAPSHOT_MAGIC     "CCNLSNP"
+#define CCNL_SNAPSHOT_VERSION   2
+
+enum {
+    CCNL_SNAPSHOT_CONTENT = 1,
+    CCNL_SNAPSHOT_FIB = 2
+};
+
+struct ccnl_snapshot_hdr_s {
+    char magic[8];          /**< CCNL_SNAPSHOT_MAGIC */
+    uint32_t version;       /**< CCNL_SNAPSHOT_VERSION */
+    uint32_t ifcount;       /**< number of interfaces of the relay */
+};
+
+struct ccnl_snapshot_rec_s {
+    uint8_t type;           /**< CCNL_SNAPSHOT_CONTENT or _FIB */
+    uint8_t suite;          /**< suite of the packet or prefix */
+    uint16_t flags;         /**< content flags */
+    uint32_t len;           /**< length of the payload */
+};
+
+/**
+ * @brief Writes a snapshot of the Content Store and the FIB
+ *
+ * The snapshot is written to a temporary file which replaces \p path once
+ * it is complete, an existing snapshot is never left half written.
+ *
+ * @param[in] relay     The relay
+ * @param[in] path      The snapshot file
+ *
+ * @return 0 on success, -1 on error
+ */
+int
+ccnl_snapshot_save(struct ccnl_relay_s *relay, char *path);
+
+/**
+ * @brief Loads a snapshot into the Content Store and the FIB
+ *
+ * Records are read one by one, a damaged tail is ignored.
+ *
+ * @param[in] relay     The relay, configured with the same interfaces as
+ *                      the one the snapshot was taken from
+ * @param[in] path      The snapshot file
+ *
+ * @return Number of records loaded, -1 if the file could not be read
+ */
+int
+ccnl_snapshot_load(struct ccnl_relay_s *relay, char *path);
+
+#endif // CCNL_SNAPSHOT_H
@@ -0,0 +1,137 @@
+/*
+ * @f ccnl-stream.h
+ * @b CCN lite, TCP and Unix stream faces
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * A stream interface is a listening TCP or Unix stream socket, or no
+ * socket at all if it only connects out. Each of its connections is one
+ * face, with the address of the peer; the clients of a Unix socket get a
+ * made-up address, the path of the socket followed by a number.
+ *
+ * The bytes read from a connection are cut into packets along the length
+ * in their TLV header (ccnl_pkt_framelen()), so only the TLV suites work
+ * over streams. A complete packet is handed to ccnl_core_RX() from the
+ * read buffer.
+ *
+ * Packets sent on a face are queued with its connection and written in
+ * one sendmsg() per round of the IO loop once the socket is writable.
+ * A connection is closed when its peer closes it, on errors, and when its
+ * face is removed; the face goes away with the connection.
+ */
+
+#ifndef CCNL_STREAM_H
+#define CCNL_STREAM_H
+
+#ifdef USE_STREAM
+
+#include <sys/select.h>
+#include <sys/uio.h>
+
+#include "ccnl-relay.h"
+#include "ccnl-if.h"
+#include "ccnl-sockunion.h"
+
+#ifndef CCNL_STREAM_OUTQ
+# define CCNL_STREAM_OUTQ       64      // packets waiting per connection
+#endif
+#define CCNL_STREAM_BACKLOG     16      // connections accepted per round
+
+struct ccnl_stream_s {
+    struct ccnl_stream_s *next;
+    int ifndx;
+    int sock;
+    char connecting;                    // until the connect() completes
+    char dead;                          // closed, freed at the next round
+    sockunion peer;                     // the address of the face
+    socklen_t peerlen;
+    size_t inlen;                       // bytes in the read buffer
+    size_t outoffs;                     // bytes of the first packet written
+    int outfront, outcnt;
+    struct ccnl_buf_s *out[CCNL_STREAM_OUTQ];
+    uint8_t in[CCNL_MAX_PACKET_SIZE];
+};
+
+/**
+ * @brief Adds a stream interface listening on \p addr
+ *
+ * @param[in] relay  The relay
+ * @param[in] addr   A TCP port (with the address to bind to) or a path
+ *
+ * @return 0 on success, -1 on failure
+ */
+int
+ccnl_stream_listen(struct ccnl_relay_s *relay, sockunion *addr);
+
+/**
+ * @brief Connects to \p peer and returns the face of the connection
+ *
+ * The connection is made in the background, packets sent in the meantime
+ * are queued. An existing connection to \p peer is reused.
+ *
+ * @return The face, NULL on failure
+ */
+struct ccnl_face_s*
+ccnl_stream_connect(struct ccnl_relay_s *relay, sockunion *peer);
+
+/**
+ * @brief Closes the connection of a face that is removed
+ */
+void
+ccnl_stream_close(struct ccnl_relay_s *relay, struct ccnl_face_s *face);
+
+/**
+ * @brief Closes all connections
+ */
+void
+ccnl_stream_close_all(struct ccnl_relay_s *relay);
+
+/**
+ * @brief Queues a packet for the connection to \p dest
+ *
+ * @param[in] relay   The relay
+ * @param[in] ifc     The stream interface
+ * @param[in] dest    The peer
+ * @param[in] iov     The pieces of the packet, copied
+ * @param[in] iovcnt  Their number
+ *
+ * @return 0 if queued, -1 if there is no such connection or it is full
+ */
+int
+ccnl_stream_TX(struct ccnl_relay_s *relay, struct ccnl_if_s *ifc,
+               sockunion *dest, struct iovec *iov, int iovcnt);
+
+/**
+ * @brief Adds the sockets to wait for to the sets of the IO loop
+ */
+void
+ccnl_stream_fdset(struct ccnl_relay_s *relay, fd_set *readfs, fd_set *writefs,
+                  int *maxfd);
+
+/**
+ * @brief Accepts, reads and writes what the IO loop found ready
+ */
+void
+ccnl_stream_process(struct ccnl_relay_s *relay, fd_set *readfs,
+                    fd_set *writefs);
+
+#endif // USE_STREAM
+
+#endif // CCNL_STREAM_H
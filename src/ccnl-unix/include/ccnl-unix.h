@@ -37,6 +37,13 @@
 #include "ccnl-if.h"
 #include "ccnl-buf.h"
 
+/**
+ * maximum number of datagrams read from one socket per select() round
+ */
+#ifndef CCNL_RX_BURST
+#define CCNL_RX_BURST 16
+#endif
+
 #ifdef USE_LINKLAYER
 #if !(defined(__FreeBSD__) || defined(__APPLE__))
 int
@@ -97,6 +104,18 @@ void
 ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
            sockunion *dest, struct ccnl_buf_s *buf);
 
+#ifdef USE_FRAG
+/**
+ * @brief Sends a batch of fragments to \p dest, with sendmmsg() where it is
+ *        available, gathering each fragment from its header and the packet
+ *
+ * @return the number of fragments sent, the rest is lost
+ */
+int
+ccnl_ll_TXv(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+            sockunion *dest, struct ccnl_frag_iov_s *frags, int cnt);
+#endif
+
 void
 ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
                   int32_t udpport1, int32_t udpport2,
@@ -107,6 +126,40 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
 int
 ccnl_io_loop(struct ccnl_relay_s *ccnl);
 
+/**
+ * @brief Hands a datagram received on an interface to ccnl_core_RX()
+ *
+ * @param[in] ccnl   The relay
+ * @param[in] ifndx  The interface it was received on
+ * @param[in] buf    The datagram, with the Ethernet header for AF_PACKET
+ * @param[in] len    Its length
+ * @param[in] src    Where it came from
+ */
+void
+ccnl_unix_RX(struct ccnl_relay_s *ccnl, int ifndx, uint8_t *buf, size_t len,
+             sockunion *src);
+
+/**
+ * @brief Picks up the error a receive on an interface failed with
+ */
+void
+ccnl_unix_RXerror(struct ccnl_relay_s *ccnl, int ifndx);
+
+/**
+ * @brief Handles a send that failed with \p err after it was queued,
+ *        a packet too big for the path is fragmented and sent again
+ */
+void
+ccnl_unix_TXerror(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+                  sockunion *dest, struct ccnl_buf_s *buf, int err);
+
+/**
+ * @brief Preloads the Content Store
+ *
+ * If \p path is a directory, every file in it is loaded as one content
+ * object. If it is a regular file, it is attached as a packed content
+ * segment (see ccnl-segment.h).
+ */
 void
 ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path);
 
@@ -0,0 +1,96 @@
+/*
+ * @f ccnl-uring.h
+ * @b CCN lite, io_uring event and IO loop for the relay
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * A second event and IO loop next to ccnl_io_loop(), selected with the
+ * relay's -b option.
+ *
+ * Each UDP, Unix and Ethernet interface without rings has one multishot
+ * recvmsg armed. The kernel picks a buffer from a registered pool of
+ * CCNL_URING_BUFS for each datagram, which is handed to ccnl_core_RX()
+ * where it lies and goes back to the pool afterwards.
+ *
+ * While the loop runs, ccnl_ll_TX() queues UDP and Unix sends instead of
+ * calling sendto(); all sends of a round are submitted together with the
+ * next wait. Timers, the HTTP status server, the disk store, the Ethernet
+ * rings and the stream faces are served as in ccnl_io_loop(), all but the
+ * timers through polls on their descriptors.
+ *
+ * Multishot recvmsg needs Linux 6.0. On older kernels ccnl_uring_loop()
+ * returns at once and the relay uses ccnl_io_loop().
+ */
+
+#ifndef CCNL_URING_H
+#define CCNL_URING_H
+
+#ifdef USE_IO_URING
+
+#include "ccnl-relay.h"
+#include "ccnl-if.h"
+#include "ccnl-buf.h"
+#include "ccnl-sockunion.h"
+
+#ifndef CCNL_URING_ENTRIES
+# define CCNL_URING_ENTRIES     256     // submission queue
+#endif
+#ifndef CCNL_URING_BUFS
+# define CCNL_URING_BUFS        256     // receive buffers, a power of two
+#endif
+#ifndef CCNL_URING_SENDS
+# define CCNL_URING_SENDS       128     // sends in flight
+#endif
+#ifndef CCNL_URING_POLLS
+# define CCNL_URING_POLLS       32      // watched descriptors
+#endif
+
+/**
+ * @brief Runs the relay on io_uring until its halt_flag is set
+ *
+ * @param[in] ccnl  The relay
+ *
+ * @return 0 once halted, -1 if the kernel lacks what the loop needs
+ */
+int
+ccnl_uring_loop(struct ccnl_relay_s *ccnl);
+
+/**
+ * @brief Queues a packet to be sent on a UDP or Unix interface
+ *
+ * The packet is copied, \p buf stays with the caller.
+ *
+ * @return 0 if queued, -1 if it has to be sent the usual way
+ */
+int
+ccnl_uring_TX(struct ccnl_if_s *ifc, sockunion *dest, struct ccnl_buf_s *buf);
+
+/**
+ * @brief Tells the loop that a descriptor it may poll was closed
+ *
+ * The polls are armed anew in the next round, before the number of the
+ * descriptor can stand for another file.
+ */
+void
+ccnl_uring_fdclosed(void);
+
+#endif // USE_IO_URING
+
+#endif // CCNL_URING_H
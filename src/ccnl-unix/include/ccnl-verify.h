@@ -0,0 +1,73 @@
+/*
+ * @f ccnl-verify.h
+ * @b CCN lite, batched HMAC verification of incoming Data
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/**
+ * The verification stage holds incoming Data packets back (through the
+ * rx on-data callback) before they reach the Content Store and the PIT.
+ * Held packets are verified together when the batch is full or the receive
+ * loop has handled a burst, grouped by key so that ccnl_hmac256_key_sign_many()
+ * can hash several packets side by side. Packets with a valid HMAC-SHA256
+ * signature are handed back to ccnl_fwd_handleContent() in arrival order;
+ * all others are dropped, so pending Interests are only satisfied by
+ * verified Data.
+ *
+ * The keyring is read from a file with one base64 encoded key per line.
+ * A key is selected by the packet's keyid (CCNx KeyId, NDN
+ * KeyLocatorDigest), which is the SHA256 digest of the key as computed by
+ * ccnl_hmac256_keyid(). Packets without a keyid are checked with the first
+ * key of the file.
+ */
+
+#ifndef CCNL_VERIFY_H
+#define CCNL_VERIFY_H
+
+#include "ccnl-relay.h"
+
+#define CCNL_VERIFY_BATCH       32      // default number of held packets
+
+/**
+ * @brief Loads a keyring and starts verifying the relay's incoming Data
+ *
+ * @param[in] relay     The relay
+ * @param[in] keyfile   File with base64 encoded HMAC keys, one per line
+ * @param[in] batch     Max. number of packets held back (0: CCNL_VERIFY_BATCH)
+ *
+ * @return 0 on success, -1 on error
+ */
+int
+ccnl_verify_open(struct ccnl_relay_s *relay, char *keyfile, size_t batch);
+
+/**
+ * @brief Verifies all held packets and passes the valid ones on
+ *
+ * @param[in] relay     The relay
+ */
+void
+ccnl_verify_flush(struct ccnl_relay_s *relay);
+
+/**
+ * @brief Drops the held packets and releases the keyring
+ */
+void
+ccnl_verify_close(void);
+
+#endif // CCNL_VERIFY_H
@@ -0,0 +1,947 @@
+/*
+ * @f ccnl-diskstore.c
+ * @b CCN lite, disk backed second tier of the Content Store
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "ccnl-diskstore.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ccnl-os-includes.h"
+#include "ccnl-core.h"
+#include "ccnl-callbacks.h"
+#include "ccnl-segment.h"
+
+enum {
+    CCNL_DISK_JOB_APPEND,
+    CCNL_DISK_JOB_READ,
+    CCNL_DISK_JOB_COPY,
+    CCNL_DISK_JOB_DROP
+};
+
+struct ccnl_disk_log_s {
+    struct ccnl_disk_log_s *next;   // oldest first
+    uint32_t id;
+    int fd;
+    uint64_t size;                  // append offset
+    uint64_t live;                  // bytes of records still in the index
+    int dropped;
+};
+
+struct ccnl_disk_ent_s {
+    struct ccnl_disk_ent_s *next;
+    uint64_t hash;
+    struct ccnl_disk_log_s *log;
+    uint64_t offset;                // of the record header
+    uint32_t len;                   // of the packet
+    uint64_t sum;                   // of the packet, tells copies apart
+    uint64_t staletime;             // restored when the copy is read back
+};
+
+struct ccnl_disk_copy_s {
+    uint64_t from;
+    struct ccnl_disk_log_s *to;
+    uint64_t offset;
+    uint32_t len;                   // of the record
+};
+
+struct ccnl_disk_job_s {
+    struct ccnl_disk_job_s *next;       // worker queue, then done list
+    struct ccnl_disk_job_s *inflight;   // pending reads, main thread only
+    int type;
+    int err;
+    uint64_t hash, sum, staletime;
+    struct ccnl_disk_log_s *log;
+    uint64_t offset;
+    uint32_t len;
+    uint8_t *data;
+    uint32_t cnt;
+    struct ccnl_disk_copy_s *copy;
+};
+
+struct ccnl_diskstore_s {
+    char *dir;
+    uint64_t maxbytes, total;
+    uint64_t logsize;
+    struct ccnl_disk_log_s *logs, *active;
+    uint32_t nextid;
+    struct ccnl_disk_ent_s **tab;
+    uint32_t tabsize, cnt;
+    struct ccnl_disk_job_s *reads;
+    int compacting;
+
+    // shared with the worker
+    pthread_t worker;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct ccnl_disk_job_s *queue, *queueend;
+    struct ccnl_disk_job_s *done, *doneend;
+    int woken;                      // a wakeup byte is in the pipe
+    int stop;
+    int pipefd[2];
+};
+
+static struct ccnl_diskstore_s *_disk = NULL;
+
+static void
+ccnl_diskstore_logname(struct ccnl_diskstore_s *ds, uint32_t id,
+                       char *buf, size_t len)
+{
+    snprintf(buf, len, "%s/%08" PRIx32 ".log", ds->dir, id);
+}
+
+static uint64_t
+ccnl_diskstore_sum(const uint8_t *data, size_t len)
+{
+    return ccnl_prefix_hash_comp(CCNL_PREFIX_HASH_INIT, data, len);
+}
+
+static int
+ccnl_diskstore_pio(int fd, uint8_t *buf, size_t len, uint64_t offset, int wr)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        n = wr ? pwrite(fd, buf, len, (off_t) offset)
+               : pread(fd, buf, len, (off_t) offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        buf += n;
+        len -= (size_t) n;
+        offset += (uint64_t) n;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------
+// worker thread, must not touch the index, the relay or ccnl_malloc
+
+static void*
+ccnl_diskstore_worker(void *arg)
+{
+    struct ccnl_diskstore_s *ds = (struct ccnl_diskstore_s *) arg;
+    struct ccnl_disk_job_s *job;
+    uint8_t buf[sizeof(struct ccnl_disk_rechdr_s) + CCNL_MAX_PACKET_SIZE];
+    char path[PATH_MAX];
+    uint32_t i;
+
+    for (;;) {
+        pthread_mutex_lock(&ds->lock);
+        while (!ds->queue && !ds->stop) {
+            pthread_cond_wait(&ds->cond, &ds->lock);
+        }
+        job = ds->queue;
+        if (job) {
+            ds->queue = job->next;
+            if (!ds->queue) {
+                ds->queueend = NULL;
+            }
+        }
+        pthread_mutex_unlock(&ds->lock);
+        if (!job) {
+            break;
+        }
+
+        switch (job->type) {
+        case CCNL_DISK_JOB_APPEND:
+            job->err = ccnl_diskstore_pio(job->log->fd, job->data, job->len,
+                                          job->offset, 1);
+            break;
+        case CCNL_DISK_JOB_READ:
+            job->err = ccnl_diskstore_pio(job->log->fd, job->data, job->len,
+                           job->offset + sizeof(struct ccnl_disk_rechdr_s), 0);
+            break;
+        case CCNL_DISK_JOB_COPY:
+            for (i = 0; i < job->cnt && !job->err; i++) {
+                struct ccnl_disk_copy_s *c = job->copy + i;
+                job->err = c->len > sizeof(buf) ||
+                    ccnl_diskstore_pio(job->log->fd, buf, c->len, c->from, 0) ||
+                    ccnl_diskstore_pio(c->to->fd, buf, c->len, c->offset, 1);
+            }
+            break;
+        case CCNL_DISK_JOB_DROP:
+            close(job->log->fd);
+            ccnl_diskstore_logname(ds, job->log->id, path, sizeof(path));
+            job->err = unlink(path);
+            break;
+        default:
+            break;
+        }
+
+        // hand the job back to the main thread, the pipe only wakes it up
+        // and never fills, so the worker cannot block on it
+        job->next = NULL;
+        pthread_mutex_lock(&ds->lock);
+        if (ds->doneend) {
+            ds->doneend->next = job;
+        } else {
+            ds->done = job;
+        }
+        ds->doneend = job;
+        if (!ds->woken) {
+            ds->woken = 1;
+            while (write(ds->pipefd[1], "", 1) < 0 && errno == EINTR) {
+            }
+        }
+        pthread_mutex_unlock(&ds->lock);
+    }
+
+    return NULL;
+}
+
+static void
+ccnl_diskstore_submit(struct ccnl_diskstore_s *ds, struct ccnl_disk_job_s *job)
+{
+    job->next = NULL;
+    pthread_mutex_lock(&ds->lock);
+    if (ds->queueend) {
+        ds->queueend->next = job;
+    } else {
+        ds->queue = job;
+    }
+    ds->queueend = job;
+    pthread_cond_signal(&ds->cond);
+    pthread_mutex_unlock(&ds->lock);
+}
+
+// ----------------------------------------------------------------------
+// name hash index
+
+static struct ccnl_disk_ent_s**
+ccnl_diskstore_slot(struct ccnl_diskstore_s *ds, uint64_t hash)
+{
+    struct ccnl_disk_ent_s **e = ds->tab + (hash & (ds->tabsize - 1));
+
+    while (*e && (*e)->hash != hash) {
+        e = &(*e)->next;
+    }
+    return e;
+}
+
+static void
+ccnl_diskstore_grow(struct ccnl_diskstore_s *ds)
+{
+    struct ccnl_disk_ent_s **tab, *e, *next;
+    uint32_t i, size = 2 * ds->tabsize;
+
+    tab = (struct ccnl_disk_ent_s **) ccnl_calloc(size, sizeof(*tab));
+    if (!tab) {
+        return; // longer chains, but still correct
+    }
+    for (i = 0; i < ds->tabsize; i++) {
+        for (e = ds->tab[i]; e; e = next) {
+            next = e->next;
+            e->next = tab[e->hash & (size - 1)];
+            tab[e->hash & (size - 1)] = e;
+        }
+    }
+    ccnl_free(ds->tab);
+    ds->tab = tab;
+    ds->tabsize = size;
+}
+
+static int
+ccnl_diskstore_index(struct ccnl_diskstore_s *ds,
+                     const struct ccnl_disk_rechdr_s *hdr,
+                     struct ccnl_disk_log_s *log, uint64_t offset)
+{
+    struct ccnl_disk_ent_s **slot = ccnl_diskstore_slot(ds, hdr->hash), *e = *slot;
+
+    if (e) {
+        e->log->live -= sizeof(struct ccnl_disk_rechdr_s) + e->len;
+    } else {
+        e = (struct ccnl_disk_ent_s *) ccnl_calloc(1, sizeof(*e));
+        if (!e) {
+            return -1;
+        }
+        e->hash = hdr->hash;
+        *slot = e;
+        ds->cnt++;
+    }
+    e->log = log;
+    e->offset = offset;
+    e->len = hdr->len;
+    e->sum = hdr->sum;
+    e->staletime = hdr->staletime;
+    log->live += sizeof(struct ccnl_disk_rechdr_s) + hdr->len;
+
+    if (ds->cnt > ds->tabsize) {
+        ccnl_diskstore_grow(ds);
+    }
+    return 0;
+}
+
+static void
+ccnl_diskstore_unindex(struct ccnl_diskstore_s *ds, uint64_t hash)
+{
+    struct ccnl_disk_ent_s **slot = ccnl_diskstore_slot(ds, hash), *e = *slot;
+
+    if (e) {
+        e->log->live -= sizeof(struct ccnl_disk_rechdr_s) + e->len;
+        *slot = e->next;
+        ccnl_free(e);
+        ds->cnt--;
+    }
+}
+
+// ----------------------------------------------------------------------
+// log management
+
+static struct ccnl_disk_log_s*
+ccnl_diskstore_addlog(struct ccnl_diskstore_s *ds, uint32_t id, int fd)
+{
+    struct ccnl_disk_log_s *log, **lp;
+
+    log = (struct ccnl_disk_log_s *) ccnl_calloc(1, sizeof(*log));
+    if (!log) {
+        return NULL;
+    }
+    log->id = id;
+    log->fd = fd;
+    for (lp = &ds->logs; *lp; lp = &(*lp)->next) {
+    }
+    *lp = log;
+    if (id >= ds->nextid) {
+        ds->nextid = id + 1;
+    }
+    return log;
+}
+
+// makes sure the active log has room for len more bytes
+static int
+ccnl_diskstore_reserve(struct ccnl_diskstore_s *ds, uint64_t len)
+{
+    struct ccnl_disk_log_s *log;
+    char path[PATH_MAX];
+    int fd;
+
+    if (ds->active && ds->active->size + len <= ds->logsize) {
+        return 0;
+    }
+    ccnl_diskstore_logname(ds, ds->nextid, path, sizeof(path));
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) {
+        DEBUGMSG(ERROR, "disk store: could not create %s: %d\n", path, errno);
+        return -1;
+    }
+    log = ccnl_diskstore_addlog(ds, ds->nextid, fd);
+    if (!log) {
+        close(fd);
+        return -1;
+    }
+    DEBUGMSG(DEBUG, "disk store: new log %s\n", path);
+    ds->active = log;
+    return 0;
+}
+
+static void
+ccnl_diskstore_drop(struct ccnl_diskstore_s *ds, struct ccnl_disk_log_s *log)
+{
+    struct ccnl_disk_ent_s **e, *x;
+    struct ccnl_disk_job_s *job;
+    uint32_t i;
+
+    job = (struct ccnl_disk_job_s *) ccnl_calloc(1, sizeof(*job));
+    if (!job) {
+        return;
+    }
+    for (i = 0; i < ds->tabsize; i++) {
+        for (e = ds->tab + i; *e; ) {
+            if ((*e)->log == log) {
+                x = *e;
+                *e = x->next;
+                ccnl_free(x);
+                ds->cnt--;
+            } else {
+                e = &(*e)->next;
+            }
+        }
+    }
+    DEBUGMSG(DEBUG, "disk store: dropping log %08" PRIx32 "\n", log->id);
+    log->live = 0;
+    log->dropped = 1;
+    ds->total -= log->size;
+    if (ds->active == log) {
+        ds->active = NULL;
+    }
+
+    job->type = CCNL_DISK_JOB_DROP;
+    job->log = log;
+    ccnl_diskstore_submit(ds, job);
+}
+
+// moves the live records of a log to the active log and drops it
+static void
+ccnl_diskstore_compact(struct ccnl_diskstore_s *ds, struct ccnl_disk_log_s *log)
+{
+    struct ccnl_disk_job_s *job;
+    struct ccnl_disk_ent_s *e;
+    uint32_t i, n = 0;
+
+    for (i = 0; i < ds->tabsize; i++) {
+        for (e = ds->tab[i]; e; e = e->next) {
+            n += e->log == log;
+        }
+    }
+    job = (struct ccnl_disk_job_s *) ccnl_calloc(1, sizeof(*job));
+    if (!job || !n ||
+        !(job->copy = (struct ccnl_disk_copy_s *) ccnl_malloc(n * sizeof(*job->copy)))) {
+        ccnl_free(job);
+        if (!n) {
+            ccnl_diskstore_drop(ds, log);
+        }
+        return;
+    }
+    DEBUGMSG(DEBUG, "disk store: compacting log %08" PRIx32 ", %" PRIu32 " records\n",
+             log->id, n);
+
+    ds->compacting = 1;
+    for (i = 0; i < ds->tabsize && job->cnt < n; i++) {
+        for (e = ds->tab[i]; e; e = e->next) {
+            struct ccnl_disk_copy_s *c = job->copy + job->cnt;
+
+            if (e->log != log) {
+                continue;
+            }
+            c->len = (uint32_t) sizeof(struct ccnl_disk_rechdr_s) + e->len;
+            if (ccnl_diskstore_reserve(ds, c->len)) {
+                break;
+            }
+            c->from = e->offset;
+            c->to = ds->active;
+            c->offset = ds->active->size;
+            ds->active->size += c->len;
+            ds->total += c->len;
+            // reads queued from now on are behind the copy
+            log->live -= c->len;
+            ds->active->live += c->len;
+            e->log = ds->active;
+            e->offset = c->offset;
+            job->cnt++;
+        }
+    }
+    job->type = CCNL_DISK_JOB_COPY;
+    job->log = log;
+    ccnl_diskstore_submit(ds, job);
+    if (job->cnt == n) {
+        ccnl_diskstore_drop(ds, log);
+    }
+    ds->compacting = 0;
+}
+
+static void
+ccnl_diskstore_maintain(struct ccnl_diskstore_s *ds)
+{
+    struct ccnl_disk_log_s *log;
+
+    if (ds->compacting) {
+        return;
+    }
+    // size limit: oldest logs go first
+    while (ds->total > ds->maxbytes) {
+        for (log = ds->logs; log && (log->dropped || log == ds->active);
+             log = log->next) {
+        }
+        if (!log) {
+            break;
+        }
+        ccnl_diskstore_drop(ds, log);
+    }
+    // one compaction at a time
+    for (log = ds->logs; log; log = log->next) {
+        if (log != ds->active && !log->dropped && log->live * 2 < log->size) {
+            ccnl_diskstore_compact(ds, log);
+            break;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------
+// relay side
+
+static void
+ccnl_diskstore_evict(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    struct ccnl_diskstore_s *ds = _disk;
+    struct ccnl_disk_rechdr_s hdr;
+    struct ccnl_disk_job_s *job;
+    struct ccnl_disk_ent_s *e;
+    struct ccnl_buf_s *buf = c->pkt->buf;
+    (void) relay;
+
+    if (!ds || !buf || buf->datalen > CCNL_MAX_PACKET_SIZE) {
+        return;
+    }
+    hdr.magic = CCNL_DISK_REC_MAGIC;
+    hdr.len = (uint32_t) buf->datalen;
+    hdr.hash = ccnl_prefix_hash(c->pkt->pfx);
+    hdr.sum = ccnl_diskstore_sum(buf->data, hdr.len);
+    hdr.staletime = (c->flags & CCNL_CONTENT_FLAGS_STALE) ? 0 : c->staletime;
+    e = *ccnl_diskstore_slot(ds, hdr.hash);
+    if (e && e->len == hdr.len && e->sum == hdr.sum &&
+        e->staletime >= hdr.staletime) {
+        return; // came from disk and is still there, not refreshed since
+    }
+    if (ccnl_diskstore_reserve(ds, sizeof(hdr) + hdr.len)) {
+        return;
+    }
+
+    job = (struct ccnl_disk_job_s *) ccnl_calloc(1, sizeof(*job));
+    if (!job || !(job->data = ccnl_malloc(sizeof(hdr) + hdr.len))) {
+        ccnl_free(job);
+        return;
+    }
+    memcpy(job->data, &hdr, sizeof(hdr));
+    memcpy(job->data + sizeof(hdr), buf->data, hdr.len);
+    job->type = CCNL_DISK_JOB_APPEND;
+    job->hash = hdr.hash;
+    job->log = ds->active;
+    job->offset = ds->active->size;
+    job->len = (uint32_t) sizeof(hdr) + hdr.len;
+    ds->active->size += job->len;
+    ds->total += job->len;
+    ccnl_diskstore_index(ds, &hdr, job->log, job->offset);
+    ccnl_diskstore_submit(ds, job);
+
+    ccnl_diskstore_maintain(ds);
+}
+
+static int
+ccnl_diskstore_cs_miss(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                       struct ccnl_pkt_s **pkt)
+{
+    struct ccnl_diskstore_s *ds = _disk;
+    struct ccnl_disk_job_s *job;
+    struct ccnl_disk_ent_s *e;
+    struct ccnl_interest_s *i;
+    uint64_t hash;
+    int32_t nonce = 0;
+    uint32_t lifetime;
+
+    if (ccnl_segment_cs_miss(relay, from, pkt)) {
+        return 1;
+    }
+    if (!ds) {
+        return 0;
+    }
+    hash = ccnl_prefix_hash((*pkt)->pfx);
+    e = *ccnl_diskstore_slot(ds, hash);
+    if (!e) {
+        return 0;
+    }
+
+    for (job = ds->reads; job && job->hash != hash; job = job->inflight) {
+    }
+    if (!job) {
+        job = (struct ccnl_disk_job_s *) ccnl_calloc(1, sizeof(*job));
+        if (!job || !(job->data = ccnl_malloc(e->len))) {
+            ccnl_free(job);
+            return 0;
+        }
+        job->type = CCNL_DISK_JOB_READ;
+        job->hash = hash;
+        job->sum = e->sum;
+        job->staletime = e->staletime;
+        job->log = e->log;
+        job->offset = e->offset;
+        job->len = e->len;
+        job->inflight = ds->reads;
+        ds->reads = job;
+        ccnl_diskstore_submit(ds, job);
+    }
+
+    // hold the Interest in the PIT until the read completes
+#ifdef USE_SUITE_NDNTLV
+    if ((*pkt)->suite == CCNL_SUITE_NDNTLV && (*pkt)->s.ndntlv.nonce &&
+        (*pkt)->s.ndntlv.nonce->datalen == 4) {
+        memcpy(&nonce, (*pkt)->s.ndntlv.nonce->data, 4);
+    }
+#endif
+    lifetime = (uint32_t) ccnl_pkt_interest_lifetime(*pkt);
+    for (i = ccnl_interest_lookup_name(relay, hash); i; i = i->name_next) {
+        if (i->namehash == hash && ccnl_interest_isSame(i, *pkt)) {
+            break;
+        }
+    }
+    if (!i) {
+        i = ccnl_interest_new(relay, from, pkt);
+        if (!i) {
+            CCNL_FACE_COUNT(from, cs_misses, 1);
+            return CCNL_CS_MISS_DEFERRED; // PIT is full, the Interest was dropped
+        }
+    }
+    ccnl_interest_append_pending(i, from, nonce, lifetime);
+
+    return CCNL_CS_MISS_DEFERRED;
+}
+
+// counts the faces the last ccnl_content_serve_pending() answered as CS hits
+static void
+ccnl_diskstore_count_served(struct ccnl_relay_s *relay)
+{
+#ifdef USE_STATS
+    struct ccnl_face_s *f;
+
+    for (f = relay->faces; f; f = f->next) {
+        if (f->served == relay->servegen) {
+            CCNL_FACE_COUNT(f, cs_hits, 1);
+        }
+    }
+#else
+    (void) relay;
+#endif
+}
+
+// forwards what was held back for a read and is still pending: the record
+// was bad, or its data does not satisfy the Interest (e.g. selectors)
+static void
+ccnl_diskstore_forward(struct ccnl_relay_s *relay, uint64_t hash)
+{
+    struct ccnl_interest_s *i;
+    int k;
+
+    for (i = ccnl_interest_lookup_name(relay, hash); i; i = i->name_next) {
+        if (i->namehash != hash) {
+            continue;
+        }
+        for (k = 0; k < i->pendcnt; k++) {
+            CCNL_FACE_COUNT(i->pending[k].face, cs_misses, 1);
+        }
+        ccnl_interest_propagate(relay, i);
+    }
+}
+
+static void
+ccnl_diskstore_serve(struct ccnl_relay_s *relay, struct ccnl_diskstore_s *ds,
+                     struct ccnl_disk_job_s *job)
+{
+    struct ccnl_pkt_s *pkt = NULL;
+    struct ccnl_content_s *c;
+
+    if (!job->err && ccnl_diskstore_sum(job->data, job->len) == job->sum) {
+        pkt = ccnl_bytes2content(job->data, job->len);
+    }
+    if (pkt && ccnl_prefix_hash(pkt->pfx) == job->hash &&
+        (c = ccnl_content_new(&pkt))) {
+        // the copy keeps the freshness it had when it went to disk, MustBeFresh
+        // Interests for content gone stale meanwhile are forwarded
+        ccnl_content_set_staletime(relay, c, job->staletime);
+        ccnl_content_serve_pending(relay, c);
+        ccnl_diskstore_count_served(relay);
+        ccnl_diskstore_forward(relay, job->hash);
+        if (relay->max_cache_entries != 0 && cache_strategy_cache(relay, c) &&
+            ccnl_content_add2cache(relay, c) && relay->contents == c) {
+            ccnl_content_set_staletime(relay, c, job->staletime);
+            return;
+        }
+        ccnl_content_free(c);
+        return;
+    }
+    ccnl_pkt_free(pkt);
+
+    DEBUGMSG(WARNING, "disk store: bad record in log %08" PRIx32 "\n", job->log->id);
+    ccnl_diskstore_unindex(ds, job->hash);
+    ccnl_diskstore_forward(relay, job->hash);
+}
+
+static void
+ccnl_diskstore_done(struct ccnl_relay_s *relay, struct ccnl_diskstore_s *ds,
+                    struct ccnl_disk_job_s *job)
+{
+    struct ccnl_disk_job_s **jp;
+    struct ccnl_disk_log_s **lp;
+    struct ccnl_disk_ent_s *e;
+
+    switch (job->type) {
+    case CCNL_DISK_JOB_APPEND:
+        e = *ccnl_diskstore_slot(ds, job->hash);
+        if (job->err && e && e->log == job->log && e->offset == job->offset) {
+            DEBUGMSG(WARNING, "disk store: write to log %08" PRIx32 " failed\n",
+                     job->log->id);
+            ccnl_diskstore_unindex(ds, job->hash);
+        }
+        break;
+    case CCNL_DISK_JOB_READ:
+        for (jp = &ds->reads; *jp && *jp != job; jp = &(*jp)->inflight) {
+        }
+        if (*jp) {
+            *jp = job->inflight;
+        }
+        if (relay) {
+            ccnl_diskstore_serve(relay, ds, job);
+        }
+        break;
+    case CCNL_DISK_JOB_COPY:
+        if (job->err) {
+            DEBUGMSG(WARNING, "disk store: compaction of log %08" PRIx32 " failed\n",
+                     job->log->id);
+        }
+        break;
+    case CCNL_DISK_JOB_DROP:
+        for (lp = &ds->logs; *lp && *lp != job->log; lp = &(*lp)->next) {
+        }
+        if (*lp) {
+            *lp = job->log->next;
+        }
+        ccnl_free(job->log);
+        break;
+    default:
+        break;
+    }
+    ccnl_free(job->data);
+    ccnl_free(job->copy);
+    ccnl_free(job);
+}
+
+void
+ccnl_diskstore_complete(struct ccnl_relay_s *relay)
+{
+    struct ccnl_disk_job_s *job, *next;
+    uint8_t buf[16];
+
+    if (!_disk) {
+        return;
+    }
+    while (read(_disk->pipefd[0], buf, sizeof(buf)) > 0) {
+    }
+    pthread_mutex_lock(&_disk->lock);
+    job = _disk->done;
+    _disk->done = _disk->doneend = NULL;
+    _disk->woken = 0;
+    pthread_mutex_unlock(&_disk->lock);
+    for (; job; job = next) {
+        next = job->next;
+        ccnl_diskstore_done(relay, _disk, job);
+    }
+}
+
+int
+ccnl_diskstore_fd(void)
+{
+    return _disk ? _disk->pipefd[0] : -1;
+}
+
+// ----------------------------------------------------------------------
+// setup
+
+static int
+ccnl_diskstore_idcmp(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+
+    return x < y ? -1 : x > y;
+}
+
+// rebuilds the index entries of one log, cuts off a torn tail
+static void
+ccnl_diskstore_recover(struct ccnl_diskstore_s *ds, uint32_t id)
+{
+    struct ccnl_disk_rechdr_s hdr;
+    struct ccnl_disk_log_s *log;
+    char path[PATH_MAX];
+    struct stat st;
+    uint64_t off = 0, size;
+    int fd;
+
+    ccnl_diskstore_logname(ds, id, path, sizeof(path));
+    fd = open(path, O_RDWR);
+    if (fd < 0 || fstat(fd, &st) || !(log = ccnl_diskstore_addlog(ds, id, fd))) {
+        DEBUGMSG(WARNING, "disk store: could not open %s\n", path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+    size = (uint64_t) st.st_size;
+    while (off + sizeof(hdr) <= size &&
+           !ccnl_diskstore_pio(fd, (uint8_t *) &hdr, sizeof(hdr), off, 0) &&
+           hdr.magic == CCNL_DISK_REC_MAGIC && hdr.len <= CCNL_MAX_PACKET_SIZE &&
+           off + sizeof(hdr) + hdr.len <= size) {
+        ccnl_diskstore_index(ds, &hdr, log, off);
+        off += sizeof(hdr) + hdr.len;
+    }
+    if (off < size) {
+        DEBUGMSG(WARNING, "disk store: truncating %s at %" PRIu64 "\n", path, off);
+        if (ftruncate(fd, (off_t) off)) {
+            DEBUGMSG(WARNING, "disk store: truncate failed: %d\n", errno);
+        }
+    }
+    log->size = off;
+    ds->total += off;
+    ds->active = log;
+}
+
+int
+ccnl_diskstore_open(struct ccnl_relay_s *relay, char *dir, uint64_t maxbytes)
+{
+    struct ccnl_diskstore_s *ds;
+    struct dirent *de;
+    uint32_t *ids = NULL, *tmp, idcnt = 0, idsize = 0, i;
+    char *end;
+    DIR *d;
+    (void) relay;
+
+    if (_disk) {
+        return -1;
+    }
+    if (mkdir(dir, 0777) && errno != EEXIST) {
+        DEBUGMSG(ERROR, "disk store: could not create %s: %d\n", dir, errno);
+        return -1;
+    }
+    d = opendir(dir);
+    if (!d) {
+        DEBUGMSG(ERROR, "disk store: could not open %s: %d\n", dir, errno);
+        return -1;
+    }
+    while ((de = readdir(d))) {
+        unsigned long id = strtoul(de->d_name, &end, 16);
+
+        if (end != de->d_name + 8 || strcmp(end, ".log") || id > UINT32_MAX) {
+            continue;
+        }
+        if (idcnt == idsize) {
+            idsize = idsize ? 2 * idsize : 64;
+            tmp = (uint32_t *) ccnl_malloc(idsize * sizeof(*ids));
+            if (!tmp) {
+                break;
+            }
+            if (ids) {
+                memcpy(tmp, ids, idcnt * sizeof(*ids));
+                ccnl_free(ids);
+            }
+            ids = tmp;
+        }
+        ids[idcnt++] = (uint32_t) id;
+    }
+    closedir(d);
+
+    ds = (struct ccnl_diskstore_s *) ccnl_calloc(1, sizeof(*ds));
+    if (!ds) {
+        ccnl_free(ids);
+        return -1;
+    }
+    ds->dir = (char *) ccnl_malloc(strlen(dir) + 1);
+    ds->tabsize = 1024;
+    ds->tab = (struct ccnl_disk_ent_s **) ccnl_calloc(ds->tabsize, sizeof(*ds->tab));
+    if (!ds->dir || !ds->tab || pipe(ds->pipefd)) {
+        ccnl_free(ds->dir);
+        ccnl_free(ds->tab);
+        ccnl_free(ds);
+        ccnl_free(ids);
+        return -1;
+    }
+    strcpy(ds->dir, dir);
+    ds->maxbytes = maxbytes ? maxbytes : 16 * (uint64_t) CCNL_DISK_LOG_SIZE;
+    // small stores use smaller logs, so that dropping one does not empty them
+    ds->logsize = ds->maxbytes / 4 < CCNL_DISK_LOG_SIZE ? ds->maxbytes / 4
+                                                        : CCNL_DISK_LOG_SIZE;
+    fcntl(ds->pipefd[0], F_SETFL, O_NONBLOCK);
+    fcntl(ds->pipefd[1], F_SETFL, O_NONBLOCK);
+
+    // later logs override earlier ones
+    if (idcnt) {
+        qsort(ids, idcnt, sizeof(*ids), ccnl_diskstore_idcmp);
+    }
+    for (i = 0; i < idcnt; i++) {
+        ccnl_diskstore_recover(ds, ids[i]);
+    }
+    ccnl_free(ids);
+    DEBUGMSG(INFO, "disk store %s: %" PRIu32 " records, %" PRIu64 " bytes\n",
+             dir, ds->cnt, ds->total);
+
+    pthread_mutex_init(&ds->lock, NULL);
+    pthread_cond_init(&ds->cond, NULL);
+    if (pthread_create(&ds->worker, NULL, ccnl_diskstore_worker, ds)) {
+        DEBUGMSG(ERROR, "disk store: could not start worker thread\n");
+        _disk = ds;
+        ds->stop = 1;
+        ccnl_diskstore_close();
+        return -1;
+    }
+    _disk = ds;
+    ccnl_set_cb_cs_miss(ccnl_diskstore_cs_miss);
+    ccnl_set_cb_cs_evict(ccnl_diskstore_evict);
+    ccnl_diskstore_maintain(ds);
+
+    return 0;
+}
+
+void
+ccnl_diskstore_close(void)
+{
+    struct ccnl_diskstore_s *ds = _disk;
+    struct ccnl_disk_ent_s *e;
+    struct ccnl_disk_log_s *log;
+    uint32_t i;
+    int started;
+
+    if (!ds) {
+        return;
+    }
+    ccnl_set_cb_cs_miss(ccnl_segment_cs_miss);
+    ccnl_set_cb_cs_evict(NULL);
+
+    // let the worker drain its queue
+    pthread_mutex_lock(&ds->lock);
+    started = !ds->stop;
+    ds->stop = 1;
+    pthread_cond_signal(&ds->cond);
+    pthread_mutex_unlock(&ds->lock);
+    if (started) {
+        pthread_join(ds->worker, NULL);
+    }
+    ccnl_diskstore_complete(NULL);
+
+    for (i = 0; i < ds->tabsize; i++) {
+        while ((e = ds->tab[i])) {
+            ds->tab[i] = e->next;
+            ccnl_free(e);
+        }
+    }
+    while ((log = ds->logs)) {
+        ds->logs = log->next;
+        close(log->fd);
+        ccnl_free(log);
+    }
+    close(ds->pipefd[0]);
+    close(ds->pipefd[1]);
+    pthread_cond_destroy(&ds->cond);
+    pthread_mutex_destroy(&ds->lock);
+    ccnl_free(ds->tab);
+    ccnl_free(ds->dir);
+    ccnl_free(ds);
+    _disk = NULL;
+}
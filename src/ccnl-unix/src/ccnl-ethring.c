@@ -0,0 +1,239 @@
+/*
+ * @f ccnl-ethring.c
+ * @b CCN lite, PACKET_MMAP rings for Ethernet interfaces
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "ccnl-ethring.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "ccnl-os-includes.h"
+#include "ccnl-core.h"
+#include "ccnl-dispatch.h"
+
+#if defined(USE_LINKLAYER) && defined(USE_PACKET_MMAP)
+
+// where the frame starts in a TX slot, as the kernel expects it
+#define CCNL_ETHRING_TXOFFS     (TPACKET3_HDRLEN - sizeof(struct sockaddr_ll))
+#define CCNL_ETHRING_ETHHDR     14
+
+struct ccnl_ethring_s*
+ccnl_ethring_open(int sock)
+{
+    struct ccnl_ethring_s *r;
+    struct tpacket_req3 req;
+    size_t rxlen = (size_t) CCNL_ETHRING_BLOCKSIZE * CCNL_ETHRING_RXBLOCKS;
+    size_t txlen = (size_t) CCNL_ETHRING_FRAMESIZE * CCNL_ETHRING_TXFRAMES;
+    int val = TPACKET_V3;
+
+    if (setsockopt(sock, SOL_PACKET, PACKET_VERSION, &val, sizeof(val)) < 0) {
+        DEBUGMSG(WARNING, "no TPACKET_V3 rings: %s\n", strerror(errno));
+        return NULL;
+    }
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = CCNL_ETHRING_BLOCKSIZE;
+    req.tp_block_nr = CCNL_ETHRING_RXBLOCKS;
+    req.tp_frame_size = CCNL_ETHRING_FRAMESIZE;
+    req.tp_frame_nr = (CCNL_ETHRING_BLOCKSIZE / CCNL_ETHRING_FRAMESIZE) *
+                      CCNL_ETHRING_RXBLOCKS;
+    req.tp_retire_blk_tov = CCNL_ETHRING_TIMEOUT;
+    if (setsockopt(sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        DEBUGMSG(WARNING, "no RX ring: %s\n", strerror(errno));
+        val = TPACKET_V1;
+        setsockopt(sock, SOL_PACKET, PACKET_VERSION, &val, sizeof(val));
+        return NULL;
+    }
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = CCNL_ETHRING_BLOCKSIZE;
+    req.tp_block_nr = (unsigned int) (txlen / CCNL_ETHRING_BLOCKSIZE);
+    req.tp_frame_size = CCNL_ETHRING_FRAMESIZE;
+    req.tp_frame_nr = CCNL_ETHRING_TXFRAMES;
+    if (setsockopt(sock, SOL_PACKET, PACKET_TX_RING, &req, sizeof(req)) < 0) {
+        DEBUGMSG(INFO, "no TX ring, sending with sendto(): %s\n",
+                 strerror(errno));
+        txlen = 0;
+    } else {
+        // the frames leave for the driver directly, as with sendto()
+        // through an interface without queueing discipline
+        val = 1;
+        setsockopt(sock, SOL_PACKET, PACKET_QDISC_BYPASS, &val, sizeof(val));
+    }
+
+    r = (struct ccnl_ethring_s*) ccnl_calloc(1, sizeof(*r));
+    if (!r) {
+        return NULL;
+    }
+    r->sock = sock;
+    r->maplen = rxlen + txlen;
+    r->map = mmap(NULL, r->maplen, PROT_READ | PROT_WRITE, MAP_SHARED, sock, 0);
+    if (r->map == MAP_FAILED) {
+        DEBUGMSG(WARNING, "mapping the rings failed: %s\n", strerror(errno));
+        ccnl_free(r);
+        return NULL;
+    }
+    r->tx = txlen ? r->map + rxlen : NULL;
+    DEBUGMSG(INFO, "PACKET_MMAP rings: %d RX blocks of %d bytes, %d TX slots\n",
+             CCNL_ETHRING_RXBLOCKS, CCNL_ETHRING_BLOCKSIZE,
+             txlen ? CCNL_ETHRING_TXFRAMES : 0);
+
+    return r;
+}
+
+void
+ccnl_ethring_close(struct ccnl_ethring_s *r)
+{
+    if (!r) {
+        return;
+    }
+    ccnl_ethring_flush(r);
+    munmap(r->map, r->maplen);
+    ccnl_free(r);
+}
+
+void
+ccnl_ethring_close_all(struct ccnl_relay_s *relay)
+{
+    int i;
+
+    for (i = 0; i < relay->ifcount; i++) {
+        ccnl_ethring_close(relay->ifs[i].ring);
+        relay->ifs[i].ring = NULL;
+    }
+}
+
+int
+ccnl_ethring_RX(struct ccnl_relay_s *relay, int ifndx)
+{
+    struct ccnl_ethring_s *r = relay->ifs[ifndx].ring;
+    int blocks, cnt = 0;
+
+    for (blocks = 0; blocks < CCNL_ETHRING_RXBLOCKS; blocks++) {
+        struct tpacket_block_desc *bd = (struct tpacket_block_desc*)
+                (r->map + (size_t) r->rxblock * CCNL_ETHRING_BLOCKSIZE);
+        struct tpacket3_hdr *h;
+        uint32_t k;
+
+        if (!(((volatile struct tpacket_block_desc*) bd)->hdr.bh1.block_status &
+                                                            TP_STATUS_USER)) {
+            break;
+        }
+        __sync_synchronize();
+        h = (struct tpacket3_hdr*) ((uint8_t*) bd + bd->hdr.bh1.offset_to_first_pkt);
+        for (k = 0; k < bd->hdr.bh1.num_pkts; k++) {
+            // the kernel puts the source address behind the frame header
+            struct sockaddr_ll *sll = (struct sockaddr_ll*)
+                                  ((uint8_t*) h + TPACKET_ALIGN(sizeof(*h)));
+
+            if (h->tp_snaplen > CCNL_ETHRING_ETHHDR) {
+                ccnl_core_RX(relay, ifndx,
+                             (uint8_t*) h + h->tp_mac + CCNL_ETHRING_ETHHDR,
+                             h->tp_snaplen - CCNL_ETHRING_ETHHDR,
+                             (struct sockaddr*) sll, sizeof(*sll));
+                cnt++;
+            }
+            h = (struct tpacket3_hdr*) ((uint8_t*) h + h->tp_next_offset);
+        }
+        __sync_synchronize();
+        bd->hdr.bh1.block_status = TP_STATUS_KERNEL;
+        r->rxblock = (r->rxblock + 1) % CCNL_ETHRING_RXBLOCKS;
+    }
+#ifdef USE_STATS
+    relay->ifs[ifndx].rx_cnt += cnt;
+#endif
+    return cnt;
+}
+
+static struct tpacket3_hdr*
+ccnl_ethring_slot(struct ccnl_ethring_s *r)
+{
+    struct tpacket3_hdr *h = (struct tpacket3_hdr*)
+                (r->tx + (size_t) r->txslot * CCNL_ETHRING_FRAMESIZE);
+
+    if (((volatile struct tpacket3_hdr*) h)->tp_status &
+                                (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING)) {
+        return NULL;
+    }
+    __sync_synchronize();
+    return h;
+}
+
+int
+ccnl_ethring_put(struct ccnl_ethring_s *r, uint8_t *dst, uint8_t *src,
+                 struct iovec *iov, int iovcnt)
+{
+    uint16_t type = htons(CCNL_ETH_TYPE);
+    struct tpacket3_hdr *h;
+    uint8_t *cp;
+    size_t len = CCNL_ETHRING_ETHHDR;
+    int i;
+
+    for (i = 0; i < iovcnt; i++) {
+        len += iov[i].iov_len;
+    }
+    if (len > CCNL_ETHRING_FRAMESIZE - CCNL_ETHRING_TXOFFS) {
+        DEBUGMSG(WARNING, "frame of %zu bytes does not fit a TX slot\n", len);
+        return -1;
+    }
+    h = ccnl_ethring_slot(r);
+    if (!h) {
+        // wait for the kernel to send what is in the ring
+        r->txpending = 0;
+        if (send(r->sock, NULL, 0, 0) < 0 || !(h = ccnl_ethring_slot(r))) {
+            DEBUGMSG(WARNING, "TX ring full, frame dropped\n");
+            return -1;
+        }
+    }
+
+    cp = (uint8_t*) h + CCNL_ETHRING_TXOFFS;
+    memcpy(cp, dst, 6);
+    memcpy(cp + 6, src, 6);
+    memcpy(cp + 12, &type, sizeof(type));
+    cp += CCNL_ETHRING_ETHHDR;
+    for (i = 0; i < iovcnt; i++) {
+        memcpy(cp, iov[i].iov_base, iov[i].iov_len);
+        cp += iov[i].iov_len;
+    }
+    h->tp_len = (uint32_t) len;
+    h->tp_snaplen = (uint32_t) len;
+    h->tp_next_offset = 0;
+    __sync_synchronize();
+    h->tp_status = TP_STATUS_SEND_REQUEST;
+
+    r->txslot = (r->txslot + 1) % CCNL_ETHRING_TXFRAMES;
+    r->txpending++;
+    return 0;
+}
+
+void
+ccnl_ethring_flush(struct ccnl_ethring_s *r)
+{
+    if (r->txpending) {
+        r->txpending = 0;
+        if (send(r->sock, NULL, 0, MSG_DONTWAIT) < 0 && errno != EAGAIN) {
+            DEBUGMSG(WARNING, "TX ring kick failed: %s\n", strerror(errno));
+        }
+    }
+}
+
+#endif // USE_LINKLAYER && USE_PACKET_MMAP
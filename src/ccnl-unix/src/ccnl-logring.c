@@ -0,0 +1,175 @@
+/*
+ * @f ccnl-logring.c
+ * @b CCN lite, log messages written by a background thread
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "ccnl-logring.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "ccnl-os-includes.h"
+#include "ccnl-logging.h"
+#include "ccnl-os-time.h"
+
+#ifdef USE_LOGGING
+
+struct ccnl_logrec_s {
+    double time;
+    int level;
+    char msg[CCNL_LOGRING_MSGLEN];
+};
+
+struct ccnl_logring_s {
+    unsigned int head;                  // written by the relay's thread
+    unsigned int tail;                  // written by the writer
+    unsigned int dropped;
+    int stop;
+    pthread_t writer;
+    struct ccnl_logrec_s recs[CCNL_LOGRING_SLOTS];
+};
+
+static struct ccnl_logring_s *theRing;
+
+// called by DEBUGMSG() on the relay's thread
+static void
+ccnl_logring_put(int level, const char *fmt, va_list ap)
+{
+    struct ccnl_logring_s *r = theRing;
+    struct ccnl_logrec_s *rec;
+
+    if (r->head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) ==
+                                                        CCNL_LOGRING_SLOTS) {
+        __atomic_add_fetch(&r->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    rec = r->recs + (r->head & (CCNL_LOGRING_SLOTS - 1));
+    rec->time = CCNL_NOW();
+    rec->level = level;
+    if (vsnprintf(rec->msg, sizeof(rec->msg), fmt, ap) >= (int) sizeof(rec->msg)) {
+        rec->msg[sizeof(rec->msg) - 2] = '\n';
+    }
+    __atomic_store_n(&r->head, r->head + 1, __ATOMIC_RELEASE);
+}
+
+static void
+ccnl_logring_write(char *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(STDERR_FILENO, buf, len);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        buf += n;
+        len -= (size_t) n;
+    }
+}
+
+static void
+ccnl_logring_drain(struct ccnl_logring_s *r)
+{
+    char buf[16 * 1024];
+    size_t len = 0;
+    unsigned int head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    unsigned int tail = r->tail, dropped;
+
+    while (tail != head) {
+        struct ccnl_logrec_s *rec = r->recs + (tail & (CCNL_LOGRING_SLOTS - 1));
+
+        if (sizeof(buf) - len < CCNL_LOGRING_MSGLEN + 32) {
+            ccnl_logring_write(buf, len);
+            len = 0;
+        }
+        len += (size_t) snprintf(buf + len, sizeof(buf) - len, "[%c] %.4f: %s",
+                                 ccnl_debugLevelToChar(rec->level),
+                                 rec->time, rec->msg);
+        tail++;
+        __atomic_store_n(&r->tail, tail, __ATOMIC_RELEASE);
+    }
+    dropped = __atomic_exchange_n(&r->dropped, 0, __ATOMIC_RELAXED);
+    if (dropped) {
+        len += (size_t) snprintf(buf + len, sizeof(buf) - len,
+                                 "[W] %.4f: %u log messages dropped\n",
+                                 CCNL_NOW(), dropped);
+    }
+    ccnl_logring_write(buf, len);
+}
+
+static void*
+ccnl_logring_writer(void *arg)
+{
+    struct ccnl_logring_s *r = (struct ccnl_logring_s *) arg;
+    struct timespec ts = { 0, CCNL_LOGRING_PERIOD * 1000L };
+
+    while (!__atomic_load_n(&r->stop, __ATOMIC_ACQUIRE)) {
+        ccnl_logring_drain(r);
+        nanosleep(&ts, NULL);
+    }
+    ccnl_logring_drain(r);
+    return NULL;
+}
+
+int
+ccnl_logring_open(void)
+{
+    struct ccnl_logring_s *r;
+
+    if (theRing) {
+        return 0;
+    }
+    // not ccnl_malloc(): the ring is still in use while the relay cleans up
+    r = (struct ccnl_logring_s *) calloc(1, sizeof(*r));
+    if (!r) {
+        return -1;
+    }
+    if (pthread_create(&r->writer, NULL, ccnl_logring_writer, r)) {
+        free(r);
+        return -1;
+    }
+    theRing = r;
+    ccnl_log_set_sink(ccnl_logring_put);
+    atexit(ccnl_logring_close);
+    return 0;
+}
+
+void
+ccnl_logring_close(void)
+{
+    struct ccnl_logring_s *r = theRing;
+
+    if (!r) {
+        return;
+    }
+    ccnl_log_set_sink(NULL);
+    theRing = NULL;
+    __atomic_store_n(&r->stop, 1, __ATOMIC_RELEASE);
+    pthread_join(r->writer, NULL);
+    free(r);
+}
+
+#endif // USE_LOGGING
@@ -0,0 +1,441 @@
+/*
+ * @f ccnl-segment.c
+ * @b CCN lite, packed and memory mapped content segments
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "ccnl-segment.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ccnl-os-includes.h"
+#include "ccnl-core.h"
+#include "ccnl-callbacks.h"
+#include "ccnl-pkt-ccnb.h"
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-pkt-switch.h"
+
+/**
+ * segments attached to the relay
+ */
+static struct ccnl_segment_s *_segments = NULL;
+
+struct ccnl_pkt_s*
+ccnl_bytes2content(uint8_t *data, size_t datalen)
+{
+    size_t skip;
+    int suite;
+    (void) data; // silence compiler warning (if any USE_SUITE_* is not set)
+#if defined(USE_SUITE_NDNTLV)
+    uint64_t typ;
+    size_t len;
+#endif
+
+    if (datalen < 2) {
+        return NULL;
+    }
+    suite = ccnl_pkt2suite(data, datalen, &skip);
+    switch (suite) {
+#ifdef USE_SUITE_CCNB
+    case CCNL_SUITE_CCNB: {
+        uint8_t *start;
+
+        data = start = data + skip;
+        datalen -= skip;
+
+        if (datalen < 2 || data[0] != 0x04 || data[1] != 0x82) {
+            return NULL;
+        }
+        data += 2;
+        datalen -= 2;
+
+        return ccnl_ccnb_bytes2pkt(start, &data, &datalen);
+    }
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV: {
+        size_t hdrlen;
+        uint8_t *start;
+
+        data = start = data + skip;
+        datalen -=  skip;
+
+        if (ccnl_ccntlv_getHdrLen(data, datalen, &hdrlen) ||
+            ((struct ccnx_tlvhdr_ccnx2015_s*) start)->pkttype != CCNX_PT_Data) {
+            return NULL;
+        }
+        data += hdrlen;
+        datalen -= hdrlen;
+
+        return ccnl_ccntlv_bytes2pkt(start, &data, &datalen);
+    }
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV: {
+        uint8_t *olddata;
+
+        data = olddata = data + skip;
+        datalen -= skip;
+        if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len) ||
+                                                     typ != NDN_TLV_Data) {
+            return NULL;
+        }
+        return ccnl_ndntlv_bytes2pkt(typ, olddata, &data, &datalen);
+    }
+#endif
+    default:
+        return NULL;
+    }
+}
+
+// the suite's CS matching function, 0 on a match
+static int
+ccnl_segment_cMatch(struct ccnl_pkt_s *p, struct ccnl_content_s *c)
+{
+    switch (p->suite) {
+#ifdef USE_SUITE_CCNB
+    case CCNL_SUITE_CCNB:
+        return ccnl_ccnb_cMatch(p, c);
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV:
+        return ccnl_ccntlv_cMatch(p, c);
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+        return ccnl_ndntlv_cMatch(p, c);
+#endif
+    default:
+        return -1;
+    }
+}
+
+struct ccnl_segment_s*
+ccnl_segment_open(char *path)
+{
+    struct ccnl_segment_s *seg;
+    struct ccnl_segment_hdr_s *hdr;
+    struct stat st;
+    uint8_t *base;
+    size_t size;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        DEBUGMSG(ERROR, "could not open segment %s: %d\n", path, errno);
+        return NULL;
+    }
+    if (fstat(fd, &st) || st.st_size < (off_t) sizeof(*hdr)) {
+        DEBUGMSG(ERROR, "segment %s is too short\n", path);
+        close(fd);
+        return NULL;
+    }
+    size = (size_t) st.st_size;
+    base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        DEBUGMSG(ERROR, "could not map segment %s: %d\n", path, errno);
+        return NULL;
+    }
+
+    hdr = (struct ccnl_segment_hdr_s *) base;
+    if (memcmp(hdr->magic, CCNL_SEGMENT_MAGIC, sizeof(CCNL_SEGMENT_MAGIC)) ||
+        hdr->version != CCNL_SEGMENT_VERSION) {
+        DEBUGMSG(ERROR, "%s is not a content segment (or of another version)\n", path);
+        goto Bail;
+    }
+    if (hdr->indexoffs < sizeof(*hdr) || hdr->indexoffs % 8 ||
+        hdr->indexoffs > size ||
+        (size - hdr->indexoffs) / sizeof(struct ccnl_segment_idx_s) < hdr->count) {
+        DEBUGMSG(ERROR, "segment %s has a corrupt index\n", path);
+        goto Bail;
+    }
+
+    seg = (struct ccnl_segment_s *) ccnl_calloc(1, sizeof(*seg));
+    if (!seg) {
+        goto Bail;
+    }
+    seg->base = base;
+    seg->size = size;
+    seg->count = hdr->count;
+    seg->indexoffs = hdr->indexoffs;
+    seg->idx = (struct ccnl_segment_idx_s *) (base + hdr->indexoffs);
+    // only the index pages and the hit packets are touched
+    posix_madvise(base, size, POSIX_MADV_RANDOM);
+
+    DEBUGMSG(INFO, "mapped segment %s, %u packets\n", path, seg->count);
+    return seg;
+
+Bail:
+    munmap(base, size);
+    return NULL;
+}
+
+void
+ccnl_segment_close(struct ccnl_segment_s *seg)
+{
+    if (seg) {
+        munmap(seg->base, seg->size);
+        ccnl_free(seg);
+    }
+}
+
+struct ccnl_content_s*
+ccnl_segment_lookup(struct ccnl_segment_s *seg, struct ccnl_pkt_s *interest)
+{
+    struct ccnl_segment_idx_s *e;
+    struct ccnl_content_s *c;
+    struct ccnl_pkt_s *pkt;
+    uint64_t h;
+    uint32_t lo = 0, hi = seg->count, mid;
+
+    h = ccnl_prefix_hash(interest->pfx);
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (seg->idx[mid].hash < h) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    for (e = seg->idx + lo; lo < seg->count && e->hash == h; lo++, e++) {
+        if (e->offset > seg->indexoffs || e->len > seg->indexoffs - e->offset) {
+            continue;
+        }
+        pkt = ccnl_bytes2content(seg->base + e->offset, e->len);
+        if (!pkt) {
+            continue;
+        }
+        if (pkt->suite != interest->suite) {
+            ccnl_pkt_free(pkt);
+            continue;
+        }
+        c = ccnl_content_new(&pkt);
+        if (!c) {
+            ccnl_pkt_free(pkt);
+            return NULL;
+        }
+        if (!ccnl_segment_cMatch(interest, c)) {
+            return c;
+        }
+        ccnl_content_free(c);
+    }
+
+    return NULL;
+}
+
+int
+ccnl_segment_cs_miss(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                     struct ccnl_pkt_s **pkt)
+{
+    struct ccnl_segment_s *seg;
+    struct ccnl_content_s *c = NULL;
+
+    for (seg = _segments; seg && !c; seg = seg->next) {
+        c = ccnl_segment_lookup(seg, *pkt);
+    }
+    if (!c) {
+        return 0;
+    }
+
+    DEBUGMSG_CFWD(DEBUG, "  found matching content %p in segment\n", (void *) c);
+    if (from && from->ifndx >= 0) {
+        CCNL_FACE_COUNT(from, data_out, 1);
+        ccnl_send_pkt(relay, from, c->pkt);
+    }
+
+    // keep a copy in memory, it is likely to be asked for again
+    if (relay->max_cache_entries != 0 && cache_strategy_cache(relay, c) &&
+        ccnl_content_add2cache(relay, c) && relay->contents == c) {
+        return 1;
+    }
+    ccnl_content_free(c);
+
+    return 1;
+}
+
+int
+ccnl_segment_attach(struct ccnl_relay_s *relay, char *path)
+{
+    struct ccnl_segment_s *seg = ccnl_segment_open(path);
+    (void) relay;
+
+    if (!seg) {
+        return -1;
+    }
+    seg->next = _segments;
+    _segments = seg;
+    ccnl_set_cb_cs_miss(ccnl_segment_cs_miss);
+
+    return 0;
+}
+
+void
+ccnl_segment_detach_all(void)
+{
+    struct ccnl_segment_s *seg;
+
+    while ((seg = _segments)) {
+        _segments = seg->next;
+        ccnl_segment_close(seg);
+    }
+    ccnl_set_cb_cs_miss(NULL);
+}
+
+// ----------------------------------------------------------------------
+// creating segments
+
+static int
+ccnl_segment_pwrite(int fd, void *buf, size_t len, uint64_t offset)
+{
+    uint8_t *cp = (uint8_t *) buf;
+    ssize_t n;
+
+    while (len > 0) {
+        n = pwrite(fd, cp, len, (off_t) offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        cp += n;
+        len -= (size_t) n;
+        offset += (uint64_t) n;
+    }
+    return 0;
+}
+
+static int
+ccnl_segment_idx_cmp(const void *a, const void *b)
+{
+    const struct ccnl_segment_idx_s *x = a, *y = b;
+
+    if (x->hash != y->hash) {
+        return x->hash < y->hash ? -1 : 1;
+    }
+    if (x->offset != y->offset) {
+        return x->offset < y->offset ? -1 : 1;
+    }
+    return 0;
+}
+
+struct ccnl_segment_writer_s*
+ccnl_segment_writer_open(char *path)
+{
+    struct ccnl_segment_writer_s *w;
+
+    w = (struct ccnl_segment_writer_s *) ccnl_calloc(1, sizeof(*w));
+    if (!w) {
+        return NULL;
+    }
+    w->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (w->fd < 0) {
+        DEBUGMSG(ERROR, "could not create segment %s: %d\n", path, errno);
+        ccnl_free(w);
+        return NULL;
+    }
+    w->offset = sizeof(struct ccnl_segment_hdr_s);
+
+    return w;
+}
+
+int
+ccnl_segment_writer_add(struct ccnl_segment_writer_s *w,
+                        uint8_t *data, size_t datalen)
+{
+    struct ccnl_segment_idx_s *e;
+    struct ccnl_pkt_s *pkt;
+
+    if (datalen > UINT32_MAX) {
+        return -1;
+    }
+    pkt = ccnl_bytes2content(data, datalen);
+    if (!pkt) {
+        DEBUGMSG(WARNING, "segment: not a content object, skipped\n");
+        return -1;
+    }
+
+    if (w->count == w->size) {
+        uint32_t size = w->size ? 2 * w->size : 1024;
+        e = (struct ccnl_segment_idx_s *) ccnl_malloc(size * sizeof(*e));
+        if (!e) {
+            ccnl_pkt_free(pkt);
+            return -1;
+        }
+        if (w->idx) {
+            memcpy(e, w->idx, w->count * sizeof(*e));
+            ccnl_free(w->idx);
+        }
+        w->idx = e;
+        w->size = size;
+    }
+
+    if (ccnl_segment_pwrite(w->fd, data, datalen, w->offset)) {
+        ccnl_pkt_free(pkt);
+        return -1;
+    }
+    e = w->idx + w->count++;
+    e->hash = ccnl_prefix_hash(pkt->pfx);
+    e->offset = w->offset;
+    e->len = (uint32_t) datalen;
+    e->flags = 0;
+    w->offset += datalen;
+    ccnl_pkt_free(pkt);
+
+    return 0;
+}
+
+int
+ccnl_segment_writer_close(struct ccnl_segment_writer_s *w)
+{
+    struct ccnl_segment_hdr_s hdr;
+    int rc = -1;
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, CCNL_SEGMENT_MAGIC, sizeof(CCNL_SEGMENT_MAGIC));
+    hdr.version = CCNL_SEGMENT_VERSION;
+    hdr.count = w->count;
+    hdr.indexoffs = (w->offset + 7) & ~(uint64_t) 7;
+
+    if (w->count) {
+        qsort(w->idx, w->count, sizeof(*w->idx), ccnl_segment_idx_cmp);
+    }
+    if (!ccnl_segment_pwrite(w->fd, w->idx, w->count * sizeof(*w->idx),
+                             hdr.indexoffs) &&
+        !ccnl_segment_pwrite(w->fd, &hdr, sizeof(hdr), 0) &&
+        !ftruncate(w->fd, (off_t) (hdr.indexoffs + w->count * sizeof(*w->idx)))) {
+        rc = 0;
+    }
+
+    close(w->fd);
+    ccnl_free(w->idx);
+    ccnl_free(w);
+    return rc;
+}
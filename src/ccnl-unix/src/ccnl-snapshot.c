@@ -0,0 +1,300 @@
+/*
+ * @f ccnl-snapshot.c
+ * @b CCN lite, snapshots of the Content Store and the FIB
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "ccnl-snapshot.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ccnl-os-includes.h"
+#include "ccnl-core.h"
+#include "ccnl-segment.h"
+
+// large stdio buffers, snapshots are streamed
+#define CCNL_SNAPSHOT_BUFSIZE   (1024 * 1024)
+
+static int
+ccnl_snapshot_write_content(FILE *f, struct ccnl_content_s *c)
+{
+    struct ccnl_snapshot_rec_s rec;
+    struct ccnl_buf_s *buf = c->pkt->buf;
+
+    if (!buf) {
+        return 0;
+    }
+    memset(&rec, 0, sizeof(rec));
+    rec.type = CCNL_SNAPSHOT_CONTENT;
+    rec.suite = (uint8_t) c->pkt->suite;
+    rec.flags = (uint16_t) c->flags;
+    rec.len = (uint32_t) buf->datalen;
+
+    if (fwrite(&rec, sizeof(rec), 1, f) != 1 ||
+        fwrite(buf->data, buf->datalen, 1, f) != 1) {
+        return -1;
+    }
+    return 0;
+}
+
+static int
+ccnl_snapshot_write_fib(FILE *f, struct ccnl_relay_s *relay,
+                        struct ccnl_forward_s *fwd)
+{
+    struct ccnl_snapshot_rec_s rec;
+    struct ccnl_prefix_s *pfx = fwd->prefix;
+    int32_t flags = fwd->face->flags;
+    uint32_t i, len;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.type = CCNL_SNAPSHOT_FIB;
+    rec.suite = (uint8_t) fwd->suite;
+    rec.len = 2 * sizeof(sockunion) + sizeof(int32_t) + sizeof(uint32_t);
+    for (i = 0; i < pfx->compcnt; i++) {
+        rec.len += sizeof(uint32_t) + (uint32_t) pfx->complen[i];
+    }
+
+    if (fwrite(&rec, sizeof(rec), 1, f) != 1 ||
+        fwrite(&relay->ifs[fwd->face->ifndx].addr, sizeof(sockunion), 1, f) != 1 ||
+        fwrite(&flags, sizeof(flags), 1, f) != 1 ||
+        fwrite(&fwd->face->peer, sizeof(sockunion), 1, f) != 1 ||
+        fwrite(&pfx->compcnt, sizeof(uint32_t), 1, f) != 1) {
+        return -1;
+    }
+    for (i = 0; i < pfx->compcnt; i++) {
+        len = (uint32_t) pfx->complen[i];
+        if (fwrite(&len, sizeof(len), 1, f) != 1 ||
+            (len && fwrite(pfx->comp[i], len, 1, f) != 1)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int
+ccnl_snapshot_save(struct ccnl_relay_s *relay, char *path)
+{
+    struct ccnl_snapshot_hdr_s hdr;
+    struct ccnl_content_s *c;
+    struct ccnl_forward_s *fwd;
+    char tmp[1024];
+    int ok = 1, ccnt = 0, fcnt = 0;
+    FILE *f;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    f = fopen(tmp, "wb");
+    if (!f) {
+        DEBUGMSG(ERROR, "snapshot: could not create %s: %d\n", tmp, errno);
+        return -1;
+    }
+    setvbuf(f, NULL, _IOFBF, CCNL_SNAPSHOT_BUFSIZE);
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, CCNL_SNAPSHOT_MAGIC, sizeof(CCNL_SNAPSHOT_MAGIC));
+    hdr.version = CCNL_SNAPSHOT_VERSION;
+    hdr.ifcount = (uint32_t) relay->ifcount;
+    ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+
+    // oldest first, reloading adds each in front of the previous one
+    for (c = relay->contents; c && c->next; c = c->next) {
+    }
+    for (; ok && c; c = c->prev, ccnt++) {
+        ok = !ccnl_snapshot_write_content(f, c);
+    }
+    for (fwd = relay->fib; ok && fwd; fwd = fwd->next) {
+        if (fwd->tap || !fwd->prefix || !fwd->face || fwd->face->ifndx < 0 ||
+            fwd->face->ifndx >= relay->ifcount) {
+            continue; // local registrations come back with their apps
+        }
+        ok = !ccnl_snapshot_write_fib(f, relay, fwd);
+        fcnt++;
+    }
+
+    ok = ok && !fflush(f) && !fsync(fileno(f));
+    if (fclose(f) || !ok || rename(tmp, path)) {
+        DEBUGMSG(ERROR, "snapshot: writing %s failed: %d\n", path, errno);
+        unlink(tmp);
+        return -1;
+    }
+    DEBUGMSG(INFO, "snapshot: saved %d contents and %d FIB entries to %s\n",
+             ccnt, fcnt, path);
+    return 0;
+}
+
+static int
+ccnl_snapshot_load_content(struct ccnl_relay_s *relay,
+                           struct ccnl_snapshot_rec_s *rec, uint8_t *data)
+{
+    struct ccnl_pkt_s *pkt = ccnl_bytes2content(data, rec->len);
+    struct ccnl_content_s *c;
+
+    if (!pkt) {
+        return -1;
+    }
+    c = ccnl_content_new(&pkt);
+    if (!c) {
+        ccnl_pkt_free(pkt);
+        return -1;
+    }
+    // whether it is stale again is up to ccnl_content_add2cache()
+    c->flags = (ccnl_content_flags) (rec->flags & CCNL_CONTENT_FLAGS_STATIC);
+    if (!ccnl_content_add2cache(relay, c) || relay->contents != c) {
+        ccnl_content_free(c);
+    }
+    return 0;
+}
+
+static int
+ccnl_snapshot_load_fib(struct ccnl_relay_s *relay,
+                       struct ccnl_snapshot_rec_s *rec, uint8_t *data)
+{
+    struct ccnl_prefix_s *pfx;
+    struct ccnl_face_s *face;
+    uint8_t *cp = data, *end = data + rec->len;
+    int32_t ifndx, flags;
+    uint32_t i, compcnt, len, total;
+    sockunion ifaddr, peer;
+
+    if (rec->len < sizeof(ifaddr) + sizeof(flags) + sizeof(peer) + sizeof(compcnt)) {
+        return -1;
+    }
+    memcpy(&ifaddr, cp, sizeof(ifaddr));
+    cp += sizeof(ifaddr);
+    memcpy(&flags, cp, sizeof(flags));
+    cp += sizeof(flags);
+    memcpy(&peer, cp, sizeof(peer));
+    cp += sizeof(peer);
+    memcpy(&compcnt, cp, sizeof(compcnt));
+    cp += sizeof(compcnt);
+    // the interfaces may come up in another order after a restart
+    for (ifndx = 0; ifndx < relay->ifcount; ifndx++) {
+        if (!ccnl_addr_cmp(&relay->ifs[ifndx].addr, &ifaddr)) {
+            break;
+        }
+    }
+    if (ifndx == relay->ifcount) {
+        DEBUGMSG(WARNING, "snapshot: no interface %s, FIB entry skipped\n",
+                 ccnl_addr2ascii(&ifaddr));
+        return -1;
+    }
+    if (compcnt > CCNL_MAX_NAME_COMP ||
+        (size_t) (end - cp) < compcnt * sizeof(len)) {
+        return -1;
+    }
+    total = (uint32_t) (end - cp) - compcnt * (uint32_t) sizeof(len);
+
+    pfx = ccnl_prefix_new((char) rec->suite, compcnt);
+    if (!pfx) {
+        return -1;
+    }
+    pfx->bytes = (unsigned char *) ccnl_malloc(total ? total : 1);
+    if (!pfx->bytes) {
+        ccnl_prefix_free(pfx);
+        return -1;
+    }
+    for (i = 0, total = 0; i < compcnt; i++) {
+        memcpy(&len, cp, sizeof(len));
+        cp += sizeof(len);
+        if ((size_t) (end - cp) < len) {
+            ccnl_prefix_free(pfx);
+            return -1;
+        }
+        pfx->comp[i] = pfx->bytes + total;
+        pfx->complen[i] = len;
+        memcpy(pfx->comp[i], cp, len);
+        cp += len;
+        total += len;
+    }
+
+    face = ccnl_get_face_or_create(relay, ifndx, &peer.sa, sizeof(peer));
+    if (!face) {
+        ccnl_prefix_free(pfx);
+        return -1;
+    }
+    face->flags |= flags & CCNL_FACE_FLAGS_STATIC;
+    if (ccnl_fib_add_entry(relay, pfx, face)) {
+        ccnl_prefix_free(pfx);
+        return -1;
+    }
+    return 0;
+}
+
+int
+ccnl_snapshot_load(struct ccnl_relay_s *relay, char *path)
+{
+    struct ccnl_snapshot_hdr_s hdr;
+    struct ccnl_snapshot_rec_s rec;
+    uint8_t *data;
+    int cnt = 0, bad = 0;
+    FILE *f;
+
+    f = fopen(path, "rb");
+    if (!f) {
+        DEBUGMSG(WARNING, "snapshot: could not open %s: %d\n", path, errno);
+        return -1;
+    }
+    setvbuf(f, NULL, _IOFBF, CCNL_SNAPSHOT_BUFSIZE);
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+        memcmp(hdr.magic, CCNL_SNAPSHOT_MAGIC, sizeof(CCNL_SNAPSHOT_MAGIC)) ||
+        hdr.version != CCNL_SNAPSHOT_VERSION) {
+        DEBUGMSG(ERROR, "snapshot: %s is not a snapshot\n", path);
+        fclose(f);
+        return -1;
+    }
+    if (hdr.ifcount != (uint32_t) relay->ifcount) {
+        DEBUGMSG(WARNING, "snapshot: taken with %u interfaces, now %d\n",
+                 (unsigned) hdr.ifcount, relay->ifcount);
+    }
+
+    // no record is larger than a packet
+    data = (uint8_t *) ccnl_malloc(CCNL_MAX_PACKET_SIZE);
+    if (!data) {
+        fclose(f);
+        return -1;
+    }
+    while (fread(&rec, sizeof(rec), 1, f) == 1) {
+        if (rec.len > CCNL_MAX_PACKET_SIZE || fread(data, rec.len, 1, f) != 1) {
+            DEBUGMSG(WARNING, "snapshot: %s is truncated\n", path);
+            break;
+        }
+        switch (rec.type) {
+        case CCNL_SNAPSHOT_CONTENT:
+            bad += ccnl_snapshot_load_content(relay, &rec, data) != 0;
+            break;
+        case CCNL_SNAPSHOT_FIB:
+            bad += ccnl_snapshot_load_fib(relay, &rec, data) != 0;
+            break;
+        default:
+            bad++;
+            break;
+        }
+        cnt++;
+    }
+    ccnl_free(data);
+    fclose(f);
+
+    DEBUGMSG(INFO, "snapshot: loaded %d records from %s, %d skipped\n",
+             cnt - bad, path, bad);
+    return cnt - bad;
+}
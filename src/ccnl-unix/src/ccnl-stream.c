@@ -0,0 +1,480 @@
+/*
+ * @f ccnl-stream.c
+ * @b CCN lite, TCP and Unix stream faces
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "ccnl-stream.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#include "ccnl-os-includes.h"
+#include "ccnl-core.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-pkt-util.h"
+#include "ccnl-uring.h"
+
+#ifdef USE_STREAM
+
+#include <netinet/tcp.h>
+
+static struct ccnl_stream_s *streams;
+
+static socklen_t
+ccnl_stream_addrlen(int af)
+{
+    switch (af) {
+#ifdef USE_IPV4
+    case AF_INET:
+        return sizeof(struct sockaddr_in);
+#endif
+#ifdef USE_IPV6
+    case AF_INET6:
+        return sizeof(struct sockaddr_in6);
+#endif
+    case AF_UNIX:
+        return sizeof(struct sockaddr_un);
+    default:
+        return 0;
+    }
+}
+
+static struct ccnl_stream_s*
+ccnl_stream_find(int ifndx, sockunion *peer)
+{
+    struct ccnl_stream_s *s;
+
+    for (s = streams; s; s = s->next) {
+        if (!s->dead && s->ifndx == ifndx && !ccnl_addr_cmp(&s->peer, peer)) {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+static struct ccnl_stream_s*
+ccnl_stream_new(int ifndx, int sock, sockunion *peer)
+{
+    struct ccnl_stream_s *s;
+    int one = 1;
+
+    s = (struct ccnl_stream_s*) ccnl_calloc(1, sizeof(*s));
+    if (!s) {
+        return NULL;
+    }
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+    if (peer->sa.sa_family != AF_UNIX) {
+        // Interests are small and should not wait for more to come
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    s->ifndx = ifndx;
+    s->sock = sock;
+    s->peerlen = ccnl_stream_addrlen(peer->sa.sa_family);
+    memcpy(&s->peer, peer, s->peerlen);
+    s->next = streams;
+    streams = s;
+    return s;
+}
+
+// the face goes, the connection is freed in the next round
+static void
+ccnl_stream_drop(struct ccnl_relay_s *relay, struct ccnl_stream_s *s)
+{
+    struct ccnl_face_s *f;
+
+    DEBUGMSG(INFO, "stream connection to %s closed\n",
+             ccnl_addr2ascii(&s->peer));
+    for (f = relay->faces; f; f = f->next) {
+        if (f->ifndx == s->ifndx && !ccnl_addr_cmp(&f->peer, &s->peer)) {
+            ccnl_face_remove(relay, f);
+            break;
+        }
+    }
+    s->dead = 1;
+}
+
+static void
+ccnl_stream_reap(void)
+{
+    struct ccnl_stream_s **ps = &streams;
+
+    while (*ps) {
+        struct ccnl_stream_s *s = *ps;
+
+        if (!s->dead) {
+            ps = &s->next;
+            continue;
+        }
+        *ps = s->next;
+        close(s->sock);
+#ifdef USE_IO_URING
+        ccnl_uring_fdclosed();
+#endif
+        while (s->outcnt--) {
+            ccnl_free(s->out[s->outfront]);
+            s->outfront = (s->outfront + 1) % CCNL_STREAM_OUTQ;
+        }
+        ccnl_free(s);
+    }
+}
+
+// the stream interface for a family, one that only connects out is added
+static int
+ccnl_stream_if(struct ccnl_relay_s *relay, int af, int sock)
+{
+    struct ccnl_if_s *i;
+    int k;
+
+    if (sock < 0) {
+        for (k = 0; k < relay->ifcount; k++) {
+            if (relay->ifs[k].stream && relay->ifs[k].addr.sa.sa_family == af) {
+                return k;
+            }
+        }
+    }
+    if (relay->ifcount >= CCNL_MAX_INTERFACES) {
+        DEBUGMSG(WARNING, "no interface left for a stream socket\n");
+        return -1;
+    }
+    i = relay->ifs + relay->ifcount;
+    i->sock = sock;
+    i->addr.sa.sa_family = (sa_family_t) af;
+    i->stream = 1;
+    i->mtu = CCNL_MAX_PACKET_SIZE;
+    if (relay->defaultInterfaceScheduler) {
+        i->sched = relay->defaultInterfaceScheduler(relay, ccnl_interface_CTS);
+    }
+    return relay->ifcount++;
+}
+
+int
+ccnl_stream_listen(struct ccnl_relay_s *relay, sockunion *addr)
+{
+    socklen_t addrlen = ccnl_stream_addrlen(addr->sa.sa_family);
+    int sock, one = 1, ifndx;
+
+    sock = socket(addr->sa.sa_family, SOCK_STREAM, 0);
+    if (sock < 0) {
+        DEBUGMSG(ERROR, "stream socket: %s\n", strerror(errno));
+        return -1;
+    }
+    if (addr->sa.sa_family == AF_UNIX) {
+        unlink(addr->ux.sun_path);
+    } else {
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+    if (bind(sock, &addr->sa, addrlen) < 0 || listen(sock, CCNL_STREAM_BACKLOG) < 0) {
+        DEBUGMSG(ERROR, "could not listen on %s: %s\n", ccnl_addr2ascii(addr),
+                 strerror(errno));
+        close(sock);
+        return -1;
+    }
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+    ifndx = ccnl_stream_if(relay, addr->sa.sa_family, sock);
+    if (ifndx < 0) {
+        close(sock);
+        return -1;
+    }
+    memcpy(&relay->ifs[ifndx].addr, addr, addrlen);
+    DEBUGMSG(INFO, "stream interface (%s) configured\n", ccnl_addr2ascii(addr));
+    return 0;
+}
+
+struct ccnl_face_s*
+ccnl_stream_connect(struct ccnl_relay_s *relay, sockunion *peer)
+{
+    socklen_t addrlen = ccnl_stream_addrlen(peer->sa.sa_family);
+    struct ccnl_stream_s *s;
+    int ifndx, sock;
+
+    if (!addrlen) {
+        return NULL;
+    }
+    ifndx = ccnl_stream_if(relay, peer->sa.sa_family, -1);
+    if (ifndx < 0) {
+        return NULL;
+    }
+    if (!ccnl_stream_find(ifndx, peer)) {
+        sock = socket(peer->sa.sa_family, SOCK_STREAM, 0);
+        if (sock < 0) {
+            return NULL;
+        }
+        s = ccnl_stream_new(ifndx, sock, peer);
+        if (!s) {
+            close(sock);
+            return NULL;
+        }
+        if (connect(sock, &peer->sa, addrlen) < 0) {
+            if (errno != EINPROGRESS) {
+                DEBUGMSG(WARNING, "connecting to %s failed: %s\n",
+                         ccnl_addr2ascii(peer), strerror(errno));
+                s->dead = 1;
+                return NULL;
+            }
+            s->connecting = 1;
+        }
+        DEBUGMSG(INFO, "stream connection to %s opened\n", ccnl_addr2ascii(peer));
+    }
+    return ccnl_get_face_or_create(relay, ifndx, &peer->sa, addrlen);
+}
+
+void
+ccnl_stream_close(struct ccnl_relay_s *relay, struct ccnl_face_s *face)
+{
+    struct ccnl_stream_s *s = ccnl_stream_find(face->ifndx, &face->peer);
+
+    (void) relay;
+    if (s) {
+        DEBUGMSG(DEBUG, "face %d removed, closing its stream connection\n",
+                 face->faceid);
+        s->dead = 1;
+    }
+}
+
+void
+ccnl_stream_close_all(struct ccnl_relay_s *relay)
+{
+    struct ccnl_stream_s *s;
+
+    (void) relay;
+    for (s = streams; s; s = s->next) {
+        s->dead = 1;
+    }
+    ccnl_stream_reap();
+}
+
+int
+ccnl_stream_TX(struct ccnl_relay_s *relay, struct ccnl_if_s *ifc,
+               sockunion *dest, struct iovec *iov, int iovcnt)
+{
+    struct ccnl_stream_s *s = ccnl_stream_find((int) (ifc - relay->ifs), dest);
+    struct ccnl_buf_s *buf;
+    size_t len = 0;
+    int i;
+
+    if (!s) {
+        DEBUGMSG(WARNING, "no stream connection to %s\n", ccnl_addr2ascii(dest));
+        return -1;
+    }
+    if (s->outcnt == CCNL_STREAM_OUTQ) {
+        DEBUGMSG(WARNING, "stream to %s is full, packet dropped\n",
+                 ccnl_addr2ascii(dest));
+        return -1;
+    }
+    for (i = 0; i < iovcnt; i++) {
+        len += iov[i].iov_len;
+    }
+    buf = ccnl_buf_new(NULL, len);
+    if (!buf) {
+        return -1;
+    }
+    for (len = 0, i = 0; i < iovcnt; i++) {
+        memcpy(buf->data + len, iov[i].iov_base, iov[i].iov_len);
+        len += iov[i].iov_len;
+    }
+    s->out[(s->outfront + s->outcnt) % CCNL_STREAM_OUTQ] = buf;
+    s->outcnt++;
+    return 0;
+}
+
+void
+ccnl_stream_fdset(struct ccnl_relay_s *relay, fd_set *readfs, fd_set *writefs,
+                  int *maxfd)
+{
+    struct ccnl_stream_s *s;
+    int i;
+
+    for (i = 0; i < relay->ifcount; i++) {
+        if (relay->ifs[i].stream && relay->ifs[i].sock >= 0) {
+            FD_SET(relay->ifs[i].sock, readfs);
+            if (relay->ifs[i].sock >= *maxfd) {
+                *maxfd = relay->ifs[i].sock + 1;
+            }
+        }
+    }
+    for (s = streams; s; s = s->next) {
+        if (s->dead) {
+            continue;
+        }
+        if (!s->connecting) {
+            FD_SET(s->sock, readfs);
+        }
+        if (s->connecting || s->outcnt) {
+            FD_SET(s->sock, writefs);
+        }
+        if (s->sock >= *maxfd) {
+            *maxfd = s->sock + 1;
+        }
+    }
+}
+
+static void
+ccnl_stream_accept(struct ccnl_relay_s *relay, int ifndx)
+{
+    static unsigned int seqno;
+    struct ccnl_if_s *ifc = relay->ifs + ifndx;
+    int k;
+
+    for (k = 0; k < CCNL_STREAM_BACKLOG; k++) {
+        sockunion peer;
+        socklen_t len = sizeof(peer);
+        int sock;
+
+        memset(&peer, 0, sizeof(peer));
+        sock = accept(ifc->sock, &peer.sa, &len);
+        if (sock < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                DEBUGMSG(WARNING, "accept: %s\n", strerror(errno));
+            }
+            return;
+        }
+        if (ifc->addr.sa.sa_family == AF_UNIX) {
+            // the clients of a Unix socket have no address of their own
+            peer.ux.sun_family = AF_UNIX;
+            snprintf(peer.ux.sun_path, sizeof(peer.ux.sun_path), "%.*s#%u",
+                     (int) sizeof(peer.ux.sun_path) - 12,
+                     ifc->addr.ux.sun_path, ++seqno);
+        }
+        if (!ccnl_stream_new(ifndx, sock, &peer)) {
+            close(sock);
+            continue;
+        }
+        DEBUGMSG(INFO, "stream connection from %s accepted\n",
+                 ccnl_addr2ascii(&peer));
+    }
+}
+
+// reads what is there and hands the complete packets on
+static int
+ccnl_stream_read(struct ccnl_relay_s *relay, struct ccnl_stream_s *s)
+{
+    size_t offs = 0, framelen = 0;
+    ssize_t n;
+
+    n = recv(s->sock, s->in + s->inlen, sizeof(s->in) - s->inlen, 0);
+    if (n <= 0) {
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK ||
+                         errno == EINTR) ? 0 : -1;
+    }
+    s->inlen += (size_t) n;
+    while (!s->dead && offs < s->inlen) {
+        if (ccnl_pkt_framelen(s->in + offs, s->inlen - offs, &framelen) ||
+                                            framelen > sizeof(s->in)) {
+            DEBUGMSG(WARNING, "no packet boundary in the stream from %s\n",
+                     ccnl_addr2ascii(&s->peer));
+            return -1;
+        }
+        if (!framelen || framelen > s->inlen - offs) {
+            break;
+        }
+        ccnl_core_RX(relay, s->ifndx, s->in + offs, framelen,
+                     &s->peer.sa, s->peerlen);
+        offs += framelen;
+    }
+    memmove(s->in, s->in + offs, s->inlen - offs);
+    s->inlen -= offs;
+    return 0;
+}
+
+// writes as much of the queue as the socket takes in one go
+static int
+ccnl_stream_write(struct ccnl_stream_s *s)
+{
+    struct iovec iov[CCNL_STREAM_OUTQ];
+    struct msghdr msg;
+    ssize_t n;
+    int i;
+
+    if (s->connecting) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+
+        if (getsockopt(s->sock, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err) {
+            DEBUGMSG(WARNING, "connecting to %s failed: %s\n",
+                     ccnl_addr2ascii(&s->peer), strerror(err));
+            return -1;
+        }
+        s->connecting = 0;
+    }
+    if (!s->outcnt) {
+        return 0;
+    }
+    for (i = 0; i < s->outcnt; i++) {
+        struct ccnl_buf_s *buf = s->out[(s->outfront + i) % CCNL_STREAM_OUTQ];
+        size_t skip = i ? 0 : s->outoffs;
+
+        iov[i].iov_base = buf->data + skip;
+        iov[i].iov_len = buf->datalen - skip;
+    }
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = (size_t) s->outcnt;
+    n = sendmsg(s->sock, &msg, MSG_NOSIGNAL);
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+    }
+    while (n > 0) {
+        struct ccnl_buf_s *buf = s->out[s->outfront];
+        size_t rest = buf->datalen - s->outoffs;
+
+        if ((size_t) n < rest) {
+            s->outoffs += (size_t) n;
+            break;
+        }
+        n -= (ssize_t) rest;
+        ccnl_free(buf);
+        s->outoffs = 0;
+        s->outfront = (s->outfront + 1) % CCNL_STREAM_OUTQ;
+        s->outcnt--;
+    }
+    return 0;
+}
+
+void
+ccnl_stream_process(struct ccnl_relay_s *relay, fd_set *readfs, fd_set *writefs)
+{
+    struct ccnl_stream_s *s;
+    int i;
+
+    ccnl_stream_reap();
+    for (i = 0; i < relay->ifcount; i++) {
+        if (relay->ifs[i].stream && relay->ifs[i].sock >= 0 &&
+                                    FD_ISSET(relay->ifs[i].sock, readfs)) {
+            ccnl_stream_accept(relay, i);
+        }
+    }
+    // connections accepted just now are read in the next round,
+    // the sets do not tell about them
+    for (s = streams; s; s = s->next) {
+        if (s->dead) {
+            continue;
+        }
+        if ((FD_ISSET(s->sock, writefs) && ccnl_stream_write(s)) ||
+            (!s->dead && FD_ISSET(s->sock, readfs) && ccnl_stream_read(relay, s))) {
+            ccnl_stream_drop(relay, s);
+        }
+    }
+    ccnl_stream_reap();
+}
+
+#endif // USE_STREAM
@@ -20,11 +20,14 @@
  * 2017-06-16 created
  */
 
+#define _GNU_SOURCE // sendmmsg()
+
 #include "ccnl-unix.h"
 
 #include "ccnl-os-includes.h"
 
 #include "ccnl-core.h"
+#include "ccnl-callbacks.h"
 #include "ccnl-producer.h"
 
 #include "ccnl-pkt-ccnb.h"
@@ -32,10 +35,29 @@
 #include "ccnl-pkt-ndntlv.h"
 #include "ccnl-pkt-switch.h"
 #include "ccnl-dispatch.h"
+#include "ccnl-segment.h"
+#include "ccnl-diskstore.h"
+#include "ccnl-ethring.h"
+#include "ccnl-uring.h"
+#include "ccnl-stream.h"
 #ifdef USE_HTTP_STATUS
 #include "ccnl-http-status.h"
 #endif
 
+#if defined(__linux__) && defined(USE_FRAG) && \
+    (defined(USE_IPV4) || defined(USE_IPV6))
+// UDP faces learn their path MTU from the errors queued on the socket
+# define CCNL_UNIX_PMTU
+# include <linux/errqueue.h>
+#endif
+
+#ifdef USE_FRAG
+# include <poll.h>
+// how often and how long (ms) a batch of fragments waits for a full socket
+# define CCNL_UNIX_TXWAITS      3
+# define CCNL_UNIX_TXWAIT       10
+#endif
+
 /**
  * TODO: The variables are never updated within the context of
  * ccnl_unix.c
@@ -153,6 +175,113 @@ ccnl_open_unixpath(char *path, struct sockaddr_un *ux)
 #endif // USE_UNIXSOCKET
 
 
+#ifdef CCNL_UNIX_PMTU
+// sets or clears the DF bit on the datagrams of a UDP socket
+static void
+ccnl_unix_pmtudisc(int sock, int af, int on)
+{
+    int val;
+
+#ifdef USE_IPV6
+    if (af == AF_INET6) {
+        val = on ? IPV6_PMTUDISC_DO : IPV6_PMTUDISC_DONT;
+        setsockopt(sock, IPPROTO_IPV6, IPV6_MTU_DISCOVER, &val, sizeof(val));
+        return;
+    }
+#endif
+    (void) af;
+    val = on ? IP_PMTUDISC_DO : IP_PMTUDISC_DONT;
+    setsockopt(sock, IPPROTO_IP, IP_MTU_DISCOVER, &val, sizeof(val));
+}
+
+// drains the error queue of an interface and hands the path MTUs reported
+// in it to the faces; dest is where the datagram just refused went, and
+// refused the packet if it was a whole one
+static int
+ccnl_unix_errqueue(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+                   sockunion *dest, struct ccnl_buf_s *refused)
+{
+    int rc = -1;
+
+    for (;;) {
+        uint8_t ctrl[256];
+        sockunion peer;
+        struct msghdr msg;
+        struct cmsghdr *cm;
+
+        memset(&msg, 0, sizeof(msg));
+        memset(&peer, 0, sizeof(peer));
+        msg.msg_name = &peer;
+        msg.msg_namelen = sizeof(peer);
+        msg.msg_control = ctrl;
+        msg.msg_controllen = sizeof(ctrl);
+        if (recvmsg(ifc->sock, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            break;
+        }
+        for (cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            struct sock_extended_err *ee;
+            struct ccnl_face_s *f;
+            uint32_t hdrlen; // the path MTU counts the IP and UDP headers
+
+            if (cm->cmsg_level == IPPROTO_IP && cm->cmsg_type == IP_RECVERR) {
+                hdrlen = 20 + 8;
+            }
+#ifdef USE_IPV6
+            else if (cm->cmsg_level == IPPROTO_IPV6 &&
+                     cm->cmsg_type == IPV6_RECVERR) {
+                hdrlen = 40 + 8;
+            }
+#endif
+            else {
+                continue;
+            }
+            ee = (struct sock_extended_err*) CMSG_DATA(cm);
+            if (ee->ee_errno != EMSGSIZE || ee->ee_info <= hdrlen) {
+                continue;
+            }
+            if (ee->ee_origin == SO_EE_ORIGIN_LOCAL && dest) {
+                // no port in the address of a locally refused datagram
+                memcpy(&peer, dest, sizeof(peer));
+            }
+            for (f = ccnl->faces; f; f = f->next) {
+                if (f->ifndx == ifc - ccnl->ifs &&
+                    !ccnl_addr_cmp(&f->peer, &peer)) {
+                    break;
+                }
+            }
+            if (!f) {
+                continue;
+            }
+            if (dest && refused && !ccnl_addr_cmp(dest, &peer)) {
+                rc = ccnl_face_setmtu(ccnl, f, (int) (ee->ee_info - hdrlen),
+                                      refused);
+                refused = NULL;
+            } else {
+                ccnl_face_setmtu(ccnl, f, (int) (ee->ee_info - hdrlen), NULL);
+            }
+        }
+    }
+    return rc;
+}
+
+// a datagram was too large for the path: fragment it if the face can, or
+// else let IP do it
+static ssize_t
+ccnl_unix_refused(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+                  sockunion *dest, socklen_t addrlen, struct ccnl_buf_s *buf)
+{
+    ssize_t rc;
+
+    if (!ccnl_unix_errqueue(ccnl, ifc, dest, buf)) {
+        return (ssize_t) buf->datalen;
+    }
+    ccnl_unix_pmtudisc(ifc->sock, dest->sa.sa_family, 0);
+    rc = sendto(ifc->sock, buf->data, buf->datalen, 0, &dest->sa, addrlen);
+    ccnl_unix_pmtudisc(ifc->sock, dest->sa.sa_family, 1);
+    return rc;
+}
+#endif // CCNL_UNIX_PMTU
+
 #ifdef USE_IPV4
 int
 ccnl_open_udpdev(uint16_t port, struct sockaddr_in *si)
@@ -181,6 +310,10 @@ ccnl_open_udpdev(uint16_t port, struct sockaddr_in *si)
         close(s);
         return -1;
     }
+#ifdef CCNL_UNIX_PMTU
+    ccnl_unix_pmtudisc(s, AF_INET, 1);
+    setsockopt(s, IPPROTO_IP, IP_RECVERR, &opt_value, sizeof(opt_value));
+#endif
 
     return s;
 }
@@ -209,6 +342,14 @@ ccnl_open_udp6dev(uint16_t port, struct sockaddr_in6 *sin)
     }
     len = sizeof(*sin);
     getsockname(s, (struct sockaddr*) sin, &len);
+#ifdef CCNL_UNIX_PMTU
+    {
+        int opt_value = 1;
+
+        ccnl_unix_pmtudisc(s, AF_INET6, 1);
+        setsockopt(s, IPPROTO_IPV6, IPV6_RECVERR, &opt_value, sizeof(opt_value));
+    }
+#endif
 
     return s;
 }
@@ -351,12 +492,32 @@ ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
 {
     ssize_t rc = -1;
     (void) ccnl;
+#ifdef USE_STREAM
+    if (ifc->stream) {
+        struct iovec iov = { buf->data, buf->datalen };
+
+        // written once the connection can take it, see ccnl_stream_process()
+        ccnl_stream_TX(ccnl, ifc, dest, &iov, 1);
+        return;
+    }
+#endif
+#ifdef USE_IO_URING
+    if (ccnl_uring_TX(ifc, dest, buf) == 0) {
+        // submitted with the other sends of this round, see ccnl_uring_loop()
+        return;
+    }
+#endif
     switch(dest->sa.sa_family) {
 #ifdef USE_IPV4
     case AF_INET:
         rc = sendto(ifc->sock,
                     buf->data, buf->datalen, 0,
                     (struct sockaddr*) &dest->ip4, sizeof(struct sockaddr_in));
+#ifdef CCNL_UNIX_PMTU
+        if (rc < 0 && errno == EMSGSIZE) {
+            rc = ccnl_unix_refused(ccnl, ifc, dest, sizeof(struct sockaddr_in), buf);
+        }
+#endif
         DEBUGMSG(DEBUG, "udp sendto %s/%d returned %zd\n",
                  inet_ntoa(dest->ip4.sin_addr), ntohs(dest->ip4.sin_port), rc);
         /*
@@ -374,6 +535,11 @@ ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
         rc = sendto(ifc->sock,
                     buf->data, buf->datalen, 0,
                     (struct sockaddr*) &dest->ip6, sizeof(struct sockaddr_in6));
+#ifdef CCNL_UNIX_PMTU
+        if (rc < 0 && errno == EMSGSIZE) {
+            rc = ccnl_unix_refused(ccnl, ifc, dest, sizeof(struct sockaddr_in6), buf);
+        }
+#endif
 	{
 #ifdef USE_LOGGING
 	    char abuf[INET6_ADDRSTRLEN];
@@ -388,6 +554,20 @@ ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
 #endif
 #ifdef USE_LINKLAYER
     case AF_PACKET:
+#ifdef USE_PACKET_MMAP
+        if (ifc->ring && ifc->ring->tx) {
+            // sent with the other frames of this round, see ccnl_io_loop()
+            struct iovec iov;
+
+            iov.iov_base = buf->data;
+            iov.iov_len = buf->datalen;
+            rc = ccnl_ethring_put(ifc->ring, dest->linklayer.sll_addr,
+                                  ifc->addr.linklayer.sll_addr, &iov, 1);
+            DEBUGMSG(DEBUG, "eth ring put %s returned %zd\n",
+                     ll2ascii(dest->linklayer.sll_addr, dest->linklayer.sll_halen), rc);
+            break;
+        }
+#endif
         rc = ccnl_eth_sendto(ifc->sock,
                              dest->linklayer.sll_addr,
                              ifc->addr.linklayer.sll_addr,
@@ -417,6 +597,153 @@ ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
     (void) rc; // just to silence a compiler warning (if USE_DEBUG is not set)
 }
 
+#ifdef USE_FRAG
+int
+ccnl_ll_TXv(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+            sockunion *dest, struct ccnl_frag_iov_s *frags, int cnt)
+{
+    struct iovec iov[2 * CCNL_FRAG_BATCH];
+    socklen_t addrlen;
+    int i, sent = 0;
+
+#ifdef USE_STREAM
+    if (ifc->stream) {
+        for (i = 0; i < cnt; i++) {
+            iov[0].iov_base = frags[i].hdr;
+            iov[0].iov_len = frags[i].hdrlen;
+            iov[1].iov_base = frags[i].data;
+            iov[1].iov_len = frags[i].datalen;
+            if (ccnl_stream_TX(ccnl, ifc, dest, iov, 2)) {
+                break;
+            }
+        }
+        return i;
+    }
+#endif
+    switch(dest->sa.sa_family) {
+#ifdef USE_IPV4
+    case AF_INET:
+        addrlen = sizeof(struct sockaddr_in);
+        break;
+#endif
+#ifdef USE_IPV6
+    case AF_INET6:
+        addrlen = sizeof(struct sockaddr_in6);
+        break;
+#endif
+#ifdef USE_UNIXSOCKET
+    case AF_UNIX:
+        addrlen = sizeof(struct sockaddr_un);
+        break;
+#endif
+    default:
+#ifdef USE_PACKET_MMAP
+        if (dest->sa.sa_family == AF_PACKET && ifc->ring && ifc->ring->tx) {
+            // gathered into the slots of the TX ring
+            for (i = 0; i < cnt; i++) {
+                iov[0].iov_base = frags[i].hdr;
+                iov[0].iov_len = frags[i].hdrlen;
+                iov[1].iov_base = frags[i].data;
+                iov[1].iov_len = frags[i].datalen;
+                if (ccnl_ethring_put(ifc->ring, dest->linklayer.sll_addr,
+                                     ifc->addr.linklayer.sll_addr, iov, 2)) {
+                    break;
+                }
+            }
+            return i;
+        }
+#endif
+        // no gathering for this transport: one buffer per fragment
+        for (i = 0; i < cnt; i++) {
+            struct ccnl_buf_s *buf;
+
+            buf = ccnl_buf_new(NULL, frags[i].hdrlen + frags[i].datalen);
+            if (!buf) {
+                break;
+            }
+            memcpy(buf->data, frags[i].hdr, frags[i].hdrlen);
+            memcpy(buf->data + frags[i].hdrlen, frags[i].data, frags[i].datalen);
+            ccnl_ll_TX(ccnl, ifc, dest, buf);
+            ccnl_free(buf);
+        }
+        return i;
+    }
+
+    if (cnt > CCNL_FRAG_BATCH) {
+        cnt = CCNL_FRAG_BATCH;
+    }
+    for (i = 0; i < cnt; i++) {
+        iov[2*i].iov_base = frags[i].hdr;
+        iov[2*i].iov_len = frags[i].hdrlen;
+        iov[2*i+1].iov_base = frags[i].data;
+        iov[2*i+1].iov_len = frags[i].datalen;
+    }
+#ifdef __linux__
+    {
+        struct mmsghdr msg[CCNL_FRAG_BATCH];
+        int rc, waits = 0;
+
+        memset(msg, 0, sizeof(msg));
+        for (i = 0; i < cnt; i++) {
+            msg[i].msg_hdr.msg_name = &dest->sa;
+            msg[i].msg_hdr.msg_namelen = addrlen;
+            msg[i].msg_hdr.msg_iov = iov + 2*i;
+            msg[i].msg_hdr.msg_iovlen = 2;
+        }
+        while (sent < cnt) {
+            rc = sendmmsg(ifc->sock, msg + sent, cnt - sent, 0);
+            if (rc > 0) {
+                sent += rc;
+                continue;
+            }
+            if (rc < 0 && errno == EINTR) {
+                continue;
+            }
+            if (rc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) &&
+                waits++ < CCNL_UNIX_TXWAITS) {
+                // the send buffer is full, the rest goes once it drains
+                struct pollfd pfd = { ifc->sock, POLLOUT, 0 };
+
+                poll(&pfd, 1, CCNL_UNIX_TXWAIT);
+                continue;
+            }
+            break;
+        }
+#ifdef CCNL_UNIX_PMTU
+        if (sent < cnt && errno == EMSGSIZE && dest->sa.sa_family != AF_UNIX) {
+            // the fragments of this packet are not split again: the next
+            // packets are cut to the path MTU, these are left to IP
+            ccnl_unix_errqueue(ccnl, ifc, dest, NULL);
+            ccnl_unix_pmtudisc(ifc->sock, dest->sa.sa_family, 0);
+            while (sent < cnt && sendmsg(ifc->sock, &msg[sent].msg_hdr, 0) >= 0) {
+                sent++;
+            }
+            ccnl_unix_pmtudisc(ifc->sock, dest->sa.sa_family, 1);
+        }
+#endif
+    }
+#else
+    for (; sent < cnt; sent++) {
+        struct msghdr msg;
+        ssize_t rc;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &dest->sa;
+        msg.msg_namelen = addrlen;
+        msg.msg_iov = iov + 2*sent;
+        msg.msg_iovlen = 2;
+        while ((rc = sendmsg(ifc->sock, &msg, 0)) < 0 && errno == EINTR);
+        if (rc < 0) {
+            break;
+        }
+    }
+#endif
+    DEBUGMSG(DEBUG, "sent %d of %d fragments to %s\n",
+             sent, cnt, ccnl_addr2ascii(dest));
+    return sent;
+}
+#endif // USE_FRAG
+
 void
 ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
                   int32_t udpport1, int32_t udpport2,
@@ -435,6 +762,7 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
     DEBUGMSG(INFO, "configuring relay\n");
 
     relay->contents = NULL;
+    relay->contentsend = NULL;
     relay->pit = NULL;
     relay->fib = NULL;
     relay->faces = NULL;
@@ -442,6 +770,13 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
     relay->max_cache_entries = max_cache_entries;
     relay->max_pit_entries = CCNL_DEFAULT_MAX_PIT_ENTRIES;
     relay->ccnl_ll_TX_ptr = &ccnl_ll_TX;
+#ifdef USE_FRAG
+    relay->ccnl_ll_TXv_ptr = &ccnl_ll_TXv;
+#endif
+#ifdef USE_STREAM
+    relay->ccnl_stream_connect_ptr = &ccnl_stream_connect;
+    relay->ccnl_stream_close_ptr = &ccnl_stream_close;
+#endif
 
 #ifdef USE_SCHEDULER
     relay->defaultFaceScheduler = ccnl_relay_defaultFaceScheduler;
@@ -459,6 +794,9 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
             relay->ifcount++;
             DEBUGMSG(INFO, "ETH interface (%s %s) configured\n",
                      ethdev, ccnl_addr2ascii(&i->addr));
+#ifdef USE_PACKET_MMAP
+            i->ring = ccnl_ethring_open(i->sock);
+#endif
             if (relay->defaultInterfaceScheduler)
                 i->sched = relay->defaultInterfaceScheduler(relay,
                                                         ccnl_interface_CTS);
@@ -559,11 +897,82 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
     ccnl_set_timer(1000000, ccnl_ageing, relay, 0);
 }
 
+void
+ccnl_unix_RX(struct ccnl_relay_s *ccnl, int ifndx, uint8_t *buf, size_t len,
+             sockunion *src)
+{
+    if (0) {}
+#ifdef USE_IPV4
+    else if (src->sa.sa_family == AF_INET) {
+        ccnl_core_RX(ccnl, ifndx, buf, len,
+                     &src->sa, sizeof(src->ip4));
+    }
+#endif
+#ifdef USE_IPV6
+    else if (src->sa.sa_family == AF_INET6) {
+        ccnl_core_RX(ccnl, ifndx, buf, len,
+                     &src->sa, sizeof(src->ip6));
+    }
+#endif
+#ifdef USE_LINKLAYER
+    else if (src->sa.sa_family == AF_PACKET) {
+        if (len > 14) {
+            ccnl_core_RX(ccnl, ifndx, buf + 14, len - 14,
+                         &src->sa, sizeof(src->linklayer));
+        }
+    }
+#endif
+#ifdef USE_WPAN
+    else if (src->sa.sa_family == AF_IEEE802154) {
+        if (len > 14) {
+            ccnl_core_RX(ccnl, ifndx, buf, len,
+                         &src->sa, sizeof(src->linklayer));
+        }
+    }
+#endif
+#ifdef USE_UNIXSOCKET
+    else if (src->sa.sa_family == AF_UNIX) {
+        ccnl_core_RX(ccnl, ifndx, buf, len,
+                     &src->sa, sizeof(src->ux));
+    }
+#endif
+}
+
+void
+ccnl_unix_RXerror(struct ccnl_relay_s *ccnl, int ifndx)
+{
+#ifdef CCNL_UNIX_PMTU
+    // an ICMP error was queued, possibly a path MTU
+    ccnl_unix_errqueue(ccnl, ccnl->ifs + ifndx, NULL, NULL);
+#else
+    (void) ccnl;
+    (void) ifndx;
+#endif
+}
+
+void
+ccnl_unix_TXerror(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+                  sockunion *dest, struct ccnl_buf_s *buf, int err)
+{
+    DEBUGMSG(DEBUG, "sending %zu bytes to %s failed: %s\n", buf->datalen,
+             ccnl_addr2ascii(dest), strerror(err));
+#ifdef CCNL_UNIX_PMTU
+    if (err == EMSGSIZE && (dest->sa.sa_family == AF_INET ||
+                            dest->sa.sa_family == AF_INET6)) {
+        ccnl_unix_refused(ccnl, ifc, dest, dest->sa.sa_family == AF_INET ?
+                          sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6),
+                          buf);
+    }
+#else
+    (void) ccnl;
+    (void) ifc;
+#endif
+}
+
 int
 ccnl_io_loop(struct ccnl_relay_s *ccnl)
 {
-    int i, maxfd = -1, rc;
-    size_t len;
+    int i, burst, maxfd = -1, rc;
     fd_set readfs, writefs;
     unsigned char buf[CCNL_MAX_PACKET_SIZE];
 
@@ -589,13 +998,33 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
         ccnl_http_anteselect(ccnl, ccnl->http, &readfs, &writefs, &maxfd);
 #endif
         for (i = 0; i < ccnl->ifcount; i++) {
+            if (ccnl->ifs[i].stream) {
+                continue;
+            }
             FD_SET(ccnl->ifs[i].sock, &readfs);
             if (ccnl->ifs[i].qlen > 0) {
                 FD_SET(ccnl->ifs[i].sock, &writefs);
             }
         }
+        if (ccnl_diskstore_fd() >= 0) {
+            FD_SET(ccnl_diskstore_fd(), &readfs);
+            if (ccnl_diskstore_fd() >= maxfd) {
+                maxfd = ccnl_diskstore_fd() + 1;
+            }
+        }
+#ifdef USE_STREAM
+        ccnl_stream_fdset(ccnl, &readfs, &writefs, &maxfd);
+#endif
 
         usec = ccnl_run_events();
+#ifdef USE_PACKET_MMAP
+        // one kick per ring for all frames put since the last select()
+        for (i = 0; i < ccnl->ifcount; i++) {
+            if (ccnl->ifs[i].ring && ccnl->ifs[i].ring->tx) {
+                ccnl_ethring_flush(ccnl->ifs[i].ring);
+            }
+        }
+#endif
         if (usec >= 0) {
             struct timeval deadline;
             deadline.tv_sec = usec / 1000000;
@@ -605,6 +1034,9 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
             rc = select(maxfd, &readfs, &writefs, NULL, NULL);
         }
 
+        if (rc < 0 && errno == EINTR) {
+            continue;   // interrupted by a signal, e.g. SIGTERM
+        }
         if (rc < 0) {
             perror("select(): ");
             exit(EXIT_FAILURE);
@@ -612,57 +1044,52 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
 
 #ifdef USE_HTTP_STATUS
         ccnl_http_postselect(ccnl, ccnl->http, &readfs, &writefs);
+#endif
+        if (ccnl_diskstore_fd() >= 0 && FD_ISSET(ccnl_diskstore_fd(), &readfs)) {
+            ccnl_diskstore_complete(ccnl);
+        }
+#ifdef USE_STREAM
+        ccnl_stream_process(ccnl, &readfs, &writefs);
 #endif
         for (i = 0; i < ccnl->ifcount; i++) {
-            if (FD_ISSET(ccnl->ifs[i].sock, &readfs)) {
+#ifdef USE_STREAM
+            if (ccnl->ifs[i].stream) {
+                // queued with the connections, nothing to wait for
+                while (ccnl->ifs[i].qlen > 0) {
+                    ccnl_interface_CTS(ccnl, ccnl->ifs + i);
+                }
+                continue;
+            }
+#endif
+#ifdef USE_PACKET_MMAP
+            if (ccnl->ifs[i].ring) {
+                if (FD_ISSET(ccnl->ifs[i].sock, &readfs)) {
+                    ccnl_ethring_RX(ccnl, i);
+                }
+            } else
+#endif
+            // drain a burst, batching stages flush in the rx burst end callback
+            for (burst = 0; burst < CCNL_RX_BURST &&
+                            FD_ISSET(ccnl->ifs[i].sock, &readfs); burst++) {
                 sockunion src_addr;
                 socklen_t addrlen = sizeof(sockunion);
                 ssize_t recvlen;
-                if ((recvlen = recvfrom(ccnl->ifs[i].sock, buf, sizeof(buf), 0,
-                                (struct sockaddr*) &src_addr, &addrlen)) > 0) {
-                    len = (size_t) recvlen;
-                    if (0) {}
-#ifdef USE_IPV4
-                    else if (src_addr.sa.sa_family == AF_INET) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ip4));
-                    }
-#endif
-#ifdef USE_IPV6
-                    else if (src_addr.sa.sa_family == AF_INET6) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ip6));
+                if ((recvlen = recvfrom(ccnl->ifs[i].sock, buf, sizeof(buf),
+                                        burst ? MSG_DONTWAIT : 0,
+                                        (struct sockaddr*) &src_addr, &addrlen)) <= 0) {
+                    if (recvlen < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                        ccnl_unix_RXerror(ccnl, i);
                     }
-#endif
-#ifdef USE_LINKLAYER
-                    else if (src_addr.sa.sa_family == AF_PACKET) {
-                        if (len > 14) {
-                            ccnl_core_RX(ccnl, i, buf + 14, len - 14,
-                                         &src_addr.sa, sizeof(src_addr.linklayer));
-                        }
-                    }
-#endif
-#ifdef USE_WPAN
-                    else if (src_addr.sa.sa_family == AF_IEEE802154) {
-                        if (len > 14) {
-                            ccnl_core_RX(ccnl, i, buf, len,
-                                         &src_addr.sa, sizeof(src_addr.linklayer));
-                        }
-                    }
-#endif
-#ifdef USE_UNIXSOCKET
-                    else if (src_addr.sa.sa_family == AF_UNIX) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ux));
-                    }
-#endif
+                    break;
                 }
+                ccnl_unix_RX(ccnl, i, buf, (size_t) recvlen, &src_addr);
             }
 
             if (FD_ISSET(ccnl->ifs[i].sock, &writefs)) {
               ccnl_interface_CTS(ccnl, ccnl->ifs + i);
             }
         }
+        ccnl_callback_rx_burst_end(ccnl);
     }
 
     return 0;
@@ -673,6 +1100,12 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
 {
     DIR *dir;
     struct dirent *de;
+    struct stat s;
+
+    if (!stat(path, &s) && S_ISREG(s.st_mode)) {
+        ccnl_segment_attach(ccnl, path);
+        return;
+    }
 
     dir = opendir(path);
     if (!dir) {
@@ -684,18 +1117,11 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
 
     while ((de = readdir(dir))) {
         char fname[1000];
-        struct stat s;
         struct ccnl_buf_s *buf = 0; // , *nonce=0, *ppkd=0, *pkt = 0;
         struct ccnl_content_s *c = 0;
-        int fd, suite;
+        int fd;
         ssize_t recvlen;
-        size_t datalen, skip, flen;
-        uint8_t *data;
-        (void) data; // silence compiler warning (if any USE_SUITE_* is not set)
-#if defined(USE_SUITE_NDNTLV)
-        uint64_t typ;
-        size_t len;
-#endif
+        size_t datalen, flen;
         struct ccnl_pkt_s *pk;
 
         if (de->d_name[0] == '.') {
@@ -740,65 +1166,10 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
             continue;
         }
         buf->datalen = datalen;
-        suite = ccnl_pkt2suite(buf->data, datalen, &skip);
 
-        pk = NULL;
-        switch (suite) {
-#ifdef USE_SUITE_CCNB
-        case CCNL_SUITE_CCNB: {
-            uint8_t *start;
-
-            data = start = buf->data + skip;
-            datalen -= skip;
-
-            if (data[0] != 0x04 || data[1] != 0x82) {
-                goto notacontent;
-            }
-            data += 2;
-            datalen -= 2;
-
-            pk = ccnl_ccnb_bytes2pkt(start, &data, &datalen);
-            break;
-        }
-#endif
-#ifdef USE_SUITE_CCNTLV
-        case CCNL_SUITE_CCNTLV: {
-            size_t hdrlen;
-            uint8_t *start;
-
-            data = start = buf->data + skip;
-            datalen -=  skip;
-
-            if (ccnl_ccntlv_getHdrLen(data, datalen, &hdrlen)) {
-                goto notacontent;
-            }
-            data += hdrlen;
-            datalen -= hdrlen;
-
-            pk = ccnl_ccntlv_bytes2pkt(start, &data, &datalen);
-            break;
-        }
-#endif
-#ifdef USE_SUITE_NDNTLV
-        case CCNL_SUITE_NDNTLV: {
-            uint8_t *olddata;
-
-            data = olddata = buf->data + skip;
-            datalen -= skip;
-            if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len) ||
-                                                         typ != NDN_TLV_Data) {
-                goto notacontent;
-            }
-            pk = ccnl_ndntlv_bytes2pkt(typ, olddata, &data, &datalen);
-            break;
-        }
-#endif
-        default:
-            DEBUGMSG(WARNING, "unknown packet format (%s)\n", de->d_name);
-            goto Done;
-        }
+        pk = ccnl_bytes2content(buf->data, datalen);
         if (!pk) {
-            DEBUGMSG(DEBUG, "  parsing error in %s\n", de->d_name);
+            DEBUGMSG(WARNING, "not a content object (%s)\n", de->d_name);
             goto Done;
         }
         c = ccnl_content_new(&pk);
@@ -807,16 +1178,10 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
             goto Done;
         }
         ccnl_content_add2cache(ccnl, c);
-        c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+        ccnl_content_set_static(ccnl, c);
 Done:
         ccnl_pkt_free(pk);
         ccnl_free(buf);
-        continue;
-#if defined(USE_SUITE_CCNB) || defined(USE_SUITE_NDNTLV)
-notacontent:
-        DEBUGMSG(WARNING, "not a content object (%s)\n", de->d_name);
-        ccnl_free(buf);
-#endif
     }
 
     closedir(dir);
@@ -0,0 +1,687 @@
+/*
+ * @f ccnl-uring.c
+ * @b CCN lite, io_uring event and IO loop for the relay
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "ccnl-uring.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include "ccnl-os-includes.h"
+#include "ccnl-core.h"
+#include "ccnl-callbacks.h"
+#include "ccnl-unix.h"
+#include "ccnl-diskstore.h"
+#include "ccnl-ethring.h"
+#include "ccnl-http-status.h"
+#include "ccnl-stream.h"
+
+#ifdef USE_IO_URING
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+// what a completion belongs to, in the top byte of its user_data
+#define CCNL_URING_RECV         1ULL
+#define CCNL_URING_SEND         2ULL
+#define CCNL_URING_POLL         3ULL
+#define CCNL_URING_CANCEL       4ULL
+#define CCNL_URING_UDATA(kind, ndx)     (((kind) << 56) | (uint64_t) (ndx))
+#define CCNL_URING_KIND(udata)          ((udata) >> 56)
+#define CCNL_URING_NDX(udata)           ((udata) & ((1ULL << 56) - 1))
+// a poll is told apart from the polls its slot had before by a sequence number
+#define CCNL_URING_POLLUDATA(slot, seq) \
+        CCNL_URING_UDATA(CCNL_URING_POLL, ((uint64_t) (seq) << 16) | (slot))
+
+#define CCNL_URING_BGID         0       // buffer group of the receive pool
+
+struct ccnl_uring_send_s {
+    struct ccnl_buf_s *buf;             // NULL if the slot is free
+    struct ccnl_if_s *ifc;
+    sockunion dest;
+    struct iovec iov;
+    struct msghdr msg;
+};
+
+struct ccnl_uring_poll_s {
+    int fd;                             // -1 if the slot is free
+    short events;
+    uint32_t seq;
+};
+
+struct ccnl_uring_s {
+    int fd;
+    struct ccnl_relay_s *relay;
+    unsigned int inflight;              // requests still to complete
+
+    void *sqmap, *cqmap;
+    size_t sqlen, cqlen;
+    unsigned int *sqhead, *sqktail, sqmask, sqentries, sqtail;
+    struct io_uring_sqe *sqes;
+    unsigned int *cqhead, *cqtail, cqmask;
+    struct io_uring_cqe *cqes;
+
+    // the receive pool and the ring it is handed to the kernel through
+    struct io_uring_buf_ring *br;
+    uint16_t brtail;
+    uint8_t *bufs;
+    size_t bufsize;
+    struct msghdr rxmsg[CCNL_MAX_INTERFACES];
+    char rxarmed[CCNL_MAX_INTERFACES];
+    char failed;
+
+    struct ccnl_uring_send_s sends[CCNL_URING_SENDS];
+    int sendfree[CCNL_URING_SENDS], nsendfree;
+
+    struct ccnl_uring_poll_s polls[CCNL_URING_POLLS];
+    char pollfired;
+    fd_set rready, wready;              // what the polls of this round found
+};
+
+static struct ccnl_uring_s *theUring;   // while ccnl_uring_loop() runs
+
+static int
+ccnl_uring_enter(struct ccnl_uring_s *u, unsigned int wait,
+                 struct __kernel_timespec *ts)
+{
+    struct io_uring_getevents_arg arg;
+    unsigned int flags = IORING_ENTER_EXT_ARG;
+
+    __atomic_store_n(u->sqktail, u->sqtail, __ATOMIC_RELEASE);
+    memset(&arg, 0, sizeof(arg));
+    arg.ts = (uint64_t) (uintptr_t) ts;
+    if (wait) {
+        flags |= IORING_ENTER_GETEVENTS;
+    }
+    return (int) syscall(__NR_io_uring_enter, u->fd,
+                         u->sqtail - __atomic_load_n(u->sqhead, __ATOMIC_ACQUIRE),
+                         wait, flags, &arg, sizeof(arg));
+}
+
+static struct io_uring_sqe*
+ccnl_uring_sqe(struct ccnl_uring_s *u)
+{
+    struct io_uring_sqe *sqe;
+
+    if (u->sqtail - __atomic_load_n(u->sqhead, __ATOMIC_ACQUIRE) >= u->sqentries) {
+        ccnl_uring_enter(u, 0, NULL);
+        if (u->sqtail - __atomic_load_n(u->sqhead, __ATOMIC_ACQUIRE) >=
+                                                                u->sqentries) {
+            DEBUGMSG(WARNING, "io_uring submission queue full\n");
+            return NULL;
+        }
+    }
+    sqe = u->sqes + (u->sqtail & u->sqmask);
+    memset(sqe, 0, sizeof(*sqe));
+    u->sqtail++;
+    u->inflight++;
+    return sqe;
+}
+
+static void
+ccnl_uring_putbuf(struct ccnl_uring_s *u, unsigned int bid)
+{
+    struct io_uring_buf *b = u->br->bufs + (u->brtail & (CCNL_URING_BUFS - 1));
+
+    b->addr = (uint64_t) (uintptr_t) (u->bufs + bid * u->bufsize);
+    b->len = (uint32_t) u->bufsize;
+    b->bid = (uint16_t) bid;
+    u->brtail++;
+}
+
+static void
+ccnl_uring_recv(struct ccnl_uring_s *u, int ifndx)
+{
+    struct io_uring_sqe *sqe = ccnl_uring_sqe(u);
+
+    if (!sqe) {
+        return;
+    }
+    // the kernel puts the source address in front of each datagram
+    memset(u->rxmsg + ifndx, 0, sizeof(struct msghdr));
+    u->rxmsg[ifndx].msg_namelen = sizeof(sockunion);
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = u->relay->ifs[ifndx].sock;
+    sqe->addr = (uint64_t) (uintptr_t) (u->rxmsg + ifndx);
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = CCNL_URING_BGID;
+    sqe->user_data = CCNL_URING_UDATA(CCNL_URING_RECV, ifndx);
+    u->rxarmed[ifndx] = 1;
+}
+
+static void
+ccnl_uring_recvd(struct ccnl_uring_s *u, int ifndx, struct io_uring_cqe *cqe)
+{
+    if (cqe->flags & IORING_CQE_F_BUFFER) {
+        unsigned int bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        uint8_t *b = u->bufs + bid * u->bufsize;
+        struct io_uring_recvmsg_out *o = (struct io_uring_recvmsg_out*) b;
+        sockunion *src = (sockunion*) (b + sizeof(*o));
+
+        if (cqe->res > 0 && !u->failed && !u->relay->halt_flag) {
+            if (o->flags & MSG_TRUNC) {
+                DEBUGMSG(WARNING, "datagram of %u bytes truncated, dropped\n",
+                         o->payloadlen);
+            } else {
+                if (o->namelen < sizeof(sockunion)) {
+                    memset((uint8_t*) src + o->namelen, 0,
+                           sizeof(sockunion) - o->namelen);
+                }
+                ccnl_unix_RX(u->relay, ifndx, (uint8_t*) (src + 1),
+                             o->payloadlen, src);
+            }
+        }
+        ccnl_uring_putbuf(u, bid);
+    }
+    if (cqe->flags & IORING_CQE_F_MORE) {
+        return;
+    }
+    // rearmed in the next round
+    u->rxarmed[ifndx] = 0;
+    if (cqe->res == -EINVAL) {
+        DEBUGMSG(WARNING, "no multishot recvmsg (Linux 6.0) on interface %d\n",
+                 ifndx);
+        u->failed = 1;
+    } else if (cqe->res < 0 && cqe->res != -ENOBUFS && cqe->res != -ECANCELED) {
+        errno = -cqe->res;
+        ccnl_unix_RXerror(u->relay, ifndx);
+    }
+}
+
+static void
+ccnl_uring_sent(struct ccnl_uring_s *u, int slot, struct io_uring_cqe *cqe)
+{
+    struct ccnl_uring_send_s *s = u->sends + slot;
+
+    if (cqe->res < 0 && !u->relay->halt_flag) {
+        ccnl_unix_TXerror(u->relay, s->ifc, &s->dest, s->buf, -cqe->res);
+    }
+    ccnl_free(s->buf);
+    s->buf = NULL;
+    u->sendfree[u->nsendfree++] = slot;
+}
+
+static void
+ccnl_uring_polled(struct ccnl_uring_s *u, uint64_t ndx, struct io_uring_cqe *cqe)
+{
+    struct ccnl_uring_poll_s *p = u->polls + (ndx & 0xffff);
+
+    if (p->fd < 0 || p->seq != (uint32_t) (ndx >> 16)) {
+        return;         // cancelled
+    }
+    if (cqe->res > 0) {
+        if ((p->events & POLLIN) && (cqe->res & (POLLIN | POLLHUP | POLLERR))) {
+            FD_SET(p->fd, &u->rready);
+        }
+        if ((p->events & POLLOUT) && (cqe->res & (POLLOUT | POLLHUP | POLLERR))) {
+            FD_SET(p->fd, &u->wready);
+        }
+    }
+    p->fd = -1;
+    p->seq++;
+    u->pollfired = 1;
+}
+
+static void
+ccnl_uring_reap(struct ccnl_uring_s *u)
+{
+    unsigned int head = *u->cqhead;
+    unsigned int tail = __atomic_load_n(u->cqtail, __ATOMIC_ACQUIRE);
+
+    while (head != tail) {
+        struct io_uring_cqe cqe = u->cqes[head & u->cqmask];
+
+        // free the entry before the handlers submit more
+        __atomic_store_n(u->cqhead, ++head, __ATOMIC_RELEASE);
+        if (!(cqe.flags & IORING_CQE_F_MORE)) {
+            u->inflight--;
+        }
+        switch (CCNL_URING_KIND(cqe.user_data)) {
+        case CCNL_URING_RECV:
+            ccnl_uring_recvd(u, (int) CCNL_URING_NDX(cqe.user_data), &cqe);
+            break;
+        case CCNL_URING_SEND:
+            ccnl_uring_sent(u, (int) CCNL_URING_NDX(cqe.user_data), &cqe);
+            break;
+        case CCNL_URING_POLL:
+            ccnl_uring_polled(u, CCNL_URING_NDX(cqe.user_data), &cqe);
+            break;
+        default:
+            break;
+        }
+        if (head == tail) {
+            tail = __atomic_load_n(u->cqtail, __ATOMIC_ACQUIRE);
+        }
+    }
+    // the buffers given back go to the kernel in one go
+    __atomic_store_n(&u->br->tail, u->brtail, __ATOMIC_RELEASE);
+}
+
+static short
+ccnl_uring_events(int fd, fd_set *readfs, fd_set *writefs)
+{
+    return (short) ((FD_ISSET(fd, readfs) ? POLLIN : 0) |
+                    (FD_ISSET(fd, writefs) ? POLLOUT : 0));
+}
+
+static void
+ccnl_uring_polls(struct ccnl_uring_s *u, fd_set *readfs, fd_set *writefs,
+                 int maxfd)
+{
+    struct io_uring_sqe *sqe;
+    int i, fd;
+
+    // after a poll fired, the HTTP server may have closed and opened sockets:
+    // a descriptor still polled can now stand for another file
+    for (i = 0; i < CCNL_URING_POLLS; i++) {
+        struct ccnl_uring_poll_s *p = u->polls + i;
+
+        if (p->fd < 0 || (!u->pollfired &&
+                          p->events == ccnl_uring_events(p->fd, readfs, writefs))) {
+            continue;
+        }
+        if (!(sqe = ccnl_uring_sqe(u))) {
+            continue;
+        }
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = CCNL_URING_POLLUDATA(i, p->seq);
+        sqe->user_data = CCNL_URING_UDATA(CCNL_URING_CANCEL, 0);
+        p->fd = -1;
+        p->seq++;
+    }
+    u->pollfired = 0;
+
+    for (fd = 0; fd < maxfd && fd < FD_SETSIZE; fd++) {
+        short events = ccnl_uring_events(fd, readfs, writefs);
+        int slot = -1;
+
+        if (!events) {
+            continue;
+        }
+        for (i = 0; i < CCNL_URING_POLLS && u->polls[i].fd != fd; i++) {
+            if (slot < 0 && u->polls[i].fd < 0) {
+                slot = i;
+            }
+        }
+        if (i < CCNL_URING_POLLS) {
+            continue;   // still armed
+        }
+        if (slot < 0) {
+            DEBUGMSG(WARNING, "too many descriptors to poll, fd %d left out\n", fd);
+            break;
+        }
+        if (!(sqe = ccnl_uring_sqe(u))) {
+            break;
+        }
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = fd;
+        sqe->poll32_events = (uint32_t) events;
+        sqe->user_data = CCNL_URING_POLLUDATA(slot, u->polls[slot].seq);
+        u->polls[slot].fd = fd;
+        u->polls[slot].events = events;
+    }
+}
+
+static void
+ccnl_uring_close(struct ccnl_uring_s *u)
+{
+    struct io_uring_sqe *sqe;
+    int i;
+
+    if (u->inflight && (sqe = ccnl_uring_sqe(u))) {
+        struct __kernel_timespec ts = { 0, 100 * 1000 * 1000 };
+
+        // the kernel has to let go of the buffers and messages first
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+        sqe->user_data = CCNL_URING_UDATA(CCNL_URING_CANCEL, 0);
+        for (i = 0; i < 10 && u->inflight; i++) {
+            ccnl_uring_enter(u, 1, &ts);
+            ccnl_uring_reap(u);
+        }
+    }
+    close(u->fd);
+    for (i = 0; i < CCNL_URING_SENDS; i++) {
+        if (u->sends[i].buf) {
+            ccnl_free(u->sends[i].buf);
+        }
+    }
+    if (u->br) {
+        munmap(u->br, CCNL_URING_BUFS * sizeof(struct io_uring_buf));
+    }
+    if (u->sqes) {
+        munmap(u->sqes, u->sqentries * sizeof(struct io_uring_sqe));
+    }
+    if (u->cqmap && u->cqmap != u->sqmap) {
+        munmap(u->cqmap, u->cqlen);
+    }
+    if (u->sqmap) {
+        munmap(u->sqmap, u->sqlen);
+    }
+    if (u->bufs) {
+        ccnl_free(u->bufs);
+    }
+    ccnl_free(u);
+}
+
+static void*
+ccnl_uring_map(struct ccnl_uring_s *u, size_t len, off_t offset)
+{
+    void *map = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, u->fd, offset);
+
+    return map == MAP_FAILED ? NULL : map;
+}
+
+static struct ccnl_uring_s*
+ccnl_uring_open(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_uring_s *u;
+    struct io_uring_params p;
+    struct io_uring_buf_reg reg;
+    uint8_t *sq, *cq;
+    unsigned int i;
+
+    u = (struct ccnl_uring_s*) ccnl_calloc(1, sizeof(*u));
+    if (!u) {
+        return NULL;
+    }
+    u->relay = ccnl;
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = 4 * CCNL_URING_ENTRIES;
+    u->fd = (int) syscall(__NR_io_uring_setup, CCNL_URING_ENTRIES, &p);
+    if (u->fd < 0) {
+        DEBUGMSG(WARNING, "io_uring_setup failed: %s\n", strerror(errno));
+        ccnl_free(u);
+        return NULL;
+    }
+    if (!(p.features & IORING_FEAT_EXT_ARG)) {
+        DEBUGMSG(WARNING, "io_uring without timed waits (Linux 5.11)\n");
+        goto failed;
+    }
+
+    u->sqlen = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+    u->cqlen = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (u->cqlen > u->sqlen) {
+            u->sqlen = u->cqlen;
+        }
+        u->sqmap = u->cqmap = ccnl_uring_map(u, u->sqlen, IORING_OFF_SQ_RING);
+    } else {
+        u->sqmap = ccnl_uring_map(u, u->sqlen, IORING_OFF_SQ_RING);
+        u->cqmap = ccnl_uring_map(u, u->cqlen, IORING_OFF_CQ_RING);
+    }
+    u->sqentries = p.sq_entries;
+    u->sqes = ccnl_uring_map(u, p.sq_entries * sizeof(struct io_uring_sqe),
+                             IORING_OFF_SQES);
+    if (!u->sqmap || !u->cqmap || !u->sqes) {
+        DEBUGMSG(WARNING, "mapping the io_uring failed: %s\n", strerror(errno));
+        goto failed;
+    }
+    sq = u->sqmap;
+    cq = u->cqmap;
+    u->sqhead = (unsigned int*) (sq + p.sq_off.head);
+    u->sqktail = (unsigned int*) (sq + p.sq_off.tail);
+    u->sqmask = *(unsigned int*) (sq + p.sq_off.ring_mask);
+    u->sqtail = *u->sqktail;
+    for (i = 0; i < p.sq_entries; i++) {
+        ((unsigned int*) (sq + p.sq_off.array))[i] = i;
+    }
+    u->cqhead = (unsigned int*) (cq + p.cq_off.head);
+    u->cqtail = (unsigned int*) (cq + p.cq_off.tail);
+    u->cqmask = *(unsigned int*) (cq + p.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe*) (cq + p.cq_off.cqes);
+
+    // each buffer takes the recvmsg header, the address and the datagram
+    u->bufsize = (sizeof(struct io_uring_recvmsg_out) + sizeof(sockunion) +
+                  CCNL_MAX_PACKET_SIZE + 63) & ~(size_t) 63;
+    u->bufs = (uint8_t*) ccnl_malloc(CCNL_URING_BUFS * u->bufsize);
+    u->br = mmap(NULL, CCNL_URING_BUFS * sizeof(struct io_uring_buf),
+                 PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (u->br == MAP_FAILED) {
+        u->br = NULL;
+    }
+    if (!u->bufs || !u->br) {
+        goto failed;
+    }
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t) (uintptr_t) u->br;
+    reg.ring_entries = CCNL_URING_BUFS;
+    reg.bgid = CCNL_URING_BGID;
+    if (syscall(__NR_io_uring_register, u->fd, IORING_REGISTER_PBUF_RING,
+                &reg, 1) < 0) {
+        DEBUGMSG(WARNING, "no provided buffer ring (Linux 5.19): %s\n",
+                 strerror(errno));
+        goto failed;
+    }
+    for (i = 0; i < CCNL_URING_BUFS; i++) {
+        ccnl_uring_putbuf(u, i);
+    }
+    __atomic_store_n(&u->br->tail, u->brtail, __ATOMIC_RELEASE);
+
+    for (i = 0; i < CCNL_URING_SENDS; i++) {
+        u->sendfree[u->nsendfree++] = (int) (CCNL_URING_SENDS - 1 - i);
+    }
+    for (i = 0; i < CCNL_URING_POLLS; i++) {
+        u->polls[i].fd = -1;
+    }
+    DEBUGMSG(INFO, "io_uring: %u entries, %d receive buffers of %zu bytes\n",
+             p.sq_entries, CCNL_URING_BUFS, u->bufsize);
+
+    return u;
+
+failed:
+    ccnl_uring_close(u);
+    return NULL;
+}
+
+int
+ccnl_uring_TX(struct ccnl_if_s *ifc, sockunion *dest, struct ccnl_buf_s *buf)
+{
+    struct ccnl_uring_s *u = theUring;
+    struct ccnl_uring_send_s *s;
+    struct io_uring_sqe *sqe;
+    socklen_t addrlen;
+    int slot;
+
+    if (!u || !u->nsendfree) {
+        return -1;
+    }
+    switch (dest->sa.sa_family) {
+#ifdef USE_IPV4
+    case AF_INET:
+        addrlen = sizeof(struct sockaddr_in);
+        break;
+#endif
+#ifdef USE_IPV6
+    case AF_INET6:
+        addrlen = sizeof(struct sockaddr_in6);
+        break;
+#endif
+#ifdef USE_UNIXSOCKET
+    case AF_UNIX:
+        addrlen = sizeof(struct sockaddr_un);
+        break;
+#endif
+    default:
+        return -1;
+    }
+
+    slot = u->sendfree[u->nsendfree - 1];
+    s = u->sends + slot;
+    s->buf = ccnl_buf_new(buf->data, buf->datalen);
+    if (!s->buf) {
+        return -1;
+    }
+    if (!(sqe = ccnl_uring_sqe(u))) {
+        ccnl_free(s->buf);
+        s->buf = NULL;
+        return -1;
+    }
+    u->nsendfree--;
+    s->ifc = ifc;
+    memcpy(&s->dest, dest, sizeof(sockunion));
+    s->iov.iov_base = s->buf->data;
+    s->iov.iov_len = s->buf->datalen;
+    memset(&s->msg, 0, sizeof(s->msg));
+    s->msg.msg_name = &s->dest;
+    s->msg.msg_namelen = addrlen;
+    s->msg.msg_iov = &s->iov;
+    s->msg.msg_iovlen = 1;
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = ifc->sock;
+    sqe->addr = (uint64_t) (uintptr_t) &s->msg;
+    sqe->len = 1;
+    sqe->user_data = CCNL_URING_UDATA(CCNL_URING_SEND, slot);
+    DEBUGMSG(DEBUG, "io_uring send of %zu bytes to %s queued\n",
+             buf->datalen, ccnl_addr2ascii(dest));
+
+    return 0;
+}
+
+void
+ccnl_uring_fdclosed(void)
+{
+    if (theUring) {
+        theUring->pollfired = 1;
+    }
+}
+
+int
+ccnl_uring_loop(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_uring_s *u;
+    int i, rc;
+
+    if (ccnl->ifcount == 0) {
+        DEBUGMSG(ERROR, "no socket to work with, not good, quitting\n");
+        exit(EXIT_FAILURE);
+    }
+    u = ccnl_uring_open(ccnl);
+    if (!u) {
+        return -1;
+    }
+    theUring = u;
+
+    DEBUGMSG(INFO, "starting main event and IO loop on io_uring\n");
+    while (!ccnl->halt_flag && !u->failed) {
+        fd_set readfs, writefs;
+        struct __kernel_timespec ts;
+        int usec, maxfd = 0;
+
+        FD_ZERO(&readfs);
+        FD_ZERO(&writefs);
+#ifdef USE_HTTP_STATUS
+        ccnl_http_anteselect(ccnl, ccnl->http, &readfs, &writefs, &maxfd);
+#endif
+        if (ccnl_diskstore_fd() >= 0) {
+            FD_SET(ccnl_diskstore_fd(), &readfs);
+            if (ccnl_diskstore_fd() >= maxfd) {
+                maxfd = ccnl_diskstore_fd() + 1;
+            }
+        }
+        for (i = 0; i < ccnl->ifcount; i++) {
+#ifdef USE_PACKET_MMAP
+            if (ccnl->ifs[i].ring) {
+                FD_SET(ccnl->ifs[i].sock, &readfs);
+                if (ccnl->ifs[i].sock >= maxfd) {
+                    maxfd = ccnl->ifs[i].sock + 1;
+                }
+                continue;
+            }
+#endif
+            if (ccnl->ifs[i].stream) {
+                continue;
+            }
+            if (!u->rxarmed[i]) {
+                ccnl_uring_recv(u, i);
+            }
+        }
+#ifdef USE_STREAM
+        ccnl_stream_fdset(ccnl, &readfs, &writefs, &maxfd);
+#endif
+        ccnl_uring_polls(u, &readfs, &writefs, maxfd);
+
+        usec = ccnl_run_events();
+#ifdef USE_PACKET_MMAP
+        for (i = 0; i < ccnl->ifcount; i++) {
+            if (ccnl->ifs[i].ring && ccnl->ifs[i].ring->tx) {
+                ccnl_ethring_flush(ccnl->ifs[i].ring);
+            }
+        }
+#endif
+        for (i = 0; i < ccnl->ifcount; i++) {
+            if (ccnl->ifs[i].qlen > 0) {
+                usec = 0;   // the queue is worked off below
+            }
+        }
+
+        FD_ZERO(&u->rready);
+        FD_ZERO(&u->wready);
+        if (usec >= 0) {
+            ts.tv_sec = usec / 1000000;
+            ts.tv_nsec = (usec % 1000000) * 1000;
+            rc = ccnl_uring_enter(u, 1, &ts);
+        } else {
+            rc = ccnl_uring_enter(u, 1, NULL);
+        }
+        if (rc < 0 && errno != ETIME && errno != EINTR && errno != EBUSY) {
+            perror("io_uring_enter(): ");
+            exit(EXIT_FAILURE);
+        }
+        ccnl_uring_reap(u);
+
+#ifdef USE_HTTP_STATUS
+        ccnl_http_postselect(ccnl, ccnl->http, &u->rready, &u->wready);
+#endif
+        if (ccnl_diskstore_fd() >= 0 && FD_ISSET(ccnl_diskstore_fd(), &u->rready)) {
+            ccnl_diskstore_complete(ccnl);
+        }
+#ifdef USE_STREAM
+        ccnl_stream_process(ccnl, &u->rready, &u->wready);
+#endif
+        for (i = 0; i < ccnl->ifcount; i++) {
+#ifdef USE_PACKET_MMAP
+            if (ccnl->ifs[i].ring && FD_ISSET(ccnl->ifs[i].sock, &u->rready)) {
+                ccnl_ethring_RX(ccnl, i);
+            }
+#endif
+            if (ccnl->ifs[i].qlen > 0) {
+                ccnl_interface_CTS(ccnl, ccnl->ifs + i);
+            }
+        }
+        ccnl_callback_rx_burst_end(ccnl);
+    }
+
+    rc = u->failed ? -1 : 0;
+    theUring = NULL;
+    ccnl_uring_close(u);
+    return rc;
+}
+
+#endif // USE_IO_URING
@@ -0,0 +1,340 @@
+/*
+ * @f ccnl-verify.c
+ * @b CCN lite, batched HMAC verification of incoming Data
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#include "ccnl-verify.h"
+
+#ifdef USE_HMAC256
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ccnl-os-includes.h"
+#include "ccnl-core.h"
+#include "ccnl-callbacks.h"
+#include "ccnl-fwd.h"
+#include "ccnl-ext-hmac.h"
+#include "base64.h"
+
+struct ccnl_verify_key_s {
+    struct ccnl_verify_key_s *next;     // in file order, the first is the default
+    uint8_t keyid[SHA256_DIGEST_LENGTH];
+    struct ccnl_hmac256_key_s key;
+};
+
+struct ccnl_verify_ent_s {
+    struct ccnl_pkt_s *pkt;
+    int faceid;                         // the face may be gone at flush time
+    struct ccnl_verify_key_s *key;
+    int valid;
+};
+
+struct ccnl_verify_s {
+    struct ccnl_verify_key_s *keys;
+    struct ccnl_verify_ent_s *ents;
+    size_t cnt, max;
+
+    // per key batch, passed to ccnl_hmac256_key_sign_many()
+    const uint8_t **data;
+    size_t *dlen, *idx;
+    uint8_t **md, *mdbuf;
+
+    struct ccnl_pkt_s *passing;         // handed back, not to be held again
+};
+
+static struct ccnl_verify_s *_vfy = NULL;
+
+// ----------------------------------------------------------------------
+
+static struct ccnl_verify_key_s*
+ccnl_verify_load_keys(char *keyfile)
+{
+    FILE *fp = fopen(keyfile, "r");
+    char line[256];
+    struct ccnl_verify_key_s *keys = NULL, **kend = &keys;
+    int cnt = 0;
+
+    if (!fp) {
+        DEBUGMSG(ERROR, "verify: could not open key file %s\n", keyfile);
+        return NULL;
+    }
+    base64_build_decoding_table();
+    while (fgets(line, sizeof(line), fp)) {
+        struct ccnl_verify_key_s *k;
+        uint8_t keyval[64], *key;
+        size_t len = strlen(line), keylen;
+
+        while (len > 0 && (line[len-1] == '\n' || line[len-1] == '\r')) {
+            line[--len] = '\0';
+        }
+        key = base64_decode(line, len, &keylen);
+        if (!key || !keylen) {
+            free(key);
+            continue;
+        }
+        k = (struct ccnl_verify_key_s *) ccnl_calloc(1, sizeof(*k));
+        if (!k) {
+            free(key);
+            break;
+        }
+        ccnl_hmac256_keyid(key, keylen, k->keyid);
+        ccnl_hmac256_keyval(key, keylen, keyval);
+        ccnl_hmac256_key_init(&k->key, keyval, sizeof(keyval));
+        memset(keyval, 0, sizeof(keyval));
+        memset(key, 0, keylen);
+        free(key);
+
+        *kend = k;
+        kend = &k->next;
+        cnt++;
+    }
+    fclose(fp);
+    base64_cleanup();
+    DEBUGMSG(INFO, "verify: %d keys loaded from %s\n", cnt, keyfile);
+    return keys;
+}
+
+// returns the key a packet claims to be signed with, NULL if unknown
+static struct ccnl_verify_key_s*
+ccnl_verify_find_key(struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_verify_key_s *k;
+    struct ccnl_buf_s *keyid = NULL;
+
+    switch (pkt->suite) {
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV:
+        keyid = pkt->s.ccntlv.keyid;
+        break;
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+        keyid = pkt->s.ndntlv.ppkl;
+        break;
+#endif
+    default:
+        break;
+    }
+    if (!keyid) {
+        return _vfy->keys;
+    }
+    if (keyid->datalen != SHA256_DIGEST_LENGTH) {
+        return NULL;
+    }
+    for (k = _vfy->keys; k; k = k->next) {
+        if (!memcmp(k->keyid, keyid->data, SHA256_DIGEST_LENGTH)) {
+            return k;
+        }
+    }
+    return NULL;
+}
+
+// compares in constant time, the signature is attacker controlled
+static int
+ccnl_verify_digest_eq(const uint8_t *a, const uint8_t *b)
+{
+    uint8_t diff = 0;
+    int i;
+
+    for (i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+static int
+ccnl_verify_rx_on_data(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                       struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_verify_ent_s *e;
+    char s[CCNL_MAX_PREFIX_SIZE];
+    (void) s;
+
+    if (!_vfy || pkt == _vfy->passing) {
+        return 0;
+    }
+    if (!pkt->hmacLen || !pkt->hmacSignature) {
+        DEBUGMSG(DEBUG, "verify: unsigned data <%s> dropped\n",
+                 ccnl_prefix_to_str(pkt->pfx, s, CCNL_MAX_PREFIX_SIZE));
+        ccnl_pkt_free(pkt);
+        return 1;
+    }
+
+    e = _vfy->ents + _vfy->cnt++;
+    e->pkt = pkt;
+    e->faceid = from ? from->faceid : -1;
+    e->key = ccnl_verify_find_key(pkt);
+    e->valid = 0;
+
+    if (_vfy->cnt == _vfy->max) {
+        ccnl_verify_flush(relay);
+    }
+    return 1;
+}
+
+static void
+ccnl_verify_burst_end(struct ccnl_relay_s *relay)
+{
+    ccnl_verify_flush(relay);
+}
+
+// ----------------------------------------------------------------------
+
+int
+ccnl_verify_open(struct ccnl_relay_s *relay, char *keyfile, size_t batch)
+{
+    struct ccnl_verify_s *v;
+    size_t i;
+    (void) relay;
+
+    if (_vfy) {
+        return -1;
+    }
+    if (!batch) {
+        batch = CCNL_VERIFY_BATCH;
+    }
+    v = (struct ccnl_verify_s *) ccnl_calloc(1, sizeof(*v));
+    if (!v) {
+        return -1;
+    }
+    v->keys = ccnl_verify_load_keys(keyfile);
+    v->max = batch;
+    v->ents = (struct ccnl_verify_ent_s *) ccnl_calloc(batch, sizeof(*v->ents));
+    v->data = (const uint8_t **) ccnl_calloc(batch, sizeof(*v->data));
+    v->dlen = (size_t *) ccnl_calloc(batch, sizeof(size_t));
+    v->idx = (size_t *) ccnl_calloc(batch, sizeof(size_t));
+    v->md = (uint8_t **) ccnl_calloc(batch, sizeof(*v->md));
+    v->mdbuf = (uint8_t *) ccnl_malloc(batch * SHA256_DIGEST_LENGTH);
+    _vfy = v;
+    if (!v->keys || !v->ents || !v->data || !v->dlen || !v->idx ||
+                                                  !v->md || !v->mdbuf) {
+        ccnl_verify_close();
+        return -1;
+    }
+    for (i = 0; i < batch; i++) {
+        v->md[i] = v->mdbuf + i * SHA256_DIGEST_LENGTH;
+    }
+
+    ccnl_set_cb_rx_on_data(ccnl_verify_rx_on_data);
+    ccnl_set_cb_rx_burst_end(ccnl_verify_burst_end);
+    DEBUGMSG(INFO, "verify: checking incoming data, batches of %zu (sha256 %s)\n",
+             batch, ccnl_SHA256_kernel());
+    return 0;
+}
+
+void
+ccnl_verify_flush(struct ccnl_relay_s *relay)
+{
+    struct ccnl_verify_s *v = _vfy;
+    struct ccnl_verify_key_s *k;
+    size_t i, cnt, n;
+    char s[CCNL_MAX_PREFIX_SIZE];
+    (void) s;
+
+    if (!v || !v->cnt) {
+        return;
+    }
+    cnt = v->cnt;
+    v->cnt = 0;
+    DEBUGMSG(TRACE, "verify: checking %zu packets\n", cnt);
+
+    // one multi-buffer run per key
+    for (k = v->keys; k; k = k->next) {
+        for (i = 0, n = 0; i < cnt; i++) {
+            if (v->ents[i].key == k) {
+                v->idx[n] = i;
+                v->data[n] = v->ents[i].pkt->hmacStart;
+                v->dlen[n] = v->ents[i].pkt->hmacLen;
+                n++;
+            }
+        }
+        if (!n) {
+            continue;
+        }
+        ccnl_hmac256_key_sign_many(&k->key, v->data, v->dlen, v->md, n);
+        for (i = 0; i < n; i++) {
+            struct ccnl_verify_ent_s *e = v->ents + v->idx[i];
+            e->valid = ccnl_verify_digest_eq(v->md[i], e->pkt->hmacSignature);
+        }
+    }
+
+    // hand back in arrival order
+    for (i = 0; i < cnt; i++) {
+        struct ccnl_verify_ent_s *e = v->ents + i;
+        struct ccnl_pkt_s *pkt = e->pkt;
+        struct ccnl_face_s *from;
+
+        e->pkt = NULL;
+        if (!e->valid) {
+            DEBUGMSG(INFO, "verify: data <%s> dropped, %s\n",
+                     ccnl_prefix_to_str(pkt->pfx, s, CCNL_MAX_PREFIX_SIZE),
+                     e->key ? "invalid signature" : "unknown key");
+            ccnl_pkt_free(pkt);
+            continue;
+        }
+        for (from = relay->faces; from; from = from->next) {
+            if (from->faceid == e->faceid) {
+                break;
+            }
+        }
+        v->passing = pkt;
+        ccnl_fwd_handleContent(relay, from, &pkt);
+        v->passing = NULL;
+        if (pkt) {
+            ccnl_pkt_free(pkt);
+        }
+    }
+}
+
+void
+ccnl_verify_close(void)
+{
+    struct ccnl_verify_s *v = _vfy;
+    size_t i;
+
+    if (!v) {
+        return;
+    }
+    ccnl_set_cb_rx_on_data(NULL);
+    ccnl_set_cb_rx_burst_end(NULL);
+
+    // not verified, so not passed on
+    for (i = 0; i < v->cnt; i++) {
+        ccnl_pkt_free(v->ents[i].pkt);
+    }
+    while (v->keys) {
+        struct ccnl_verify_key_s *k = v->keys;
+        v->keys = k->next;
+        memset(k, 0, sizeof(*k));
+        ccnl_free(k);
+    }
+    ccnl_free(v->ents);
+    ccnl_free(v->data);
+    ccnl_free(v->dlen);
+    ccnl_free(v->idx);
+    ccnl_free(v->md);
+    ccnl_free(v->mdbuf);
+    ccnl_free(v);
+    _vfy = NULL;
+}
+
+#endif // USE_HMAC256
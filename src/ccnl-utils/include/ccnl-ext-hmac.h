@@ -86,6 +86,60 @@ ccnl_hmac256_sign(uint8_t *keyval, size_t kvlen,
                   uint8_t *data, size_t dlen,
                   uint8_t *md, size_t *mlen);
 
+/**
+ * @brief A prepared HMAC key
+ *
+ * Holds the SHA256 states after the (key ^ ipad) and (key ^ opad) blocks,
+ * which are the same for every message signed with the key.
+ */
+struct ccnl_hmac256_key_s {
+    sha2_word32 istate[8]; /**< inner hash state */
+    sha2_word32 ostate[8]; /**< outer hash state */
+};
+
+/**
+ * @brief Prepares a key for ccnl_hmac256_key_sign()
+ *
+ * @param[out] key The prepared key
+ * @param[in]  keyval The key as returned by ccnl_hmac256_keyval()
+ * @param[in]  kvlen The length of \p keyval
+ */
+void
+ccnl_hmac256_key_init(struct ccnl_hmac256_key_s *key,
+                      uint8_t *keyval, size_t kvlen);
+
+/**
+ * @brief Generates an HMAC signature with a prepared key
+ *
+ * Same result as ccnl_hmac256_sign(), without hashing the key blocks.
+ *
+ * @param[in]  key The prepared key
+ * @param[in]  data The data to sign
+ * @param[in]  dlen The length of \p data
+ * @param[out] md The message digest
+ * @param[in,out] mlen The size of \p md, the length of the digest on return
+ */
+void
+ccnl_hmac256_key_sign(const struct ccnl_hmac256_key_s *key,
+                      const uint8_t *data, size_t dlen,
+                      uint8_t *md, size_t *mlen);
+
+/**
+ * @brief Generates the HMAC signatures of several messages at once
+ *
+ * The messages are hashed side by side where the CPU allows it (see
+ * ccnl_SHA256_FinalMany()).
+ *
+ * @param[in]  key The prepared key
+ * @param[in]  data The messages
+ * @param[in]  dlen The lengths of the messages
+ * @param[out] md The message digests, 32 bytes each
+ * @param[in]  n The number of messages
+ */
+void
+ccnl_hmac256_key_sign_many(const struct ccnl_hmac256_key_s *key,
+                           const uint8_t *data[], const size_t dlen[],
+                           uint8_t *md[], size_t n);
 
 #ifdef NEEDS_PACKET_CRAFTING
 #ifdef USE_SUITE_CCNTLV
@@ -115,6 +169,19 @@ ccnl_ccntlv_prependSignedContentWithHdr(struct ccnl_prefix_s *name,
                                         uint8_t *keyval, // 64B
                                         uint8_t *keydigest, // 32B
                                         size_t *offset, uint8_t *buf, size_t *retlen);
+
+/**
+ * @brief Same as ccnl_ccntlv_prependSignedContentWithHdr(), with a
+ * prepared key
+ */
+int8_t
+ccnl_ccntlv_prependSignedContentWithHdrKey(struct ccnl_prefix_s *name,
+                                           uint8_t *payload, size_t paylen,
+                                           uint32_t *lastchunknum,
+                                           size_t *contentpos,
+                                           const struct ccnl_hmac256_key_s *key,
+                                           size_t *offset, uint8_t *buf,
+                                           size_t *retlen);
 #endif // USE_SUITE_CCNTLV
 
 #ifdef USE_SUITE_NDNTLV
@@ -140,6 +207,16 @@ ccnl_ndntlv_prependSignedContent(struct ccnl_prefix_s *name,
                                  uint8_t *keyval, // 64B
                                  uint8_t *keydigest, // 32B
                                  size_t *offset, uint8_t *buf, size_t *reslen);
+
+/**
+ * @brief Same as ccnl_ndntlv_prependSignedContent(), with a prepared key
+ */
+int8_t
+ccnl_ndntlv_prependSignedContentKey(struct ccnl_prefix_s *name,
+                                    uint8_t *payload, size_t paylen,
+                                    uint32_t *final_block_id, size_t *contentpos,
+                                    const struct ccnl_hmac256_key_s *key,
+                                    size_t *offset, uint8_t *buf, size_t *reslen);
 #endif // USE_SUITE_NDNTLV
 #endif // NEEDS_PACKET_CRAFTING
 
@@ -125,4 +125,30 @@ void ccnl_SHA256_Update(SHA256_CTX_t* context, const sha2_byte *data, size_t len
 
 void ccnl_SHA256_Final(sha2_byte digest[], SHA256_CTX_t* context);
 
+
+/*** accelerated kernels **********************************************/
+/*
+ * The compression function is picked at first use: SHA-NI when the CPU has
+ * it, else the portable code. Independent messages can be hashed together
+ * with ccnl_SHA256_FinalMany(), which runs up to SHA256_MAX_LANES of them
+ * in the lanes of one AVX2 register when there is no SHA-NI.
+ */
+#define SHA256_MAX_LANES		8
+
+/* compresses nblocks consecutive 64 byte blocks into state */
+void ccnl_SHA256_Blocks(sha2_word32 state[8], const sha2_byte *data, size_t nblocks);
+
+/*
+ * Same as ccnl_SHA256_Update(context[i], data[i], len[i]) followed by
+ * ccnl_SHA256_Final(digest[i], context[i]) for all i < n.
+ */
+void ccnl_SHA256_FinalMany(SHA256_CTX_t *context[], const sha2_byte *data[],
+			   const size_t len[], sha2_byte *digest[], size_t n);
+
+/* "sha-ni", "avx2" or "generic" */
+const char* ccnl_SHA256_kernel(void);
+
+/* selects a kernel by name, returns -1 if the CPU does not support it */
+int ccnl_SHA256_setKernel(const char *name);
+
 // eof
@@ -0,0 +1,707 @@
+/*
+ * @f util/ccn-lite-cachesim.c
+ * @b CLI cache simulator, replays a request trace through the content store
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/*
+ * Each request of the trace is looked up in the CS of a relay without
+ * faces. A miss fetches the object: it is offered to the admission policy
+ * (cache_strategy_cache()) and ccnl_content_add2cache(), which evicts as
+ * the relay does. The "lru" eviction touches an entry on every hit.
+ *
+ * A trace is a pcap file, whose NDN Interests over Ethernet, UDP or TCP
+ * are the requests and whose Data packets give the object sizes, or a
+ * text file with one request per line:
+ *
+ *   NAME [SIZE [TIMESTAMP]]
+ */
+
+#include "ccnl-common.h"
+
+#include <sys/time.h>
+
+#include "ccnl-callbacks.h"
+
+struct sim_name_s {
+    char *uri;
+    struct ccnl_prefix_s *pfx;
+    uint64_t hash;              // ccnl_prefix_hash()
+    size_t size;                // bytes of the object, 0: unknown
+    long next;                  // in the chain of the name table
+};
+
+struct sim_trace_s {
+    struct sim_name_s *names;
+    long namecnt, namemax;
+    long *tab;                  // first name of each chain, -1: none
+    long tabsize;
+    long *reqs;                 // names requested, in order
+    long reqcnt, reqmax;
+    double first, last;         // timestamps
+};
+
+struct sim_result_s {
+    long requests, hits;
+    uint64_t bytes, hitbytes;
+    long evictions;
+    double secs;
+};
+
+static long sim_evictions;
+
+static double
+sim_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (double) tv.tv_sec + (double) tv.tv_usec / 1e6;
+}
+
+static uint64_t
+sim_strhash(const char *s)
+{
+    uint64_t h = 14695981039346656037ULL;
+
+    while (*s) {
+        h = (h ^ (uint8_t) *s++) * 1099511628211ULL;
+    }
+    return h;
+}
+
+// returns the index of the name, adding it to the table if new
+static long
+sim_intern(struct sim_trace_s *t, const char *uri)
+{
+    struct sim_name_s *n;
+    char *tmp;
+    long i, *tab;
+    uint64_t h = sim_strhash(uri);
+
+    if (t->tab) {
+        for (i = t->tab[h & (uint64_t) (t->tabsize - 1)]; i >= 0; i = t->names[i].next) {
+            if (!strcmp(t->names[i].uri, uri)) {
+                return i;
+            }
+        }
+    }
+    if (t->namecnt >= t->tabsize) {
+        long size = t->tabsize ? 2 * t->tabsize : 1024;
+
+        tab = (long *) malloc((size_t) size * sizeof(long));
+        if (!tab) {
+            return -1;
+        }
+        memset(tab, 0xff, (size_t) size * sizeof(long));
+        for (i = 0; i < t->namecnt; i++) {
+            long b = (long) (sim_strhash(t->names[i].uri) & (uint64_t) (size - 1));
+
+            t->names[i].next = tab[b];
+            tab[b] = i;
+        }
+        free(t->tab);
+        t->tab = tab;
+        t->tabsize = size;
+    }
+    if (t->namecnt >= t->namemax) {
+        long max = t->namemax ? 2 * t->namemax : 1024;
+
+        n = (struct sim_name_s *) realloc(t->names, (size_t) max * sizeof(*n));
+        if (!n) {
+            return -1;
+        }
+        t->names = n;
+        t->namemax = max;
+    }
+
+    n = t->names + t->namecnt;
+    memset(n, 0, sizeof(*n));
+    n->uri = strdup(uri);
+    tmp = strdup(uri);          // ccnl_URItoPrefix() takes the string apart
+    if (!n->uri || !tmp) {
+        free(n->uri);
+        free(tmp);
+        return -1;
+    }
+    n->pfx = ccnl_URItoPrefix(tmp, CCNL_SUITE_NDNTLV, NULL);
+    free(tmp);
+    if (!n->pfx) {
+        DEBUGMSG(WARNING, "cannot parse name %s\n", uri);
+        free(n->uri);
+        return -1;
+    }
+    n->hash = ccnl_prefix_hash(n->pfx);
+    i = (long) (h & (uint64_t) (t->tabsize - 1));
+    n->next = t->tab[i];
+    t->tab[i] = t->namecnt;
+    return t->namecnt++;
+}
+
+static int
+sim_request(struct sim_trace_s *t, long name, double ts)
+{
+    if (t->reqcnt >= t->reqmax) {
+        long max = t->reqmax ? 2 * t->reqmax : 65536;
+        long *r = (long *) realloc(t->reqs, (size_t) max * sizeof(long));
+
+        if (!r) {
+            return -1;
+        }
+        t->reqs = r;
+        t->reqmax = max;
+    }
+    if (!t->reqcnt) {
+        t->first = ts;
+    }
+    t->last = ts;
+    t->reqs[t->reqcnt++] = name;
+    return 0;
+}
+
+static int
+sim_load_text(struct sim_trace_s *t, FILE *f)
+{
+    char *line = NULL, *uri, *cp;
+    size_t linemax = 0;
+    long lineno = 0, n;
+    double ts;
+
+    while (getline(&line, &linemax, f) > 0) {
+        lineno++;
+        uri = strtok(line, " \t\r\n");
+        if (!uri || *uri == '#') {
+            continue;
+        }
+        n = sim_intern(t, uri);
+        if (n < 0) {
+            DEBUGMSG(ERROR, "line %ld: bad request\n", lineno);
+            free(line);
+            return -1;
+        }
+        cp = strtok(NULL, " \t\r\n");
+        if (cp) {
+            t->names[n].size = (size_t) strtoull(cp, NULL, 10);
+        }
+        cp = strtok(NULL, " \t\r\n");
+        ts = cp ? strtod(cp, NULL) : (double) t->reqcnt;
+        if (sim_request(t, n, ts)) {
+            free(line);
+            return -1;
+        }
+    }
+    free(line);
+    return 0;
+}
+
+#ifdef USE_SUITE_NDNTLV
+
+// an NDN packet, possibly in an NDNLP fragment
+static int
+sim_load_ndn(struct sim_trace_s *t, uint8_t *data, size_t len, double ts)
+{
+    struct ccnl_pkt_s *pkt;
+    uint8_t *start = data;
+    uint64_t typ;
+    size_t vallen;
+    char uri[CCNL_MAX_PREFIX_SIZE];
+    long n;
+
+    if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen)) {
+        return 0;
+    }
+    if (typ == NDN_TLV_NDNLP) {
+        len = vallen;
+        while (!ccnl_ndntlv_dehead(&data, &len, &typ, &vallen)) {
+            // NdnlpFragment, or the Fragment of NDNLPv2 (our NdnlpHeader)
+            if ((typ == NDN_TLV_NdnlpFragment || typ == NDN_TLV_NdnlpHeader) &&
+                sim_load_ndn(t, data, vallen, ts)) {
+                return -1;
+            }
+            data += vallen;
+            len -= vallen;
+        }
+        return 0;
+    }
+    if (typ != NDN_TLV_Interest && typ != NDN_TLV_Data) {
+        return 0;
+    }
+    len = vallen;
+    pkt = ccnl_ndntlv_bytes2pkt(typ, start, &data, &len);
+    if (!pkt || !pkt->pfx ||
+        !ccnl_prefix_to_str(pkt->pfx, uri, sizeof(uri))) {
+        ccnl_pkt_free(pkt);
+        return 0;
+    }
+    n = sim_intern(t, uri);
+    if (n >= 0 && typ == NDN_TLV_Data) {
+        t->names[n].size = pkt->buf ? pkt->buf->datalen : 0;
+    }
+    ccnl_pkt_free(pkt);
+    if (n >= 0 && typ == NDN_TLV_Interest) {
+        return sim_request(t, n, ts);
+    }
+    return 0;
+}
+
+// the UDP or TCP payload of an IP packet
+static int
+sim_load_ip(struct sim_trace_s *t, uint8_t *p, size_t len, double ts)
+{
+    size_t hl;
+    int proto;
+
+    if (len < 1) {
+        return 0;
+    }
+    if ((p[0] >> 4) == 4) {
+        hl = (size_t) (p[0] & 0x0f) * 4;
+        if (len < 20 || len < hl) {
+            return 0;
+        }
+        proto = p[9];
+    } else if ((p[0] >> 4) == 6) {
+        hl = 40;
+        if (len < hl) {
+            return 0;
+        }
+        proto = p[6];
+    } else {
+        return 0;
+    }
+    p += hl;
+    len -= hl;
+    if (proto == IPPROTO_UDP && len >= 8) {
+        hl = 8;
+    } else if (proto == IPPROTO_TCP && len >= 20) {
+        hl = (size_t) (p[12] >> 4) * 4;
+    } else {
+        return 0;
+    }
+    if (len <= hl) {
+        return 0;
+    }
+    return sim_load_ndn(t, p + hl, len - hl, ts);
+}
+
+static int
+sim_load_pcap(struct sim_trace_s *t, FILE *f, uint32_t magic)
+{
+    uint8_t hdr[24], rec[16], *pkt = NULL, *p;
+    uint32_t linktype, caplen, max = 0;
+    int swap = magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1;
+    double frac = (magic == 0xa1b23c4d || magic == 0x4d3cb2a1) ? 1e9 : 1e6;
+    size_t len;
+    uint16_t ethertype;
+
+#define SIM_U32(b) (swap ? ((uint32_t) (b)[3] << 24 | (uint32_t) (b)[2] << 16 | \
+                            (uint32_t) (b)[1] << 8 | (b)[0]) :                     \
+                           ((uint32_t) (b)[0] << 24 | (uint32_t) (b)[1] << 16 | \
+                            (uint32_t) (b)[2] << 8 | (b)[3]))
+
+    if (fread(hdr, sizeof(hdr), 1, f) != 1) {
+        return -1;
+    }
+    linktype = SIM_U32(hdr + 20) & 0xffff;
+    while (fread(rec, sizeof(rec), 1, f) == 1) {
+        double ts = SIM_U32(rec) + SIM_U32(rec + 4) / frac;
+
+        caplen = SIM_U32(rec + 8);
+        if (caplen > max) {
+            p = (uint8_t *) realloc(pkt, caplen);
+            if (!p) {
+                free(pkt);
+                return -1;
+            }
+            pkt = p;
+            max = caplen;
+        }
+        if (caplen && fread(pkt, caplen, 1, f) != 1) {
+            break;
+        }
+        p = pkt;
+        len = caplen;
+        switch (linktype) {
+        case 0:                 // BSD loopback
+            if (len > 4) {
+                sim_load_ip(t, p + 4, len - 4, ts);
+            }
+            break;
+        case 1:                 // Ethernet
+        case 113:               // Linux cooked
+            if (len < (linktype == 1 ? 14U : 16U)) {
+                break;
+            }
+            ethertype = (uint16_t) (p[linktype == 1 ? 12 : 14] << 8 |
+                                    p[linktype == 1 ? 13 : 15]);
+            p += linktype == 1 ? 14 : 16;
+            len -= linktype == 1 ? 14 : 16;
+            while (ethertype == 0x8100 && len >= 4) {            // VLAN
+                ethertype = (uint16_t) (p[2] << 8 | p[3]);
+                p += 4;
+                len -= 4;
+            }
+            if (ethertype == 0x0800 || ethertype == 0x86dd) {
+                sim_load_ip(t, p, len, ts);
+            } else if (ethertype == 0x8624) {                    // NDN
+                sim_load_ndn(t, p, len, ts);
+            }
+            break;
+        case 12:                // raw IP
+        case 101:
+            sim_load_ip(t, p, len, ts);
+            break;
+        default:
+            DEBUGMSG(ERROR, "unsupported pcap link type %u\n", linktype);
+            free(pkt);
+            return -1;
+        }
+    }
+    free(pkt);
+    return 0;
+#undef SIM_U32
+}
+
+#endif // USE_SUITE_NDNTLV
+
+static int
+sim_load(struct sim_trace_s *t, const char *fname)
+{
+    FILE *f = strcmp(fname, "-") ? fopen(fname, "rb") : stdin;
+    uint8_t m[4];
+    uint32_t magic = 0;
+    int rc;
+
+    if (!f) {
+        perror(fname);
+        return -1;
+    }
+    if (f != stdin && fread(m, sizeof(m), 1, f) == 1) {
+        magic = (uint32_t) m[0] << 24 | (uint32_t) m[1] << 16 |
+                (uint32_t) m[2] << 8 | m[3];
+        rewind(f);
+    }
+    if (magic == 0xa1b2c3d4 || magic == 0xd4c3b2a1 ||
+        magic == 0xa1b23c4d || magic == 0x4d3cb2a1) {
+#ifdef USE_SUITE_NDNTLV
+        rc = sim_load_pcap(t, f, magic);
+#else
+        DEBUGMSG(ERROR, "pcap traces need the NDN suite\n");
+        rc = -1;
+#endif
+    } else {
+        rc = sim_load_text(t, f);
+    }
+    if (f != stdin) {
+        fclose(f);
+    }
+    return rc;
+}
+
+static void
+sim_evicted(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    (void) relay;
+    (void) c;
+    sim_evictions++;
+}
+
+static struct ccnl_content_s*
+sim_lookup(struct ccnl_relay_s *relay, struct sim_name_s *n)
+{
+    struct ccnl_content_s *c;
+
+    for (c = ccnl_content_lookup_name(relay, n->hash); c; c = c->name_next) {
+        if (c->namehash == n->hash &&
+            !ccnl_prefix_cmp(c->pkt->pfx, NULL, n->pfx, CMP_EXACT)) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+// the object as the producer would send it, without its bytes
+static struct ccnl_content_s*
+sim_fetch(struct sim_name_s *n)
+{
+    struct ccnl_pkt_s *pkt = (struct ccnl_pkt_s *) calloc(1, sizeof(*pkt));
+    struct ccnl_content_s *c;
+
+    if (!pkt) {
+        return NULL;
+    }
+    pkt->pfx = ccnl_prefix_dup(n->pfx);
+    pkt->suite = CCNL_SUITE_NDNTLV;
+    pkt->contlen = n->size;
+    c = pkt->pfx ? ccnl_content_new(&pkt) : NULL;
+    ccnl_pkt_free(pkt);
+    return c;
+}
+
+static int
+sim_run(struct sim_trace_s *t, int size, const char *evict, const char *admit,
+        long warmup, struct sim_result_s *res)
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *c;
+    struct sim_name_s *n;
+    int lru = !strcmp(evict, "lru");
+    long i;
+    double t0;
+
+    memset(&relay, 0, sizeof(relay));
+    memset(res, 0, sizeof(*res));
+    relay.max_cache_entries = size;
+    if (ccnl_admit_set(&relay, admit)) {
+        DEBUGMSG(ERROR, "unknown admission policy %s\n", admit);
+        return -1;
+    }
+    sim_evictions = 0;
+
+    t0 = sim_now();
+    for (i = 0; i < t->reqcnt; i++) {
+        int counted = i >= warmup;
+
+        n = t->names + t->reqs[i];
+        if (i == warmup) {
+            sim_evictions = 0;
+        }
+        // as ccnl_fwd_handleInterest() does
+        ccnl_admit_seen(&relay, n->hash);
+        c = sim_lookup(&relay, n);
+        if (counted) {
+            res->requests++;
+            res->bytes += n->size;
+        }
+        if (c) {
+            c->served_cnt++;
+            if (lru) {
+                ccnl_content_touch(&relay, c);
+            }
+            if (counted) {
+                res->hits++;
+                res->hitbytes += n->size;
+            }
+            continue;
+        }
+        c = sim_fetch(n);
+        if (!c) {
+            DEBUGMSG(ERROR, "out of memory\n");
+            ccnl_core_cleanup(&relay);
+            return -1;
+        }
+        if (!cache_strategy_cache(&relay, c) || !ccnl_content_add2cache(&relay, c)) {
+            ccnl_content_free(c);
+        }
+    }
+    res->secs = sim_now() - t0;
+    res->evictions = sim_evictions;
+
+    ccnl_core_cleanup(&relay);
+    return 0;
+}
+
+#ifdef USE_DEBUG_MALLOC
+/*
+ * The debug allocator of the libraries never returns memory and formats
+ * a timestamp for every block, which a replay of millions of misses cannot
+ * afford. The link maps it to the plain one, see CMakeLists.txt, log lines
+ * go without timestamps then.
+ */
+void* __wrap_debug_malloc(size_t s, const char *fn, int lno, char *tstamp);
+void* __wrap_debug_calloc(size_t num, size_t size, const char *fn, int lno,
+                          char *tstamp);
+void* __wrap_debug_realloc(void *p, size_t s, const char *fn, int lno);
+void* __wrap_debug_strdup(const char *s, const char *fn, int lno, char *tstamp);
+void __wrap_debug_free(void *p, const char *fn, int lno);
+char* __wrap_timestamp(void);
+
+void*
+__wrap_debug_malloc(size_t s, const char *fn, int lno, char *tstamp)
+{
+    (void) fn;
+    (void) lno;
+    (void) tstamp;
+    return malloc(s);
+}
+
+void*
+__wrap_debug_calloc(size_t num, size_t size, const char *fn, int lno,
+                    char *tstamp)
+{
+    (void) fn;
+    (void) lno;
+    (void) tstamp;
+    return calloc(num, size);
+}
+
+void*
+__wrap_debug_realloc(void *p, size_t s, const char *fn, int lno)
+{
+    (void) fn;
+    (void) lno;
+    return realloc(p, s);
+}
+
+void*
+__wrap_debug_strdup(const char *s, const char *fn, int lno, char *tstamp)
+{
+    (void) fn;
+    (void) lno;
+    (void) tstamp;
+    return strdup(s);
+}
+
+void
+__wrap_debug_free(void *p, const char *fn, int lno)
+{
+    (void) fn;
+    (void) lno;
+    free(p);
+}
+
+char*
+__wrap_timestamp(void)
+{
+    return "";
+}
+#endif // USE_DEBUG_MALLOC
+
+int
+main(int argc, char *argv[])
+{
+    char *sizes = "1000", *evicts = "fifo", *admits = "all";
+    char *s1, *s2, *s3, *sz, *ev, *ad, *sp1, *sp2, *sp3;
+    struct sim_trace_s trace;
+    struct sim_result_s res;
+    size_t defsize = 1000;
+    uint64_t total = 0;
+    long warmup = 0, i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:b:c:e:hv:w:")) != -1) {
+        switch (opt) {
+        case 'a':
+            admits = optarg;
+            break;
+        case 'b':
+            defsize = (size_t) strtoull(optarg, NULL, 10);
+            break;
+        case 'c':
+            sizes = optarg;
+            break;
+        case 'e':
+            evicts = optarg;
+            break;
+        case 'w':
+            warmup = strtol(optarg, NULL, 10);
+            break;
+        case 'v':
+#ifdef USE_LOGGING
+            if (isdigit(optarg[0]))
+                debug_level = (int)strtol(optarg, (char**)NULL, 10);
+            else
+                debug_level = ccnl_debug_str2level(optarg);
+#endif
+            break;
+        case 'h':
+        /* falls through */
+        default:
+Usage:
+            fprintf(stderr, "usage: %s [options] TRACE\n"
+            "  -a POLICIES  admission: all, prob:P, second, tinylfu (default all)\n"
+            "  -b BYTES     size of objects the trace gives none (default 1000)\n"
+            "  -c SIZES     cache sizes in entries (default 1000)\n"
+            "  -e POLICIES  eviction: fifo (the relay's), lru (default fifo)\n"
+            "  -w N         requests that warm the cache up, not counted\n"
+#ifdef USE_LOGGING
+            "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
+#endif
+            "POLICIES and SIZES are comma separated lists, all combinations\n"
+            "are simulated. TRACE is a pcap or a text file (- for stdin) with\n"
+            "lines NAME [SIZE [TIMESTAMP]].\n",
+            argv[0]);
+            exit(1);
+        }
+    }
+    if (!argv[optind]) {
+        goto Usage;
+    }
+
+    memset(&trace, 0, sizeof(trace));
+    if (sim_load(&trace, argv[optind])) {
+        DEBUGMSG(ERROR, "cannot read trace %s\n", argv[optind]);
+        return -1;
+    }
+    if (trace.reqcnt <= warmup) {
+        DEBUGMSG(ERROR, "no requests in trace %s\n", argv[optind]);
+        return -1;
+    }
+    for (i = 0; i < trace.namecnt; i++) {
+        if (!trace.names[i].size) {
+            trace.names[i].size = defsize;
+        }
+    }
+    for (i = warmup; i < trace.reqcnt; i++) {
+        total += trace.names[trace.reqs[i]].size;
+    }
+    ccnl_set_cb_cs_evict(sim_evicted);
+
+    printf("# %ld requests of %ld names, %.1f MB, %.1f s\n",
+           trace.reqcnt - warmup, trace.namecnt, (double) total / 1e6,
+           trace.last - trace.first);
+    printf("%10s %-6s %-10s %8s %9s %10s %10s %10s\n", "cache", "evict",
+           "admit", "hits", "bytehits", "evictions", "evict/s", "req/s");
+
+    s1 = strdup(sizes);
+    for (sz = strtok_r(s1, ",", &sp1); sz; sz = strtok_r(NULL, ",", &sp1)) {
+        int size = atoi(sz);
+
+        if (size <= 0) {
+            DEBUGMSG(ERROR, "bad cache size %s\n", sz);
+            return -1;
+        }
+        s2 = strdup(evicts);
+        for (ev = strtok_r(s2, ",", &sp2); ev; ev = strtok_r(NULL, ",", &sp2)) {
+            if (strcmp(ev, "fifo") && strcmp(ev, "lru")) {
+                DEBUGMSG(ERROR, "unknown eviction policy %s\n", ev);
+                return -1;
+            }
+            s3 = strdup(admits);
+            for (ad = strtok_r(s3, ",", &sp3); ad; ad = strtok_r(NULL, ",", &sp3)) {
+                if (sim_run(&trace, size, ev, ad, warmup, &res)) {
+                    return -1;
+                }
+                printf("%10d %-6s %-10s %7.2f%% %8.2f%% %10ld %10.0f %10.0f\n",
+                       size, ev, ad, 100.0 * (double) res.hits / (double) res.requests,
+                       res.bytes ? 100.0 * (double) res.hitbytes / (double) res.bytes : 0.0,
+                       res.evictions, (double) res.evictions / res.secs,
+                       (double) (trace.reqcnt) / res.secs);
+                fflush(stdout);
+            }
+            free(s3);
+        }
+        free(s2);
+    }
+    free(s1);
+
+    return 0;
+}
+
+// eof
@@ -24,6 +24,7 @@
 
 #include "ccnl-common.h"
 #include "ccnl-crypto.h"
+#include "ccnl-mgmt-bin.h"
 
 // ----------------------------------------------------------------------
 
@@ -513,8 +514,9 @@ mkEchoserverRequest(uint8_t *out, size_t outlen, char *path, int suite,
 }
 
 int8_t
-mkNewFaceRequest(uint8_t *out, size_t outlen, char *macsrc, char *ip4src, char *ip6src, char *wpan_addr,
-         char *wpan_panid, char *host, char *port, char *flags, char *private_key_path, size_t *reslen)
+mkNewFaceRequest(uint8_t *out, size_t outlen, char *macsrc, char *ip4src, char *ip6src, char *proto,
+         char *wpan_addr, char *wpan_panid, char *host, char *port, char *flags, char *private_key_path,
+         size_t *reslen)
 {
     size_t len = 0, len1 = 0, len2 = 0, len3 = 0;
     uint8_t out1[CCNL_MAX_PACKET_SIZE];
@@ -555,7 +557,7 @@ mkNewFaceRequest(uint8_t *out, size_t outlen, char *macsrc, char *ip4src, char *
         if (ccnl_ccnb_mkStrBlob(faceinst+len3, faceinst + sizeof(faceinst), CCNL_DTAG_IP4SRC, CCN_TT_DTAG, ip4src, &len3)) {
             return -1;
         }
-        if (ccnl_ccnb_mkStrBlob(faceinst+len3, faceinst + sizeof(faceinst), CCN_DTAG_IPPROTO, CCN_TT_DTAG, "17", &len3)) {
+        if (ccnl_ccnb_mkStrBlob(faceinst+len3, faceinst + sizeof(faceinst), CCN_DTAG_IPPROTO, CCN_TT_DTAG, proto, &len3)) {
             return -1;
         }
     }
@@ -563,7 +565,7 @@ mkNewFaceRequest(uint8_t *out, size_t outlen, char *macsrc, char *ip4src, char *
         if (ccnl_ccnb_mkStrBlob(faceinst+len3, faceinst + sizeof(faceinst), CCNL_DTAG_IP6SRC, CCN_TT_DTAG, ip6src, &len3)) {
             return -1;
         }
-        if (ccnl_ccnb_mkStrBlob(faceinst+len3, faceinst + sizeof(faceinst), CCN_DTAG_IPPROTO, CCN_TT_DTAG, "17", &len3)) {
+        if (ccnl_ccnb_mkStrBlob(faceinst+len3, faceinst + sizeof(faceinst), CCN_DTAG_IPPROTO, CCN_TT_DTAG, proto, &len3)) {
             return -1;
         }
     }
@@ -1581,6 +1583,639 @@ check_has_next(uint8_t *buf, size_t len, char **recvbuffer, size_t *recvbufferle
     return ret;
 }
 
+// ----------------------------------------------------------------------
+// the binary management protocol, see ccnl-mgmt-bin.h
+
+#if defined(USE_MGMT) && defined(USE_SUITE_NDNTLV)
+
+struct bin_session_s {
+    int sock;
+    char *ux;
+    uint32_t reqid;
+    uint8_t ops[CCNL_MGMT_BIN_MAXREQ];
+    size_t opslen;
+    int nops;
+    int lineno[CCNL_MGMT_BIN_MAXREQ / 2];   // input line of each op
+    int done, failed;
+    long count;                             // COUNT of the last reply
+    char policy[32];                        // POLICY of the last reply
+};
+
+struct bin_route_s {
+    char *prefix;
+    int faceid, suite, lineno;
+};
+
+static const char*
+bin_status2str(int status)
+{
+    static const char *s[] = {
+        "ok", "malformed", "no such face", "no such FIB entry",
+        "failed", "unknown operation"
+    };
+
+    return status >= 0 && status <= CCNL_MGMT_BIN_EUNKNOWN ? s[status] : "?";
+}
+
+// sends the ops as one request and returns the content of the reply
+static int
+bin_exchange(struct bin_session_s *s, uint8_t *reply, size_t replylen,
+             uint8_t **content, size_t *contlen)
+{
+    uint8_t req[16], *cp = req, *data;
+    uint8_t tmp[CCNL_MAX_PACKET_SIZE];
+    struct ccnl_prefix_s *name;
+    struct ccnl_pkt_s *pkt;
+    size_t len = 0, offs = sizeof(tmp), vallen;
+    uint64_t typ;
+    ssize_t rc;
+    int enc, try;
+    char uri[] = "/ccnx";
+
+    s->reqid++;
+    if (ccnl_mgmt_bin_putInt(&cp, req + sizeof(req), CCNL_MGMT_BIN_REQID,
+                             s->reqid) ||
+        (size_t) (cp - req) + s->opslen > sizeof(s->ops)) {
+        return -1;
+    }
+    // the REQID goes in front of the ops
+    memmove(s->ops + (cp - req), s->ops, s->opslen);
+    memcpy(s->ops, req, (size_t) (cp - req));
+    s->opslen += (size_t) (cp - req);
+
+    name = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+    if (!name || ccnl_prefix_appendCmp(name, (uint8_t*) "", 0) ||
+        ccnl_prefix_appendCmp(name, (uint8_t*) CCNL_MGMT_BIN_CMD,
+                              strlen(CCNL_MGMT_BIN_CMD)) ||
+        ccnl_prefix_appendCmp(name, s->ops, s->opslen) ||
+        ccnl_mkInterest(name, NULL, tmp, tmp + sizeof(tmp), &len, &offs)) {
+        ccnl_prefix_free(name);
+        return -1;
+    }
+    ccnl_prefix_free(name);
+
+    if (ux_sendto2(s->sock, s->ux, tmp + offs, len) < 0) {
+        return -1;
+    }
+
+    // wait for the reply to this request, skip stale ones
+    for (try = 0; try < 100; try++) {
+        struct timeval tv = { 3, 0 };
+        fd_set fds;
+
+        FD_ZERO(&fds);
+        FD_SET(s->sock, &fds);
+        if (select(s->sock + 1, &fds, NULL, NULL, &tv) <= 0) {
+            DEBUGMSG(ERROR, "no reply from the relay\n");
+            return -1;
+        }
+        rc = recv(s->sock, reply, replylen, 0);
+        if (rc <= 0) {
+            return -1;
+        }
+        data = reply;
+        len = (size_t) rc;
+        while (!ccnl_switch_dehead(&data, &len, &enc));
+        cp = data;
+        if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen) ||
+            typ != NDN_TLV_Data) {
+            continue;
+        }
+        pkt = ccnl_ndntlv_bytes2pkt(typ, cp, &data, &len);
+        if (!pkt) {
+            continue;
+        }
+        // the packet has a copy of reply
+        *content = cp + (pkt->content - pkt->buf->data);
+        *contlen = pkt->contlen;
+        ccnl_pkt_free(pkt);
+
+        data = *content;
+        len = *contlen;
+        if (!ccnl_ndntlv_dehead(&data, &len, &typ, &vallen) &&
+            typ == CCNL_MGMT_BIN_REQID && vallen <= len &&
+            ccnl_ndntlv_nonNegInt(data, vallen) == s->reqid) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// sends the pending ops and reports those that failed
+static int
+bin_flush(struct bin_session_s *s)
+{
+    uint8_t reply[CCNL_MAX_PACKET_SIZE], *content, *data;
+    size_t contlen, vallen, k;
+    uint64_t typ;
+
+    if (!s->nops) {
+        return 0;
+    }
+    if (bin_exchange(s, reply, sizeof(reply), &content, &contlen)) {
+        return -1;
+    }
+    data = content;
+    while (contlen > 0) {
+        if (ccnl_ndntlv_dehead(&data, &contlen, &typ, &vallen) ||
+            vallen > contlen) {
+            return -1;
+        }
+        if (typ == CCNL_MGMT_BIN_STATUS) {
+            for (k = 0; k < vallen && k < (size_t) s->nops; k++) {
+                if (data[k] == CCNL_MGMT_BIN_OK) {
+                    continue;
+                }
+                if (s->lineno[k]) {
+                    fprintf(stderr, "line %d: ", s->lineno[k]);
+                }
+                fprintf(stderr, "%s\n", bin_status2str(data[k]));
+                s->failed++;
+            }
+        } else if (typ == CCNL_MGMT_BIN_COUNT) {
+            s->count = (long) ccnl_ndntlv_nonNegInt(data, vallen);
+        } else if (typ == CCNL_MGMT_BIN_POLICY && vallen < sizeof(s->policy)) {
+            memcpy(s->policy, data, vallen);
+            s->policy[vallen] = '\0';
+        }
+        data += vallen;
+        contlen -= vallen;
+    }
+    s->done += s->nops;
+    s->nops = 0;
+    s->opslen = 0;
+    return 0;
+}
+
+static int
+bin_add(struct bin_session_s *s, uint64_t op, uint8_t *args, size_t argslen,
+        int lineno)
+{
+    uint8_t *cp = s->ops + s->opslen;
+    // room for the REQID
+    uint8_t *end = s->ops + sizeof(s->ops) - 16;
+
+    if (ccnl_mgmt_bin_putTL(&cp, end, op, argslen) ||
+        s->nops >= (int) (sizeof(s->lineno) / sizeof(int))) {
+        if (!s->nops) {
+            fprintf(stderr, "line %d: too large\n", lineno);
+            return -1;
+        }
+        if (bin_flush(s)) {
+            return -1;
+        }
+        return bin_add(s, op, args, argslen, lineno);
+    }
+    if (argslen) {
+        memcpy(cp, args, argslen);
+    }
+    s->opslen = (size_t) (cp + argslen - s->ops);
+    s->lineno[s->nops++] = lineno;
+    return 0;
+}
+
+static int
+bin_addroute(struct bin_session_s *s, uint64_t op, char *prefix, int faceid,
+             int suite, int lineno)
+{
+    uint8_t args[CCNL_MAX_PREFIX_SIZE + 32], *cp = args;
+    uint8_t *end = args + sizeof(args);
+
+    if (ccnl_mgmt_bin_putBlob(&cp, end, CCNL_MGMT_BIN_PREFIX,
+                              prefix, strlen(prefix)) ||
+        ccnl_mgmt_bin_putInt(&cp, end, CCNL_MGMT_BIN_FACEID,
+                             (uint64_t) faceid) ||
+        ccnl_mgmt_bin_putInt(&cp, end, CCNL_MGMT_BIN_SUITE,
+                             (uint64_t) suite)) {
+        fprintf(stderr, "line %d: prefix too long\n", lineno);
+        return -1;
+    }
+    return bin_add(s, op, args, (size_t) (cp - args), lineno);
+}
+
+static uint8_t*
+bin_readfile(char *fname, size_t *len)
+{
+    struct stat st;
+    uint8_t *data;
+    int fd = open(fname, O_RDONLY);
+
+    if (fd < 0) {
+        perror(fname);
+        return NULL;
+    }
+    if (fstat(fd, &st) || st.st_size <= 0 ||
+        st.st_size > CCNL_MGMT_BIN_MAXREQ) {
+        close(fd);
+        return NULL;
+    }
+    data = malloc((size_t) st.st_size);
+    if (data && read(fd, data, (size_t) st.st_size) != st.st_size) {
+        free(data);
+        data = NULL;
+    }
+    close(fd);
+    *len = (size_t) st.st_size;
+    return data;
+}
+
+// lines of "prefixreg|prefixunreg PREFIX FACEID [SUITE]" and
+// "addContentToCache FILE", batched into as few requests as possible
+static int
+bin_bulk(struct bin_session_s *s, char *fname)
+{
+    char line[CCNL_MAX_PREFIX_SIZE + 64], *cmd, *a1, *a2, *a3;
+    uint8_t args[CCNL_MGMT_BIN_MAXREQ], *cp, *end = args + sizeof(args);
+    uint8_t *data;
+    size_t datalen;
+    FILE *f = strcmp(fname, "-") ? fopen(fname, "r") : stdin;
+    int lineno = 0, suite, rc = 0;
+
+    if (!f) {
+        perror(fname);
+        return -1;
+    }
+    while (!rc && fgets(line, sizeof(line), f)) {
+        lineno++;
+        cmd = strtok(line, " \t\r\n");
+        if (!cmd || cmd[0] == '#') {
+            continue;
+        }
+        a1 = strtok(NULL, " \t\r\n");
+        a2 = strtok(NULL, " \t\r\n");
+        a3 = strtok(NULL, " \t\r\n");
+        cp = args;
+        if ((!strcmp(cmd, "prefixreg") || !strcmp(cmd, "prefixunreg")) &&
+                                                                a1 && a2) {
+            suite = a3 ? ccnl_str2suite(a3) : CCNL_SUITE_NDNTLV;
+            if (!ccnl_isSuite(suite)) {
+                fprintf(stderr, "line %d: unknown suite %s\n", lineno, a3);
+                rc = -1;
+                break;
+            }
+            rc = bin_addroute(s, cmd[6] == 'r' ? CCNL_MGMT_BIN_PREFIXREG :
+                              CCNL_MGMT_BIN_PREFIXUNREG, a1,
+                              (int) strtol(a2, NULL, 0), suite, lineno);
+        } else if (!strcmp(cmd, "addContentToCache") && a1) {
+            data = bin_readfile(a1, &datalen);
+            if (!data) {
+                fprintf(stderr, "line %d: cannot read %s\n", lineno, a1);
+                rc = -1;
+                break;
+            }
+            rc = ccnl_mgmt_bin_putBlob(&cp, end, CCNL_MGMT_BIN_PACKET,
+                                       data, datalen);
+            free(data);
+            if (!rc) {
+                rc = bin_add(s, CCNL_MGMT_BIN_ADDCACHE, args,
+                             (size_t) (cp - args), lineno);
+            }
+        } else {
+            fprintf(stderr, "line %d: cannot parse\n", lineno);
+            rc = -1;
+        }
+    }
+    if (f != stdin) {
+        fclose(f);
+    }
+    if (!rc) {
+        rc = bin_flush(s);
+    }
+    fprintf(stderr, "%d operation(s), %d failed\n", s->done, s->failed);
+    return rc || s->failed ? -1 : 0;
+}
+
+static void
+bin_printrow(void *ctx, uint8_t *data, size_t len)
+{
+    static const char *names[] = {
+        "prefix", "faceid", "suite", "packet", "table", "start",
+        "ifndx", "peer", "flags", "count"
+    };
+    uint64_t typ, val;
+    size_t vallen;
+    const char *sep = "";
+    (void) ctx;
+
+    while (len > 0) {
+        if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen) || vallen > len) {
+            break;
+        }
+        if (typ == CCNL_MGMT_BIN_PREFIX || typ == CCNL_MGMT_BIN_PEER) {
+            printf("%s%s=%.*s", sep, names[typ - CCNL_MGMT_BIN_PREFIX],
+                   (int) vallen, (char*) data);
+        } else if (typ >= CCNL_MGMT_BIN_PREFIX && typ <= CCNL_MGMT_BIN_COUNT) {
+            val = ccnl_ndntlv_nonNegInt(data, vallen);
+            if (typ == CCNL_MGMT_BIN_SUITE) {
+                printf("%ssuite=%s", sep, ccnl_suite2str((int) val));
+            } else {
+                printf("%s%s=%llu", sep, names[typ - CCNL_MGMT_BIN_PREFIX],
+                       (unsigned long long) val);
+            }
+        }
+        sep = " ";
+        data += vallen;
+        len -= vallen;
+    }
+    printf("\n");
+}
+
+// passes all rows of a table to row(), one reply at a time
+static int
+bin_dump(struct bin_session_s *s, char *table,
+         void (*row)(void *ctx, uint8_t *data, size_t len), void *ctx)
+{
+    static const char *tables[] = { "fib", "faces", "ifs", "pit", "cs" };
+    uint8_t reply[CCNL_MAX_PACKET_SIZE], *content, *data, *cp;
+    size_t contlen, vallen;
+    uint64_t typ, start = 0;
+    int t, more;
+
+    for (t = 0; t < CCNL_MGMT_BIN_TABLES && strcmp(table, tables[t]); t++);
+    if (t == CCNL_MGMT_BIN_TABLES) {
+        fprintf(stderr, "unknown table %s\n", table);
+        return -1;
+    }
+    do {
+        uint8_t args[32];
+
+        cp = args;
+        ccnl_mgmt_bin_putInt(&cp, args + sizeof(args), CCNL_MGMT_BIN_TABLE,
+                             (uint64_t) t);
+        ccnl_mgmt_bin_putInt(&cp, args + sizeof(args), CCNL_MGMT_BIN_START,
+                             start);
+        if (bin_add(s, CCNL_MGMT_BIN_DUMP, args, (size_t) (cp - args), 0) ||
+            bin_exchange(s, reply, sizeof(reply), &content, &contlen)) {
+            return -1;
+        }
+        s->nops = 0;
+        s->opslen = 0;
+        more = 0;
+        data = content;
+        while (contlen > 0) {
+            if (ccnl_ndntlv_dehead(&data, &contlen, &typ, &vallen) ||
+                vallen > contlen) {
+                return -1;
+            }
+            if (typ == CCNL_MGMT_BIN_STATUS && vallen &&
+                                            data[0] != CCNL_MGMT_BIN_OK) {
+                fprintf(stderr, "%s\n", bin_status2str(data[0]));
+                return -1;
+            } else if (typ == CCNL_MGMT_BIN_ROW) {
+                row(ctx, data, vallen);
+            } else if (typ == CCNL_MGMT_BIN_NEXT) {
+                start = ccnl_ndntlv_nonNegInt(data, vallen);
+                more = 1;
+            }
+            data += vallen;
+            contlen -= vallen;
+        }
+    } while (more);
+    return 0;
+}
+
+struct bin_routes_s {
+    struct bin_route_s *r;
+    int cnt, size;
+};
+
+static int
+bin_routes_add(struct bin_routes_s *rt, char *prefix, int faceid, int suite,
+               int lineno)
+{
+    if (rt->cnt == rt->size) {
+        struct bin_route_s *r;
+
+        r = realloc(rt->r, (size_t) (rt->size ? 2 * rt->size : 1024) *
+                           sizeof(*r));
+        if (!r) {
+            return -1;
+        }
+        rt->r = r;
+        rt->size = rt->size ? 2 * rt->size : 1024;
+    }
+    rt->r[rt->cnt].prefix = strdup(prefix);
+    if (!rt->r[rt->cnt].prefix) {
+        return -1;
+    }
+    rt->r[rt->cnt].faceid = faceid;
+    rt->r[rt->cnt].suite = suite;
+    rt->r[rt->cnt].lineno = lineno;
+    rt->cnt++;
+    return 0;
+}
+
+static void
+bin_routes_free(struct bin_routes_s *rt)
+{
+    while (rt->cnt > 0) {
+        free(rt->r[--rt->cnt].prefix);
+    }
+    free(rt->r);
+    rt->r = NULL;
+    rt->size = 0;
+}
+
+// lines of "PREFIX FACEID [SUITE]"
+static int
+bin_routes_read(struct bin_routes_s *rt, char *fname)
+{
+    char line[CCNL_MAX_PREFIX_SIZE + 64], *pfx, *face, *suite;
+    FILE *f = strcmp(fname, "-") ? fopen(fname, "r") : stdin;
+    int lineno = 0, rc = 0, st;
+
+    if (!f) {
+        perror(fname);
+        return -1;
+    }
+    while (!rc && fgets(line, sizeof(line), f)) {
+        lineno++;
+        pfx = strtok(line, " \t\r\n");
+        if (!pfx || pfx[0] == '#') {
+            continue;
+        }
+        face = strtok(NULL, " \t\r\n");
+        suite = strtok(NULL, " \t\r\n");
+        st = suite ? ccnl_str2suite(suite) : CCNL_SUITE_NDNTLV;
+        if (!face || !ccnl_isSuite(st)) {
+            fprintf(stderr, "line %d: cannot parse\n", lineno);
+            rc = -1;
+            break;
+        }
+        rc = bin_routes_add(rt, pfx, (int) strtol(face, NULL, 0), st, lineno);
+    }
+    if (f != stdin) {
+        fclose(f);
+    }
+    return rc;
+}
+
+static void
+bin_routes_row(void *ctx, uint8_t *data, size_t len)
+{
+    char prefix[CCNL_MAX_PREFIX_SIZE];
+    int faceid = 0, suite = CCNL_SUITE_NDNTLV;
+    uint64_t typ;
+    size_t vallen;
+
+    prefix[0] = '\0';
+    while (len > 0) {
+        if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen) || vallen > len) {
+            return;
+        }
+        if (typ == CCNL_MGMT_BIN_PREFIX && vallen < sizeof(prefix)) {
+            memcpy(prefix, data, vallen);
+            prefix[vallen] = '\0';
+        } else if (typ == CCNL_MGMT_BIN_FACEID) {
+            faceid = (int) ccnl_ndntlv_nonNegInt(data, vallen);
+        } else if (typ == CCNL_MGMT_BIN_SUITE) {
+            suite = (int) ccnl_ndntlv_nonNegInt(data, vallen);
+        }
+        data += vallen;
+        len -= vallen;
+    }
+    if (prefix[0]) {
+        bin_routes_add((struct bin_routes_s*) ctx, prefix, faceid, suite, 0);
+    }
+}
+
+static int
+bin_routes_cmp(const void *a, const void *b)
+{
+    const struct bin_route_s *r1 = a, *r2 = b;
+    int rc = r1->suite - r2->suite;
+
+    if (!rc) {
+        rc = strcmp(r1->prefix, r2->prefix);
+    }
+    return rc ? rc : r1->lineno - r2->lineno;
+}
+
+// applies the staged routes with op, unless staging one of them failed
+static int
+bin_fibcommit(struct bin_session_s *s, int rc, uint64_t op)
+{
+    if (!rc) {
+        rc = bin_flush(s);
+    }
+    if (!rc) {
+        rc = bin_add(s, s->failed ? CCNL_MGMT_BIN_FIBABORT : op, NULL, 0, 0);
+    }
+    s->count = -1;
+    if (!rc) {
+        rc = bin_flush(s);
+    }
+    if (s->count >= 0) {
+        fprintf(stderr, "%ld FIB entries\n", s->count);
+    } else {
+        fprintf(stderr, "FIB not changed\n");
+    }
+    return rc;
+}
+
+// replaces the FIB with the routes of a file in one step
+static int
+bin_fibimport(struct bin_session_s *s, char *fname)
+{
+    struct bin_routes_s rt = { NULL, 0, 0 };
+    int k, rc;
+
+    rc = bin_routes_read(&rt, fname);
+    // start from an empty stage, and do not commit half of the routes
+    if (!rc) {
+        rc = bin_add(s, CCNL_MGMT_BIN_FIBABORT, NULL, 0, 0);
+    }
+    for (k = 0; !rc && k < rt.cnt; k++) {
+        rc = bin_addroute(s, CCNL_MGMT_BIN_FIBSTAGE, rt.r[k].prefix,
+                          rt.r[k].faceid, rt.r[k].suite, rt.r[k].lineno);
+    }
+    rc = bin_fibcommit(s, rc, CCNL_MGMT_BIN_FIBCOMMIT);
+    bin_routes_free(&rt);
+    return rc || s->failed ? -1 : 0;
+}
+
+// brings the FIB to the routes of a file, with as few changes as possible
+static int
+bin_fibdiff(struct bin_session_s *s, char *fname)
+{
+    struct bin_routes_s want = { NULL, 0, 0 }, have = { NULL, 0, 0 };
+    struct bin_route_s *w, *h;
+    int i = 0, j = 0, cmp, reg = 0, unreg = 0, rc;
+
+    rc = bin_routes_read(&want, fname);
+    if (!rc) {
+        rc = bin_dump(s, "fib", bin_routes_row, &have);
+    }
+    qsort(want.r, (size_t) want.cnt, sizeof(*want.r), bin_routes_cmp);
+    qsort(have.r, (size_t) have.cnt, sizeof(*have.r), bin_routes_cmp);
+    if (!rc) {
+        rc = bin_add(s, CCNL_MGMT_BIN_FIBABORT, NULL, 0, 0);
+    }
+
+    while (!rc && (i < want.cnt || j < have.cnt)) {
+        // of several lines for a prefix the last one counts
+        while (i + 1 < want.cnt && want.r[i].suite == want.r[i+1].suite &&
+               !strcmp(want.r[i].prefix, want.r[i+1].prefix)) {
+            i++;
+        }
+        w = i < want.cnt ? want.r + i : NULL;
+        h = j < have.cnt ? have.r + j : NULL;
+        if (!w) {
+            cmp = 1;
+        } else if (!h) {
+            cmp = -1;
+        } else {
+            cmp = w->suite != h->suite ? w->suite - h->suite :
+                                         strcmp(w->prefix, h->prefix);
+        }
+        if (cmp > 0) {
+            rc = bin_addroute(s, CCNL_MGMT_BIN_FIBSTAGERM, h->prefix,
+                              h->faceid, h->suite, 0);
+            unreg++;
+            j++;
+            continue;
+        }
+        if (cmp < 0 || w->faceid != h->faceid) {
+            rc = bin_addroute(s, CCNL_MGMT_BIN_FIBSTAGE, w->prefix,
+                              w->faceid, w->suite, w->lineno);
+            reg++;
+        }
+        i++;
+        if (!cmp) {
+            j++;
+        }
+    }
+    // a merge touches only the staged prefixes
+    rc = bin_fibcommit(s, rc, CCNL_MGMT_BIN_FIBMERGE);
+    bin_routes_free(&want);
+    bin_routes_free(&have);
+    fprintf(stderr, "%d added or changed, %d removed, %d failed\n",
+            reg, unreg, s->failed);
+    return rc || s->failed ? -1 : 0;
+}
+
+// selects the admission policy of the content store, prints the one in use
+static int
+bin_admission(struct bin_session_s *s, char *policy)
+{
+    uint8_t args[64], *cp = args;
+
+    if (policy && ccnl_mgmt_bin_putBlob(&cp, args + sizeof(args),
+                                        CCNL_MGMT_BIN_POLICY,
+                                        policy, strlen(policy))) {
+        fprintf(stderr, "policy too long\n");
+        return -1;
+    }
+    if (bin_add(s, CCNL_MGMT_BIN_ADMISSION, args, (size_t) (cp - args), 0) ||
+        bin_flush(s) || s->failed) {
+        return -1;
+    }
+    printf("%s\n", s->policy);
+    return 0;
+}
+
+#endif // USE_MGMT && USE_SUITE_NDNTLV
+
 int
 main(int argc, char *argv[])
 {
@@ -1664,6 +2299,7 @@ help:
        "  newWPANface   WPAN_ADDR WPAN_PANID [FACEFLAGS]\n"
        "  newUDP6face   IP6SRC|any IP6DST PORT [FACEFLAGS]\n"
        "  newUNIXface   PATH [FACEFLAGS]\n"
+       "  newTCPface    tcp://IP4DST:PORT|tcp://[IP6DST]:PORT [FACEFLAGS]\n"
        "  destroyface   FACEID\n"
        "  prefixreg     PREFIX FACEID [SUITE]\n"
        "  prefixunreg   PREFIX FACEID [SUITE]\n"
@@ -1673,9 +2309,21 @@ help:
        "  debug         dump\n"
        "  debug         halt\n"
        "  debug         dump+halt\n"
+       "  debug         snapshot\n"
+       "  debug         histo\n"
        "  addContentToCache             ccn-file\n"
        "  removeContentFromCache        ccn-path\n"
-       "where FRAG in one of (none, seqd2012, ccnx2013)\n"
+#if defined(USE_MGMT) && defined(USE_SUITE_NDNTLV)
+       "  bulk          FILE|-         (lines of prefixreg, prefixunreg\n"
+       "                               and addContentToCache)\n"
+       "  dump          fib|faces|ifs|pit|cs\n"
+       "  fibimport     FILE|-         (lines of PREFIX FACEID [SUITE],\n"
+       "                               replace the FIB at once)\n"
+       "  fibdiff       FILE|-         (same, apply only the changes)\n"
+       "  admission     [POLICY]       (of the CS: all, prob:P, second,\n"
+       "                               tinylfu)\n"
+#endif
+       "where FRAG in one of (none, seqd2012, ccnx2013, be2015)\n"
        "      SUITE is one of (ccnb, ccnx2015, ndn2013)\n"
        "-m is a special mode which only prints the interest message of the corresponding command\n",
                     argv[0]);
@@ -1761,17 +2409,46 @@ help:
                        !strcmp(argv[1], "newETHface") ? argv[2] : NULL,
                        !strcmp(argv[1], "newUDPface") ? argv[2] : NULL,
                        !strcmp(argv[1], "newUDP6face") ? argv[2] : NULL,
-                       NULL, NULL,
+                       "17", NULL, NULL,
                        argv[3], argv[4],
                        argc > 5 ? argv[5] : "0x0001", private_key_path, &len)) {
             goto Bail;
         }
+    } else if (!strcmp(argv[1], "newTCPface")) {
+        char *host, *port;
+        int ip6;
+
+        if (argc < 3 || strncmp(argv[2], "tcp://", 6)) {
+            goto help;
+        }
+        host = argv[2] + 6;
+        ip6 = host[0] == '[';
+        if (ip6) {
+            // tcp://[IP6DST]:PORT
+            port = strchr(++host, ']');
+            if (!port || port[1] != ':') {
+                goto help;
+            }
+            *port++ = '\0';
+        } else {
+            port = strrchr(host, ':');
+            if (!port) {
+                goto help;
+            }
+        }
+        *port++ = '\0';
+        if (mkNewFaceRequest(out, sizeof(out), NULL,
+                       ip6 ? NULL : "any", ip6 ? "any" : NULL, "6",
+                       NULL, NULL, host, port,
+                       argc > 3 ? argv[3] : "0x0001", private_key_path, &len)) {
+            goto Bail;
+        }
     } else if (!strcmp(argv[1], "newWPANface")) {
         if (argc < 4) {
             goto help;
         }
         if (mkNewFaceRequest(out, sizeof(out),
-                NULL, NULL, NULL, argv[2], argv[3], NULL, NULL, argc > 5 ? argv[5] : "0x0001", private_key_path,
+                NULL, NULL, NULL, NULL, argv[2], argv[3], NULL, NULL, argc > 5 ? argv[5] : "0x0001", private_key_path,
                 &len)) {
             goto Bail;
         }
@@ -1836,6 +2513,39 @@ help:
         if (mkRemoveFormRelayCacheRequest(out, sizeof(out), ccn_path, private_key_path, &len)) {
             goto Bail;
         }
+#if defined(USE_MGMT) && defined(USE_SUITE_NDNTLV)
+    } else if (!strcmp(argv[1], "bulk") || !strcmp(argv[1], "dump") ||
+               !strcmp(argv[1], "fibimport") || !strcmp(argv[1], "fibdiff") ||
+               !strcmp(argv[1], "admission")) {
+        struct bin_session_s *s;
+
+        if ((argc < 3 && strcmp(argv[1], "admission")) || msgOnly || use_udp) {
+            goto help;
+        }
+        s = calloc(1, sizeof(*s));
+        if (!s) {
+            goto Bail;
+        }
+        snprintf(mysockname, sizeof(mysockname),
+                 "/tmp/.ccn-light-ctrl-%d.sock", getpid());
+        sock = ccnl_crypto_ux_open(mysockname);
+        srand((unsigned int) (time(NULL) ^ getpid()));
+        s->sock = sock;
+        s->ux = ux;
+        if (!strcmp(argv[1], "bulk")) {
+            ret = bin_bulk(s, argv[2]);
+        } else if (!strcmp(argv[1], "dump")) {
+            ret = bin_dump(s, argv[2], bin_printrow, NULL);
+        } else if (!strcmp(argv[1], "fibimport")) {
+            ret = bin_fibimport(s, argv[2]);
+        } else if (!strcmp(argv[1], "admission")) {
+            ret = bin_admission(s, argc < 3 ? NULL : argv[2]);
+        } else {
+            ret = bin_fibdiff(s, argv[2]);
+        }
+        free(s);
+        goto Bail;
+#endif
     } else{
         DEBUGMSG(ERROR, "unknown command %s\n", argv[1]);
         goto help;
@@ -0,0 +1,152 @@
+/*
+ * @f util/ccn-lite-mkseg.c
+ * @b CLI mkseg, pack content objects into a content segment file
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#include "ccnl-common.h"
+#include "ccnl-unix.h"
+#include "ccnl-segment.h"
+
+static int packed, skipped;
+
+// add one file holding a single content object
+static int
+add_file(struct ccnl_segment_writer_s *w, char *fname)
+{
+    struct stat st;
+    uint8_t *buf;
+    ssize_t len;
+    int fd, rc = -1;
+
+    fd = open(fname, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) || st.st_size <= 0) {
+        DEBUGMSG(WARNING, "could not read %s\n", fname);
+        goto Done;
+    }
+    buf = ccnl_malloc((size_t) st.st_size);
+    if (!buf) {
+        goto Done;
+    }
+    len = read(fd, buf, (size_t) st.st_size);
+    if (len == st.st_size && !ccnl_segment_writer_add(w, buf, (size_t) len)) {
+        DEBUGMSG(DEBUG, "added %s, %zd bytes\n", fname, len);
+        rc = 0;
+    } else {
+        DEBUGMSG(WARNING, "%s is not a content object, skipped\n", fname);
+    }
+    ccnl_free(buf);
+
+Done:
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (rc) {
+        skipped++;
+    } else {
+        packed++;
+    }
+    return rc;
+}
+
+int
+main(int argc, char *argv[])
+{
+    struct ccnl_segment_writer_s *w;
+    struct dirent **names;
+    struct stat st;
+    char *outfname = NULL, fname[1024];
+    int opt, i, j, n;
+
+    while ((opt = getopt(argc, argv, "ho:v:")) != -1) {
+        switch (opt) {
+        case 'o':
+            outfname = optarg;
+            break;
+        case 'v':
+#ifdef USE_LOGGING
+            if (isdigit(optarg[0]))
+                debug_level = (int)strtol(optarg, (char**)NULL, 10);
+            else
+                debug_level = ccnl_debug_str2level(optarg);
+#endif
+            break;
+        case 'h':
+        default:
+Usage:
+            fprintf(stderr,
+            "Packs content objects (e.g. a chunk directory written by ccn-lite-produce -o)\n"
+            "into a content segment file for ccn-lite-relay -d.\n"
+            "usage: %s [options] -o SEGFILE (DIR | FILE)...\n"
+            "  -o SEGFILE       segment file to create\n"
+#ifdef USE_LOGGING
+            "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
+#endif
+            , argv[0]);
+            exit(1);
+        }
+    }
+
+    if (!outfname || optind >= argc) {
+        goto Usage;
+    }
+
+    w = ccnl_segment_writer_open(outfname);
+    if (!w) {
+        exit(1);
+    }
+
+    for (i = optind; i < argc; i++) {
+        if (stat(argv[i], &st)) {
+            DEBUGMSG(ERROR, "could not stat %s\n", argv[i]);
+            continue;
+        }
+        if (!S_ISDIR(st.st_mode)) {
+            add_file(w, argv[i]);
+            continue;
+        }
+        // sorted, so that packing the same directory twice gives the same file
+        n = scandir(argv[i], &names, NULL, alphasort);
+        if (n < 0) {
+            DEBUGMSG(ERROR, "could not open directory %s\n", argv[i]);
+            continue;
+        }
+        for (j = 0; j < n; j++) {
+            if (names[j]->d_name[0] != '.') {
+                snprintf(fname, sizeof(fname), "%s/%s", argv[i], names[j]->d_name);
+                if (!stat(fname, &st) && S_ISREG(st.st_mode)) {
+                    add_file(w, fname);
+                }
+            }
+            free(names[j]);
+        }
+        free(names);
+    }
+
+    if (ccnl_segment_writer_close(w)) {
+        DEBUGMSG(ERROR, "could not write %s\n", outfname);
+        exit(1);
+    }
+    DEBUGMSG(INFO, "%d content objects packed into %s, %d files skipped\n",
+             packed, outfname, skipped);
+
+    return 0;
+}
+
+// eof
@@ -32,15 +32,15 @@
 unsigned char out[8*CCNL_MAX_PACKET_SIZE];
 int outlen;
 
-int
+int8_t
 frag_cb(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
-        unsigned char **data, int *len)
+        uint8_t **data, size_t *len)
 {
     (void)relay;
     (void)from;
     DEBUGMSG(INFO, "frag_cb\n");
 
-    memcpy(out, *data, *len);
+    memmove(out, *data, *len);
     outlen = *len;
     return 0;
 }
@@ -55,9 +55,6 @@ main(int argc, char *argv[])
     float wait = 3.0;
     unsigned int chunknum = UINT_MAX;
     struct ccnl_buf_s *buf = NULL;
-#ifdef USE_FRAG
-    ccnl_isFragmentFunc isFragment;
-#endif
 
     while ((opt = getopt(argc, argv, "hn:s:u:v:w:x:")) != -1) {
         switch (opt) {
@@ -122,10 +119,6 @@ usage:
     }
     DEBUGMSG(TRACE, "using udp address %s/%d\n", addr, port);
 
-#ifdef USE_FRAG
-    isFragment = ccnl_suite2isFragmentFunc(suite);
-#endif
-
     if (ux) { // use UNIX socket
         struct sockaddr_un *su = (struct sockaddr_un*) &sa;
         su->sun_family = AF_UNIX;
@@ -214,17 +207,17 @@ usage:
             }
 
 #ifdef USE_FRAG
-            if (isFragment && isFragment(cp, len2)) {
-                int t;
-                int len3;
-                DEBUGMSG(DEBUG, "  fragment, %d bytes\n", len2);
+            if (ccnl_isFragment(cp, len2, suite) > 0) {
+                uint16_t t;
+                size_t len3;
+                DEBUGMSG(DEBUG, "  fragment, %zu bytes\n", len2);
                 switch(suite) {
                 case CCNL_SUITE_CCNTLV: {
                     struct ccnx_tlvhdr_ccnx2015_s *hp;
                     hp = (struct ccnx_tlvhdr_ccnx2015_s *) out;
                     cp = out + sizeof(*hp);
                     len2 -= sizeof(*hp);
-                    if (ccnl_ccntlv_dehead(&cp, &len2, (unsigned*)&t, (unsigned*) &len3) < 0 ||
+                    if (ccnl_ccntlv_dehead(&cp, &len2, &t, &len3) < 0 ||
                         t != CCNX_TLV_TL_Fragment) {
                         DEBUGMSG(ERROR, "  error parsing fragment\n");
                         continue;
@@ -235,10 +228,11 @@ usage:
                                       ntohs(*(uint16_t*) hp->fill) & 0x03fff,
                                       &cp, (int*) &len2);
                     */
+                    outlen = 0;
                     rc = ccnl_frag_RX_BeginEnd2015(frag_cb, NULL, &dummyFace,
                                       4096, hp->fill[0] >> 6,
                                       ntohs(*(uint16_t*) hp->fill) & 0x03fff,
-                                      &cp, (int*) &len3);
+                                      &cp, &len3);
                     break;
                 }
                 default:
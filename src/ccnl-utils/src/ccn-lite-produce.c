@@ -22,33 +22,258 @@
 
 
 #define CCNL_MAX_CHUNK_SIZE 4048
+// number of chunks each worker gets per window, bounds the memory
+// kept for in-order writing to stdout or a packed file
+#define CCNL_PRODUCE_WINDOW 64
 
 #include "ccnl-common.h"
 #include "ccnl-crypto.h"
+#include "ccnl-ext-hmac.h"
+#include "ccnl-segment.h"
+
+#include <pthread.h>
+#include <sys/mman.h>
+
+struct produce_ctx_s {
+    uint8_t *data;              // the (mapped) input
+    size_t datalen;
+    size_t chunk_size;
+    uint32_t lastchunknum;
+    int suite;
+    char *url;
+    struct ccnl_hmac256_key_s *key; // NULL for unsigned content
+    char *outdirname, *outfname, *fileext;
+
+    // current window, protected by lock
+    uint32_t wbase, wcnt, wnext;
+    uint32_t wgen;              // bumped for each new window
+    int busy;                   // pool threads still working on the window
+    int quit;
+    int err;
+    uint8_t *slots;             // wcnt * CCNL_MAX_PACKET_SIZE bytes
+    size_t *slotoffs, *slotlen;
+
+    // guards the window, busy, quit and err: a worker claims a chunk by
+    // taking wnext under it
+    pthread_mutex_t lock;
+    pthread_cond_t cond;        // a new window, or the pool is done with it
+};
+
+struct produce_worker_s {
+    pthread_t tid;
+    struct produce_ctx_s *ctx;
+    struct ccnl_prefix_s *name; // reused for every chunk, only the
+                                // chunk number changes
+};
+
+static int
+produce_write_all(int fd, uint8_t *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= (size_t) n;
+    }
+    return 0;
+}
+
+static int
+produce_chunk(struct produce_ctx_s *ctx, struct ccnl_prefix_s *name,
+              uint32_t chunknum, uint8_t *out, size_t *offs, size_t *len)
+{
+    size_t pos = (size_t) chunknum * ctx->chunk_size;
+    size_t chunk_len = ctx->datalen - pos;
+    ccnl_data_opts_u data_opts;
+
+    if (chunk_len > ctx->chunk_size) {
+        chunk_len = ctx->chunk_size;
+    }
+    *name->chunknum = chunknum;
+    *offs = CCNL_MAX_PACKET_SIZE;
+
+    switch (ctx->suite) {
+    case CCNL_SUITE_CCNTLV:
+        if (ctx->key) {
+            return ccnl_ccntlv_prependSignedContentWithHdrKey(name,
+                           ctx->data + pos, chunk_len, &ctx->lastchunknum,
+                           NULL, ctx->key, offs, out, len);
+        }
+        return ccnl_ccntlv_prependContentWithHdr(name, ctx->data + pos,
+                           chunk_len, &ctx->lastchunknum, NULL, offs, out, len);
+    case CCNL_SUITE_NDNTLV:
+        if (ctx->key) {
+            return ccnl_ndntlv_prependSignedContentKey(name, ctx->data + pos,
+                           chunk_len, &ctx->lastchunknum, NULL,
+                           ctx->key, offs, out, len);
+        }
+        memset(&data_opts, 0, sizeof(data_opts));
+        data_opts.ndntlv.finalblockid = ctx->lastchunknum;
+        return ccnl_ndntlv_prependContent(name, ctx->data + pos, chunk_len,
+                           NULL, &(data_opts.ndntlv), offs, out, len);
+    default:
+        DEBUGMSG(ERROR, "produce for suite %i is not implemented\n", ctx->suite);
+        return -1;
+    }
+}
+
+// builds chunks of the current window until none are left
+static void
+produce_window(struct produce_worker_s *w)
+{
+    struct produce_ctx_s *ctx = w->ctx;
+    char outpathname[255];
+    uint8_t *out;
+    uint32_t i, chunknum;
+    int fout;
+
+    for (;;) {
+        pthread_mutex_lock(&ctx->lock);
+        if (ctx->err || ctx->wnext >= ctx->wcnt) {
+            pthread_mutex_unlock(&ctx->lock);
+            break;
+        }
+        i = ctx->wnext++;
+        pthread_mutex_unlock(&ctx->lock);
+
+        chunknum = ctx->wbase + i;
+        out = ctx->slots + (size_t) i * CCNL_MAX_PACKET_SIZE;
+        if (produce_chunk(ctx, w->name, chunknum, out,
+                          ctx->slotoffs + i, ctx->slotlen + i)) {
+            DEBUGMSG(ERROR, "could not build chunk %u\n", chunknum);
+            goto Error;
+        }
+        if (!ctx->outdirname) {
+            // written in chunk order by the main thread
+            continue;
+        }
+
+        snprintf(outpathname, sizeof(outpathname), "%s/%s%u.%s",
+                 ctx->outdirname, ctx->outfname, chunknum, ctx->fileext);
+        DEBUGMSG(INFO, "writing chunk %u to file %s\n", chunknum, outpathname);
+        fout = creat(outpathname, 0666);
+        if (fout < 0 || produce_write_all(fout, out + ctx->slotoffs[i],
+                                          ctx->slotlen[i])) {
+            DEBUGMSG(ERROR, "could not write %s: %d\n", outpathname, errno);
+            if (fout >= 0) {
+                close(fout);
+            }
+            goto Error;
+        }
+        close(fout);
+    }
+    return;
+
+Error:
+    pthread_mutex_lock(&ctx->lock);
+    ctx->err = 1;
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+// a pool thread: takes part in every window until told to quit
+static void*
+produce_worker(void *arg)
+{
+    struct produce_worker_s *w = (struct produce_worker_s *) arg;
+    struct produce_ctx_s *ctx = w->ctx;
+    uint32_t gen = 0;
+
+    pthread_mutex_lock(&ctx->lock);
+    for (;;) {
+        while (!ctx->quit && ctx->wgen == gen) {
+            pthread_cond_wait(&ctx->cond, &ctx->lock);
+        }
+        if (ctx->quit) {
+            break;
+        }
+        gen = ctx->wgen;
+        pthread_mutex_unlock(&ctx->lock);
+
+        produce_window(w);
+
+        pthread_mutex_lock(&ctx->lock);
+        if (--ctx->busy == 0) {
+            pthread_cond_broadcast(&ctx->cond);
+        }
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    return NULL;
+}
+
+// reads all of fd into a ccnl_malloc'ed buffer, used when the input
+// cannot be mapped (stdin, pipes)
+static uint8_t*
+produce_read_all(int fd, size_t *len)
+{
+    size_t size = 64 * 1024, used = 0;
+    uint8_t *buf = ccnl_malloc(size), *tmp;
+    ssize_t n;
+
+    while (buf) {
+        if (used == size) {
+            tmp = ccnl_malloc(2 * size);
+            if (tmp) {
+                memcpy(tmp, buf, used);
+            }
+            ccnl_free(buf);
+            buf = tmp;
+            size *= 2;
+            continue;
+        }
+        n = read(fd, buf + used, size - used);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            ccnl_free(buf);
+            return NULL;
+        }
+        if (n == 0) {
+            break;
+        }
+        used += (size_t) n;
+    }
+    *len = used;
+    return buf;
+}
 
 int
 main(int argc, char *argv[])
 {
-    // char *private_key_path = 0;
-    //    char *witness = 0;
-    uint8_t out[65*1024];
+    struct produce_ctx_s ctx;
+    struct produce_worker_s *workers = NULL;
+    struct key_s *keys = NULL;
+    struct ccnl_segment_writer_s *seg = NULL;
+    uint8_t keyval[64];
+    struct ccnl_hmac256_key_s key;
     char *publisher = 0;
-    char *infname = 0, *outdirname = 0, *outfname = 0;
-    size_t contentlen = 0, plen;
-    int f, fout, opt;
-    //    int suite = CCNL_SUITE_DEFAULT;
+    char *infname = 0, *outdirname = 0, *outfname = 0, *packfname = 0;
+    size_t plen, window, chunkcnt_s;
+    int f = -1, opt, mapped = 0, rc = -1;
     int suite = CCNL_SUITE_CCNTLV;
-    size_t chunk_size = CCNL_MAX_CHUNK_SIZE;
-    struct ccnl_prefix_s *name;
-    ccnl_data_opts_u data_opts;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN), t, started = 0;
+    uint32_t chunkcnt, zero = 0, i;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.chunk_size = CCNL_MAX_CHUNK_SIZE;
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.cond, NULL);
 
-    while ((opt = getopt(argc, argv, "hc:f:i:o:p:k:w:s:v:")) != -1) {
+    while ((opt = getopt(argc, argv, "hc:f:i:j:k:o:O:p:s:v:")) != -1) {
         switch (opt) {
         case 'c':
-            chunk_size = (size_t) strtol(optarg, (char **) NULL, 10);
-            if (chunk_size > CCNL_MAX_CHUNK_SIZE) {
-                DEBUGMSG(WARNING, "max chunk size is %d (%zu is to large), using max chunk size\n", CCNL_MAX_CHUNK_SIZE, chunk_size);
-                chunk_size = CCNL_MAX_CHUNK_SIZE;
+            ctx.chunk_size = (size_t) strtol(optarg, (char **) NULL, 10);
+            if (ctx.chunk_size > CCNL_MAX_CHUNK_SIZE) {
+                DEBUGMSG(WARNING, "max chunk size is %d (%zu is to large), using max chunk size\n", CCNL_MAX_CHUNK_SIZE, ctx.chunk_size);
+                ctx.chunk_size = CCNL_MAX_CHUNK_SIZE;
+            }
+            if (ctx.chunk_size == 0) {
+                goto Usage;
             }
             break;
         case 'f':
@@ -57,17 +282,22 @@ main(int argc, char *argv[])
         case 'i':
             infname = optarg;
             break;
-        case 'o':
-            outdirname = optarg;
+        case 'j':
+            threads = strtol(optarg, (char **) NULL, 10);
             break;
-/*
         case 'k':
-            private_key_path = optarg;
+            keys = load_keys_from_file(optarg);
+            if (!keys) {
+                DEBUGMSG(ERROR, "could not load key from %s\n", optarg);
+                exit(-1);
+            }
+            break;
+        case 'o':
+            outdirname = optarg;
             break;
-        case 'w':
-            witness = optarg;
+        case 'O':
+            packfname = optarg;
             break;
-*/
         case 'p':
             publisher = optarg;
             plen = unescape_component(publisher);
@@ -97,9 +327,12 @@ Usage:
         "  -c SIZE          size for each chunk (max %d)\n"
         "  -f FNAME         filename of the chunks when using -o\n"
         "  -i FNAME         input file (instead of stdin)\n"
+        "  -j THREADS       number of producer threads (default: online CPUs)\n"
+        "  -k FNAME         HMAC256 key (base64 encoded) to sign the chunks\n"
         "  -o DIR           output dir (instead of stdout), filename default is cN, otherwise specify -f\n"
+        "  -O FNAME         write all chunks to a content segment file (see ccn-lite-mkseg)\n"
         "  -p DIGEST        publisher fingerprint\n"
-        "  -s SUITE         (ccnb, ccnx2015, ndn2013)\n"
+        "  -s SUITE         (ccnx2015, ndn2013)\n"
 #ifdef USE_LOGGING
         "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
 #endif
@@ -118,68 +351,75 @@ Usage:
     if (!argv[optind]) {
         goto Usage;
     }
-
-    char *url_orig = argv[optind];
-    char url[strlen(url_orig)];
+    ctx.url = argv[optind];
+    ctx.suite = suite;
     optind++;
 
+    if (outdirname && packfname) {
+        DEBUGMSG(ERROR, "-o and -O are mutually exclusive\n");
+        goto Usage;
+    }
+
     int status;
     struct stat st_buf;
     if (outdirname) {
         // Check if outdirname is a directory and open it as a file
         status = stat(outdirname, &st_buf);
         if (status != 0) {
-            // DEBUGMSG (ERROR, "Error (%d) when opening file %s\n", errno, outdirname);
             DEBUGMSG(ERROR, "Error (%d) when opening output dir %s (probaby does not exist)\n", errno, outdirname);
             goto Usage;
         }
         if (S_ISREG (st_buf.st_mode)) {
-            // DEBUGMSG (ERROR, "Error: %s is a file and not a directory.\n", argv[optind]);
             DEBUGMSG(ERROR, "Error: output dir %s is a file and not a directory.\n", outdirname);
             goto Usage;
         }
     }
     if (infname) {
-        // Check if outdirname is a directory and open it as a file
         status = stat(infname, &st_buf);
         if (status != 0) {
-            // DEBUGMSG (ERROR, "Error (%d) when opening file %s\n", errno, outdirname);
             DEBUGMSG(ERROR, "Error (%d) when opening input file %s (probaby does not exist)\n", errno, infname);
             goto Usage;
         }
         if (S_ISDIR (st_buf.st_mode)) {
-            // DEBUGMSG (ERROR, "Error: %s is a file and not a directory.\n", argv[optind]);
             DEBUGMSG(ERROR, "Error: input file %s is a directory and not a file.\n", infname);
             goto Usage;
         }
         f = open(infname, O_RDONLY);
         if (f < 0) {
             perror("file open:");
+            exit(1);
         }
     } else {
         f = 0;
     }
 
+    // map regular files, slurp everything else (stdin, pipes)
+    if (infname && S_ISREG(st_buf.st_mode) && st_buf.st_size > 0) {
+        ctx.datalen = (size_t) st_buf.st_size;
+        ctx.data = mmap(NULL, ctx.datalen, PROT_READ, MAP_PRIVATE, f, 0);
+        if (ctx.data == MAP_FAILED) {
+            DEBUGMSG(ERROR, "Error mapping input file; error: %d\n", errno);
+            goto Done;
+        }
+        posix_madvise(ctx.data, ctx.datalen, POSIX_MADV_SEQUENTIAL);
+        mapped = 1;
+    } else {
+        ctx.data = produce_read_all(f, &ctx.datalen);
+        if (!ctx.data) {
+            DEBUGMSG(ERROR, "Error reading input file; error: %d\n", errno);
+            goto Done;
+        }
+    }
+
     char default_file_name[2] = "c";
     if (!outfname) {
         outfname = default_file_name;
     } else if(!outdirname) {
         DEBUGMSG(WARNING, "filename -f without -o output dir does nothing\n");
     }
+    ctx.outdirname = outdirname;
+    ctx.outfname = outfname;
 
-    uint8_t *chunk_buf;
-    chunk_buf = ccnl_malloc(chunk_size * sizeof(uint8_t));
-    if (!chunk_buf) {
-        DEBUGMSG(ERROR, "Error: Failed to allocate memory\n");
-        exit(1);
-    }
-    size_t chunk_len;
-    ssize_t s_chunk_len;
-    int8_t is_last = 0;
-    size_t offs;
-    uint32_t chunknum = 0;
-
-    char outpathname[255];
     char fileext[10];
     switch (suite) {
         case CCNL_SUITE_CCNB:
@@ -193,106 +433,170 @@ Usage:
             break;
         default:
             DEBUGMSG(ERROR, "fileext for suite %d not implemented\n", suite);
+            fileext[0] = '\0';
     }
+    ctx.fileext = fileext;
 
-    
-    FILE *fp = fopen(infname, "r");
-    fseek(fp, 0L, SEEK_END);
-    long sz = ftell(fp);
-    size_t isz;
-    if (sz < 0) {
-        DEBUGMSG(ERROR, "Error reading input file offset; error: %d\n", errno);
-        exit(1);
+    if (keys) {
+        if (keys->keylen < 0) {
+            DEBUGMSG(ERROR, "Error: Invalid key length: %d", keys->keylen);
+            goto Done;
+        }
+        // the key blocks are hashed once, not for every chunk
+        ccnl_hmac256_keyval(keys->key, (size_t) keys->keylen, keyval);
+        ccnl_hmac256_key_init(&key, keyval, sizeof(keyval));
+        ctx.key = &key;
     }
-    if ((unsigned long) sz > SIZE_MAX) {
-        DEBUGMSG(ERROR, "Input file offset exceeds bounds: %ld", sz);
-        exit(1);
+
+    chunkcnt_s = (ctx.datalen + ctx.chunk_size - 1) / ctx.chunk_size;
+    if (chunkcnt_s > UINT32_MAX) {
+        DEBUGMSG(ERROR, "lastchunknum exceeds bounds: %zu", chunkcnt_s);
+        goto Done;
     }
-    isz = (size_t) sz;
-    rewind(fp);
-    fclose(fp);
+    chunkcnt = (uint32_t) chunkcnt_s;
+    if (chunkcnt == 0) {
+        rc = 0;
+        goto Done;
+    }
+    ctx.lastchunknum = chunkcnt - 1;
 
-    size_t lastchunknum_s = (isz / chunk_size);
-    if (lastchunknum_s > UINT32_MAX) {
-        DEBUGMSG(ERROR, "lastchunknum exceeds bounds: %zu", lastchunknum_s);
-        exit(1);
+    if (packfname) {
+        seg = ccnl_segment_writer_open(packfname);
+        if (!seg) {
+            goto Done;
+        }
+    }
+
+    if (threads < 1) {
+        threads = 1;
+    }
+    if ((unsigned long) threads > chunkcnt) {
+        threads = (long) chunkcnt;
     }
-    uint32_t lastchunknum = (uint32_t) lastchunknum_s;
-    if (sz % chunk_size == 0) {
-        --lastchunknum;
+    window = (size_t) threads * CCNL_PRODUCE_WINDOW;
+    if (window > chunkcnt) {
+        window = chunkcnt;
     }
+    DEBUGMSG(INFO, "producing %u chunks with %ld threads\n", chunkcnt, threads);
 
-    s_chunk_len = read(f, chunk_buf, chunk_size);
-    if (s_chunk_len < 0) {
-        DEBUGMSG(ERROR, "Error reading input file; error: %d\n", errno);
-        exit(1);
+    ctx.slots = ccnl_malloc(window * CCNL_MAX_PACKET_SIZE);
+    ctx.slotoffs = ccnl_malloc(window * sizeof(size_t));
+    ctx.slotlen = ccnl_malloc(window * sizeof(size_t));
+    workers = ccnl_calloc((size_t) threads, sizeof(*workers));
+    if (!ctx.slots || !ctx.slotoffs || !ctx.slotlen || !workers) {
+        DEBUGMSG(ERROR, "Error: Failed to allocate memory\n");
+        goto Done;
     }
-    chunk_len = (size_t) s_chunk_len;
-    while (!is_last && chunk_len > 0) {
 
-        if (chunk_len < chunk_size) {
-            is_last = 1;
+    for (t = 0; t < threads; t++) {
+        // ccnl_URItoPrefix tokenizes its argument in place
+        char *url = ccnl_malloc(strlen(ctx.url) + 1);
+        if (!url) {
+            goto Done;
         }
+        strcpy(url, ctx.url);
+        workers[t].ctx = &ctx;
+        workers[t].name = ccnl_URItoPrefix(url, suite, &zero);
+        ccnl_free(url);
+        if (!workers[t].name) {
+            DEBUGMSG(ERROR, "could not parse %s\n", ctx.url);
+            goto Done;
+        }
+    }
 
-        strncpy(url, url_orig, strlen(url_orig));
-        offs = CCNL_MAX_PACKET_SIZE;
-        name = ccnl_URItoPrefix(url, suite, &chunknum);
+    // the main thread acts as worker 0, the others wait for windows
+    for (t = 1; t < threads; t++) {
+        if (pthread_create(&workers[t].tid, NULL, produce_worker, workers + t)) {
+            DEBUGMSG(ERROR, "could not create thread: %d\n", errno);
+            goto Done;
+        }
+        started++;
+    }
 
-        switch (suite) {
-        case CCNL_SUITE_CCNTLV:
-            if (ccnl_ccntlv_prependContentWithHdr(name, chunk_buf, chunk_len, &lastchunknum,
-                                                  //is_last ? &chunknum : NULL,
-                                                  NULL, // int *contentpos
-                                                  &offs, out, &contentlen)) {
-                goto Error;
-            }
-            break;
-        case CCNL_SUITE_NDNTLV:
-            data_opts.ndntlv.finalblockid = lastchunknum;
-            if (ccnl_ndntlv_prependContent(name, chunk_buf, chunk_len, NULL,
-                                           &(data_opts.ndntlv),// is_last ? &chunknum : NULL,
-                                           &offs, out, &contentlen)) {
-                goto Error;
-            }
-            break;
-        default:
-            DEBUGMSG(ERROR, "produce for suite %i is not implemented\n", suite);
-            goto Error;
-            break;
+    for (ctx.wbase = 0; ctx.wbase < chunkcnt; ctx.wbase += ctx.wcnt) {
+        pthread_mutex_lock(&ctx.lock);
+        ctx.wcnt = chunkcnt - ctx.wbase;
+        if (ctx.wcnt > window) {
+            ctx.wcnt = (uint32_t) window;
         }
+        ctx.wnext = 0;
+        ctx.busy = (int) started;
+        ctx.wgen++;
+        pthread_cond_broadcast(&ctx.cond);
+        pthread_mutex_unlock(&ctx.lock);
 
-        if (outdirname) {
-            snprintf(outpathname, sizeof(outpathname), "%s/%s%d.%s", outdirname, outfname, chunknum, fileext);
+        produce_window(workers);
 
-            DEBUGMSG(INFO, "writing chunk %d to file %s\n", chunknum, outpathname);
+        pthread_mutex_lock(&ctx.lock);
+        while (ctx.busy > 0) {
+            pthread_cond_wait(&ctx.cond, &ctx.lock);
+        }
+        pthread_mutex_unlock(&ctx.lock);
+        if (ctx.err) {
+            goto Done;
+        }
 
-            fout = creat(outpathname, 0666);
-            write(fout, out + offs, contentlen);
-            close(fout);
-        } else {
-            DEBUGMSG(INFO, "writing chunk %d\n", chunknum);
-            fwrite(out + offs, sizeof(unsigned char),contentlen, stdout);
+        if (outdirname) {
+            continue;
         }
+        for (i = 0; i < ctx.wcnt; i++) {
+            uint8_t *out = ctx.slots + (size_t) i * CCNL_MAX_PACKET_SIZE
+                           + ctx.slotoffs[i];
 
-        chunknum++;
-        if (!is_last) {
-            s_chunk_len = read(f, chunk_buf, chunk_size);
-            if (s_chunk_len < 0) {
-                DEBUGMSG(ERROR, "Error reading input file; error: %d\n", errno);
-                exit(1);
+            DEBUGMSG(INFO, "writing chunk %u\n", ctx.wbase + i);
+            if (seg ? ccnl_segment_writer_add(seg, out, ctx.slotlen[i])
+                    : produce_write_all(STDOUT_FILENO, out, ctx.slotlen[i])) {
+                DEBUGMSG(ERROR, "Error writing chunk %u; error: %d\n",
+                         ctx.wbase + i, errno);
+                goto Done;
             }
-            chunk_len = (size_t) s_chunk_len;
         }
     }
+    rc = 0;
 
-    close(f);
-    ccnl_free(chunk_buf);
-    return 0;
+Done:
+    if (started) {
+        pthread_mutex_lock(&ctx.lock);
+        ctx.quit = 1;
+        pthread_cond_broadcast(&ctx.cond);
+        pthread_mutex_unlock(&ctx.lock);
+        for (t = 1; t <= started; t++) {
+            pthread_join(workers[t].tid, NULL);
+        }
+    }
+    if (seg && ccnl_segment_writer_close(seg)) {
+        DEBUGMSG(ERROR, "could not write %s\n", packfname);
+        rc = -1;
+    }
+    if (workers) {
+        for (t = 0; t < threads; t++) {
+            if (workers[t].name) {
+                ccnl_prefix_free(workers[t].name);
+            }
+        }
+        ccnl_free(workers);
+    }
+    pthread_cond_destroy(&ctx.cond);
+    pthread_mutex_destroy(&ctx.lock);
+    ccnl_free(ctx.slots);
+    ccnl_free(ctx.slotoffs);
+    ccnl_free(ctx.slotlen);
+    if (mapped) {
+        munmap(ctx.data, ctx.datalen);
+    } else if (ctx.data) {
+        ccnl_free(ctx.data);
+    }
+    if (f > 0) {
+        close(f);
+    }
+    while (keys) {
+        struct key_s *next = keys->next;
 
-Error:
-    close(f);
-    ccnl_free(chunk_buf);
-    return -1;
+        free(keys->key);
+        free(keys);
+        keys = next;
+    }
+    return rc;
 }
 
 // eof
@@ -65,22 +65,43 @@ ccnl_hmac256_keysetup(SHA256_CTX_t *ctx, uint8_t *keyval, size_t kvlen,
     ccnl_SHA256_Update(ctx, buf, sizeof(buf));
 }
 
-// RFC2104 signature generation
 void
-ccnl_hmac256_sign(uint8_t *keyval, size_t kvlen,
-                  uint8_t *data, size_t dlen,
-                  uint8_t *md, size_t *mlen)
+ccnl_hmac256_key_init(struct ccnl_hmac256_key_s *key,
+                      uint8_t *keyval, size_t kvlen)
+{
+    SHA256_CTX_t ctx;
+
+    ccnl_hmac256_keysetup(&ctx, keyval, kvlen, 0x36); // inner hash
+    memcpy(key->istate, ctx.state, sizeof(key->istate));
+    ccnl_hmac256_keysetup(&ctx, keyval, kvlen, 0x5c); // outer hash
+    memcpy(key->ostate, ctx.state, sizeof(key->ostate));
+    memset(&ctx, 0, sizeof(ctx));
+}
+
+// a hash context that has seen the key block
+static void
+ccnl_hmac256_key_ctx(SHA256_CTX_t *ctx, const sha2_word32 *state)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    memcpy(ctx->state, state, sizeof(ctx->state));
+    ctx->bitcount = SHA256_BLOCK_LENGTH << 3;
+}
+
+void
+ccnl_hmac256_key_sign(const struct ccnl_hmac256_key_s *key,
+                      const uint8_t *data, size_t dlen,
+                      uint8_t *md, size_t *mlen)
 {
     uint8_t tmp[SHA256_DIGEST_LENGTH];
     SHA256_CTX_t ctx;
 
     DEBUGMSG(TRACE, "ccnl_hmac_sign %zu bytes\n", dlen);
 
-    ccnl_hmac256_keysetup(&ctx, keyval, kvlen, 0x36); // inner hash
+    ccnl_hmac256_key_ctx(&ctx, key->istate);
     ccnl_SHA256_Update(&ctx, data, dlen);
     ccnl_SHA256_Final(tmp, &ctx);
 
-    ccnl_hmac256_keysetup(&ctx, keyval, kvlen, 0x5c); // outer hash
+    ccnl_hmac256_key_ctx(&ctx, key->ostate);
     ccnl_SHA256_Update(&ctx, tmp, sizeof(tmp));
     ccnl_SHA256_Final(tmp, &ctx);
 
@@ -90,6 +111,48 @@ ccnl_hmac256_sign(uint8_t *keyval, size_t kvlen,
     memcpy(md, tmp, *mlen);
 }
 
+void
+ccnl_hmac256_key_sign_many(const struct ccnl_hmac256_key_s *key,
+                           const uint8_t *data[], const size_t dlen[],
+                           uint8_t *md[], size_t n)
+{
+    SHA256_CTX_t ctx[SHA256_MAX_LANES], *cp[SHA256_MAX_LANES];
+    const uint8_t *ip[SHA256_MAX_LANES];
+    size_t i, j, cnt, ilen[SHA256_MAX_LANES];
+
+    DEBUGMSG(TRACE, "ccnl_hmac_sign_many %zu messages\n", n);
+
+    for (i = 0; i < n; i += cnt) {
+        cnt = n - i < SHA256_MAX_LANES ? n - i : SHA256_MAX_LANES;
+
+        for (j = 0; j < cnt; j++) {
+            ccnl_hmac256_key_ctx(ctx + j, key->istate);
+            cp[j] = ctx + j;
+        }
+        ccnl_SHA256_FinalMany(cp, data + i, dlen + i, md + i, cnt);
+
+        for (j = 0; j < cnt; j++) {
+            ccnl_hmac256_key_ctx(ctx + j, key->ostate);
+            ip[j] = md[i + j];
+            ilen[j] = SHA256_DIGEST_LENGTH;
+        }
+        ccnl_SHA256_FinalMany(cp, ip, ilen, md + i, cnt);
+    }
+}
+
+// RFC2104 signature generation
+void
+ccnl_hmac256_sign(uint8_t *keyval, size_t kvlen,
+                  uint8_t *data, size_t dlen,
+                  uint8_t *md, size_t *mlen)
+{
+    struct ccnl_hmac256_key_s key;
+
+    ccnl_hmac256_key_init(&key, keyval, kvlen);
+    ccnl_hmac256_key_sign(&key, data, dlen, md, mlen);
+    memset(&key, 0, sizeof(key));
+}
+
 #ifdef NEEDS_PACKET_CRAFTING
 
 #ifdef USE_SUITE_CCNTLV
@@ -103,10 +166,30 @@ ccnl_ccntlv_prependSignedContentWithHdr(struct ccnl_prefix_s *name,
                                         uint8_t *keyval, // 64B
                                         uint8_t *keydigest, // 32B
                                         size_t *offset, uint8_t *buf, size_t *retlen)
+{
+    struct ccnl_hmac256_key_s key;
+    int8_t rc;
+    (void)keydigest;
+
+    ccnl_hmac256_key_init(&key, keyval, 64);
+    rc = ccnl_ccntlv_prependSignedContentWithHdrKey(name, payload, paylen,
+                                                    lastchunknum, contentpos,
+                                                    &key, offset, buf, retlen);
+    memset(&key, 0, sizeof(key));
+    return rc;
+}
+
+int8_t
+ccnl_ccntlv_prependSignedContentWithHdrKey(struct ccnl_prefix_s *name,
+                                           uint8_t *payload, size_t paylen,
+                                           uint32_t *lastchunknum,
+                                           size_t *contentpos,
+                                           const struct ccnl_hmac256_key_s *key,
+                                           size_t *offset, uint8_t *buf,
+                                           size_t *retlen)
 {
     size_t mdlength = 32, mdoffset, endofsign, oldoffset, len;
     uint8_t hoplimit = 255; // setting to max (conten obj has no hoplimit)
-    (void)keydigest;
 
     if (*offset < (8 + paylen + 4+32 + 3*4+32)) {
         return -1;
@@ -145,13 +228,15 @@ ccnl_ccntlv_prependSignedContentWithHdr(struct ccnl_prefix_s *name,
                                    contentpos, offset, buf, &len)) {
         return -1;
     }
+    // the fixed header covers the validation TLVs, too
+    len = oldoffset - *offset;
     if (len > (UINT16_MAX - 8)) {
         DEBUGMSG(ERROR, "payload to sign is too large\n");
         return -1;
     }
 
-    ccnl_hmac256_sign(keyval, 64, buf + *offset, endofsign - *offset,
-                      buf + mdoffset, &mdlength);
+    ccnl_hmac256_key_sign(key, buf + *offset, endofsign - *offset,
+                          buf + mdoffset, &mdlength);
     if (ccnl_ccntlv_prependFixedHdr(CCNX_TLV_V1, CCNX_PT_Data,
                                     len, hoplimit, offset, buf)) {
         return -1;
@@ -171,10 +256,27 @@ ccnl_ndntlv_prependSignedContent(struct ccnl_prefix_s *name,
                                  uint8_t *keyval, // 64B
                                  uint8_t *keydigest, // 32B
                                  size_t *offset, uint8_t *buf, size_t *reslen) {
+    struct ccnl_hmac256_key_s key;
+    int8_t rc;
+    (void) keydigest;
+
+    ccnl_hmac256_key_init(&key, keyval, 64);
+    rc = ccnl_ndntlv_prependSignedContentKey(name, payload, paylen,
+                                             final_block_id, contentpos, &key,
+                                             offset, buf, reslen);
+    memset(&key, 0, sizeof(key));
+    return rc;
+}
+
+int8_t
+ccnl_ndntlv_prependSignedContentKey(struct ccnl_prefix_s *name,
+                                    uint8_t *payload, size_t paylen,
+                                    uint32_t *final_block_id, size_t *contentpos,
+                                    const struct ccnl_hmac256_key_s *key,
+                                    size_t *offset, uint8_t *buf, size_t *reslen) {
     size_t mdlength = 32;
     size_t oldoffset = *offset, oldoffset2, mdoffset, endofsign;
     uint8_t signatureType[1] = {NDN_SigTypeVal_SignatureHmacWithSha256};
-    (void) keydigest;
     if (contentpos) {
         *contentpos = *offset - paylen;
     }
@@ -255,8 +357,8 @@ ccnl_ndntlv_prependSignedContent(struct ccnl_prefix_s *name,
         *contentpos -= *offset;
     }
 
-    ccnl_hmac256_sign(keyval, 64, buf + *offset, (endofsign - *offset),
-                      buf + mdoffset, &mdlength);
+    ccnl_hmac256_key_sign(key, buf + *offset, (endofsign - *offset),
+                          buf + mdoffset, &mdlength);
 
     *reslen = oldoffset - *offset;
     return 0;
@@ -89,82 +89,312 @@ void ccnl_SHA256_Init(SHA256_CTX_t* context) {
 	context->bitcount = 0;
 }
 
-void ccnl_SHA256_Transform(SHA256_CTX_t* context, const sha2_word32* data) {
+/*** KERNELS ********************************************************/
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && \
+    !defined(CCNL_ARDUINO) && !defined(CCNL_LINUXKERNEL) && !defined(CCNL_RIOT)
+# define SHA256_X86
+# include <cpuid.h>
+# include <immintrin.h>
+#endif
+
+static void sha256_blocks_generic(sha2_word32 state[8], const sha2_byte *data, size_t nblocks) {
 	sha2_word32	a, b, c, d, e, f, g, h, s0, s1;
-	sha2_word32	T1, T2, *W256;
+	sha2_word32	T1, T2, W256[16];
 	int		j;
 
-	W256 = (sha2_word32*)context->buffer;
+	while (nblocks-- > 0) {
+		/* Initialize registers with the prev. intermediate value */
+		a = state[0];
+		b = state[1];
+		c = state[2];
+		d = state[3];
+		e = state[4];
+		f = state[5];
+		g = state[6];
+		h = state[7];
+
+		j = 0;
+		do {
+			/* Copy data while converting to host byte order */
+			W256[j] = ((sha2_word32) data[0] << 24) | ((sha2_word32) data[1] << 16) |
+				  ((sha2_word32) data[2] << 8) | (sha2_word32) data[3];
+			data += 4;
+			/* Apply the SHA-256 compression function to update a..h */
+			T1 = h + Sigma1_256(e) + Ch(e, f, g) + K256_(j) + W256[j];
+			T2 = Sigma0_256(a) + Maj(a, b, c);
+			h = g;
+			g = f;
+			f = e;
+			e = d + T1;
+			d = c;
+			c = b;
+			b = a;
+			a = T1 + T2;
+
+			j++;
+		} while (j < 16);
+
+		do {
+			/* Part of the message block expansion: */
+			s0 = W256[(j+1)&0x0f];
+			s0 = sigma0_256(s0);
+			s1 = W256[(j+14)&0x0f];
+			s1 = sigma1_256(s1);
+
+			/* Apply the SHA-256 compression function to update a..h */
+			T1 = h + Sigma1_256(e) + Ch(e, f, g) + K256_(j) +
+			     (W256[j&0x0f] += s1 + W256[(j+9)&0x0f] + s0);
+			T2 = Sigma0_256(a) + Maj(a, b, c);
+			h = g;
+			g = f;
+			f = e;
+			e = d + T1;
+			d = c;
+			c = b;
+			b = a;
+			a = T1 + T2;
+
+			j++;
+		} while (j < 64);
+
+		/* Compute the current intermediate hash value */
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+	}
 
-	/* Initialize registers with the prev. intermediate value */
-	a = context->state[0];
-	b = context->state[1];
-	c = context->state[2];
-	d = context->state[3];
-	e = context->state[4];
-	f = context->state[5];
-	g = context->state[6];
-	h = context->state[7];
+	/* Clean up */
+	a = b = c = d = e = f = g = h = T1 = T2 = 0;
+	MEMSET_BZERO(W256, sizeof(W256));
+}
 
-	j = 0;
-	do {
-#if BYTE_ORDER == LITTLE_ENDIAN
-		/* Copy data while converting to host byte order */
-		REVERSE32(*data++,W256[j]);
-		/* Apply the SHA-256 compression function to update a..h */
-		T1 = h + Sigma1_256(e) + Ch(e, f, g) + K256_(j) + W256[j];
-#else /* BYTE_ORDER == LITTLE_ENDIAN */
-		/* Apply the SHA-256 compression function to update a..h with copy */
-		T1 = h + Sigma1_256(e) + Ch(e, f, g) + K256_(j) + (W256[j] = *data++);
-#endif /* BYTE_ORDER == LITTLE_ENDIAN */
-		T2 = Sigma0_256(a) + Maj(a, b, c);
-		h = g;
-		g = f;
-		f = e;
-		e = d + T1;
-		d = c;
-		c = b;
-		b = a;
-		a = T1 + T2;
-
-		j++;
-	} while (j < 16);
-
-	do {
-		/* Part of the message block expansion: */
-		s0 = W256[(j+1)&0x0f];
-		s0 = sigma0_256(s0);
-		s1 = W256[(j+14)&0x0f];	
-		s1 = sigma1_256(s1);
-
-		/* Apply the SHA-256 compression function to update a..h */
-		T1 = h + Sigma1_256(e) + Ch(e, f, g) + K256_(j) +
-		     (W256[j&0x0f] += s1 + W256[(j+9)&0x0f] + s0);
-		T2 = Sigma0_256(a) + Maj(a, b, c);
+#ifdef SHA256_X86
+
+/*
+ * SHA-NI: the state is kept as ABEF/CDGH, sha256rnds2 does two rounds and
+ * sha256msg1/msg2 the message schedule, four words at a time.
+ */
+__attribute__((target("sha,sse4.1")))
+static void sha256_blocks_shani(sha2_word32 state[8], const sha2_byte *data, size_t nblocks) {
+	const __m128i	MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i		STATE0, STATE1, ABEF_SAVE, CDGH_SAVE, MSG, TMP, M[4];
+	int		g;
+
+	TMP = _mm_loadu_si128((const __m128i*) &state[0]);
+	STATE1 = _mm_loadu_si128((const __m128i*) &state[4]);
+	TMP = _mm_shuffle_epi32(TMP, 0xB1);		/* CDAB */
+	STATE1 = _mm_shuffle_epi32(STATE1, 0x1B);	/* EFGH */
+	STATE0 = _mm_alignr_epi8(TMP, STATE1, 8);	/* ABEF */
+	STATE1 = _mm_blend_epi16(STATE1, TMP, 0xF0);	/* CDGH */
+
+	while (nblocks-- > 0) {
+		ABEF_SAVE = STATE0;
+		CDGH_SAVE = STATE1;
+
+		/* rounds 4g .. 4g+3 */
+		for (g = 0; g < 16; g++) {
+			if (g < 4) {
+				M[g] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 16 * g)), MASK);
+			}
+			MSG = _mm_add_epi32(M[g & 3], _mm_loadu_si128((const __m128i*) &K256[4 * g]));
+			STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+			if (g >= 3 && g < 15) {
+				TMP = _mm_alignr_epi8(M[g & 3], M[(g - 1) & 3], 4);
+				M[(g + 1) & 3] = _mm_add_epi32(M[(g + 1) & 3], TMP);
+				M[(g + 1) & 3] = _mm_sha256msg2_epu32(M[(g + 1) & 3], M[g & 3]);
+			}
+			MSG = _mm_shuffle_epi32(MSG, 0x0E);
+			STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG);
+			if (g >= 1 && g < 13) {
+				M[(g - 1) & 3] = _mm_sha256msg1_epu32(M[(g - 1) & 3], M[g & 3]);
+			}
+		}
+
+		STATE0 = _mm_add_epi32(STATE0, ABEF_SAVE);
+		STATE1 = _mm_add_epi32(STATE1, CDGH_SAVE);
+		data += SHA256_BLOCK_LENGTH;
+	}
+
+	TMP = _mm_shuffle_epi32(STATE0, 0x1B);		/* FEBA */
+	STATE1 = _mm_shuffle_epi32(STATE1, 0xB1);	/* DCHG */
+	STATE0 = _mm_blend_epi16(TMP, STATE1, 0xF0);	/* DCBA */
+	STATE1 = _mm_alignr_epi8(STATE1, TMP, 8);	/* HGFE */
+	_mm_storeu_si128((__m128i*) &state[0], STATE0);
+	_mm_storeu_si128((__m128i*) &state[4], STATE1);
+}
+
+/*
+ * AVX2 multi-buffer: one block of each of 8 independent messages, lane i
+ * of every register belongs to message i. st[w][i] is word w of lane i.
+ */
+#define ROTR_X8(x,n)	_mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define ADD_X8(x,y)	_mm256_add_epi32((x), (y))
+#define XOR_X8(x,y)	_mm256_xor_si256((x), (y))
+
+__attribute__((target("avx2")))
+static void sha256_block_x8_avx2(sha2_word32 st[8][SHA256_MAX_LANES],
+				 const sha2_byte *blk[SHA256_MAX_LANES]) {
+	__m256i		a, b, c, d, e, f, g, h, T1, T2, W[16];
+	sha2_word32	w[SHA256_MAX_LANES];
+	int		i, j;
+
+	a = _mm256_loadu_si256((const __m256i*) st[0]);
+	b = _mm256_loadu_si256((const __m256i*) st[1]);
+	c = _mm256_loadu_si256((const __m256i*) st[2]);
+	d = _mm256_loadu_si256((const __m256i*) st[3]);
+	e = _mm256_loadu_si256((const __m256i*) st[4]);
+	f = _mm256_loadu_si256((const __m256i*) st[5]);
+	g = _mm256_loadu_si256((const __m256i*) st[6]);
+	h = _mm256_loadu_si256((const __m256i*) st[7]);
+
+	for (j = 0; j < 64; j++) {
+		if (j < 16) {
+			for (i = 0; i < SHA256_MAX_LANES; i++) {
+				const sha2_byte *p = blk[i] + 4 * j;
+				w[i] = ((sha2_word32) p[0] << 24) | ((sha2_word32) p[1] << 16) |
+				       ((sha2_word32) p[2] << 8) | (sha2_word32) p[3];
+			}
+			W[j] = _mm256_loadu_si256((const __m256i*) w);
+		} else {
+			__m256i s0 = W[(j+1)&0x0f], s1 = W[(j+14)&0x0f];
+
+			s0 = XOR_X8(XOR_X8(ROTR_X8(s0, 7), ROTR_X8(s0, 18)), _mm256_srli_epi32(s0, 3));
+			s1 = XOR_X8(XOR_X8(ROTR_X8(s1, 17), ROTR_X8(s1, 19)), _mm256_srli_epi32(s1, 10));
+			W[j&0x0f] = ADD_X8(ADD_X8(W[j&0x0f], s1), ADD_X8(W[(j+9)&0x0f], s0));
+		}
+		T1 = ADD_X8(h, XOR_X8(XOR_X8(ROTR_X8(e, 6), ROTR_X8(e, 11)), ROTR_X8(e, 25)));
+		T1 = ADD_X8(T1, XOR_X8(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g)));
+		T1 = ADD_X8(T1, ADD_X8(_mm256_set1_epi32((int) K256_(j)), W[j&0x0f]));
+		T2 = XOR_X8(XOR_X8(ROTR_X8(a, 2), ROTR_X8(a, 13)), ROTR_X8(a, 22));
+		T2 = ADD_X8(T2, _mm256_or_si256(_mm256_and_si256(a, b),
+						_mm256_and_si256(c, _mm256_or_si256(a, b))));
 		h = g;
 		g = f;
 		f = e;
-		e = d + T1;
+		e = ADD_X8(d, T1);
 		d = c;
 		c = b;
 		b = a;
-		a = T1 + T2;
+		a = ADD_X8(T1, T2);
+	}
+
+	_mm256_storeu_si256((__m256i*) st[0], ADD_X8(a, _mm256_loadu_si256((const __m256i*) st[0])));
+	_mm256_storeu_si256((__m256i*) st[1], ADD_X8(b, _mm256_loadu_si256((const __m256i*) st[1])));
+	_mm256_storeu_si256((__m256i*) st[2], ADD_X8(c, _mm256_loadu_si256((const __m256i*) st[2])));
+	_mm256_storeu_si256((__m256i*) st[3], ADD_X8(d, _mm256_loadu_si256((const __m256i*) st[3])));
+	_mm256_storeu_si256((__m256i*) st[4], ADD_X8(e, _mm256_loadu_si256((const __m256i*) st[4])));
+	_mm256_storeu_si256((__m256i*) st[5], ADD_X8(f, _mm256_loadu_si256((const __m256i*) st[5])));
+	_mm256_storeu_si256((__m256i*) st[6], ADD_X8(g, _mm256_loadu_si256((const __m256i*) st[6])));
+	_mm256_storeu_si256((__m256i*) st[7], ADD_X8(h, _mm256_loadu_si256((const __m256i*) st[7])));
+}
 
-		j++;
-	} while (j < 64);
+#undef ROTR_X8
+#undef ADD_X8
+#undef XOR_X8
 
-	/* Compute the current intermediate hash value */
-	context->state[0] += a;
-	context->state[1] += b;
-	context->state[2] += c;
-	context->state[3] += d;
-	context->state[4] += e;
-	context->state[5] += f;
-	context->state[6] += g;
-	context->state[7] += h;
+static void sha256_cpu_features(int *shani, int *avx2) {
+	unsigned int	a, b, c, d, xcr0 = 0, xcr0_hi = 0;
+	int		ssse3, sse41, osxsave, avx;
 
-	/* Clean up */
-	a = b = c = d = e = f = g = h = T1 = T2 = 0;
+	*shani = *avx2 = 0;
+	if (!__get_cpuid(1, &a, &b, &c, &d)) {
+		return;
+	}
+	ssse3 = (c >> 9) & 1;
+	sse41 = (c >> 19) & 1;
+	osxsave = (c >> 27) & 1;
+	avx = (c >> 28) & 1;
+	if (!__get_cpuid_count(7, 0, &a, &b, &c, &d)) {
+		return;
+	}
+	*shani = ssse3 && sse41 && ((b >> 29) & 1);
+	if (osxsave && avx) {
+		/* the OS must save the ymm registers */
+		__asm__ volatile ("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+		*avx2 = ((b >> 5) & 1) && (xcr0 & 6) == 6;
+	}
+	(void) xcr0_hi;
+}
+
+#endif /* SHA256_X86 */
+
+enum {
+	SHA256_KERNEL_UNSET,
+	SHA256_KERNEL_GENERIC,
+	SHA256_KERNEL_SHANI,
+	SHA256_KERNEL_AVX2
+};
+
+static int sha256_kernel = SHA256_KERNEL_UNSET;
+static void (*sha256_blocks)(sha2_word32 state[8], const sha2_byte *data, size_t nblocks) = sha256_blocks_generic;
+
+static int sha256_select(int kernel) {
+#ifdef SHA256_X86
+	int	shani, avx2;
+
+	sha256_cpu_features(&shani, &avx2);
+	if (kernel == SHA256_KERNEL_UNSET) {
+		kernel = shani ? SHA256_KERNEL_SHANI :
+			 avx2 ? SHA256_KERNEL_AVX2 : SHA256_KERNEL_GENERIC;
+	}
+	if ((kernel == SHA256_KERNEL_SHANI && !shani) ||
+	    (kernel == SHA256_KERNEL_AVX2 && !avx2)) {
+		return -1;
+	}
+	sha256_blocks = kernel == SHA256_KERNEL_SHANI ? sha256_blocks_shani : sha256_blocks_generic;
+#else
+	if (kernel != SHA256_KERNEL_UNSET && kernel != SHA256_KERNEL_GENERIC) {
+		return -1;
+	}
+	kernel = SHA256_KERNEL_GENERIC;
+	sha256_blocks = sha256_blocks_generic;
+#endif
+	sha256_kernel = kernel;
+	return 0;
+}
+
+const char* ccnl_SHA256_kernel(void) {
+	if (sha256_kernel == SHA256_KERNEL_UNSET) {
+		sha256_select(SHA256_KERNEL_UNSET);
+	}
+	switch (sha256_kernel) {
+	case SHA256_KERNEL_SHANI:
+		return "sha-ni";
+	case SHA256_KERNEL_AVX2:
+		return "avx2";
+	default:
+		return "generic";
+	}
+}
+
+int ccnl_SHA256_setKernel(const char *name) {
+	if (!strcmp(name, "sha-ni")) {
+		return sha256_select(SHA256_KERNEL_SHANI);
+	}
+	if (!strcmp(name, "avx2")) {
+		return sha256_select(SHA256_KERNEL_AVX2);
+	}
+	if (!strcmp(name, "generic")) {
+		return sha256_select(SHA256_KERNEL_GENERIC);
+	}
+	return -1;
+}
+
+void ccnl_SHA256_Blocks(sha2_word32 state[8], const sha2_byte *data, size_t nblocks) {
+	if (sha256_kernel == SHA256_KERNEL_UNSET) {
+		sha256_select(SHA256_KERNEL_UNSET);
+	}
+	sha256_blocks(state, data, nblocks);
+}
+
+void ccnl_SHA256_Transform(SHA256_CTX_t* context, const sha2_word32* data) {
+	ccnl_SHA256_Blocks(context->state, (const sha2_byte*) data, 1);
 }
 
 
@@ -200,12 +430,14 @@ void ccnl_SHA256_Update(SHA256_CTX_t* context, const sha2_byte *data, size_t len
 			return;
 		}
 	}
-	while (len >= SHA256_BLOCK_LENGTH) {
-		/* Process as many complete blocks as we can */
-		ccnl_SHA256_Transform(context, (sha2_word32*)data);
-		context->bitcount += SHA256_BLOCK_LENGTH << 3;
-		len -= SHA256_BLOCK_LENGTH;
-		data += SHA256_BLOCK_LENGTH;
+	if (len >= SHA256_BLOCK_LENGTH) {
+		/* Process as many complete blocks as we can, in one go */
+		size_t nblocks = len / SHA256_BLOCK_LENGTH;
+
+		ccnl_SHA256_Blocks(context->state, data, nblocks);
+		context->bitcount += (sha2_word64) nblocks * SHA256_BLOCK_LENGTH << 3;
+		len -= nblocks * SHA256_BLOCK_LENGTH;
+		data += nblocks * SHA256_BLOCK_LENGTH;
 	}
 	if (len > 0) {
 		/* There's left-overs, so save 'em */
@@ -279,4 +511,145 @@ void ccnl_SHA256_Final(sha2_byte digest[], SHA256_CTX_t* context) {
 	usedspace = 0;
 }
 
+/*** MULTI-BUFFER: ****************************************************/
+
+/* what is left of one message: full blocks in place, the padded tail copied */
+struct sha256_lane_s {
+	const sha2_byte	*data;
+	size_t		nfull, nblocks;
+	sha2_byte	tail[2 * SHA256_BLOCK_LENGTH];
+};
+
+static void sha256_lane_setup(struct sha256_lane_s *lane, SHA256_CTX_t *context,
+			      const sha2_byte *data, size_t len) {
+	sha2_word64	bitcount = context->bitcount + ((sha2_word64) len << 3);
+	size_t		rem = len % SHA256_BLOCK_LENGTH, ntail, i;
+
+	lane->data = data;
+	lane->nfull = len / SHA256_BLOCK_LENGTH;
+	ntail = rem < SHA256_SHORT_BLOCK_LENGTH ? 1 : 2;
+	lane->nblocks = lane->nfull + ntail;
+
+	MEMSET_BZERO(lane->tail, sizeof(lane->tail));
+	if (rem > 0) {
+		MEMCPY_BCOPY(lane->tail, data + lane->nfull * SHA256_BLOCK_LENGTH, rem);
+	}
+	lane->tail[rem] = 0x80;
+	for (i = 0; i < 8; i++) {
+		lane->tail[ntail * SHA256_BLOCK_LENGTH - 1 - i] = (sha2_byte) (bitcount >> (8 * i));
+	}
+}
+
+static const sha2_byte* sha256_lane_block(struct sha256_lane_s *lane, size_t k) {
+	if (k < lane->nfull) {
+		return lane->data + k * SHA256_BLOCK_LENGTH;
+	}
+	return lane->tail + (k - lane->nfull) * SHA256_BLOCK_LENGTH;
+}
+
+static void sha256_digest(sha2_byte *digest, const sha2_word32 *state) {
+	int	j;
+
+	for (j = 0; j < 8; j++) {
+		digest[4*j] = (sha2_byte) (state[j] >> 24);
+		digest[4*j + 1] = (sha2_byte) (state[j] >> 16);
+		digest[4*j + 2] = (sha2_byte) (state[j] >> 8);
+		digest[4*j + 3] = (sha2_byte) state[j];
+	}
+}
+
+#ifdef SHA256_X86
+/* up to SHA256_MAX_LANES contexts that all stand at a block boundary */
+static void sha256_final_x8(SHA256_CTX_t *context[], const sha2_byte *data[],
+			    const size_t len[], sha2_byte *digest[], size_t n) {
+	struct sha256_lane_s	lanes[SHA256_MAX_LANES];
+	sha2_word32		st[8][SHA256_MAX_LANES], out[8];
+	const sha2_byte		*blk[SHA256_MAX_LANES];
+	size_t			i, k, maxblocks = 0;
+	int			w;
+
+	for (i = 0; i < n; i++) {
+		sha256_lane_setup(&lanes[i], context[i], data[i], len[i]);
+		if (lanes[i].nblocks > maxblocks) {
+			maxblocks = lanes[i].nblocks;
+		}
+		for (w = 0; w < 8; w++) {
+			st[w][i] = context[i]->state[w];
+		}
+	}
+	/* unused lanes hash their first block again, the result is ignored */
+	for (; i < SHA256_MAX_LANES; i++) {
+		for (w = 0; w < 8; w++) {
+			st[w][i] = 0;
+		}
+		blk[i] = lanes[0].tail;
+	}
+
+	for (k = 0; k < maxblocks; k++) {
+		for (i = 0; i < n; i++) {
+			/* finished lanes repeat their last block */
+			blk[i] = sha256_lane_block(&lanes[i], k < lanes[i].nblocks ? k : lanes[i].nblocks - 1);
+		}
+		sha256_block_x8_avx2(st, blk);
+		for (i = 0; i < n; i++) {
+			if (k + 1 == lanes[i].nblocks) {
+				for (w = 0; w < 8; w++) {
+					out[w] = st[w][i];
+				}
+				sha256_digest(digest[i], out);
+				MEMSET_BZERO(context[i], sizeof(SHA256_CTX_t));
+			}
+		}
+	}
+	MEMSET_BZERO(lanes, sizeof(lanes));
+	MEMSET_BZERO(st, sizeof(st));
+}
+#endif /* SHA256_X86 */
+
+void ccnl_SHA256_FinalMany(SHA256_CTX_t *context[], const sha2_byte *data[],
+			   const size_t len[], sha2_byte *digest[], size_t n) {
+	size_t	i;
+
+	if (sha256_kernel == SHA256_KERNEL_UNSET) {
+		sha256_select(SHA256_KERNEL_UNSET);
+	}
+#ifdef SHA256_X86
+	if (sha256_kernel == SHA256_KERNEL_AVX2) {
+		SHA256_CTX_t	*c[SHA256_MAX_LANES];
+		const sha2_byte	*d[SHA256_MAX_LANES];
+		size_t		l[SHA256_MAX_LANES];
+		sha2_byte	*md[SHA256_MAX_LANES];
+		size_t		cnt = 0;
+
+		for (i = 0; i < n; i++) {
+			/* a partly filled buffer is finished on its own */
+			if (context[i]->bitcount % (SHA256_BLOCK_LENGTH << 3)) {
+				ccnl_SHA256_Update(context[i], data[i], len[i]);
+				ccnl_SHA256_Final(digest[i], context[i]);
+				continue;
+			}
+			c[cnt] = context[i];
+			d[cnt] = data[i];
+			l[cnt] = len[i];
+			md[cnt++] = digest[i];
+			if (cnt == SHA256_MAX_LANES) {
+				sha256_final_x8(c, d, l, md, cnt);
+				cnt = 0;
+			}
+		}
+		if (cnt == 1) {
+			ccnl_SHA256_Update(c[0], d[0], l[0]);
+			ccnl_SHA256_Final(md[0], c[0]);
+		} else if (cnt > 1) {
+			sha256_final_x8(c, d, l, md, cnt);
+		}
+		return;
+	}
+#endif
+	for (i = 0; i < n; i++) {
+		ccnl_SHA256_Update(context[i], data[i], len[i]);
+		ccnl_SHA256_Final(digest[i], context[i]);
+	}
+}
+
 // eof
@@ -0,0 +1,467 @@
+/*
+ * @f bench_admit.c
+ * @b CCN lite, hit ratio of the CS admission policies on a request trace
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/*
+ * Replays a trace of requests through ccnl_core_RX(), once per admission
+ * policy: an Interest from a consumer, and on a CS miss the Data from the
+ * producer, which the policy may keep out of the cache.
+ *
+ * The trace is read from a file, one name per line, or made up of Zipf
+ * requests for popular names and bursts of names requested once (a scan),
+ * which is where admission pays off. The debug build never returns freed
+ * memory (USE_DEBUG_MALLOC), keep long traces to the single-suite build.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+#include "ccnl-core.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-logging.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-relay.h"
+
+struct bench_cfg_s {
+    int suite;
+    long requests;      // of the made up trace
+    long names;         // popular names
+    double zipf;
+    double scan;        // share of requests in scans
+    long burst;         // requests per scan
+    int cs;
+    size_t paylen;
+    unsigned seed;
+    char *trace;        // file, instead of a made up trace
+    int json;
+};
+
+static const char *bench_policies[] = {
+    "all", "prob:0.1", "second", "tinylfu"
+};
+
+static uint64_t bench_tx;
+
+static void
+bench_tx_sink(struct ccnl_relay_s *relay, struct ccnl_if_s *ifc,
+              sockunion *dst, struct ccnl_buf_s *buf)
+{
+    (void) relay;
+    (void) ifc;
+    (void) dst;
+    (void) buf;
+    bench_tx++;
+}
+
+static inline uint64_t
+bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// xorshift64*, reproducible across platforms
+static uint64_t bench_rnd_state;
+
+static uint64_t
+bench_rnd(void)
+{
+    bench_rnd_state ^= bench_rnd_state >> 12;
+    bench_rnd_state ^= bench_rnd_state << 25;
+    bench_rnd_state ^= bench_rnd_state >> 27;
+    return bench_rnd_state * 2685821657736338717ULL;
+}
+
+static double
+bench_unit(void)
+{
+    return (double) (bench_rnd() >> 11) / 9007199254740992.0;
+}
+
+// Zipf ranks of popular names, and bursts of new names
+static char**
+bench_make_trace(struct bench_cfg_s *cfg, long *count)
+{
+    double *cdf = (double *) malloc((size_t) cfg->names * sizeof(double));
+    char **trace = (char **) calloc((size_t) cfg->requests, sizeof(char *));
+    char uri[64];
+    double sum = 0;
+    long i, k, scanned = 0;
+    int inscan = 0;
+
+    if (!cdf || !trace) {
+        free(cdf);
+        free(trace);
+        return NULL;
+    }
+    for (i = 0; i < cfg->names; i++) {
+        sum += cfg->zipf > 0 ? 1.0 / pow((double) (i + 1), cfg->zipf) : 1.0;
+        cdf[i] = sum;
+    }
+    for (i = 0; i < cfg->requests; i++) {
+        if (i % cfg->burst == 0) {
+            inscan = bench_unit() < cfg->scan;
+        }
+        if (inscan) {
+            snprintf(uri, sizeof(uri), "/bench/scan/%ld", scanned++);
+        } else {
+            double u = bench_unit() * sum;
+            long lo = 0, hi = cfg->names - 1;
+
+            while (lo < hi) {
+                k = (lo + hi) / 2;
+                if (cdf[k] < u) {
+                    lo = k + 1;
+                } else {
+                    hi = k;
+                }
+            }
+            snprintf(uri, sizeof(uri), "/bench/pop/%ld", lo);
+        }
+        trace[i] = strdup(uri);
+        if (!trace[i]) {
+            *count = i;
+            free(cdf);
+            return trace;
+        }
+    }
+    free(cdf);
+    *count = cfg->requests;
+    return trace;
+}
+
+// the first word of each line
+static char**
+bench_read_trace(const char *fname, long *count)
+{
+    FILE *f = fopen(fname, "r");
+    char line[1024], **trace = NULL, **t;
+    long size = 0;
+
+    *count = 0;
+    if (!f) {
+        perror(fname);
+        return NULL;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        char *name = strtok(line, " \t\r\n");
+
+        if (!name || name[0] != '/') {
+            continue;
+        }
+        if (*count == size) {
+            size = size ? 2 * size : 4096;
+            t = (char **) realloc(trace, (size_t) size * sizeof(char *));
+            if (!t) {
+                break;
+            }
+            trace = t;
+        }
+        trace[*count] = strdup(name);
+        if (!trace[*count]) {
+            break;
+        }
+        (*count)++;
+    }
+    fclose(f);
+    return trace;
+}
+
+static struct ccnl_buf_s*
+bench_packet(struct bench_cfg_s *cfg, const char *name, uint8_t *payload)
+{
+    char uri[1024];
+    struct ccnl_prefix_s *pfx;
+    struct ccnl_buf_s *buf;
+
+    snprintf(uri, sizeof(uri), "%s", name);
+    pfx = ccnl_URItoPrefix(uri, cfg->suite, NULL);
+    if (!pfx) {
+        return NULL;
+    }
+    if (payload) {
+        buf = ccnl_mkSimpleContent(pfx, payload, cfg->paylen, NULL, NULL);
+    } else {
+        ccnl_interest_opts_u opts;
+
+        memset(&opts, 0, sizeof(opts));
+#ifdef USE_SUITE_NDNTLV
+        if (cfg->suite == CCNL_SUITE_NDNTLV) {
+            // unique nonces, the duplicate check must not drop anything
+            static int32_t nonce;
+            opts.ndntlv.nonce = ++nonce;
+        }
+#endif
+        buf = ccnl_mkSimpleInterest(pfx, &opts);
+    }
+    ccnl_prefix_free(pfx);
+    return buf;
+}
+
+static void
+bench_rx(struct ccnl_relay_s *relay, struct ccnl_buf_s *buf, sockunion *from)
+{
+    ccnl_core_RX(relay, 0, buf->data, buf->datalen, &from->sa, sizeof(from->ip4));
+}
+
+static void
+bench_reset(struct ccnl_relay_s *relay)
+{
+    while (relay->pit) {
+        ccnl_interest_remove(relay, relay->pit);
+    }
+    while (relay->contents) {
+        ccnl_content_remove(relay, relay->contents);
+    }
+}
+
+static int
+bench_run(struct ccnl_relay_s *relay, struct bench_cfg_s *cfg,
+          const char *policy, char **trace, long count,
+          sockunion *consumer, sockunion *producer, uint8_t *payload)
+{
+    long i, hits = 0;
+    uint64_t t0, ns;
+    char name[32];
+
+    bench_reset(relay);
+    if (ccnl_admit_set(relay, policy)) {
+        fprintf(stderr, "%s: unknown policy\n", policy);
+        return -1;
+    }
+    t0 = bench_now();
+    for (i = 0; i < count; i++) {
+        struct ccnl_buf_s *buf = bench_packet(cfg, trace[i], NULL);
+        int pitcnt = relay->pitcnt;
+
+        if (!buf) {
+            return -1;
+        }
+        bench_rx(relay, buf, consumer);
+        ccnl_free(buf);
+        if (relay->pitcnt == pitcnt) {
+            hits++;
+            continue;
+        }
+        buf = bench_packet(cfg, trace[i], payload);
+        if (!buf) {
+            return -1;
+        }
+        bench_rx(relay, buf, producer);
+        ccnl_free(buf);
+        if (relay->pitcnt != pitcnt) {
+            fprintf(stderr, "%s: %s was not satisfied\n", policy, trace[i]);
+            return -1;
+        }
+    }
+    ns = bench_now() - t0;
+
+    ccnl_admit_str(relay, name, sizeof(name));
+    if (cfg->json) {
+        printf("{\"policy\":\"%s\",\"requests\":%ld,\"cs\":%d,\"hit_ratio\":%.4f,"
+               "\"admitted\":%llu,\"rejected\":%llu,\"req_per_s\":%.0f}\n",
+               name, count, cfg->cs, (double) hits / (double) count,
+               (unsigned long long) (relay->admit ? relay->admit->admitted : 0),
+               (unsigned long long) (relay->admit ? relay->admit->rejected : 0),
+               (double) count * 1e9 / (double) ns);
+    } else {
+        printf("%-10s %8.2f%% %10llu %10llu %10.0f\n", name,
+               100.0 * (double) hits / (double) count,
+               (unsigned long long) (relay->admit ? relay->admit->admitted : 0),
+               (unsigned long long) (relay->admit ? relay->admit->rejected : 0),
+               (double) count * 1e9 / (double) ns);
+    }
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    static struct ccnl_relay_s relay;
+    struct bench_cfg_s cfg;
+    sockunion consumer, producer;
+    struct ccnl_face_s *face;
+    struct ccnl_prefix_s *pfx;
+    char root[] = "/", **trace;
+    uint8_t *payload;
+    long count = 0, i;
+    size_t k;
+    int opt, rc = 0;
+
+    memset(&cfg, 0, sizeof(cfg));
+#ifdef CCNL_SINGLE_SUITE
+    cfg.suite = CCNL_ONLY_SUITE;
+#else
+    cfg.suite = CCNL_SUITE_NDNTLV;
+#endif
+    cfg.requests = 20000;
+    cfg.names = 20000;
+    cfg.zipf = 0.8;
+    cfg.scan = 0.3;
+    cfg.burst = 1000;
+    cfg.cs = 500;
+    cfg.paylen = 100;
+    cfg.seed = 1;
+    debug_level = ERROR;
+
+    while ((opt = getopt(argc, argv, "b:c:hjl:n:N:r:S:s:t:v:z:")) != -1) {
+        switch (opt) {
+        case 'b':
+            cfg.burst = atol(optarg);
+            break;
+        case 'c':
+            cfg.cs = atoi(optarg);
+            break;
+        case 'j':
+            cfg.json = 1;
+            break;
+        case 'l':
+            cfg.paylen = (size_t) atol(optarg);
+            break;
+        case 'n':
+            cfg.requests = atol(optarg);
+            break;
+        case 'N':
+            cfg.names = atol(optarg);
+            break;
+        case 'r':
+            cfg.seed = (unsigned) atol(optarg);
+            break;
+        case 'S':
+            cfg.scan = atof(optarg);
+            break;
+        case 's':
+            cfg.suite = ccnl_str2suite(optarg);
+            if (!ccnl_isSuite(cfg.suite)) {
+                goto usage;
+            }
+            break;
+        case 't':
+            cfg.trace = optarg;
+            break;
+        case 'v':
+#ifdef USE_LOGGING
+            if (isdigit(optarg[0])) {
+                debug_level = atoi(optarg);
+            } else {
+                debug_level = ccnl_debug_str2level(optarg);
+            }
+#endif
+            break;
+        case 'z':
+            cfg.zipf = atof(optarg);
+            break;
+        case 'h':
+        default:
+usage:
+            fprintf(stderr, "usage: %s [options]\n"
+                    "  -b BURST            requests per scan (default 1000)\n"
+                    "  -c CS_SIZE          (default 500)\n"
+                    "  -j                  JSON lines output\n"
+                    "  -l PAYLOAD_LEN      (default 100)\n"
+                    "  -n REQUESTS         (default 20000)\n"
+                    "  -N NAMES            popular names (default 20000)\n"
+                    "  -r SEED\n"
+                    "  -S SCAN_SHARE       of the requests (default 0.3)\n"
+                    "  -s SUITE            (ccnb, ccnx2015, ndn2013)\n"
+                    "  -t TRACE            file with a name per line, instead\n"
+                    "  -v DEBUG_LEVEL\n"
+                    "  -z ZIPF_ALPHA       0 for uniform (default 0.8)\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (cfg.requests < 1 || cfg.names < 1 || cfg.cs < 1 || cfg.burst < 1 ||
+        cfg.scan < 0 || cfg.scan > 1) {
+        goto usage;
+    }
+    bench_rnd_state = 0x9e3779b97f4a7c15ULL ^ cfg.seed;
+    srand(cfg.seed);
+
+    trace = cfg.trace ? bench_read_trace(cfg.trace, &count) :
+                        bench_make_trace(&cfg, &count);
+    if (!trace || count < 1) {
+        fprintf(stderr, "no requests\n");
+        return EXIT_FAILURE;
+    }
+
+    ccnl_core_init();
+    relay.max_cache_entries = cfg.cs;
+    relay.max_pit_entries = -1;
+    relay.ccnl_ll_TX_ptr = bench_tx_sink;
+    relay.ifcount = 1;
+    relay.ifs[0].addr.sa.sa_family = AF_INET;
+    relay.ifs[0].sock = -1;
+
+    memset(&consumer, 0, sizeof(consumer));
+    consumer.ip4.sin_family = AF_INET;
+    consumer.ip4.sin_addr.s_addr = htonl(0x0a000001);
+    consumer.ip4.sin_port = htons(9695);
+    producer = consumer;
+    producer.ip4.sin_addr.s_addr = htonl(0x0a010001);
+
+    // every name goes to the producer
+    face = ccnl_get_face_or_create(&relay, 0, &producer.sa, sizeof(producer.ip4));
+    pfx = ccnl_URItoPrefix(root, cfg.suite, NULL);
+    payload = (uint8_t *) malloc(cfg.paylen + 1);
+    if (!face || !pfx || ccnl_fib_add_entry(&relay, pfx, face) || !payload) {
+        fprintf(stderr, "setup failed\n");
+        return EXIT_FAILURE;
+    }
+    memset(payload, 'x', cfg.paylen + 1);
+
+    if (!cfg.json) {
+        if (cfg.trace) {
+            printf("# %s, %ld requests, cs %d\n", cfg.trace, count, cfg.cs);
+        } else {
+            printf("# %ld requests, %ld names, zipf %.2f, scans %.2f of %ld, cs %d\n",
+                   count, cfg.names, cfg.zipf, cfg.scan, cfg.burst, cfg.cs);
+        }
+        printf("%-10s %9s %10s %10s %10s\n", "policy", "hits", "admitted",
+               "rejected", "req/s");
+    }
+    for (k = 0; k < sizeof(bench_policies) / sizeof(bench_policies[0]); k++) {
+        if (bench_run(&relay, &cfg, bench_policies[k], trace, count,
+                      &consumer, &producer, payload)) {
+            rc = EXIT_FAILURE;
+            break;
+        }
+    }
+
+    bench_reset(&relay);
+    ccnl_admit_free(&relay);
+    for (i = 0; i < count; i++) {
+        free(trace[i]);
+    }
+    free(trace);
+    free(payload);
+    return rc;
+}
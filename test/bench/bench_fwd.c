@@ -0,0 +1,657 @@
+/*
+ * @f bench_fwd.c
+ * @b CCN lite, in-process throughput and latency benchmark of the forwarder
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/*
+ * Drives a relay through ccnl_core_RX() with pre-built packets, the
+ * ccnl_ll_TX_ptr sink only counts. Every packet is timed on its own, setup
+ * and cleanup between packets is not. Scenarios:
+ *
+ *   interest-hit   Interest answered from the CS (Zipf over the cached names)
+ *   interest-miss  Interest with a new name, added to the PIT and forwarded
+ *   data-satisfy   Data satisfying a PIT entry, sent on and added to the CS
+ *   aggregation    Interest for a pending name from a second face
+ *   duplicate      the same Interest again, from a second face
+ *
+ * Allocations are counted by wrapping malloc() at link time. With
+ * USE_DEBUG_MALLOC each ccnl_malloc() is two mallocs and a linear search
+ * on free, the numbers are only comparable between equal builds.
+ *
+ * Configured with -DCCNL_SINGLE_SUITE=NDNTLV the bench measures the
+ * single-suite forwarder, to compare with the default build.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+#include "ccnl-core.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-logging.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-relay.h"
+#include "ccnl-segment.h"
+
+#define BENCH_BATCH 256
+
+enum {
+    BENCH_INTEREST_HIT,
+    BENCH_INTEREST_MISS,
+    BENCH_DATA_SATISFY,
+    BENCH_AGGREGATION,
+    BENCH_DUPLICATE,
+    BENCH_COUNT
+};
+
+static const char *bench_names[BENCH_COUNT] = {
+    "interest-hit", "interest-miss", "data-satisfy", "aggregation", "duplicate"
+};
+
+// packets each scenario has to transmit per timed packet
+static const int bench_tx_expected[BENCH_COUNT] = { 1, 1, 1, 0, 0 };
+
+struct bench_cfg_s {
+    int suite;
+    long packets;       // timed packets per scenario
+    long names;         // name universe of the hit scenario
+    double zipf;        // 0: uniform
+    int cs;             // CS size
+    int pit;            // PIT entries kept pending
+    int fib;            // FIB entries
+    size_t paylen;
+    unsigned seed;
+    int json;
+};
+
+struct bench_result_s {
+    long packets;
+    uint64_t ns_total;
+    uint32_t *ns;       // per packet
+    uint64_t allocs;
+    uint64_t tx;
+};
+
+static uint64_t bench_allocs;
+static uint64_t bench_tx;
+static int bench_counting;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+
+void*
+__wrap_malloc(size_t size)
+{
+    bench_allocs += bench_counting;
+    return __real_malloc(size);
+}
+
+void*
+__wrap_calloc(size_t n, size_t size)
+{
+    bench_allocs += bench_counting;
+    return __real_calloc(n, size);
+}
+
+void*
+__wrap_realloc(void *p, size_t size)
+{
+    bench_allocs += bench_counting;
+    return __real_realloc(p, size);
+}
+
+static void
+bench_tx_sink(struct ccnl_relay_s *relay, struct ccnl_if_s *ifc,
+              sockunion *dst, struct ccnl_buf_s *buf)
+{
+    (void) relay;
+    (void) ifc;
+    (void) dst;
+    (void) buf;
+    bench_tx++;
+}
+
+static inline uint64_t
+bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// xorshift64*, reproducible across platforms
+static uint64_t bench_rnd_state;
+
+static uint64_t
+bench_rnd(void)
+{
+    bench_rnd_state ^= bench_rnd_state >> 12;
+    bench_rnd_state ^= bench_rnd_state << 25;
+    bench_rnd_state ^= bench_rnd_state >> 27;
+    return bench_rnd_state * 2685821657736338717ULL;
+}
+
+// ranks 0..n-1 with P(k) ~ 1/(k+1)^alpha
+static long*
+bench_zipf_trace(long n, long count, double alpha)
+{
+    double *cdf = (double *) malloc((size_t) n * sizeof(double)), sum = 0;
+    long *trace = (long *) malloc((size_t) count * sizeof(long)), i;
+
+    if (!cdf || !trace) {
+        free(cdf);
+        free(trace);
+        return NULL;
+    }
+    for (i = 0; i < n; i++) {
+        sum += alpha > 0 ? 1.0 / pow((double) (i + 1), alpha) : 1.0;
+        cdf[i] = sum;
+    }
+    for (i = 0; i < count; i++) {
+        double u = (double) (bench_rnd() >> 11) / 9007199254740992.0 * sum;
+        long lo = 0, hi = n - 1;
+
+        while (lo < hi) {
+            long mid = (lo + hi) / 2;
+            if (cdf[mid] < u) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        trace[i] = lo;
+    }
+    free(cdf);
+    return trace;
+}
+
+static struct ccnl_prefix_s*
+bench_name(struct bench_cfg_s *cfg, const char *kind, long n)
+{
+    char uri[128];
+
+    snprintf(uri, sizeof(uri), "/bench/p%ld/%s%ld", n % cfg->fib, kind, n);
+    return ccnl_URItoPrefix(uri, cfg->suite, NULL);
+}
+
+static struct ccnl_buf_s*
+bench_interest(struct bench_cfg_s *cfg, const char *kind, long n)
+{
+    struct ccnl_prefix_s *pfx = bench_name(cfg, kind, n);
+    ccnl_interest_opts_u opts;
+    struct ccnl_buf_s *buf;
+
+    if (!pfx) {
+        return NULL;
+    }
+    memset(&opts, 0, sizeof(opts));
+#ifdef USE_SUITE_NDNTLV
+    if (cfg->suite == CCNL_SUITE_NDNTLV) {
+        // unique nonces, the duplicate check must not drop anything
+        static int32_t nonce;
+        opts.ndntlv.nonce = ++nonce;
+    }
+#endif
+    buf = ccnl_mkSimpleInterest(pfx, &opts);
+    ccnl_prefix_free(pfx);
+    return buf;
+}
+
+static struct ccnl_buf_s*
+bench_data(struct bench_cfg_s *cfg, const char *kind, long n, uint8_t *payload)
+{
+    struct ccnl_prefix_s *pfx = bench_name(cfg, kind, n);
+    struct ccnl_buf_s *buf;
+
+    if (!pfx) {
+        return NULL;
+    }
+    buf = ccnl_mkSimpleContent(pfx, payload, cfg->paylen, NULL, NULL);
+    ccnl_prefix_free(pfx);
+    return buf;
+}
+
+// parsed like the relay's -d, ccnl_mkContentObject() does not set the suite
+static void
+bench_cache(struct ccnl_relay_s *relay, struct bench_cfg_s *cfg,
+            const char *kind, long n, uint8_t *payload)
+{
+    struct ccnl_buf_s *buf = bench_data(cfg, kind, n, payload);
+    struct ccnl_pkt_s *pkt;
+    struct ccnl_content_s *c = NULL;
+
+    if (!buf) {
+        return;
+    }
+    pkt = ccnl_bytes2content(buf->data, buf->datalen);
+    if (pkt) {
+        c = ccnl_content_new(&pkt);
+    }
+    if (c && !ccnl_content_add2cache(relay, c)) {
+        ccnl_content_free(c);
+    }
+    ccnl_pkt_free(pkt);
+    ccnl_free(buf);
+}
+
+static void
+bench_rx(struct ccnl_relay_s *relay, struct ccnl_buf_s *buf, sockunion *from,
+         struct bench_result_s *res)
+{
+    uint64_t t0, t1, allocs = bench_allocs, tx = bench_tx;
+
+    bench_counting = 1;
+    t0 = bench_now();
+    ccnl_core_RX(relay, 0, buf->data, buf->datalen, &from->sa, sizeof(from->ip4));
+    t1 = bench_now();
+    bench_counting = 0;
+
+    res->ns[res->packets++] = (uint32_t) (t1 - t0 < UINT32_MAX ? t1 - t0 : UINT32_MAX);
+    res->ns_total += t1 - t0;
+    res->allocs += bench_allocs - allocs;
+    res->tx += bench_tx - tx;
+}
+
+static void
+bench_rx_untimed(struct ccnl_relay_s *relay, struct ccnl_buf_s *buf,
+                 sockunion *from)
+{
+    ccnl_core_RX(relay, 0, buf->data, buf->datalen, &from->sa, sizeof(from->ip4));
+}
+
+// keeps cfg->pit entries pending: remembers new entries, drops the oldest
+struct bench_pitring_s {
+    struct ccnl_interest_s **ring;
+    long size, cnt, pos;
+};
+
+static void
+bench_pit_track(struct ccnl_relay_s *relay, struct bench_pitring_s *r,
+                struct ccnl_interest_s *before)
+{
+    if (!relay->pit || relay->pit == before) {
+        return;
+    }
+    if (r->cnt == r->size) {
+        ccnl_interest_remove(relay, r->ring[r->pos]);
+        r->cnt--;
+    }
+    r->ring[r->pos] = relay->pit;
+    r->pos = (r->pos + 1) % r->size;
+    r->cnt++;
+}
+
+static void
+bench_reset(struct ccnl_relay_s *relay)
+{
+    while (relay->pit) {
+        ccnl_interest_remove(relay, relay->pit);
+    }
+    while (relay->contents) {
+        ccnl_content_remove(relay, relay->contents);
+    }
+}
+
+static int
+bench_run(struct ccnl_relay_s *relay, struct bench_cfg_s *cfg, int scenario,
+          sockunion *consumer, sockunion *consumer2, sockunion *producer,
+          uint8_t *payload, struct bench_result_s *res)
+{
+    struct bench_pitring_s ring;
+    struct ccnl_buf_s **pkts, **pkts2 = NULL;
+    struct ccnl_interest_s *head;
+    long b, n, i, cached = cfg->names < cfg->cs ? cfg->names : cfg->cs, *trace = NULL;
+
+    memset(res, 0, sizeof(*res));
+    memset(&ring, 0, sizeof(ring));
+    res->ns = (uint32_t *) malloc((size_t) cfg->packets * sizeof(uint32_t));
+    pkts = (struct ccnl_buf_s **) calloc(BENCH_BATCH, sizeof(*pkts));
+    ring.size = cfg->pit > 0 ? cfg->pit : 1;
+    ring.ring = (struct ccnl_interest_s **) calloc((size_t) ring.size, sizeof(*ring.ring));
+    if (scenario == BENCH_DATA_SATISFY || scenario == BENCH_AGGREGATION) {
+        pkts2 = (struct ccnl_buf_s **) calloc(BENCH_BATCH, sizeof(*pkts2));
+    }
+    if (!res->ns || !pkts || !ring.ring ||
+        ((scenario == BENCH_DATA_SATISFY || scenario == BENCH_AGGREGATION) && !pkts2)) {
+        return -1;
+    }
+
+    // fill the CS and the PIT to their configured sizes
+    bench_reset(relay);
+    if (scenario == BENCH_INTEREST_HIT) {
+        for (i = cached - 1; i >= 0; i--) {
+            bench_cache(relay, cfg, "h", i, payload);
+        }
+        trace = bench_zipf_trace(cached, cfg->packets, cfg->zipf);
+        if (!trace) {
+            return -1;
+        }
+    } else {
+        for (i = 0; i < cfg->cs; i++) {
+            bench_cache(relay, cfg, "c", i, payload);
+        }
+    }
+    for (i = 0; i < cfg->pit; i++) {
+        struct ccnl_buf_s *buf = bench_interest(cfg, "q", i);
+
+        head = relay->pit;
+        if (buf) {
+            bench_rx_untimed(relay, buf, consumer);
+            ccnl_free(buf);
+        }
+        bench_pit_track(relay, &ring, head);
+    }
+
+    for (b = 0; b < cfg->packets; b += n) {
+        n = cfg->packets - b < BENCH_BATCH ? cfg->packets - b : BENCH_BATCH;
+
+        // pre-build a batch, few live blocks keep USE_DEBUG_MALLOC's free cheap
+        for (i = 0; i < n; i++) {
+            switch (scenario) {
+            case BENCH_INTEREST_HIT:
+                pkts[i] = bench_interest(cfg, "h", trace[b + i]);
+                break;
+            case BENCH_INTEREST_MISS:
+                pkts[i] = bench_interest(cfg, "m", b + i);
+                break;
+            case BENCH_DATA_SATISFY:
+                pkts[i] = bench_interest(cfg, "d", b + i);
+                pkts2[i] = bench_data(cfg, "d", b + i, payload);
+                break;
+            case BENCH_AGGREGATION:
+                pkts[i] = bench_interest(cfg, "a", b + i);
+                pkts2[i] = bench_interest(cfg, "a", b + i);
+                break;
+            case BENCH_DUPLICATE: // the same packet again, e.g. a looping one
+                pkts[i] = bench_interest(cfg, "u", b + i);
+                break;
+            default:
+                break;
+            }
+            if (!pkts[i] || (pkts2 && !pkts2[i])) {
+                return -1;
+            }
+        }
+
+        for (i = 0; i < n; i++) {
+            switch (scenario) {
+            case BENCH_INTEREST_HIT:
+                bench_rx(relay, pkts[i], consumer, res);
+                break;
+            case BENCH_INTEREST_MISS:
+                head = relay->pit;
+                bench_rx(relay, pkts[i], consumer, res);
+                bench_pit_track(relay, &ring, head);
+                break;
+            case BENCH_DATA_SATISFY:
+                bench_rx_untimed(relay, pkts[i], consumer);
+                bench_tx--; // the Interest was forwarded
+                bench_rx(relay, pkts2[i], producer, res);
+                break;
+            case BENCH_AGGREGATION:
+                head = relay->pit;
+                bench_rx_untimed(relay, pkts[i], consumer);
+                bench_tx--;
+                bench_pit_track(relay, &ring, head);
+                bench_rx(relay, pkts2[i], consumer2, res);
+                break;
+            case BENCH_DUPLICATE:
+                head = relay->pit;
+                bench_rx_untimed(relay, pkts[i], consumer);
+                bench_tx--;
+                bench_pit_track(relay, &ring, head);
+                bench_rx(relay, pkts[i], consumer2, res);
+                break;
+            default:
+                break;
+            }
+        }
+
+        for (i = 0; i < n; i++) {
+            ccnl_free(pkts[i]);
+            if (pkts2) {
+                ccnl_free(pkts2[i]);
+            }
+        }
+    }
+
+    free(pkts);
+    free(pkts2);
+    free(ring.ring);
+    free(trace);
+    return 0;
+}
+
+static int
+bench_cmp(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+
+    return x < y ? -1 : x > y;
+}
+
+static uint32_t
+bench_pct(struct bench_result_s *res, double p)
+{
+    long i = (long) (p * (double) (res->packets - 1) + 0.5);
+
+    return res->ns[i];
+}
+
+static void
+bench_report(struct bench_cfg_s *cfg, int scenario, struct bench_result_s *res)
+{
+    double n = (double) res->packets;
+    double pps = res->ns_total ? n * 1e9 / (double) res->ns_total : 0;
+
+    qsort(res->ns, (size_t) res->packets, sizeof(uint32_t), bench_cmp);
+    if (cfg->json) {
+        printf("{\"scenario\":\"%s\",\"suite\":\"%s\",\"packets\":%ld,"
+               "\"names\":%ld,\"zipf\":%.2f,\"cs\":%d,\"pit\":%d,\"fib\":%d,"
+               "\"pps\":%.0f,\"ns_mean\":%.1f,\"ns_p50\":%u,\"ns_p90\":%u,"
+               "\"ns_p99\":%u,\"ns_p999\":%u,\"allocs_per_pkt\":%.2f,"
+               "\"tx_per_pkt\":%.2f}\n",
+               bench_names[scenario], ccnl_suite2str(cfg->suite), res->packets,
+               cfg->names, cfg->zipf, cfg->cs, cfg->pit, cfg->fib,
+               pps, (double) res->ns_total / n, bench_pct(res, 0.5),
+               bench_pct(res, 0.9), bench_pct(res, 0.99), bench_pct(res, 0.999),
+               (double) res->allocs / n, (double) res->tx / n);
+    } else {
+        printf("%-14s %10.0f %8.1f %8u %8u %8u %8u %8.2f %6.2f\n",
+               bench_names[scenario], pps, (double) res->ns_total / n,
+               bench_pct(res, 0.5), bench_pct(res, 0.9), bench_pct(res, 0.99),
+               bench_pct(res, 0.999), (double) res->allocs / n,
+               (double) res->tx / n);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    static struct ccnl_relay_s relay;
+    struct bench_cfg_s cfg;
+    struct bench_result_s res;
+    sockunion consumer, consumer2, producer;
+    struct ccnl_face_s *face;
+    uint8_t *payload;
+    int opt, i, rc = 0;
+
+    memset(&cfg, 0, sizeof(cfg));
+#ifdef CCNL_SINGLE_SUITE
+    cfg.suite = CCNL_ONLY_SUITE;
+#else
+    cfg.suite = CCNL_SUITE_NDNTLV;
+#endif
+    cfg.packets = 20000;
+    cfg.names = 10000;
+    cfg.zipf = 0.8;
+    cfg.cs = 1000;
+    cfg.pit = 100;
+    cfg.fib = 100;
+    cfg.paylen = 100;
+    cfg.seed = 1;
+    debug_level = ERROR;
+
+    while ((opt = getopt(argc, argv, "hc:f:jl:n:N:p:r:s:v:z:")) != -1) {
+        switch (opt) {
+        case 'c':
+            cfg.cs = atoi(optarg);
+            break;
+        case 'f':
+            cfg.fib = atoi(optarg);
+            break;
+        case 'j':
+            cfg.json = 1;
+            break;
+        case 'l':
+            cfg.paylen = (size_t) atol(optarg);
+            break;
+        case 'n':
+            cfg.packets = atol(optarg);
+            break;
+        case 'N':
+            cfg.names = atol(optarg);
+            break;
+        case 'p':
+            cfg.pit = atoi(optarg);
+            break;
+        case 'r':
+            cfg.seed = (unsigned) atol(optarg);
+            break;
+        case 's':
+            cfg.suite = ccnl_str2suite(optarg);
+            if (!ccnl_isSuite(cfg.suite)) {
+                goto usage;
+            }
+            break;
+        case 'v':
+#ifdef USE_LOGGING
+            if (isdigit(optarg[0])) {
+                debug_level = atoi(optarg);
+            } else {
+                debug_level = ccnl_debug_str2level(optarg);
+            }
+#endif
+            break;
+        case 'z':
+            cfg.zipf = atof(optarg);
+            break;
+        case 'h':
+        default:
+usage:
+            fprintf(stderr, "usage: %s [options]\n"
+                    "  -c CS_SIZE          (default 1000)\n"
+                    "  -f FIB_ENTRIES      (default 100)\n"
+                    "  -j                  JSON lines output\n"
+                    "  -l PAYLOAD_LEN      (default 100)\n"
+                    "  -n PACKETS          per scenario (default 20000)\n"
+                    "  -N NAMES            name universe (default 10000)\n"
+                    "  -p PIT_ENTRIES      kept pending (default 100)\n"
+                    "  -r SEED\n"
+                    "  -s SUITE            (ccnb, ccnx2015, ndn2013)\n"
+                    "  -v DEBUG_LEVEL\n"
+                    "  -z ZIPF_ALPHA       0 for uniform (default 0.8)\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (cfg.packets < 1 || cfg.names < 1 || cfg.cs < 1 || cfg.pit < 0 ||
+        cfg.fib < 1) {
+        goto usage;
+    }
+    bench_rnd_state = 0x9e3779b97f4a7c15ULL ^ cfg.seed;
+
+    ccnl_core_init();
+    relay.max_cache_entries = cfg.cs;
+    relay.max_pit_entries = -1;
+    relay.ccnl_ll_TX_ptr = bench_tx_sink;
+    relay.ifcount = 1;
+    relay.ifs[0].addr.sa.sa_family = AF_INET;
+    relay.ifs[0].sock = -1;
+
+    memset(&consumer, 0, sizeof(consumer));
+    consumer.ip4.sin_family = AF_INET;
+    consumer.ip4.sin_addr.s_addr = htonl(0x0a000001);
+    consumer.ip4.sin_port = htons(9695);
+    consumer2 = consumer;
+    consumer2.ip4.sin_addr.s_addr = htonl(0x0a000002);
+    producer = consumer;
+    producer.ip4.sin_addr.s_addr = htonl(0x0a010001);
+
+    face = ccnl_get_face_or_create(&relay, 0, &producer.sa, sizeof(producer.ip4));
+    for (i = 0; face && i < cfg.fib; i++) {
+        char uri[64];
+        struct ccnl_prefix_s *pfx;
+
+        snprintf(uri, sizeof(uri), "/bench/p%d", i);
+        pfx = ccnl_URItoPrefix(uri, cfg.suite, NULL);
+        if (!pfx || ccnl_fib_add_entry(&relay, pfx, face)) {
+            face = NULL;
+        }
+    }
+    payload = (uint8_t *) malloc(cfg.paylen + 1);
+    if (!face || !payload) {
+        fprintf(stderr, "setup failed\n");
+        return EXIT_FAILURE;
+    }
+    memset(payload, 'x', cfg.paylen + 1);
+
+#ifdef USE_DEBUG_MALLOC
+    fprintf(stderr, "note: built with USE_DEBUG_MALLOC\n");
+#endif
+#ifdef CCNL_SINGLE_SUITE
+    fprintf(stderr, "note: single-suite build\n");
+#endif
+    if (!cfg.json) {
+        printf("# suite %s, %ld packets, %ld names, zipf %.2f, cs %d, pit %d, fib %d\n",
+               ccnl_suite2str(cfg.suite), cfg.packets, cfg.names, cfg.zipf,
+               cfg.cs, cfg.pit, cfg.fib);
+        printf("%-14s %10s %8s %8s %8s %8s %8s %8s %6s\n", "scenario", "pkt/s",
+               "ns/mean", "p50", "p90", "p99", "p99.9", "allocs", "tx");
+    }
+    for (i = 0; i < BENCH_COUNT; i++) {
+        if (bench_run(&relay, &cfg, i, &consumer, &consumer2, &producer,
+                      payload, &res)) {
+            fprintf(stderr, "%s: setup failed\n", bench_names[i]);
+            return EXIT_FAILURE;
+        }
+        bench_report(&cfg, i, &res);
+        if (res.tx != (uint64_t) bench_tx_expected[i] * (uint64_t) res.packets) {
+            fprintf(stderr, "%s: %llu packets sent, expected %ld\n",
+                    bench_names[i], (unsigned long long) res.tx,
+                    bench_tx_expected[i] * res.packets);
+            rc = EXIT_FAILURE;
+        }
+        free(res.ns);
+    }
+
+    bench_reset(&relay);
+    free(payload);
+    return rc;
+}
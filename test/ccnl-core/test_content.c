@@ -20,10 +20,22 @@
 #include <stddef.h>
 #include <setjmp.h>
 #include <cmocka.h>
- 
+#include <string.h>
+#include <openssl/sha.h>
+
+#define USE_SUITE_NDNTLV
+#ifndef NEEDS_PACKET_CRAFTING
+#define NEEDS_PACKET_CRAFTING
+#endif
+
 #include "ccnl-pkt.h"
 #include "ccnl-malloc.h"
 #include "ccnl-content.h"
+#include "ccnl-relay.h"
+#include "ccnl-buf.h"
+#include "ccnl-prefix.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-snapshot.h"
 
 void test_ccnl_content_new_invalid()
 {
@@ -67,6 +79,213 @@ void test_ccnl_content_free_valid()
     assert_int_equal(result, 0);
 }
 
+static struct ccnl_content_s*
+content_from(const char *uri)
+{
+    char name[64];
+
+    strncpy(name, uri, sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    return ccnl_mkContentObject(ccnl_URItoPrefix(name, CCNL_SUITE_NDNTLV, NULL),
+                                (uint8_t *) "data", 4, NULL);
+}
+
+void test_ccnl_content_digest_cached()
+{
+    struct ccnl_content_s *content = content_from("/test/a");
+    unsigned char expected[SHA256_DIGEST_LENGTH], *md;
+
+    SHA256(content->pkt->buf->data, content->pkt->buf->datalen, expected);
+    md = ccnl_content_digest(content);
+    assert_non_null(md);
+    assert_memory_equal(md, expected, sizeof(expected));
+
+    /** the digest is not recomputed */
+    content->pkt->buf->data[content->pkt->buf->datalen - 1] ^= 0xff;
+    assert_true(ccnl_content_digest(content) == md);
+    assert_memory_equal(md, expected, sizeof(expected));
+
+    ccnl_content_free(content);
+}
+
+void test_ccnl_content_lookup_digest()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *a = content_from("/test/a"), *b = content_from("/test/b");
+    struct ccnl_content_s *c = content_from("/test/c");
+    unsigned char md[SHA256_DIGEST_LENGTH];
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = -1;
+    ccnl_content_add2cache(&relay, a);
+    ccnl_content_add2cache(&relay, b);
+    memcpy(md, ccnl_content_digest(a), sizeof(md));
+
+    /** the index is built by the first lookup and kept up to date */
+    assert_true(ccnl_content_lookup_digest(&relay, md) == a);
+    ccnl_content_add2cache(&relay, c);
+    assert_true(ccnl_content_lookup_digest(&relay, ccnl_content_digest(c)) == c);
+    ccnl_content_remove(&relay, a);
+    assert_null(ccnl_content_lookup_digest(&relay, md));
+    assert_true(ccnl_content_lookup_digest(&relay, ccnl_content_digest(b)) == b);
+
+    ccnl_core_cleanup(&relay);
+}
+
+void test_ccnl_content_victim()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *a = content_from("/test/a"), *b = content_from("/test/b");
+    struct ccnl_content_s *c = content_from("/test/c");
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = 3;
+    assert_null(ccnl_content_victim(&relay));
+    ccnl_content_add2cache(&relay, a);
+    ccnl_content_add2cache(&relay, b);
+    ccnl_content_add2cache(&relay, c);
+
+    /** the first cached goes first, unless it was used since */
+    assert_true(ccnl_content_victim(&relay) == a);
+    ccnl_content_touch(&relay, a);
+    assert_true(ccnl_content_victim(&relay) == b);
+    assert_true(relay.contents == a);
+
+    /** static entries stay */
+    ccnl_content_set_static(&relay, b);
+    assert_true(ccnl_content_victim(&relay) == c);
+    ccnl_content_remove(&relay, c);
+    assert_true(ccnl_content_victim(&relay) == a);
+    assert_true(relay.contentsend == b);
+
+    ccnl_core_cleanup(&relay);
+    assert_null(relay.contentsend);
+}
+
+void test_ccnl_content_freshness()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *a = content_from("/test/a"), *b = content_from("/test/b");
+    struct ccnl_content_s *b2 = content_from("/test/b");
+    double t0;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = 2;
+    a->pkt->suite = b->pkt->suite = b2->pkt->suite = CCNL_SUITE_NDNTLV;
+    b->pkt->s.ndntlv.freshnessperiod = 20;
+    b2->pkt->s.ndntlv.freshnessperiod = 60000;
+    ccnl_content_add2cache(&relay, b);
+    ccnl_content_add2cache(&relay, a);
+
+    /** without a freshness period content is stale right away, and goes first */
+    assert_true(a->flags & CCNL_CONTENT_FLAGS_STALE);
+    assert_false(b->flags & CCNL_CONTENT_FLAGS_STALE);
+    assert_true(ccnl_content_victim(&relay) == a);
+
+    for (t0 = CCNL_NOW(); CCNL_NOW() < t0 + 0.03;);
+    ccnl_content_expire(&relay);
+    assert_true(b->flags & CCNL_CONTENT_FLAGS_STALE);
+    assert_true(ccnl_content_victim(&relay) == a);
+
+    /** a new copy is fresh again */
+    assert_null(ccnl_content_add2cache(&relay, b2));
+    assert_false(b->flags & CCNL_CONTENT_FLAGS_STALE);
+    assert_int_equal(relay.freshcnt, 1);
+
+    ccnl_content_free(b2);
+    ccnl_core_cleanup(&relay);
+    assert_int_equal(relay.freshcnt, 0);
+    assert_null(relay.stale);
+}
+
+void test_ccnl_content_snapshot_stale()
+{
+    struct ccnl_relay_s relay, relay2;
+    char uri[] = "/test/f", path[] = "test_content.snapshot";
+    ccnl_data_opts_u opts;
+    struct ccnl_content_s *c;
+    int cnt;
+
+    memset(&opts, 0, sizeof(opts));
+    opts.ndntlv.freshnessperiod = 60000;
+    memset(&relay, 0, sizeof(relay));
+    memset(&relay2, 0, sizeof(relay2));
+    relay.max_cache_entries = relay2.max_cache_entries = -1;
+    c = content_from("/test/a");
+    c->pkt->suite = CCNL_SUITE_NDNTLV;
+    ccnl_content_add2cache(&relay, c);
+    c = content_from("/test/b");
+    c->pkt->suite = CCNL_SUITE_NDNTLV;
+    ccnl_content_add2cache(&relay, c);
+    c = ccnl_mkContentObject(ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL),
+                             (uint8_t *) "data", 4, &opts);
+    c->pkt->suite = CCNL_SUITE_NDNTLV;
+    ccnl_content_add2cache(&relay, c);
+    assert_true(relay.stale && relay.stale->stale_next);
+    assert_int_equal(ccnl_snapshot_save(&relay, path), 0);
+
+    /** stale content comes back on a consistent stale list */
+    assert_int_equal(ccnl_snapshot_load(&relay2, path), 3);
+    remove(path);
+    assert_int_equal(relay2.contentcnt, 3);
+    assert_int_equal(relay2.freshcnt, 1);
+    for (cnt = 0, c = relay2.stale; c; c = c->stale_next, cnt++) {
+        assert_true(c->flags & CCNL_CONTENT_FLAGS_STALE);
+        assert_true(c->stale_next || relay2.staleend == c);
+    }
+    assert_int_equal(cnt, 2);
+
+    /** and leaves it again one by one */
+    ccnl_content_remove(&relay2, ccnl_content_victim(&relay2));
+    ccnl_content_remove(&relay2, ccnl_content_victim(&relay2));
+    assert_null(relay2.stale);
+    assert_null(relay2.staleend);
+    assert_int_equal(relay2.contentcnt, 1);
+
+    ccnl_core_cleanup(&relay);
+    ccnl_core_cleanup(&relay2);
+}
+
+void test_ccnl_content_admission()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *a = content_from("/test/a"), *b = content_from("/test/b");
+    struct ccnl_content_s *c = content_from("/test/c"), *d = content_from("/test/d");
+    char buf[32];
+    int i;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = 2;
+    assert_int_equal(ccnl_admit_set(&relay, "bogus"), -1);
+    assert_int_equal(ccnl_admit_set(&relay, "prob:2"), -1);
+    assert_int_equal(ccnl_admit_set(&relay, "second"), 0);
+    assert_string_equal(ccnl_admit_str(&relay, buf, sizeof(buf)), "second");
+
+    /** a store with room takes everything */
+    assert_true(cache_strategy_cache(&relay, a));
+    ccnl_content_add2cache(&relay, a);
+    ccnl_content_add2cache(&relay, b);
+
+    /** a name is admitted the second time */
+    assert_false(cache_strategy_cache(&relay, c));
+    assert_true(cache_strategy_cache(&relay, c));
+
+    /** a name requested more often than the victim's is admitted */
+    assert_int_equal(ccnl_admit_set(&relay, "tinylfu"), 0);
+    for (i = 0; i < 3; i++) {
+        ccnl_admit_seen(&relay, ccnl_prefix_hash(c->pkt->pfx));
+    }
+    assert_true(cache_strategy_cache(&relay, c));
+    assert_false(cache_strategy_cache(&relay, d));
+    assert_int_equal(relay.admit->admitted, 1);
+    assert_int_equal(relay.admit->rejected, 1);
+
+    ccnl_content_free(c);
+    ccnl_content_free(d);
+    ccnl_core_cleanup(&relay);
+    assert_null(relay.admit);
+}
+
 int main(void)
 {
     const UnitTest tests[] = {
@@ -74,6 +293,12 @@ int main(void)
         unit_test(test_ccnl_content_new_valid),
         unit_test(test_ccnl_content_free_invalid),
         unit_test(test_ccnl_content_free_valid),
+        unit_test(test_ccnl_content_digest_cached),
+        unit_test(test_ccnl_content_lookup_digest),
+        unit_test(test_ccnl_content_victim),
+        unit_test(test_ccnl_content_freshness),
+        unit_test(test_ccnl_content_snapshot_stale),
+        unit_test(test_ccnl_content_admission),
     };
     
     return run_tests(tests);
@@ -0,0 +1,331 @@
+/**
+ * @file test_diskstore.c
+ * @brief Tests for the disk backed second tier of the Content Store
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <sys/select.h>
+
+#define USE_SUITE_NDNTLV
+#ifndef NEEDS_PACKET_CRAFTING
+#define NEEDS_PACKET_CRAFTING
+#endif
+
+#include "ccnl-pkt.h"
+#include "ccnl-malloc.h"
+#include "ccnl-content.h"
+#include "ccnl-interest.h"
+#include "ccnl-relay.h"
+#include "ccnl-prefix.h"
+#include "ccnl-forward.h"
+#include "ccnl-callbacks.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-diskstore.h"
+
+#define DISKDIR "test_diskstore.d"
+
+static uint8_t sent[CCNL_MAX_PACKET_SIZE];
+static size_t sentlen;
+static int sentcnt, forwarded;
+
+static void
+keep_tx(struct ccnl_relay_s *relay, struct ccnl_if_s *ifc,
+        sockunion *dest, struct ccnl_buf_s *buf)
+{
+    (void) relay;
+    (void) ifc;
+    (void) dest;
+    sentlen = buf->datalen < sizeof(sent) ? buf->datalen : sizeof(sent);
+    memcpy(sent, buf->data, sentlen);
+    sentcnt++;
+}
+
+static void
+count_tap(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+          struct ccnl_prefix_s *pfx, struct ccnl_buf_s *buf)
+{
+    (void) relay;
+    (void) from;
+    (void) pfx;
+    (void) buf;
+    forwarded++;
+}
+
+static int
+sent_has(const char *s)
+{
+    size_t k, n = strlen(s);
+
+    for (k = 0; k + n <= sentlen; k++) {
+        if (!memcmp(sent + k, s, n)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void
+clear_dir(void)
+{
+    char path[300];
+    struct dirent *de;
+    DIR *d = opendir(DISKDIR);
+
+    if (!d) {
+        return;
+    }
+    while ((de = readdir(d))) {
+        if (de->d_name[0] != '.') {
+            snprintf(path, sizeof(path), "%s/%s", DISKDIR, de->d_name);
+            remove(path);
+        }
+    }
+    closedir(d);
+    remove(DISKDIR);
+}
+
+static struct ccnl_content_s*
+content_from(const char *uri, const char *payload)
+{
+    char name[64];
+    struct ccnl_prefix_s *pfx;
+    struct ccnl_content_s *c;
+
+    strncpy(name, uri, sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    pfx = ccnl_URItoPrefix(name, CCNL_SUITE_NDNTLV, NULL);
+    c = ccnl_mkContentObject(pfx, (uint8_t *) payload, strlen(payload), NULL);
+    ccnl_prefix_free(pfx);
+    c->pkt->suite = CCNL_SUITE_NDNTLV;
+    return c;
+}
+
+// hands an Interest to the disk store as the forwarder does on a CS miss
+static int
+interest_miss(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+              const char *uri, int32_t nonce, uint64_t minsuffix, int mbf)
+{
+    char name[64];
+    struct ccnl_prefix_s *pfx;
+    ccnl_interest_opts_u opts;
+    struct ccnl_buf_s *buf;
+    struct ccnl_pkt_s *pkt;
+    uint8_t *data;
+    size_t datalen, len;
+    uint64_t typ;
+    int rc;
+
+    strncpy(name, uri, sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    pfx = ccnl_URItoPrefix(name, CCNL_SUITE_NDNTLV, NULL);
+    memset(&opts, 0, sizeof(opts));
+    opts.ndntlv.nonce = nonce;
+    opts.ndntlv.interestlifetime = 4000;
+    opts.ndntlv.mustbefresh = mbf;
+    buf = ccnl_mkSimpleInterest(pfx, &opts);
+    ccnl_prefix_free(pfx);
+    data = buf->data;
+    datalen = buf->datalen;
+    assert_int_equal(ccnl_ndntlv_dehead(&data, &datalen, &typ, &len), 0);
+    pkt = ccnl_ndntlv_bytes2pkt(typ, buf->data, &data, &datalen);
+    ccnl_free(buf);
+    pkt->s.ndntlv.minsuffix = minsuffix;
+
+    rc = ccnl_callback_cs_miss(relay, from, &pkt);
+    ccnl_pkt_free(pkt);
+    return rc;
+}
+
+// runs the completions of the disk store until an Interest is answered or
+// forwarded
+static void
+wait_reads(struct ccnl_relay_s *relay)
+{
+    struct timeval tv;
+    fd_set fds;
+    int k, fd = ccnl_diskstore_fd(), events = sentcnt + forwarded;
+
+    for (k = 0; k < 50 && sentcnt + forwarded == events; k++) {
+        FD_ZERO(&fds);
+        FD_SET(fd, &fds);
+        tv.tv_sec = 0;
+        tv.tv_usec = 100000;
+        if (select(fd + 1, &fds, NULL, NULL, &tv) > 0) {
+            ccnl_diskstore_complete(relay);
+        }
+    }
+}
+
+void test_ccnl_diskstore_replaced()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+
+    clear_dir();
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = 1;
+    relay.max_pit_entries = -1;
+    relay.ccnl_ll_TX_ptr = keep_tx;
+    face->faceid = 1;
+    sentcnt = 0;
+    assert_int_equal(ccnl_diskstore_open(&relay, DISKDIR, 0), 0);
+
+    /** content that replaces a copy of the same length goes to disk too */
+    ccnl_content_add2cache(&relay, content_from("/disk/a", "one1"));
+    ccnl_content_add2cache(&relay, content_from("/disk/b", "data"));
+    ccnl_content_add2cache(&relay, content_from("/disk/a", "two2"));
+    ccnl_content_add2cache(&relay, content_from("/disk/c", "data"));
+    ccnl_diskstore_close();
+
+    /** after a restart the newest copy is served */
+    assert_int_equal(ccnl_diskstore_open(&relay, DISKDIR, 0), 0);
+    assert_int_equal(interest_miss(&relay, face, "/disk/a", 1, 0, 0), CCNL_CS_MISS_DEFERRED);
+    wait_reads(&relay);
+    assert_int_equal(sentcnt, 1);
+    assert_true(sent_has("two2"));
+
+    ccnl_diskstore_close();
+    ccnl_core_cleanup(&relay);
+    ccnl_free(face);
+    clear_dir();
+}
+
+void test_ccnl_diskstore_close_busy()
+{
+    struct ccnl_relay_s relay;
+    char uri[32];
+    int k;
+
+    clear_dir();
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = 1;
+    assert_int_equal(ccnl_diskstore_open(&relay, DISKDIR, 0), 0);
+
+    /** more finished jobs than a pipe holds do not stop the shutdown */
+    for (k = 0; k < 20000; k++) {
+        snprintf(uri, sizeof(uri), "/disk/busy/%d", k);
+        ccnl_content_add2cache(&relay, content_from(uri, "data"));
+    }
+    ccnl_diskstore_close();
+    assert_int_equal(ccnl_diskstore_fd(), -1);
+
+    ccnl_core_cleanup(&relay);
+    clear_dir();
+}
+
+void test_ccnl_diskstore_unsatisfied()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+    struct ccnl_forward_s *fwd = ccnl_calloc(1, sizeof(*fwd));
+    char uri[] = "/disk";
+
+    clear_dir();
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = 1;
+    relay.max_pit_entries = -1;
+    relay.ccnl_ll_TX_ptr = keep_tx;
+    fwd->prefix = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+    fwd->suite = CCNL_SUITE_NDNTLV;
+    fwd->tap = count_tap;
+    relay.fib = fwd;
+    face->faceid = 1;
+    sentcnt = forwarded = 0;
+    assert_int_equal(ccnl_diskstore_open(&relay, DISKDIR, 0), 0);
+    ccnl_content_add2cache(&relay, content_from("/disk/a", "data"));
+    ccnl_content_add2cache(&relay, content_from("/disk/b", "data"));
+
+    /** an Interest the record does not satisfy goes upstream, a CS miss */
+    assert_int_equal(interest_miss(&relay, face, "/disk/a", 1, 2, 0), CCNL_CS_MISS_DEFERRED);
+    assert_int_equal(forwarded, 0);
+    wait_reads(&relay);
+    assert_int_equal(forwarded, 1);
+    assert_int_equal(sentcnt, 0);
+    assert_non_null(relay.pit);
+    assert_int_equal(face->stats.cs_misses, 1);
+
+    ccnl_diskstore_close();
+    ccnl_core_cleanup(&relay);
+    ccnl_free(face);
+    clear_dir();
+}
+
+void test_ccnl_diskstore_freshness()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+    struct ccnl_forward_s *fwd = ccnl_calloc(1, sizeof(*fwd));
+    struct ccnl_content_s *c;
+    char uri[] = "/disk";
+
+    clear_dir();
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = 1;
+    relay.max_pit_entries = -1;
+    relay.ccnl_ll_TX_ptr = keep_tx;
+    fwd->prefix = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+    fwd->suite = CCNL_SUITE_NDNTLV;
+    fwd->tap = count_tap;
+    relay.fib = fwd;
+    face->faceid = 1;
+    sentcnt = forwarded = 0;
+    assert_int_equal(ccnl_diskstore_open(&relay, DISKDIR, 0), 0);
+    ccnl_content_add2cache(&relay, content_from("/disk/stale", "data"));
+    c = content_from("/disk/fresh", "data");
+    c->pkt->s.ndntlv.freshnessperiod = 60000;
+    ccnl_content_add2cache(&relay, c);
+    ccnl_content_add2cache(&relay, content_from("/disk/other", "data"));
+
+    /** content that was stale when it went to disk is still stale */
+    assert_int_equal(interest_miss(&relay, face, "/disk/stale", 1, 0, 1), CCNL_CS_MISS_DEFERRED);
+    wait_reads(&relay);
+    assert_int_equal(forwarded, 1);
+    assert_int_equal(sentcnt, 0);
+    assert_true(relay.contents->flags & CCNL_CONTENT_FLAGS_STALE);
+
+    /** fresh content keeps the rest of its period */
+    assert_int_equal(interest_miss(&relay, face, "/disk/fresh", 2, 0, 1), CCNL_CS_MISS_DEFERRED);
+    wait_reads(&relay);
+    assert_int_equal(forwarded, 1);
+    assert_int_equal(sentcnt, 1);
+    c = relay.contents;
+    assert_false(c->flags & CCNL_CONTENT_FLAGS_STALE);
+    assert_true(c->freshpos != 0);
+
+    ccnl_diskstore_close();
+    ccnl_core_cleanup(&relay);
+    ccnl_free(face);
+    clear_dir();
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_diskstore_replaced),
+        unit_test(test_ccnl_diskstore_close_busy),
+        unit_test(test_ccnl_diskstore_unsatisfied),
+        unit_test(test_ccnl_diskstore_freshness),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,340 @@
+/**
+ * @file test_fastpath.c
+ * @brief Tests for the Interest fast path
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+
+#ifndef USE_SUITE_NDNTLV
+#define USE_SUITE_NDNTLV
+#endif
+#ifndef NEEDS_PACKET_CRAFTING
+#define NEEDS_PACKET_CRAFTING
+#endif
+
+#include "ccnl-pkt.h"
+#include "ccnl-malloc.h"
+#include "ccnl-content.h"
+#include "ccnl-interest.h"
+#include "ccnl-relay.h"
+#include "ccnl-prefix.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-fastpath.h"
+#include "ccnl-fwd.h"
+
+static int sent;
+
+static void
+count_tx(struct ccnl_relay_s *relay, struct ccnl_if_s *ifc,
+         sockunion *dest, struct ccnl_buf_s *buf)
+{
+    (void) relay;
+    (void) ifc;
+    (void) dest;
+    (void) buf;
+    sent++;
+}
+
+static struct ccnl_buf_s*
+interest_buf(char *uri, int32_t nonce)
+{
+    char tmp[64]; // the parser writes into the URI
+    struct ccnl_prefix_s *pfx;
+    ccnl_interest_opts_u opts;
+    struct ccnl_buf_s *buf;
+
+    strncpy(tmp, uri, sizeof(tmp) - 1);
+    tmp[sizeof(tmp) - 1] = '\0';
+    pfx = ccnl_URItoPrefix(tmp, CCNL_SUITE_NDNTLV, NULL);
+    memset(&opts, 0, sizeof(opts));
+    opts.ndntlv.nonce = nonce;
+    buf = ccnl_mkSimpleInterest(pfx, &opts);
+    ccnl_prefix_free(pfx);
+    return buf;
+}
+
+// hands the value of the Interest TLV to the fast path
+static int
+classify(struct ccnl_relay_s *relay, struct ccnl_face_s *from, char *uri,
+         int32_t nonce)
+{
+    struct ccnl_buf_s *buf = interest_buf(uri, nonce);
+    uint8_t *data = buf->data;
+    size_t datalen = buf->datalen, len;
+    uint64_t typ;
+    int rc;
+
+    assert_int_equal(ccnl_ndntlv_dehead(&data, &datalen, &typ, &len), 0);
+    assert_true(typ == NDN_TLV_Interest);
+    rc = ccnl_fast_ndntlv_interest(relay, from, data, len);
+    ccnl_free(buf);
+    return rc;
+}
+
+static struct ccnl_pkt_s*
+parse(struct ccnl_buf_s *buf)
+{
+    uint8_t *data = buf->data;
+    size_t datalen = buf->datalen, len;
+    uint64_t typ;
+
+    assert_int_equal(ccnl_ndntlv_dehead(&data, &datalen, &typ, &len), 0);
+    return ccnl_ndntlv_bytes2pkt(typ, buf->data, &data, &datalen);
+}
+
+void test_ccnl_fast_pit_aggregate()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+    struct ccnl_buf_s *buf = interest_buf("/fast/pit", 1);
+    struct ccnl_pkt_s *pkt = parse(buf);
+    struct ccnl_interest_s *i;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_pit_entries = -1;
+    face->ifndx = 0;
+
+    assert_int_equal(classify(&relay, face, "/fast/pit", 1), CCNL_FAST_PARSE);
+
+    i = ccnl_interest_new(&relay, face, &pkt);
+    assert_non_null(i);
+    assert_true(i->namehash == ccnl_prefix_hash(i->pkt->pfx));
+
+    assert_int_equal(classify(&relay, face, "/fast/pit", 2), CCNL_FAST_AGGREGATE);
+    assert_int_equal(i->pendcnt, 1);
+    assert_true(i->pending[0].face == face);
+    // the nonce was recorded
+    assert_int_equal(classify(&relay, face, "/fast/pit", 2), CCNL_FAST_DROP);
+    // longer and shorter names need the full path
+    assert_int_equal(classify(&relay, face, "/fast/pit/x", 3), CCNL_FAST_PARSE);
+    assert_int_equal(classify(&relay, face, "/fast", 4), CCNL_FAST_PARSE);
+    // not from a network face
+    assert_int_equal(classify(&relay, NULL, "/fast/pit", 5), CCNL_FAST_PARSE);
+
+    ccnl_interest_remove(&relay, i);
+    assert_int_equal(classify(&relay, face, "/fast/pit", 6), CCNL_FAST_PARSE);
+
+    ccnl_core_cleanup(&relay);
+    ccnl_free(face);
+    ccnl_free(buf);
+}
+
+void test_ccnl_fast_cs_hit()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+    char uri[] = "/fast/cs";
+    struct ccnl_prefix_s *pfx = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+    struct ccnl_content_s *c = ccnl_mkContentObject(pfx, (uint8_t *) "data", 4, NULL);
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = -1;
+    relay.ccnl_ll_TX_ptr = count_tx;
+    face->ifndx = 0;
+    sent = 0;
+
+    assert_non_null(c);
+    assert_true(ccnl_content_add2cache(&relay, c) == c);
+    assert_true(c->namehash == ccnl_prefix_hash(pfx));
+
+    assert_int_equal(classify(&relay, face, "/fast/cs", 1), CCNL_FAST_CS_HIT);
+    assert_int_equal(sent, 1);
+    assert_int_equal(classify(&relay, face, "/fast/cs", 1), CCNL_FAST_DROP);
+    assert_int_equal(classify(&relay, face, "/fast/cs/x", 2), CCNL_FAST_PARSE);
+    assert_int_equal(sent, 1);
+
+    ccnl_content_remove(&relay, c);
+    assert_int_equal(classify(&relay, face, "/fast/cs", 3), CCNL_FAST_PARSE);
+
+    ccnl_core_cleanup(&relay);
+    ccnl_prefix_free(pfx);
+    ccnl_free(face);
+}
+
+// a MustBeFresh Interest through the full path, returns the packets sent
+static int
+fresh_interest(struct ccnl_relay_s *relay, struct ccnl_face_s *from, char *uri,
+               int32_t nonce)
+{
+    char tmp[64];
+    struct ccnl_prefix_s *pfx;
+    ccnl_interest_opts_u opts;
+    struct ccnl_buf_s *buf;
+    struct ccnl_pkt_s *pkt;
+
+    strncpy(tmp, uri, sizeof(tmp) - 1);
+    tmp[sizeof(tmp) - 1] = '\0';
+    pfx = ccnl_URItoPrefix(tmp, CCNL_SUITE_NDNTLV, NULL);
+    memset(&opts, 0, sizeof(opts));
+    opts.ndntlv.nonce = nonce;
+    opts.ndntlv.mustbefresh = 1;
+    buf = ccnl_mkSimpleInterest(pfx, &opts);
+    ccnl_prefix_free(pfx);
+    pkt = parse(buf);
+    ccnl_free(buf);
+    assert_true(pkt->s.ndntlv.mbf);
+
+    sent = 0;
+    ccnl_fwd_handleInterest(relay, from, &pkt, ccnl_ndntlv_cMatch);
+    ccnl_pkt_free(pkt);
+    return sent;
+}
+
+void test_ccnl_fwd_cs_fresh()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+    char uri1[] = "/fwd/fresh/a", uri2[] = "/fwd/fresh/b";
+    struct ccnl_content_s *a, *b;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = -1;
+    relay.max_pit_entries = -1;
+    relay.ccnl_ll_TX_ptr = count_tx;
+    face->ifndx = 0;
+    a = ccnl_mkContentObject(ccnl_URItoPrefix(uri1, CCNL_SUITE_NDNTLV, NULL),
+                             (uint8_t *) "data", 4, NULL);
+    b = ccnl_mkContentObject(ccnl_URItoPrefix(uri2, CCNL_SUITE_NDNTLV, NULL),
+                             (uint8_t *) "data", 4, NULL);
+    a->pkt->suite = b->pkt->suite = CCNL_SUITE_NDNTLV;
+    a->pkt->s.ndntlv.freshnessperiod = 60000;
+    ccnl_content_add2cache(&relay, a);
+    ccnl_content_add2cache(&relay, b);
+    assert_int_equal(relay.freshcnt, 1);
+    assert_true(b->flags & CCNL_CONTENT_FLAGS_STALE);
+
+    /** fresh content answers, stale content does not */
+    assert_int_equal(fresh_interest(&relay, face, "/fwd/fresh/a", 1), 1);
+    assert_int_equal(fresh_interest(&relay, face, "/fwd/fresh/b", 2), 0);
+    assert_int_equal(fresh_interest(&relay, face, "/fwd/fresh/c", 3), 0);
+
+    /** content made static leaves the stale list and answers again */
+    while (relay.pit) {
+        ccnl_interest_remove(&relay, relay.pit);
+    }
+    ccnl_content_set_static(&relay, b);
+    assert_null(relay.stale);
+    assert_int_equal(fresh_interest(&relay, face, "/fwd/fresh/b", 4), 1);
+    ccnl_content_set_static(&relay, a);
+    assert_int_equal(relay.freshcnt, 0);
+    assert_int_equal(fresh_interest(&relay, face, "/fwd/fresh/a", 5), 1);
+
+    ccnl_core_cleanup(&relay);
+    ccnl_free(face);
+}
+
+// an Interest for the name of c and the digest md, returns the packets sent
+static int
+fullname_interest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                  struct ccnl_content_s *c, const unsigned char *md,
+                  int32_t nonce)
+{
+    struct ccnl_prefix_s *pfx = ccnl_prefix_dup(c->pkt->pfx);
+    uint8_t comp[4 + CCNL_CCNX_DIGEST_LEN];
+    size_t len = ccnl_pkt_mkComponent(pfx->suite, comp, (char *) md,
+                                      CCNL_CCNX_DIGEST_LEN);
+    ccnl_interest_opts_u opts;
+    struct ccnl_buf_s *buf;
+    uint8_t *data;
+    size_t datalen;
+
+    assert_int_equal(ccnl_prefix_appendCmp(pfx, comp, len), 0);
+    memset(&opts, 0, sizeof(opts));
+    opts.ndntlv.nonce = nonce;
+    buf = ccnl_mkSimpleInterest(pfx, &opts);
+    ccnl_prefix_free(pfx);
+    assert_non_null(buf);
+    data = buf->data;
+    datalen = buf->datalen;
+
+    sent = 0;
+#ifdef USE_SUITE_CCNTLV
+    if (c->pkt->pfx->suite == CCNL_SUITE_CCNTLV) {
+        ccnl_ccntlv_forwarder(relay, from, &data, &datalen);
+    } else
+#endif
+    ccnl_ndntlv_forwarder(relay, from, &data, &datalen);
+    ccnl_free(buf);
+    return sent;
+}
+
+static struct ccnl_content_s*
+add_content(struct ccnl_relay_s *relay, char *uri, int suite)
+{
+    struct ccnl_prefix_s *pfx = ccnl_URItoPrefix(uri, suite, NULL);
+    struct ccnl_content_s *c = ccnl_mkContentObject(pfx, (uint8_t *) "data",
+                                                    4, NULL);
+
+    ccnl_prefix_free(pfx);
+    c->pkt->suite = suite;
+    assert_true(ccnl_content_add2cache(relay, c) == c);
+    return c;
+}
+
+void test_ccnl_fwd_cs_fullname()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+    char uri1[] = "/fwd/full/a";
+    unsigned char md[CCNL_CCNX_DIGEST_LEN];
+    struct ccnl_content_s *c;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = -1;
+    relay.max_pit_entries = -1;
+    relay.ccnl_ll_TX_ptr = count_tx;
+    face->ifndx = 0;
+
+    /** the digest is the last component, 32 bytes in NDN */
+    c = add_content(&relay, uri1, CCNL_SUITE_NDNTLV);
+    memcpy(md, ccnl_content_digest(c), sizeof(md));
+    assert_int_equal(fullname_interest(&relay, face, c, md, 1), 1);
+    md[0] ^= 0xff;
+    assert_int_equal(fullname_interest(&relay, face, c, md, 2), 0);
+
+#ifdef USE_SUITE_CCNTLV
+    {
+        char uri2[] = "/fwd/full/b";
+
+        /** a CCNx name segment keeps its TL, the digest is 36 bytes long */
+        c = add_content(&relay, uri2, CCNL_SUITE_CCNTLV);
+        memcpy(md, ccnl_content_digest(c), sizeof(md));
+        assert_int_equal(fullname_interest(&relay, face, c, md, 3), 1);
+        md[0] ^= 0xff;
+        assert_int_equal(fullname_interest(&relay, face, c, md, 4), 0);
+    }
+#endif
+
+    ccnl_core_cleanup(&relay);
+    ccnl_free(face);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_fast_pit_aggregate),
+        unit_test(test_ccnl_fast_cs_hit),
+        unit_test(test_ccnl_fwd_cs_fresh),
+        unit_test(test_ccnl_fwd_cs_fullname),
+    };
+
+    return run_tests(tests);
+}
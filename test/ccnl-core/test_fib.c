@@ -0,0 +1,133 @@
+/**
+ * @file test_fib.c
+ * @brief Tests for the staged FIB
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+
+#define USE_SUITE_NDNTLV
+
+#include "ccnl-core.h"
+
+static struct ccnl_relay_s relay;
+static struct ccnl_face_s face1, face2;
+
+static void
+tap(struct ccnl_relay_s *r, struct ccnl_face_s *f, struct ccnl_prefix_s *p,
+    struct ccnl_buf_s *b)
+{
+    (void) r; (void) f; (void) p; (void) b;
+}
+
+static void
+stage(const char *uri, struct ccnl_face_s *face)
+{
+    char s[32];
+
+    strcpy(s, uri);
+    assert_int_equal(ccnl_fib_stage_entry(&relay, ccnl_URItoPrefix(s,
+                                          CCNL_SUITE_NDNTLV, NULL), face), 0);
+}
+
+static struct ccnl_forward_s*
+lookup(const char *uri)
+{
+    struct ccnl_forward_s *fwd;
+    char s[CCNL_MAX_PREFIX_SIZE];
+
+    for (fwd = relay.fib; fwd; fwd = fwd->next) {
+        if (!strcmp(ccnl_prefix_to_str(fwd->prefix, s, sizeof(s)), uri)) {
+            return fwd;
+        }
+    }
+    return NULL;
+}
+
+void test_ccnl_fib_commit(void **state)
+{
+    (void) state;
+
+    memset(&relay, 0, sizeof(relay));
+    stage("/a", &face1);
+    stage("/b", &face1);
+    stage("/a", &face2);
+    stage("/c", &face1);
+    stage("/c", NULL);
+    assert_int_equal(ccnl_fib_commit(&relay, 0), 2);
+    assert_null(relay.fibstage);
+    assert_true(relay.fib == lookup("/a") && relay.fib->face == &face2);
+    assert_true(relay.fib->next == lookup("/b"));
+    assert_null(lookup("/c"));
+
+    // a replace keeps the tap of an unchanged entry
+    lookup("/b")->tap = tap;
+    stage("/b", &face1);
+    stage("/d", &face1);
+    assert_int_equal(ccnl_fib_commit(&relay, 0), 2);
+    assert_true(lookup("/b")->tap == tap);
+    assert_null(lookup("/a"));
+
+    while (relay.fib) {
+        ccnl_fib_rem_entry(&relay, relay.fib->prefix, NULL);
+    }
+}
+
+void test_ccnl_fib_merge(void **state)
+{
+    struct ccnl_forward_s *b;
+    (void) state;
+
+    memset(&relay, 0, sizeof(relay));
+    stage("/a", &face1);
+    stage("/b", &face1);
+    stage("/c", &face1);
+    assert_int_equal(ccnl_fib_commit(&relay, 0), 3);
+    b = lookup("/b");
+
+    // only the staged prefixes change, in place
+    stage("/a", NULL);
+    stage("/b", &face2);
+    stage("/d", &face1);
+    stage("/x", NULL);
+    assert_int_equal(ccnl_fib_commit(&relay, 1), 3);
+    assert_null(lookup("/a"));
+    assert_true(relay.fib == b && b->face == &face2);
+    assert_non_null(lookup("/c"));
+    assert_true(lookup("/c")->next == lookup("/d"));
+
+    // an abort leaves the FIB alone
+    stage("/c", NULL);
+    ccnl_fib_abort(&relay);
+    assert_int_equal(ccnl_fib_commit(&relay, 1), 3);
+
+    while (relay.fib) {
+        ccnl_fib_rem_entry(&relay, relay.fib->prefix, NULL);
+    }
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_fib_commit),
+        unit_test(test_ccnl_fib_merge),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,271 @@
+/**
+ * @file test_frag.c
+ * @brief Tests for BeginEnd2015 fragmentation and reassembly
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+
+#define USE_SUITE_NDNTLV
+
+#include "ccnl-malloc.h"
+#include "ccnl-frag.h"
+#include "ccnl-relay.h"
+#include "ccnl-pkt-ndntlv.h"
+
+static uint8_t pkt[1000];
+static uint8_t rcvd[sizeof(pkt)];
+static size_t rcvdlen;
+static int delivered;
+
+static int8_t
+deliver(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+        uint8_t **data, size_t *datalen)
+{
+    (void) relay;
+    (void) from;
+    assert_true(*datalen <= sizeof(rcvd));
+    memcpy(rcvd, *data, *datalen);
+    rcvdlen = *datalen;
+    delivered++;
+    *data += *datalen;
+    *datalen = 0;
+    return 0;
+}
+
+static void
+setup(void)
+{
+    size_t i;
+
+    pkt[0] = NDN_TLV_Data;
+    for (i = 1; i < sizeof(pkt); i++) {
+        pkt[i] = (uint8_t) i;
+    }
+    rcvdlen = 0;
+    delivered = 0;
+}
+
+// hands 200 bytes of pkt, the k-th chunk, to the reassembly
+static void
+rx_chunk(struct ccnl_face_s *face, unsigned int seqno, unsigned int bits,
+         int k)
+{
+    uint8_t *data = pkt + 200 * k;
+    size_t datalen = 200;
+
+    ccnl_frag_RX_BeginEnd2015(deliver, NULL, face, 1500, bits, seqno,
+                              &data, &datalen);
+    assert_int_equal(datalen, 0);
+}
+
+void test_ccnl_frag_inorder()
+{
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+    int k;
+
+    setup();
+    rx_chunk(face, 0, CCNL_BEFRAG_FLAG_FIRST, 0);
+    for (k = 1; k < 4; k++) {
+        rx_chunk(face, k, CCNL_BEFRAG_FLAG_MID, k);
+        assert_int_equal(delivered, 0);
+    }
+    rx_chunk(face, 4, CCNL_BEFRAG_FLAG_LAST, 4);
+    assert_int_equal(delivered, 1);
+    assert_int_equal(rcvdlen, sizeof(pkt));
+    assert_memory_equal(rcvd, pkt, sizeof(pkt));
+
+    rx_chunk(face, 5, CCNL_BEFRAG_FLAG_SINGLE, 2);
+    assert_int_equal(delivered, 2);
+    assert_int_equal(rcvdlen, 200);
+    assert_memory_equal(rcvd, pkt + 400, 200);
+    assert_int_equal(face->frag->losscount, 0);
+
+    ccnl_frag_destroy(face->frag);
+    ccnl_free(face);
+}
+
+void test_ccnl_frag_reorder()
+{
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+
+    setup();
+    rx_chunk(face, 0, CCNL_BEFRAG_FLAG_FIRST, 0);
+    rx_chunk(face, 2, CCNL_BEFRAG_FLAG_MID, 2);
+    rx_chunk(face, 4, CCNL_BEFRAG_FLAG_LAST, 4);
+    rx_chunk(face, 5, CCNL_BEFRAG_FLAG_SINGLE, 1);
+    rx_chunk(face, 1, CCNL_BEFRAG_FLAG_MID, 1);
+    assert_int_equal(delivered, 0);
+    rx_chunk(face, 3, CCNL_BEFRAG_FLAG_MID, 3);
+    // the packet, then the single fragment held back behind it
+    assert_int_equal(delivered, 2);
+    assert_int_equal(rcvdlen, 200);
+    assert_int_equal(face->frag->losscount, 0);
+
+    // duplicates and late fragments are dropped
+    rx_chunk(face, 3, CCNL_BEFRAG_FLAG_MID, 3);
+    assert_int_equal(delivered, 2);
+    assert_int_equal(face->frag->recvseq, 6);
+
+    ccnl_frag_destroy(face->frag);
+    ccnl_free(face);
+}
+
+void test_ccnl_frag_loss()
+{
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+
+    setup();
+    rx_chunk(face, 0, CCNL_BEFRAG_FLAG_SINGLE, 0);
+    assert_int_equal(delivered, 1);
+    face->frag->recvseq = CCNL_FRAG_SEQMASK; // the sequence numbers wrap
+
+    // the second fragment is lost
+    rx_chunk(face, CCNL_FRAG_SEQMASK, CCNL_BEFRAG_FLAG_FIRST, 0);
+    rx_chunk(face, 1, CCNL_BEFRAG_FLAG_MID, 2);
+    rx_chunk(face, 2, CCNL_BEFRAG_FLAG_LAST, 3);
+    assert_int_equal(delivered, 1);
+
+    // once the window moves past the gap, later packets get through
+    rx_chunk(face, 3 + CCNL_FRAG_WINDOW, CCNL_BEFRAG_FLAG_SINGLE, 4);
+    assert_int_equal(delivered, 2);
+    assert_memory_equal(rcvd, pkt + 800, 200);
+    assert_true(face->frag->losscount > 0);
+    assert_true(face->frag->defrag == NULL);
+
+    ccnl_frag_destroy(face->frag);
+    ccnl_free(face);
+}
+
+void test_ccnl_frag_getiov()
+{
+    struct ccnl_frag_s *fr = ccnl_frag_new(CCNL_FRAG_BEGINEND2015, 300);
+    struct ccnl_frag_s *fr2 = ccnl_frag_new(CCNL_FRAG_BEGINEND2015, 300);
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+    struct ccnl_frag_iov_s iov[CCNL_FRAG_BATCH];
+    struct ccnl_buf_s *buf;
+    sockunion dest;
+    int cnt, k;
+
+    setup();
+    memset(&dest, 0, sizeof(dest));
+    ccnl_frag_reset(fr, ccnl_buf_new(pkt, sizeof(pkt)), 0, &dest);
+    ccnl_frag_reset(fr2, ccnl_buf_new(pkt, sizeof(pkt)), 0, &dest);
+    assert_int_equal(fr->outsuite, CCNL_SUITE_NDNTLV);
+
+    cnt = ccnl_frag_getiov(fr, iov, CCNL_FRAG_BATCH);
+    assert_int_equal(cnt, 4);
+    assert_int_equal(ccnl_frag_getiov(fr, iov + cnt, 1), 0);
+    assert_true(ccnl_frag_nomorefragments(fr));
+
+    for (k = 0; k < cnt; k++) {
+        uint8_t *cp;
+        size_t len, vallen;
+        uint64_t typ;
+        unsigned int fields;
+
+        // the same bytes as the copying interface
+        buf = ccnl_frag_getnext(fr2, NULL, NULL);
+        assert_non_null(buf);
+        assert_true(buf->datalen <= 300);
+        assert_int_equal(buf->datalen, iov[k].hdrlen + iov[k].datalen);
+        assert_memory_equal(buf->data, iov[k].hdr, iov[k].hdrlen);
+        assert_memory_equal(buf->data + iov[k].hdrlen, iov[k].data,
+                            iov[k].datalen);
+
+        // and they reassemble to the packet
+        cp = buf->data;
+        len = buf->datalen;
+        assert_int_equal(ccnl_ndntlv_dehead(&cp, &len, &typ, &vallen), 0);
+        assert_true(typ == NDN_TLV_Fragment);
+        assert_int_equal(ccnl_ndntlv_dehead(&cp, &len, &typ, &vallen), 0);
+        assert_true(typ == NDN_TLV_Frag_BeginEndFields && vallen == 2);
+        fields = (cp[0] << 8) | cp[1];
+        cp += 2;
+        len -= 2;
+        assert_int_equal(ccnl_ndntlv_dehead(&cp, &len, &typ, &vallen), 0);
+        assert_true(typ == NDN_TLV_NdnlpFragment);
+        assert_int_equal(vallen, iov[k].datalen);
+        assert_true(cp == buf->data + iov[k].hdrlen);
+        ccnl_free(buf);
+
+        ccnl_frag_RX_BeginEnd2015(deliver, NULL, face, 300, fields >> 14,
+                                  fields & CCNL_FRAG_SEQMASK,
+                                  &iov[k].data, &iov[k].datalen);
+    }
+    assert_null(ccnl_frag_getnext(fr2, NULL, NULL));
+    assert_int_equal(delivered, 1);
+    assert_int_equal(rcvdlen, sizeof(pkt));
+    assert_memory_equal(rcvd, pkt, sizeof(pkt));
+
+    ccnl_frag_destroy(fr);
+    ccnl_frag_destroy(fr2);
+    ccnl_frag_destroy(face->frag);
+    ccnl_free(face);
+}
+
+// a socket that takes all but the last fragment of each batch
+static int
+lossy_TXv(struct ccnl_relay_s *relay, struct ccnl_if_s *ifc, sockunion *dest,
+          struct ccnl_frag_iov_s *frags, int cnt)
+{
+    (void) relay;
+    (void) ifc;
+    (void) dest;
+    (void) frags;
+    return cnt - 1;
+}
+
+void test_ccnl_frag_TXv_drops()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+
+    setup();
+    memset(&relay, 0, sizeof(relay));
+    relay.ifcount = 1;
+    relay.ccnl_ll_TXv_ptr = lossy_TXv;
+    face->frag = ccnl_frag_new(CCNL_FRAG_BEGINEND2015, 300);
+
+    /** the fragments the socket did not take are counted as drops */
+    assert_int_equal(ccnl_face_enqueue(&relay, face,
+                                       ccnl_buf_new(pkt, sizeof(pkt))), 0);
+    assert_null(face->outq);
+    assert_true(ccnl_frag_nomorefragments(face->frag));
+#ifdef USE_STATS
+    assert_int_equal(relay.ifs[0].tx_cnt, 3);
+    assert_int_equal(face->stats.drops[CCNL_DROP_SEND], 1);
+#endif
+
+    ccnl_frag_destroy(face->frag);
+    ccnl_free(face);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_frag_inorder),
+        unit_test(test_ccnl_frag_reorder),
+        unit_test(test_ccnl_frag_loss),
+        unit_test(test_ccnl_frag_getiov),
+        unit_test(test_ccnl_frag_TXv_drops),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file test_histo.c
+ * @brief Tests for the latency histograms
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+
+#include "ccnl-histo.h"
+
+void test_ccnl_histo_small(void **state)
+{
+    static struct ccnl_histo_s h;
+    uint64_t v;
+    (void) state;
+
+    // below 2^CCNL_HISTO_SUBBITS each value has its own bucket
+    for (v = 0; v < 8; v++) {
+        ccnl_histo_add(&h, v);
+    }
+    assert_int_equal(h.count, 8);
+    assert_int_equal(h.sum, 28);
+    assert_int_equal(h.max, 7);
+    assert_int_equal(ccnl_histo_quantile(&h, 0.0), 0);
+    assert_int_equal(ccnl_histo_quantile(&h, 0.5), 4);
+    assert_int_equal(ccnl_histo_quantile(&h, 1.0), 7);
+}
+
+void test_ccnl_histo_quantile(void **state)
+{
+    static struct ccnl_histo_s h;
+    uint64_t v, q;
+    (void) state;
+
+    for (v = 1; v <= 100000; v++) {
+        ccnl_histo_add(&h, v * 1000);
+    }
+    // the bucket ends are at most 1/8 above the exact value
+    q = ccnl_histo_quantile(&h, 0.5);
+    assert_true(q >= 50000000 && q <= 50000000 + 50000000 / 8);
+    q = ccnl_histo_quantile(&h, 0.99);
+    assert_true(q >= 99000000 && q <= 99000000 + 99000000 / 8);
+    assert_int_equal(ccnl_histo_quantile(&h, 1.0), 100000000);
+}
+
+void test_ccnl_histo_huge(void **state)
+{
+    static struct ccnl_histo_s h;
+    (void) state;
+
+    // beyond the last bucket, the maximum is still exact
+    ccnl_histo_add(&h, (uint64_t) 1 << 50);
+    assert_int_equal(h.buckets[CCNL_HISTO_BUCKETS - 1], 1);
+    assert_int_equal(ccnl_histo_quantile(&h, 0.5), (uint64_t) 1 << 50);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_histo_small),
+        unit_test(test_ccnl_histo_quantile),
+        unit_test(test_ccnl_histo_huge),
+    };
+
+    return run_tests(tests);
+}
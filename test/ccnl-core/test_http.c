@@ -0,0 +1,304 @@
+/**
+ * @file test_http.c
+ * @brief Tests for the pages of the HTTP status server
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define USE_SUITE_NDNTLV
+
+#include "ccnl-core.h"
+#include "ccnl-http-status.h"
+#include "ccnl-pkt-builder.h"
+
+static struct ccnl_relay_s relay;
+static struct ccnl_face_s face;
+static char page[CCNL_HTTP_OUTSIZE * 4];
+
+static void
+setup_fib(int n)
+{
+    char uri[16];
+    int i;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.http = ccnl_calloc(1, sizeof(*relay.http));
+    face.faceid = 7;
+    for (i = 0; i < n; i++) {
+        snprintf(uri, sizeof(uri), "/t/%d", i);
+        ccnl_fib_add_entry(&relay, ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV,
+                                                    NULL), &face);
+    }
+}
+
+static void
+teardown_fib(void)
+{
+    while (relay.fib)
+        ccnl_fib_rem_entry(&relay, relay.fib->prefix, NULL);
+    ccnl_free(relay.http);
+    relay.http = NULL;
+}
+
+// runs the response to the request in c->in to its end
+static char*
+respond(struct ccnl_http_conn_s *c, const char *req)
+{
+    size_t len = 0;
+
+    strcpy((char*) c->in, req);
+    c->inlen = (int) strlen(req);
+    assert_int_equal(ccnl_http_status(&relay, c), 0);
+    do {
+        ccnl_http_produce(&relay, c);
+        assert_true(len + c->outlen < sizeof(page));
+        memcpy(page + len, c->out, c->outlen);
+        len += c->outlen;
+        c->outlen = 0;
+    } while (c->busy);
+    page[len] = '\0';
+    return page;
+}
+
+void test_ccnl_http_json_page(void **state)
+{
+    struct ccnl_http_conn_s *c;
+    char *p;
+    (void) state;
+
+    setup_fib(5);
+    c = relay.http->conn;
+
+    p = respond(c, "GET /json/fib?start=1&limit=2 HTTP/1.0\r\n\r\n");
+    assert_non_null(strstr(p, "Connection: close"));
+    assert_null(strstr(p, "chunked"));
+    assert_non_null(strstr(p, "{\"table\":\"fib\",\"start\":1,\"rows\":["
+                              "{\"prefix\":\"/t/1\",\"face\":7,"));
+    assert_non_null(strstr(p, "{\"prefix\":\"/t/2\""));
+    assert_null(strstr(p, "/t/3"));
+    assert_non_null(strstr(p, "],\"next\":3}"));
+
+    p = respond(c, "GET /json/fib?start=4 HTTP/1.0\r\n\r\n");
+    assert_non_null(strstr(p, "],\"next\":null}"));
+
+    p = respond(c, "GET /json/nope HTTP/1.0\r\n\r\n");
+    assert_true(!strncmp(p, "HTTP/1.1 404 ", 13));
+
+    teardown_fib();
+}
+
+void test_ccnl_http_keepalive(void **state)
+{
+    struct ccnl_http_conn_s *c;
+    char *p;
+    size_t len;
+    (void) state;
+
+    setup_fib(1);
+    c = relay.http->conn;
+
+    // the second request stays in the buffer
+    p = respond(c, "GET /json/fib HTTP/1.1\r\nHost: x\r\n\r\n"
+                   "GET / HTTP/1.1\r\n\r\n");
+    assert_int_equal(c->keepalive, 1);
+    assert_non_null(strstr(p, "Transfer-Encoding: chunked"));
+    len = strlen(p);
+    assert_true(len > 5 && !strcmp(p + len - 5, "0\r\n\r\n"));
+    assert_string_equal((char*) c->in, "GET / HTTP/1.1\r\n\r\n");
+
+    p = respond(c, "GET /json/fib HTTP/1.1\r\nConnection: Close\r\n\r\n");
+    assert_int_equal(c->keepalive, 0);
+
+    p = respond(c, "POST / HTTP/1.1\r\n\r\n");
+    assert_true(!strncmp(p, "HTTP/1.1 405 ", 13));
+
+    teardown_fib();
+}
+
+void test_ccnl_http_unlinked(void **state)
+{
+    struct ccnl_http_conn_s *c;
+    struct ccnl_forward_s *second;
+    (void) state;
+
+    setup_fib(3);
+    c = relay.http->conn;
+    second = relay.fib->next;
+
+    // a response stopped at the second row goes on with the third
+    c->busy = 1;
+    c->row = second;
+    ccnl_fib_rem_entry(&relay, second->prefix, NULL);
+    assert_true(c->row == relay.fib->next);
+    c->busy = 0;
+
+    teardown_fib();
+}
+
+void test_ccnl_http_cs_touched(void **state)
+{
+    struct ccnl_http_conn_s *c;
+    struct ccnl_content_s *a, *b;
+    char uri[16];
+    int i;
+    (void) state;
+
+    setup_fib(0);
+    relay.max_cache_entries = -1;
+    for (i = 0; i < 3; i++) {
+        snprintf(uri, sizeof(uri), "/c/%d", i);
+        ccnl_content_add2cache(&relay, ccnl_mkContentObject(
+            ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL), (uint8_t*) "x", 1,
+            NULL));
+    }
+    c = relay.http->conn;
+    b = relay.contents->next;
+    a = b->next;
+
+    // a CS page stopped at a row that moves to the head goes on after it
+    c->busy = 1;
+    c->row = b;
+    ccnl_content_touch(&relay, b);
+    assert_true(relay.contents == b);
+    assert_true(c->row == a);
+    c->busy = 0;
+
+    ccnl_core_cleanup(&relay);
+    teardown_fib();
+}
+
+void test_ccnl_http_stalled(void **state)
+{
+    struct ccnl_http_conn_s *c;
+    fd_set readfs, writefs;
+    char fill[4096];
+    int sv[2];
+    (void) state;
+
+    setup_fib(0);
+    c = relay.http->conn;
+    assert_int_equal(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+    fcntl(sv[0], F_SETFL, fcntl(sv[0], F_GETFL) | O_NONBLOCK);
+    memset(fill, 'x', sizeof(fill));
+    while (write(sv[0], fill, sizeof(fill)) > 0);
+    assert_true(errno == EAGAIN || errno == EWOULDBLOCK);
+    FD_ZERO(&readfs);
+    FD_ZERO(&writefs);
+
+    // a response the client does not read is given up after the timeout
+    c->client = sv[0];
+    c->out = (unsigned char*) c->obuf;
+    c->outoffs = 0;
+    c->outlen = 100;
+    c->last = CCNL_NOW();
+    ccnl_http_postselect(&relay, relay.http, &readfs, &writefs);
+    assert_int_equal(c->client, sv[0]);
+    assert_int_equal(c->outlen, 100);
+
+    c->last = CCNL_NOW() - CCNL_HTTP_IDLE - 1;
+    ccnl_http_postselect(&relay, relay.http, &readfs, &writefs);
+    assert_int_equal(c->client, 0);
+    assert_null(c->out);
+
+    close(sv[1]);
+    teardown_fib();
+}
+
+void test_ccnl_http_metrics(void **state)
+{
+    struct ccnl_face_s f1, f2;
+    struct ccnl_http_conn_s *c;
+    char *p, *body;
+    (void) state;
+
+    setup_fib(1);
+    c = relay.http->conn;
+    memset(&f1, 0, sizeof(f1));
+    memset(&f2, 0, sizeof(f2));
+    f1.faceid = 3;
+    f1.peer.ip4.sin_family = AF_INET;
+    f1.peer.ip4.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    f1.peer.ip4.sin_port = htons(6363);
+    f1.stats.interests_in = 5;
+    f1.stats.cs_hits = 2;
+    f1.stats.drops[CCNL_DROP_DUPNONCE] = 1;
+    f1.next = &f2;
+    f2.faceid = 4;
+    f2.ifndx = -1;
+    f2.peer.ux.sun_family = AF_UNIX;
+    strcpy(f2.peer.ux.sun_path, "/tmp/a\"b\\c\nd\te");
+    relay.faces = &f1;
+    relay.fib->face = &f1;
+    relay.fib->interests = 9;
+    relay.ifcount = 1;
+    relay.ifs[0].rx_cnt = 11;
+    relay.pitcnt = 2;
+    relay.contentcnt = 3;
+
+    p = respond(c, "GET /metrics HTTP/1.0\r\n\r\n");
+    assert_true(!strncmp(p, "HTTP/1.1 200 ", 13));
+    assert_non_null(strstr(p, "Content-Type: text/plain; version=0.0.4\r\n"));
+    body = strstr(p, "\r\n\r\n");
+    assert_non_null(body);
+    body += 4;
+    assert_int_equal(strtoul(strstr(p, "Content-Length: ") + 16, NULL, 10),
+                     strlen(body));
+
+    assert_non_null(strstr(body, "# TYPE ccnl_face_info gauge\n"
+                                 "ccnl_face_info{face=\"3\",if=\"0\",peer=\"127.0.0.1/6363\"} 1\n"));
+    // quote, backslash and newline are escaped, other control bytes encoded
+    assert_non_null(strstr(body, "ccnl_face_info{face=\"4\",if=\"-1\","
+                                 "peer=\"/tmp/a\\\"b\\\\c\\nd%09e\"} 1\n"));
+    assert_non_null(strstr(body, "# TYPE ccnl_face_interests_in_total counter\n"
+                                 "ccnl_face_interests_in_total{face=\"3\"} 5\n"
+                                 "ccnl_face_interests_in_total{face=\"4\"} 0\n"));
+    assert_non_null(strstr(body, "ccnl_face_cs_hits_total{face=\"3\"} 2\n"));
+    assert_non_null(strstr(body, "ccnl_face_drops_total{face=\"3\",reason=\"dupnonce\"} 1\n"));
+    assert_non_null(strstr(body, "ccnl_fib_interests_total{prefix=\"/t/0\",face=\"3\"} 9\n"));
+    assert_non_null(strstr(body, "ccnl_if_rx_packets_total{if=\"0\"} 11\n"));
+    assert_non_null(strstr(body, "ccnl_pit_entries 2\n"));
+    assert_non_null(strstr(body, "ccnl_cs_entries 3\n"));
+
+    ccnl_free(c->metrics);
+    c->metrics = NULL;
+    c->out = NULL;
+    relay.faces = NULL;
+    relay.ifcount = 0;
+    teardown_fib();
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_http_json_page),
+        unit_test(test_ccnl_http_keepalive),
+        unit_test(test_ccnl_http_unlinked),
+        unit_test(test_ccnl_http_cs_touched),
+        unit_test(test_ccnl_http_stalled),
+        unit_test(test_ccnl_http_metrics),
+    };
+
+    return run_tests(tests);
+}
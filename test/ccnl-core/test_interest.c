@@ -19,18 +19,21 @@
 #include <stdarg.h>
 #include <stddef.h>
 #include <setjmp.h>
+#include <string.h>
 #include <cmocka.h>
  
 #include "ccnl-interest.h"
+#include "ccnl-malloc.h"
+#include "ccnl-os-time.h"
 
 
 void test_ccnl_interest_append_pending_invalid_parameters()
 {
-    int result = ccnl_interest_append_pending(NULL, NULL);
+    int result = ccnl_interest_append_pending(NULL, NULL, 0, 0);
     assert_int_equal(result, -1); 
 
     struct ccnl_interest_s interest;
-    result = ccnl_interest_append_pending(&interest, NULL);
+    result = ccnl_interest_append_pending(&interest, NULL, 0, 0);
     assert_int_equal(result, -2); 
 }
 
@@ -54,6 +57,65 @@ void test_ccnl_interest_remove_pending_invalid_parameters()
     assert_int_equal(result, -2); 
 }
 
+void test_ccnl_interest_pending()
+{
+    struct ccnl_interest_s interest;
+    struct ccnl_face_s faces[2 * CCNL_PENDINT_INLINE];
+    int k;
+
+    memset(&interest, 0, sizeof(interest));
+    memset(faces, 0, sizeof(faces));
+    interest.lifetime = 100;
+    for (k = 0; k < 2 * CCNL_PENDINT_INLINE; k++) {
+        faces[k].faceid = k;
+        assert_int_equal(ccnl_interest_append_pending(&interest, faces + k, k, 100), 0);
+    }
+    // more faces than fit inline went to the heap, in order
+    assert_int_equal(interest.pendcnt, 2 * CCNL_PENDINT_INLINE);
+    assert_true(interest.pending != interest.pendinline);
+    assert_true(interest.pending[CCNL_PENDINT_INLINE].face == faces + CCNL_PENDINT_INLINE);
+
+    // a face is listed once, with the nonce of its last interest
+    assert_int_equal(ccnl_interest_append_pending(&interest, faces + 1, 42, 100), 0);
+    assert_int_equal(interest.pendcnt, 2 * CCNL_PENDINT_INLINE);
+    assert_int_equal(interest.pending[1].nonce, 42);
+
+    assert_int_equal(ccnl_interest_remove_pending(&interest, faces + 1), 1);
+    assert_int_equal(interest.pendcnt, 2 * CCNL_PENDINT_INLINE - 1);
+    assert_true(interest.pending[1].face == faces + 2);
+
+    // records time out on their own
+    interest.pending[0].expires = 0;
+    assert_int_equal(ccnl_interest_expire_pending(&interest, 1), 1);
+    assert_true(interest.pending[0].face == faces + 2);
+
+    ccnl_free(interest.pending);
+}
+
+void test_ccnl_interest_pending_lifetime()
+{
+    struct ccnl_interest_s interest;
+    struct ccnl_face_s faces[2];
+    uint32_t now = CCNL_NOW();
+
+    memset(&interest, 0, sizeof(interest));
+    memset(faces, 0, sizeof(faces));
+    faces[1].faceid = 1;
+    interest.last_used = now;
+    interest.lifetime = 2;
+    assert_int_equal(ccnl_interest_append_pending(&interest, faces, 1, 2), 0);
+    assert_int_equal(ccnl_interest_append_pending(&interest, faces + 1, 2, 10), 0);
+
+    // each record has the lifetime of its face's interest, the entry the longest
+    assert_true(interest.pending[1].expires >= interest.pending[0].expires + 8);
+    assert_true(interest.last_used + interest.lifetime >= interest.pending[1].expires);
+    assert_int_equal(ccnl_interest_expire_pending(&interest, now + 5), 1);
+    assert_int_equal(interest.pendcnt, 1);
+    assert_true(interest.pending[0].face == faces + 1);
+    assert_int_equal(ccnl_interest_expire_pending(&interest, now + 20), 1);
+    assert_int_equal(interest.pendcnt, 0);
+}
+
 void test1()
 {
   int result = 0;
@@ -67,6 +129,8 @@ int main(void)
     unit_test(test_ccnl_interest_is_same_invalid_parameters),
     unit_test(test_ccnl_interest_remove_pending_invalid_parameters),
     unit_test(test_ccnl_interest_append_pending_invalid_parameters),
+    unit_test(test_ccnl_interest_pending_lifetime),
+    unit_test(test_ccnl_interest_pending),
   };
  
   return run_tests(tests);
@@ -0,0 +1,87 @@
+/**
+ * @file test_mgmt_bin.c
+ * @brief Tests for the encoding of the binary management protocol
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+
+#define USE_SUITE_NDNTLV
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-mgmt-bin.h"
+
+void test_ccnl_mgmt_bin_roundtrip(void **state)
+{
+    uint64_t vals[] = { 0, 252, 253, 0xffff, 0x10000, 0x100000000ULL };
+    uint8_t buf[256], *cp = buf, *data = buf;
+    uint64_t typ;
+    size_t len, vallen, k;
+    (void) state;
+
+    for (k = 0; k < sizeof(vals) / sizeof(vals[0]); k++) {
+        assert_int_equal(ccnl_mgmt_bin_putInt(&cp, buf + sizeof(buf),
+                                              CCNL_MGMT_BIN_COUNT, vals[k]), 0);
+    }
+    assert_int_equal(ccnl_mgmt_bin_putBlob(&cp, buf + sizeof(buf), 300,
+                                           "/a/b", 4), 0);
+
+    len = (size_t) (cp - buf);
+    for (k = 0; k < sizeof(vals) / sizeof(vals[0]); k++) {
+        assert_int_equal(ccnl_ndntlv_dehead(&data, &len, &typ, &vallen), 0);
+        assert_int_equal(typ, CCNL_MGMT_BIN_COUNT);
+        assert_true(ccnl_ndntlv_nonNegInt(data, vallen) == vals[k]);
+        data += vallen;
+        len -= vallen;
+    }
+    assert_int_equal(ccnl_ndntlv_dehead(&data, &len, &typ, &vallen), 0);
+    assert_int_equal(typ, 300);
+    assert_int_equal(vallen, 4);
+    assert_memory_equal(data, "/a/b", 4);
+    assert_int_equal(len, 4);
+}
+
+void test_ccnl_mgmt_bin_full(void **state)
+{
+    uint8_t buf[8], *cp = buf;
+    (void) state;
+
+    // nothing is written when the value does not fit
+    assert_int_equal(ccnl_mgmt_bin_putBlob(&cp, buf + sizeof(buf),
+                                           CCNL_MGMT_BIN_PREFIX,
+                                           "/too/long", 9), -1);
+    assert_true(cp == buf);
+    assert_int_equal(ccnl_mgmt_bin_putTL(&cp, buf + sizeof(buf), 0x10000, 4),
+                     -1);
+    assert_true(cp == buf);
+    assert_int_equal(ccnl_mgmt_bin_putInt(&cp, buf + sizeof(buf),
+                                          CCNL_MGMT_BIN_FACEID, 7), 0);
+    assert_int_equal(cp - buf, 3);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_mgmt_bin_roundtrip),
+        unit_test(test_ccnl_mgmt_bin_full),
+    };
+
+    return run_tests(tests);
+}
@@ -178,6 +178,28 @@ void test_ccnl_pkt2suite_valid()
     assert_int_equal(result, CCNL_SUITE_CCNTLV);
 }
 
+void test_ccnl_pkt_framelen()
+{
+    uint8_t ndn[] = { NDN_TLV_Data, 0xfd, 0x01, 0x00, 0x07 };
+    uint8_t ccnx[] = { CCNX_TLV_V1, CCNX_PT_Interest, 0x00, 0x20, 0x40, 0, 0, 0, 8 };
+    uint8_t junk[] = { 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42 };
+    size_t framelen;
+
+    /** the header tells the length of the whole packet */
+    assert_int_equal(ccnl_pkt_framelen(ndn, sizeof(ndn), &framelen), 0);
+    assert_int_equal(framelen, 4 + 256);
+    assert_int_equal(ccnl_pkt_framelen(ccnx, sizeof(ccnx), &framelen), 0);
+    assert_int_equal(framelen, 32);
+
+    /** a header cut short asks for more bytes */
+    assert_int_equal(ccnl_pkt_framelen(ndn, 3, &framelen), 0);
+    assert_int_equal(framelen, 0);
+    assert_int_equal(ccnl_pkt_framelen(ccnx, 4, &framelen), 0);
+    assert_int_equal(framelen, 0);
+
+    assert_int_equal(ccnl_pkt_framelen(junk, sizeof(junk), &framelen), -1);
+}
+
 int main(void)
 {
     const UnitTest tests[] = {
@@ -193,6 +215,7 @@ int main(void)
         unit_test(test_ccnl_cmp2int_valid),
         unit_test(test_ccnl_pkt2suite_invalid),
         unit_test(test_ccnl_pkt2suite_valid),
+        unit_test(test_ccnl_pkt_framelen),
     };
     
     return run_tests(tests);
@@ -127,6 +127,29 @@ void test_prefix_no_longest_match()
     assert_int_equal(0, res);
 }
 
+void test_prefix_hash()
+{
+    int prefix_hash_suite = 0;
+    char *c1 = ccnl_malloc(100);
+    strcpy(c1, "/path/to/data");
+    struct ccnl_prefix_s *p1 = ccnl_URItoPrefix(c1, prefix_hash_suite, NULL);
+    struct ccnl_prefix_s *p2 = ccnl_prefix_dup(p1);
+
+    char *c3 = ccnl_malloc(100);
+    strcpy(c3, "/path/tod/ata");
+    struct ccnl_prefix_s *p3 = ccnl_URItoPrefix(c3, prefix_hash_suite, NULL);
+
+    uint64_t h1 = ccnl_prefix_hash(p1);
+    uint64_t h2 = ccnl_prefix_hash(p2);
+    uint64_t h3 = ccnl_prefix_hash(p3);
+    ccnl_prefix_free(p1);
+    ccnl_prefix_free(p2);
+    ccnl_prefix_free(p3);
+
+    assert_true(h1 == h2);
+    assert_true(h1 != h3);
+}
+
 int main(void)
 {
   const UnitTest tests[] = {
@@ -137,6 +160,7 @@ int main(void)
     unit_test(test_prefix_no_exact_match),
     unit_test(test_prefix_longest_match),
     unit_test(test_prefix_no_longest_match),
+    unit_test(test_prefix_hash),
   };
  
   return run_tests(tests);
@@ -21,8 +21,11 @@
 #include <stddef.h>
 #include <setjmp.h>
 #include <cmocka.h>
- 
+#include <string.h>
+
 #include "ccnl-producer.h"
+#include "ccnl-relay.h"
+#include "ccnl-frag.h"
 
 int _test_local_producer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                    struct ccnl_pkt_s *pkt);
@@ -65,11 +68,61 @@ void test_local_producer_is_not_set()
     assert_int_equal(result, 0);
 }
 
+void test_producer_chunksize()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *face = ccnl_calloc(1, sizeof(*face));
+    char uri[] = "/chunk/size";
+    struct ccnl_prefix_s *pfx = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+    int chunk, chunk2;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.ifcount = 1;
+    relay.ifs[0].mtu = 4096;
+    face->ifndx = 0;
+    face->flags = CCNL_FACE_FLAGS_STATIC;
+    relay.faces = face;
+
+    /* the Data packet around the content takes some of the MTU */
+    chunk = ccnl_producer_chunksize(&relay, pfx);
+    assert_true(chunk > 4096 - 64 && chunk < 4096);
+
+    /* a narrower path lowers it and has the face fragment */
+    assert_true(ccnl_face_setmtu(&relay, face, 1400, NULL) < 0);
+    chunk2 = ccnl_producer_chunksize(&relay, pfx);
+    assert_int_equal(chunk2, chunk - (4096 - 1400));
+    assert_non_null(face->frag);
+    assert_int_equal(face->frag->protocol, CCNL_FRAG_BEGINEND2015);
+    assert_int_equal(face->frag->mtu, 1400);
+    assert_true(face->flags & CCNL_FACE_FLAGS_AUTOFRAG);
+
+    /* until the path MTU is probed again */
+    face->mtu_learned -= CCNL_PMTU_PROBE_INTERVAL;
+    ccnl_do_ageing(&relay, NULL);
+    assert_null(face->frag);
+    assert_int_equal(face->mtu, 0);
+    assert_int_equal(ccnl_producer_chunksize(&relay, pfx), chunk);
+
+    /* a hand configured fragmentation gets its MTU back */
+    face->frag = ccnl_frag_new(CCNL_FRAG_BEGINEND2015, 1200);
+    assert_true(ccnl_face_setmtu(&relay, face, 1000, NULL) < 0);
+    assert_int_equal(face->frag->mtu, 1000);
+    face->mtu_learned -= CCNL_PMTU_PROBE_INTERVAL;
+    ccnl_do_ageing(&relay, NULL);
+    assert_int_equal(face->frag->mtu, 1200);
+    assert_false(face->flags & CCNL_FACE_FLAGS_AUTOFRAG);
+
+    ccnl_frag_destroy(face->frag);
+    ccnl_prefix_free(pfx);
+    ccnl_free(face);
+}
+
 int main(void)
 {
     const UnitTest tests[] = {
         unit_test(test_local_producer_is_set),
         unit_test(test_local_producer_is_not_set),
+        unit_test(test_producer_chunksize),
     };
     
     return run_tests(tests);
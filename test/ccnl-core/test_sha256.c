@@ -0,0 +1,206 @@
+/**
+ * @file test_sha256.c
+ * @brief Tests for the SHA256 kernels and HMAC signing
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ccnl-ext-hmac.h"
+
+static const char *kernels[] = { "generic", "sha-ni", "avx2" };
+
+static void digest_hex(uint8_t *md, char *hex)
+{
+    int i;
+
+    for (i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+        sprintf(hex + 2 * i, "%02x", md[i]);
+    }
+}
+
+static void sha256(const char *msg, size_t len, uint8_t *md)
+{
+    SHA256_CTX_t ctx;
+
+    ccnl_SHA256_Init(&ctx);
+    ccnl_SHA256_Update(&ctx, (const uint8_t *) msg, len);
+    ccnl_SHA256_Final(md, &ctx);
+}
+
+static void fill(uint8_t *buf, size_t len, unsigned seed)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        buf[i] = (uint8_t) (seed >> 16);
+    }
+}
+
+void test_sha256_vectors()
+{
+    const char *abc448 = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    uint8_t md[SHA256_DIGEST_LENGTH];
+    char hex[2 * SHA256_DIGEST_LENGTH + 1];
+    size_t k;
+
+    for (k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (ccnl_SHA256_setKernel(kernels[k])) {
+            continue;
+        }
+        sha256("", 0, md);
+        digest_hex(md, hex);
+        assert_string_equal(hex, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        sha256("abc", 3, md);
+        digest_hex(md, hex);
+        assert_string_equal(hex, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+        sha256(abc448, strlen(abc448), md);
+        digest_hex(md, hex);
+        assert_string_equal(hex, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    }
+    assert_int_equal(ccnl_SHA256_setKernel("generic"), 0);
+    assert_int_equal(ccnl_SHA256_setKernel("none"), -1);
+}
+
+void test_hmac256_vectors()
+{
+    // RFC 4231, test cases 1 and 2
+    uint8_t key1[20], keyval[64], md[SHA256_DIGEST_LENGTH];
+    char hex[2 * SHA256_DIGEST_LENGTH + 1];
+    size_t mlen = sizeof(md);
+
+    memset(key1, 0x0b, sizeof(key1));
+    ccnl_hmac256_keyval(key1, sizeof(key1), keyval);
+    ccnl_hmac256_sign(keyval, sizeof(keyval), (uint8_t *) "Hi There", 8, md, &mlen);
+    digest_hex(md, hex);
+    assert_string_equal(hex, "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+
+    ccnl_hmac256_keyval((uint8_t *) "Jefe", 4, keyval);
+    ccnl_hmac256_sign(keyval, sizeof(keyval),
+                      (uint8_t *) "what do ya want for nothing?", 28, md, &mlen);
+    digest_hex(md, hex);
+    assert_string_equal(hex, "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+}
+
+void test_sha256_kernels_agree()
+{
+    uint8_t buf[1000], ref[SHA256_DIGEST_LENGTH], md[SHA256_DIGEST_LENGTH];
+    SHA256_CTX_t ctx;
+    size_t len, k;
+
+    fill(buf, sizeof(buf), 1);
+    for (len = 0; len < sizeof(buf); len += 7) {
+        ccnl_SHA256_setKernel("generic");
+        sha256((const char *) buf, len, ref);
+        for (k = 1; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+            if (ccnl_SHA256_setKernel(kernels[k])) {
+                continue;
+            }
+            // two updates, the second one starts in the middle of a block
+            ccnl_SHA256_Init(&ctx);
+            ccnl_SHA256_Update(&ctx, buf, len / 3);
+            ccnl_SHA256_Update(&ctx, buf + len / 3, len - len / 3);
+            ccnl_SHA256_Final(md, &ctx);
+            assert_memory_equal(md, ref, sizeof(md));
+        }
+    }
+}
+
+void test_sha256_final_many()
+{
+    uint8_t buf[11][300], ref[11][SHA256_DIGEST_LENGTH], out[11][SHA256_DIGEST_LENGTH];
+    SHA256_CTX_t ctx[11], *cp[11];
+    const uint8_t *data[11];
+    uint8_t *md[11];
+    size_t len[11], i, k, n;
+
+    for (i = 0; i < 11; i++) {
+        fill(buf[i], sizeof(buf[i]), (unsigned) i + 7);
+        // lengths around the padding boundaries, one context mid-block
+        len[i] = (i * 61) % 300;
+        data[i] = buf[i];
+        md[i] = out[i];
+        cp[i] = ctx + i;
+        sha256((const char *) buf[i], i == 3 ? len[i] + 5 : len[i], ref[i]);
+    }
+    for (k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (ccnl_SHA256_setKernel(kernels[k])) {
+            continue;
+        }
+        for (n = 1; n <= 11; n += 5) {
+            for (i = 0; i < n; i++) {
+                ccnl_SHA256_Init(ctx + i);
+                if (i == 3) {
+                    ccnl_SHA256_Update(ctx + i, buf[i], 5);
+                    data[i] = buf[i] + 5;
+                }
+            }
+            memset(out, 0, sizeof(out));
+            ccnl_SHA256_FinalMany(cp, data, len, md, n);
+            for (i = 0; i < n; i++) {
+                assert_memory_equal(out[i], ref[i], SHA256_DIGEST_LENGTH);
+            }
+        }
+    }
+}
+
+void test_hmac256_key_sign_many()
+{
+    uint8_t buf[9][200], keyval[64], ref[SHA256_DIGEST_LENGTH];
+    uint8_t out[9][SHA256_DIGEST_LENGTH], *md[9];
+    const uint8_t *data[9];
+    size_t len[9], mlen, i, k;
+    struct ccnl_hmac256_key_s key;
+
+    fill(keyval, sizeof(keyval), 3);
+    ccnl_hmac256_key_init(&key, keyval, sizeof(keyval));
+    for (i = 0; i < 9; i++) {
+        fill(buf[i], sizeof(buf[i]), (unsigned) i);
+        data[i] = buf[i];
+        len[i] = 20 * i + 3;
+        md[i] = out[i];
+    }
+    for (k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (ccnl_SHA256_setKernel(kernels[k])) {
+            continue;
+        }
+        ccnl_hmac256_key_sign_many(&key, data, len, md, 9);
+        for (i = 0; i < 9; i++) {
+            mlen = sizeof(ref);
+            ccnl_hmac256_sign(keyval, sizeof(keyval), buf[i], len[i], ref, &mlen);
+            assert_memory_equal(out[i], ref, sizeof(ref));
+        }
+    }
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_sha256_vectors),
+        unit_test(test_hmac256_vectors),
+        unit_test(test_sha256_kernels_agree),
+        unit_test(test_sha256_final_many),
+        unit_test(test_hmac256_key_sign_many),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,260 @@
+/**
+ * @file test_snapshot.c
+ * @brief Tests for the warm restart snapshots of the Content Store and FIB
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#define USE_SUITE_NDNTLV
+#ifndef NEEDS_PACKET_CRAFTING
+#define NEEDS_PACKET_CRAFTING
+#endif
+
+#include "ccnl-pkt.h"
+#include "ccnl-malloc.h"
+#include "ccnl-content.h"
+#include "ccnl-relay.h"
+#include "ccnl-prefix.h"
+#include "ccnl-forward.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-snapshot.h"
+
+#define SNAPSHOT "test_snapshot.snap"
+
+static struct ccnl_prefix_s*
+mkpfx(const char *uri)
+{
+    char tmp[64]; // the parser writes into the URI
+
+    strncpy(tmp, uri, sizeof(tmp) - 1);
+    tmp[sizeof(tmp) - 1] = '\0';
+    return ccnl_URItoPrefix(tmp, CCNL_SUITE_NDNTLV, NULL);
+}
+
+static struct ccnl_content_s*
+add_content(struct ccnl_relay_s *relay, const char *uri)
+{
+    struct ccnl_prefix_s *pfx = mkpfx(uri);
+    struct ccnl_content_s *c = ccnl_mkContentObject(pfx, (uint8_t *) "data", 4, NULL);
+
+    ccnl_prefix_free(pfx);
+    c->pkt->suite = CCNL_SUITE_NDNTLV;
+    assert_true(ccnl_content_add2cache(relay, c) == c);
+    return c;
+}
+
+static void
+set_addr(sockunion *su, uint16_t port)
+{
+    memset(su, 0, sizeof(*su));
+    su->ip4.sin_family = AF_INET;
+    su->ip4.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    su->ip4.sin_port = htons(port);
+}
+
+// a relay with UDP interfaces bound to the given ports, sockets not opened
+static void
+relay_init(struct ccnl_relay_s *relay, const uint16_t *ports, int cnt)
+{
+    int k;
+
+    memset(relay, 0, sizeof(*relay));
+    relay->max_cache_entries = -1;
+    relay->max_pit_entries = -1;
+    for (k = 0; k < cnt; k++) {
+        set_addr(&relay->ifs[k].addr, ports[k]);
+        relay->ifs[k].sock = -1;
+    }
+    relay->ifcount = cnt;
+}
+
+static void
+add_route(struct ccnl_relay_s *relay, const char *uri, int ifndx,
+          uint16_t port, int flags)
+{
+    sockunion peer;
+    struct ccnl_face_s *face;
+
+    set_addr(&peer, port);
+    face = ccnl_get_face_or_create(relay, ifndx, &peer.sa, sizeof(peer));
+    assert_non_null(face);
+    face->flags |= flags;
+    assert_int_equal(ccnl_fib_add_entry(relay, mkpfx(uri), face), 0);
+}
+
+static struct ccnl_forward_s*
+find_route(struct ccnl_relay_s *relay, const char *uri)
+{
+    struct ccnl_prefix_s *pfx = mkpfx(uri);
+    struct ccnl_forward_s *fwd;
+
+    for (fwd = relay->fib; fwd; fwd = fwd->next) {
+        if (!ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) {
+            break;
+        }
+    }
+    ccnl_prefix_free(pfx);
+    return fwd;
+}
+
+static int
+has_name(struct ccnl_content_s *c, const char *uri)
+{
+    struct ccnl_prefix_s *pfx = mkpfx(uri);
+    int rc = !ccnl_prefix_cmp(c->pkt->pfx, NULL, pfx, CMP_EXACT);
+
+    ccnl_prefix_free(pfx);
+    return rc;
+}
+
+static size_t
+read_file(uint8_t *buf, size_t size)
+{
+    FILE *f = fopen(SNAPSHOT, "rb");
+    size_t len;
+
+    assert_non_null(f);
+    len = fread(buf, 1, size, f);
+    fclose(f);
+    return len;
+}
+
+static void
+write_file(uint8_t *buf, size_t len)
+{
+    FILE *f = fopen(SNAPSHOT, "wb");
+
+    assert_non_null(f);
+    assert_int_equal(fwrite(buf, 1, len, f), len);
+    fclose(f);
+}
+
+void test_ccnl_snapshot_roundtrip()
+{
+    static const uint16_t ports[] = { 9001, 9002 }, swapped[] = { 9002, 9001 };
+    struct ccnl_relay_s relay, relay2, relay3;
+    struct ccnl_content_s *c;
+    struct ccnl_forward_s *fwd;
+
+    relay_init(&relay, ports, 2);
+    add_content(&relay, "/s/a");
+    ccnl_content_set_static(&relay, add_content(&relay, "/s/b"));
+    add_content(&relay, "/s/c");
+    add_route(&relay, "/s/x", 0, 7001, 0);
+    add_route(&relay, "/s/y/z", 1, 7002, CCNL_FACE_FLAGS_STATIC);
+    assert_int_equal(ccnl_snapshot_save(&relay, SNAPSHOT), 0);
+
+    /** contents come back in LRU order with their STATIC flag, routes on
+     *  the interface with the same address even if it moved */
+    relay_init(&relay2, swapped, 2);
+    assert_int_equal(ccnl_snapshot_load(&relay2, SNAPSHOT), 5);
+    assert_int_equal(relay2.contentcnt, 3);
+    c = relay2.contents;
+    assert_true(has_name(c, "/s/c"));
+    assert_false(c->flags & CCNL_CONTENT_FLAGS_STATIC);
+    c = c->next;
+    assert_true(has_name(c, "/s/b"));
+    assert_true(c->flags & CCNL_CONTENT_FLAGS_STATIC);
+    c = c->next;
+    assert_true(has_name(c, "/s/a"));
+    assert_false(c->flags & CCNL_CONTENT_FLAGS_STATIC);
+    assert_null(c->next);
+    assert_true(relay2.contentsend == c);
+
+    fwd = find_route(&relay2, "/s/x");
+    assert_non_null(fwd);
+    assert_int_equal(fwd->face->ifndx, 1);
+    assert_int_equal(ntohs(fwd->face->peer.ip4.sin_port), 7001);
+    assert_false(fwd->face->flags & CCNL_FACE_FLAGS_STATIC);
+    fwd = find_route(&relay2, "/s/y/z");
+    assert_non_null(fwd);
+    assert_int_equal(fwd->face->ifndx, 0);
+    assert_int_equal(ntohs(fwd->face->peer.ip4.sin_port), 7002);
+    assert_true(fwd->face->flags & CCNL_FACE_FLAGS_STATIC);
+
+    /** a route whose interface is gone is skipped */
+    relay_init(&relay3, ports, 1);
+    assert_int_equal(ccnl_snapshot_load(&relay3, SNAPSHOT), 4);
+    assert_non_null(find_route(&relay3, "/s/x"));
+    assert_null(find_route(&relay3, "/s/y/z"));
+
+    remove(SNAPSHOT);
+    ccnl_core_cleanup(&relay);
+    ccnl_core_cleanup(&relay2);
+    ccnl_core_cleanup(&relay3);
+}
+
+void test_ccnl_snapshot_damaged()
+{
+    static const uint16_t ports[] = { 9001 };
+    static uint8_t buf[4096];
+    struct ccnl_relay_s relay, relay2;
+    struct ccnl_snapshot_rec_s rec;
+    size_t len, first;
+
+    relay_init(&relay, ports, 1);
+    add_content(&relay, "/s/a");
+    add_content(&relay, "/s/b");
+    assert_int_equal(ccnl_snapshot_save(&relay, SNAPSHOT), 0);
+    len = read_file(buf, sizeof(buf));
+    memcpy(&rec, buf + sizeof(struct ccnl_snapshot_hdr_s), sizeof(rec));
+    first = sizeof(struct ccnl_snapshot_hdr_s) + sizeof(rec) + rec.len;
+    assert_true(first < len);
+
+    /** a truncated record is not loaded, the ones before it are */
+    write_file(buf, len - 3);
+    relay_init(&relay2, ports, 1);
+    assert_int_equal(ccnl_snapshot_load(&relay2, SNAPSHOT), 1);
+    assert_int_equal(relay2.contentcnt, 1);
+    assert_true(has_name(relay2.contents, "/s/a"));
+    ccnl_core_cleanup(&relay2);
+
+    /** a record that does not parse is skipped, the ones after it load */
+    memset(buf + sizeof(struct ccnl_snapshot_hdr_s) + sizeof(rec), 0, rec.len);
+    write_file(buf, len);
+    relay_init(&relay2, ports, 1);
+    assert_int_equal(ccnl_snapshot_load(&relay2, SNAPSHOT), 1);
+    assert_int_equal(relay2.contentcnt, 1);
+    assert_true(has_name(relay2.contents, "/s/b"));
+    ccnl_core_cleanup(&relay2);
+
+    /** a file that is no snapshot is rejected */
+    buf[0] ^= 0xff;
+    write_file(buf, len);
+    relay_init(&relay2, ports, 1);
+    assert_int_equal(ccnl_snapshot_load(&relay2, SNAPSHOT), -1);
+    assert_int_equal(relay2.contentcnt, 0);
+    ccnl_core_cleanup(&relay2);
+
+    remove(SNAPSHOT);
+    ccnl_core_cleanup(&relay);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_snapshot_roundtrip),
+        unit_test(test_ccnl_snapshot_damaged),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,234 @@
+/**
+ * @file test_uring.c
+ * @brief Loopback tests for the io_uring event and IO loop
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/filter.h>
+#include <linux/io_uring.h>
+#include <linux/seccomp.h>
+
+#define USE_SUITE_NDNTLV
+#ifndef NEEDS_PACKET_CRAFTING
+#define NEEDS_PACKET_CRAFTING
+#endif
+
+#include "ccnl-pkt.h"
+#include "ccnl-malloc.h"
+#include "ccnl-content.h"
+#include "ccnl-relay.h"
+#include "ccnl-prefix.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-os-time.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-unix.h"
+#include "ccnl-uring.h"
+
+static uint8_t reply[CCNL_MAX_PACKET_SIZE];
+static ssize_t replylen;
+static int polls;
+static void *timer;
+
+static struct ccnl_prefix_s*
+mkpfx(const char *uri)
+{
+    char tmp[64]; // the parser writes into the URI
+
+    strncpy(tmp, uri, sizeof(tmp) - 1);
+    tmp[sizeof(tmp) - 1] = '\0';
+    return ccnl_URItoPrefix(tmp, CCNL_SUITE_NDNTLV, NULL);
+}
+
+// a relay with one UDP interface on an ephemeral port and /u/a in its CS
+static void
+relay_init(struct ccnl_relay_s *relay)
+{
+    struct ccnl_prefix_s *pfx = mkpfx("/u/a");
+    struct ccnl_content_s *c;
+
+    ccnl_core_init();
+    memset(relay, 0, sizeof(*relay));
+    relay->max_cache_entries = -1;
+    relay->max_pit_entries = -1;
+    relay->ccnl_ll_TX_ptr = ccnl_ll_TX;
+#ifdef USE_FRAG
+    relay->ccnl_ll_TXv_ptr = ccnl_ll_TXv;
+#endif
+    ccnl_relay_udp(relay, 0, AF_INET, CCNL_SUITE_NDNTLV);
+    assert_int_equal(relay->ifcount, 1);
+
+    c = ccnl_mkContentObject(pfx, (uint8_t *) "uring", 5, NULL);
+    ccnl_prefix_free(pfx);
+    c->pkt->suite = CCNL_SUITE_NDNTLV;
+    assert_true(ccnl_content_add2cache(relay, c) == c);
+}
+
+// sends an Interest for /u/a to the relay from a new socket
+static int
+send_interest(struct ccnl_relay_s *relay)
+{
+    struct ccnl_prefix_s *pfx = mkpfx("/u/a");
+    ccnl_interest_opts_u opts;
+    struct ccnl_buf_s *buf;
+    struct sockaddr_in to;
+    int s = socket(AF_INET, SOCK_DGRAM, 0);
+
+    assert_true(s >= 0);
+    memset(&opts, 0, sizeof(opts));
+    opts.ndntlv.nonce = 4711;
+    opts.ndntlv.interestlifetime = 4000;
+    buf = ccnl_mkSimpleInterest(pfx, &opts);
+    ccnl_prefix_free(pfx);
+
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    to.sin_port = relay->ifs[0].addr.ip4.sin_port;
+    assert_int_equal(sendto(s, buf->data, buf->datalen, 0,
+                            (struct sockaddr*) &to, sizeof(to)),
+                     (ssize_t) buf->datalen);
+    ccnl_free(buf);
+    return s;
+}
+
+// a timer that halts the relay once the Data is back, or after two seconds;
+// it stays armed as the loops only look at the halt_flag after a wait
+static void
+poll_reply(void *relay, void *sock)
+{
+    if (replylen <= 0) {
+        replylen = recv((int) (intptr_t) sock, reply, sizeof(reply),
+                        MSG_DONTWAIT);
+    }
+    if (replylen > 0 || ++polls >= 200) {
+        ((struct ccnl_relay_s*) relay)->halt_flag = 1;
+    }
+    timer = ccnl_set_timer(10000, poll_reply, relay, sock);
+}
+
+static void
+start_polls(struct ccnl_relay_s *relay, int sock)
+{
+    replylen = 0;
+    polls = 0;
+    timer = ccnl_set_timer(10000, poll_reply, relay, (void*) (intptr_t) sock);
+}
+
+static int
+reply_has(const char *s)
+{
+    ssize_t k, n = (ssize_t) strlen(s);
+
+    for (k = 0; k + n <= replylen; k++) {
+        if (!memcmp(reply + k, s, n)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// lets io_uring_setup() fail with ENOSYS as on kernels before 5.1
+static int
+deny_io_uring(void)
+{
+    struct sock_filter filter[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_io_uring_setup, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | ENOSYS),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW),
+    };
+    struct sock_fprog prog = { sizeof(filter) / sizeof(filter[0]), filter };
+
+    if (prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) < 0) {
+        return -1;
+    }
+    return prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &prog, 0, 0);
+}
+
+void test_ccnl_uring_loopback()
+{
+    struct ccnl_relay_s relay;
+    struct io_uring_params p;
+    int fd, s;
+
+    memset(&p, 0, sizeof(p));
+    fd = (int) syscall(__NR_io_uring_setup, 1, &p);
+    if (fd < 0 && (errno == ENOSYS || errno == EPERM)) {
+        printf("io_uring not available, skipped\n");
+        return;
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    relay_init(&relay);
+    s = send_interest(&relay);
+    start_polls(&relay, s);
+    assert_int_equal(ccnl_uring_loop(&relay), 0);
+    ccnl_rem_timer(timer);
+    assert_true(replylen > 0);
+    assert_true(reply_has("uring"));
+
+    close(s);
+    ccnl_core_cleanup(&relay);
+}
+
+// must run last, the filter cannot be taken back
+void test_ccnl_uring_fallback()
+{
+    struct ccnl_relay_s relay;
+    int s;
+
+    if (deny_io_uring() < 0) {
+        printf("no seccomp filters, skipped\n");
+        return;
+    }
+    relay_init(&relay);
+    s = send_interest(&relay);
+
+    /** the relay falls back to ccnl_io_loop() which answers the Interest */
+    assert_int_equal(ccnl_uring_loop(&relay), -1);
+    assert_int_equal(relay.halt_flag, 0);
+    start_polls(&relay, s);
+    ccnl_io_loop(&relay);
+    ccnl_rem_timer(timer);
+    assert_true(replylen > 0);
+    assert_true(reply_has("uring"));
+
+    close(s);
+    ccnl_core_cleanup(&relay);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_uring_loopback),
+        unit_test(test_ccnl_uring_fallback),
+    };
+
+    return run_tests(tests);
+}
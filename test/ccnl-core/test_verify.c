@@ -0,0 +1,457 @@
+/**
+ * @file test_verify.c
+ * @brief Tests for the batched HMAC verification of incoming Data
+ *
+ * Copyright (C) 2026 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#define USE_SUITE_NDNTLV
+#define USE_SUITE_CCNTLV
+#ifndef NEEDS_PACKET_CRAFTING
+#define NEEDS_PACKET_CRAFTING
+#endif
+
+#include "ccnl-pkt.h"
+#include "ccnl-malloc.h"
+#include "ccnl-relay.h"
+#include "ccnl-prefix.h"
+#include "ccnl-callbacks.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-fwd.h"
+#include "ccnl-ext-hmac.h"
+#include "ccnl-verify.h"
+#include "base64.h"
+
+#define KEYFILE "test_verify.keys"
+
+// the first two keys are in the keyring, the third is unknown
+static uint8_t keys[3][30];
+static uint8_t keyids[3][SHA256_DIGEST_LENGTH];
+static struct ccnl_hmac256_key_s hkeys[3];
+
+static struct ccnl_relay_s relay;
+static struct ccnl_face_s *consumer, *producer;
+static char order[16]; // the payload numbers of the Data sent, in order
+static int sent;
+
+static void
+keep_tx(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+        sockunion *dest, struct ccnl_buf_s *buf)
+{
+    size_t k;
+    (void) ccnl;
+    (void) ifc;
+    (void) dest;
+
+    for (k = 0; k + 4 <= buf->datalen; k++) {
+        if (!memcmp(buf->data + k, "pay", 3) && sent < (int) sizeof(order) - 1) {
+            order[sent++] = (char) buf->data[k + 3];
+            return;
+        }
+    }
+}
+
+static void
+write_keys(void)
+{
+    FILE *fp = fopen(KEYFILE, "w");
+    uint8_t keyval[64];
+    size_t i, j, len;
+    char *b64;
+
+    assert_non_null(fp);
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < sizeof(keys[i]); j++) {
+            keys[i][j] = (uint8_t) (i * 31 + j * 7 + 1);
+        }
+        ccnl_hmac256_keyid(keys[i], sizeof(keys[i]), keyids[i]);
+        ccnl_hmac256_keyval(keys[i], sizeof(keys[i]), keyval);
+        ccnl_hmac256_key_init(&hkeys[i], keyval, sizeof(keyval));
+        if (i < 2) {
+            b64 = base64_encode((char *) keys[i], sizeof(keys[i]), &len);
+            fprintf(fp, "%s\n", b64);
+            free(b64);
+        }
+    }
+    fclose(fp);
+}
+
+static void
+start(size_t batch)
+{
+    memset(&relay, 0, sizeof(relay));
+    relay.max_pit_entries = -1;
+    relay.ccnl_ll_TX_ptr = keep_tx;
+    consumer = ccnl_calloc(1, sizeof(*consumer));
+    producer = ccnl_calloc(1, sizeof(*producer));
+    consumer->faceid = 1;
+    producer->faceid = 2;
+    consumer->next = producer;
+    producer->prev = consumer;
+    relay.faces = consumer;
+    sent = 0;
+    memset(order, 0, sizeof(order));
+    assert_int_equal(ccnl_verify_open(&relay, KEYFILE, batch), 0);
+}
+
+static void
+stop(void)
+{
+    ccnl_verify_close();
+    ccnl_core_cleanup(&relay);
+}
+
+static struct ccnl_prefix_s*
+mkpfx(const char *uri, int suite)
+{
+    char tmp[64]; // the parser writes into the URI
+
+    strncpy(tmp, uri, sizeof(tmp) - 1);
+    tmp[sizeof(tmp) - 1] = '\0';
+    return ccnl_URItoPrefix(tmp, suite, NULL);
+}
+
+static void
+rx(struct ccnl_face_s *from, int suite, uint8_t *data, size_t datalen)
+{
+    if (suite == CCNL_SUITE_NDNTLV) {
+        ccnl_ndntlv_forwarder(&relay, from, &data, &datalen);
+    } else {
+        ccnl_ccntlv_forwarder(&relay, from, &data, &datalen);
+    }
+}
+
+static void
+interest(const char *uri, int suite, int32_t nonce)
+{
+    struct ccnl_prefix_s *pfx = mkpfx(uri, suite);
+    ccnl_interest_opts_u opts;
+    struct ccnl_buf_s *buf;
+
+    memset(&opts, 0, sizeof(opts));
+    opts.ndntlv.nonce = nonce;
+    opts.ndntlv.interestlifetime = 4000;
+    buf = ccnl_mkSimpleInterest(pfx, &opts);
+    ccnl_prefix_free(pfx);
+    rx(consumer, suite, buf->data, buf->datalen);
+    ccnl_free(buf);
+}
+
+// NDN Data signed with keys[key]; with a KeyLocatorDigest if keyid is given,
+// else as our signer does it
+static size_t
+ndn_data(const char *uri, const char *payload, int key, const uint8_t *keyid,
+         uint8_t *out)
+{
+    uint8_t buf[CCNL_MAX_PACKET_SIZE];
+    uint8_t sigtype = NDN_SigTypeVal_SignatureHmacWithSha256;
+    struct ccnl_prefix_s *pfx = mkpfx(uri, CCNL_SUITE_NDNTLV);
+    size_t offset = sizeof(buf), mdoffset, endofsign, mdlen = 32, len = 0;
+
+    if (!keyid) {
+        assert_int_equal(ccnl_ndntlv_prependSignedContentKey(pfx,
+                                (uint8_t *) payload, strlen(payload), NULL, NULL,
+                                &hkeys[key], &offset, buf, &len), 0);
+    } else {
+        offset -= mdlen;
+        mdoffset = offset;
+        assert_int_equal(ccnl_ndntlv_prependTL(NDN_TLV_SignatureValue, mdlen,
+                                               &offset, buf), 0);
+        endofsign = offset;
+        assert_int_equal(ccnl_ndntlv_prependBlob(NDN_TLV_KeyLocatorDigest,
+                            (uint8_t *) keyid, SHA256_DIGEST_LENGTH, &offset, buf), 0);
+        assert_int_equal(ccnl_ndntlv_prependTL(NDN_TLV_KeyLocator,
+                            SHA256_DIGEST_LENGTH + 2, &offset, buf), 0);
+        assert_int_equal(ccnl_ndntlv_prependBlob(NDN_TLV_SignatureType,
+                            &sigtype, 1, &offset, buf), 0);
+        assert_int_equal(ccnl_ndntlv_prependTL(NDN_TLV_SignatureInfo,
+                            endofsign - offset, &offset, buf), 0);
+        assert_int_equal(ccnl_ndntlv_prependBlob(NDN_TLV_Content,
+                            (uint8_t *) payload, strlen(payload), &offset, buf), 0);
+        assert_int_equal(ccnl_ndntlv_prependTL(NDN_TLV_MetaInfo, 0, &offset, buf), 0);
+        assert_int_equal(ccnl_ndntlv_prependName(pfx, &offset, buf), 0);
+        assert_int_equal(ccnl_ndntlv_prependTL(NDN_TLV_Data, sizeof(buf) - offset,
+                                               &offset, buf), 0);
+        ccnl_hmac256_key_sign(&hkeys[key], buf + offset, endofsign - offset,
+                              buf + mdoffset, &mdlen);
+        len = sizeof(buf) - offset;
+    }
+    ccnl_prefix_free(pfx);
+    memcpy(out, buf + offset, len);
+    return len;
+}
+
+// CCNx Data signed with keys[key]; with a KeyId if keyid is given, else as
+// our signer does it
+static size_t
+ccnx_data(const char *uri, const char *payload, int key, const uint8_t *keyid,
+          uint8_t *out)
+{
+    uint8_t buf[CCNL_MAX_PACKET_SIZE];
+    struct ccnl_prefix_s *pfx = mkpfx(uri, CCNL_SUITE_CCNTLV);
+    size_t offset = sizeof(buf), mdoffset, endofsign, mdlen = 32, len = 0;
+
+    if (!keyid) {
+        assert_int_equal(ccnl_ccntlv_prependSignedContentWithHdrKey(pfx,
+                                (uint8_t *) payload, strlen(payload), NULL, NULL,
+                                &hkeys[key], &offset, buf, &len), 0);
+    } else {
+        offset -= mdlen;
+        mdoffset = offset;
+        assert_int_equal(ccnl_ccntlv_prependTL(CCNX_TLV_TL_ValidationPayload,
+                                               mdlen, &offset, buf), 0);
+        endofsign = offset;
+        offset -= SHA256_DIGEST_LENGTH;
+        memcpy(buf + offset, keyid, SHA256_DIGEST_LENGTH);
+        assert_int_equal(ccnl_ccntlv_prependTL(CCNX_VALIDALGO_KEYID,
+                            SHA256_DIGEST_LENGTH, &offset, buf), 0);
+        assert_int_equal(ccnl_ccntlv_prependTL(CCNX_VALIDALGO_HMAC_SHA256,
+                            4 + SHA256_DIGEST_LENGTH, &offset, buf), 0);
+        assert_int_equal(ccnl_ccntlv_prependTL(CCNX_TLV_TL_ValidationAlgo,
+                            8 + SHA256_DIGEST_LENGTH, &offset, buf), 0);
+        assert_int_equal(ccnl_ccntlv_prependContent(pfx, (uint8_t *) payload,
+                            strlen(payload), NULL, NULL, &offset, buf, &len), 0);
+        ccnl_hmac256_key_sign(&hkeys[key], buf + offset, endofsign - offset,
+                              buf + mdoffset, &mdlen);
+        assert_int_equal(ccnl_ccntlv_prependFixedHdr(CCNX_TLV_V1, CCNX_PT_Data,
+                            sizeof(buf) - offset, 255, &offset, buf), 0);
+        len = sizeof(buf) - offset;
+    }
+    ccnl_prefix_free(pfx);
+    memcpy(out, buf + offset, len);
+    return len;
+}
+
+static struct ccnl_pkt_s*
+ndn_parse(uint8_t *data, size_t datalen)
+{
+    uint8_t *start = data;
+    uint64_t typ;
+    size_t len;
+
+    if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len)) {
+        return NULL;
+    }
+    return ccnl_ndntlv_bytes2pkt(typ, start, &data, &len);
+}
+
+static int
+pit_count(void)
+{
+    struct ccnl_interest_s *i;
+    int n = 0;
+
+    for (i = relay.pit; i; i = i->next) {
+        n++;
+    }
+    return n;
+}
+
+void test_ccnl_verify_dehead()
+{
+    uint8_t ndn[] = { NDN_TLV_Content, 0x04, 1, 2, 3 };
+    uint8_t ccnx[] = { 0x00, CCNX_TLV_M_Payload, 0x00, 0x02, 9 };
+    uint8_t *cp;
+    uint64_t typ;
+    uint16_t typ16;
+    size_t len, vallen;
+
+    /** the value length is bounded by the bytes after the TL header */
+    cp = ndn;
+    len = sizeof(ndn);
+    assert_int_equal(ccnl_ndntlv_dehead(&cp, &len, &typ, &vallen), -1);
+    ndn[1] = 0x03;
+    cp = ndn;
+    len = sizeof(ndn);
+    assert_int_equal(ccnl_ndntlv_dehead(&cp, &len, &typ, &vallen), 0);
+    assert_int_equal(vallen, 3);
+    assert_int_equal(len, 3);
+
+    cp = ccnx;
+    len = sizeof(ccnx);
+    assert_int_equal(ccnl_ccntlv_dehead(&cp, &len, &typ16, &vallen), -1);
+    ccnx[3] = 0x01;
+    cp = ccnx;
+    len = sizeof(ccnx);
+    assert_int_equal(ccnl_ccntlv_dehead(&cp, &len, &typ16, &vallen), 0);
+    assert_int_equal(vallen, 1);
+}
+
+void test_ccnl_verify_signature()
+{
+    uint8_t pkt[CCNL_MAX_PACKET_SIZE];
+    struct ccnl_pkt_s *p;
+    size_t len;
+
+    start(0);
+    interest("/v/a", CCNL_SUITE_NDNTLV, 1);
+    interest("/v/b", CCNL_SUITE_NDNTLV, 2);
+    interest("/v/c", CCNL_SUITE_NDNTLV, 3);
+    interest("/v/d", CCNL_SUITE_NDNTLV, 4);
+    assert_int_equal(pit_count(), 4);
+
+    /** a valid signature without key locator is checked with the first key */
+    len = ndn_data("/v/a", "pay1", 0, NULL, pkt);
+    rx(producer, CCNL_SUITE_NDNTLV, pkt, len);
+    /** a bad signature */
+    len = ndn_data("/v/b", "pay2", 0, NULL, pkt);
+    pkt[len - 1] ^= 0x01;
+    rx(producer, CCNL_SUITE_NDNTLV, pkt, len);
+    /** an unknown key, even if the signature matches */
+    len = ndn_data("/v/c", "pay3", 2, keyids[2], pkt);
+    rx(producer, CCNL_SUITE_NDNTLV, pkt, len);
+    /** the KeyLocatorDigest selects the second key */
+    len = ndn_data("/v/d", "pay4", 1, keyids[1], pkt);
+    rx(producer, CCNL_SUITE_NDNTLV, pkt, len);
+    p = ndn_parse(pkt, len);
+    assert_non_null(p);
+    assert_non_null(p->s.ndntlv.ppkl);
+    assert_int_equal(p->s.ndntlv.ppkl->datalen, SHA256_DIGEST_LENGTH);
+    assert_memory_equal(p->s.ndntlv.ppkl->data, keyids[1], SHA256_DIGEST_LENGTH);
+    ccnl_pkt_free(p);
+
+    /** nothing passes before the burst ends */
+    assert_int_equal(sent, 0);
+    ccnl_callback_rx_burst_end(&relay);
+    assert_int_equal(sent, 2);
+    assert_string_equal(order, "14");
+    assert_int_equal(pit_count(), 2);
+
+    stop();
+}
+
+void test_ccnl_verify_truncated()
+{
+    uint8_t pkt[CCNL_MAX_PACKET_SIZE];
+    size_t len;
+
+    start(0);
+    interest("/v/t", CCNL_SUITE_NDNTLV, 1);
+
+    /** the SignatureValue TLV claims more bytes than the packet has */
+    len = ndn_data("/v/t", "pay1", 0, NULL, pkt);
+    assert_true(pkt[1] < 253);
+    pkt[1] -= 8;
+    len -= 8;
+    assert_null(ndn_parse(pkt, len));
+    rx(producer, CCNL_SUITE_NDNTLV, pkt, len);
+    ccnl_callback_rx_burst_end(&relay);
+    assert_int_equal(sent, 0);
+    assert_int_equal(pit_count(), 1);
+
+    stop();
+}
+
+void test_ccnl_verify_ccnx()
+{
+    uint8_t pkt[CCNL_MAX_PACKET_SIZE];
+    struct ccnx_tlvhdr_ccnx2015_s *hp = (struct ccnx_tlvhdr_ccnx2015_s *) pkt;
+    uint8_t *data;
+    size_t len, datalen;
+    struct ccnl_pkt_s *p;
+
+    start(0);
+    interest("/v/x", CCNL_SUITE_CCNTLV, 1);
+    interest("/v/y", CCNL_SUITE_CCNTLV, 2);
+
+    /** the fixed header of signed content covers the validation TLVs */
+    len = ccnx_data("/v/x", "pay1", 0, NULL, pkt);
+    assert_int_equal(ntohs(hp->pktlen), len);
+    rx(producer, CCNL_SUITE_CCNTLV, pkt, len);
+
+    /** the KeyId selects the second key */
+    len = ccnx_data("/v/y", "pay2", 1, keyids[1], pkt);
+    data = pkt + hp->hdrlen;
+    datalen = len - hp->hdrlen;
+    p = ccnl_ccntlv_bytes2pkt(pkt, &data, &datalen);
+    assert_non_null(p);
+    assert_non_null(p->hmacSignature);
+    assert_non_null(p->s.ccntlv.keyid);
+    assert_memory_equal(p->s.ccntlv.keyid->data, keyids[1], SHA256_DIGEST_LENGTH);
+    ccnl_pkt_free(p);
+    rx(producer, CCNL_SUITE_CCNTLV, pkt, len);
+
+    ccnl_verify_flush(&relay);
+    assert_int_equal(sent, 2);
+    assert_string_equal(order, "12");
+
+    stop();
+}
+
+void test_ccnl_verify_batch()
+{
+    uint8_t pkt[CCNL_MAX_PACKET_SIZE];
+    char uri[16], payload[8];
+    size_t len;
+    int k;
+
+    start(4);
+    for (k = 1; k <= 6; k++) {
+        snprintf(uri, sizeof(uri), "/v/%d", k);
+        interest(uri, CCNL_SUITE_NDNTLV, k);
+    }
+
+    /** packets of both keys are checked in one batch, the full batch is
+     *  flushed, the valid ones pass in arrival order */
+    for (k = 1; k <= 6; k++) {
+        snprintf(uri, sizeof(uri), "/v/%d", k);
+        snprintf(payload, sizeof(payload), "pay%d", k);
+        if (k % 2) {
+            len = ndn_data(uri, payload, 0, NULL, pkt);
+        } else {
+            len = ndn_data(uri, payload, 1, keyids[1], pkt);
+        }
+        if (k == 3) {
+            pkt[len - 1] ^= 0x01;
+        }
+        rx(producer, CCNL_SUITE_NDNTLV, pkt, len);
+    }
+    assert_int_equal(sent, 3);
+    assert_string_equal(order, "124");
+
+    /** the rest waits for the end of the burst */
+    ccnl_callback_rx_burst_end(&relay);
+    assert_int_equal(sent, 5);
+    assert_string_equal(order, "12456");
+
+    stop();
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_verify_dehead),
+        unit_test(test_ccnl_verify_signature),
+        unit_test(test_ccnl_verify_truncated),
+        unit_test(test_ccnl_verify_ccnx),
+        unit_test(test_ccnl_verify_batch),
+    };
+    int rc;
+
+    write_keys();
+    rc = run_tests(tests);
+    remove(KEYFILE);
+    return rc;
+}